@@ -408,6 +408,35 @@ function simpleTestCatchesExtra() {
     assert.eq(nErrors, 1, "dbCheck found too many errors after single inconsistent insertion");
 }
 
+// Add an extra document in the middle of a multi-leaf batch, and test that the Merkle mode of
+// dbCheck narrows the inconsistency down to the single leaf range holding it.
+function merkleTestLocatesExtra() {
+    let master = replSet.getPrimary();
+    let db = master.getDB(dbName);
+    db[collName].drop();
+    db[collName].insertMany([...Array(1000).keys()].map(x => ({_id: 2 * x})));
+    replSet.awaitReplication();
+
+    clearLog();
+
+    insertOnSecondaries({_id: 1001});
+
+    assert.commandWorked(db.runCommand({dbCheck: collName, merkle: true}));
+    awaitDbCheckCompletion(db);
+
+    let errors = replSet.getSecondary()
+                     .getDB("local")
+                     .system.healthlog.find({operation: "dbCheckBatch", severity: "error"})
+                     .toArray();
+
+    assert.eq(errors.length, 1, "dbCheck found wrong number of errors: " + tojson(errors));
+
+    let ranges = errors[0].data.divergentRanges;
+    assert.eq(ranges.length, 1, "expected a single divergent range: " + tojson(ranges));
+    assert.lt(ranges[0].minKey, 1001, tojson(ranges));
+    assert.gte(ranges[0].maxKey, 1001, tojson(ranges));
+}
+
 // Test that dbCheck catches changing various pieces of collection metadata.
 function testCollectionMetadataChanges() {
     let master = replSet.getPrimary();
@@ -437,5 +466,6 @@ function testCollectionMetadataChanges() {
 }
 
 simpleTestCatchesExtra();
+merkleTestLocatesExtra();
 testCollectionMetadataChanges();
 })();
@@ -0,0 +1,41 @@
+/**
+ * Tests that a chunk is fully cloned when the donor serves the initial clone over several streams.
+ */
+(function() {
+"use strict";
+
+const st = new ShardingTest({shards: 2});
+
+const dbName = "test";
+const ns = dbName + ".foo";
+const coll = st.s.getCollection(ns);
+
+assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+st.ensurePrimaryShard(dbName, st.shard0.shardName);
+assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {x: 1}}));
+
+// Enough documents for the donor to use all of its streams
+const numDocs = 10000;
+const bulk = coll.initializeUnorderedBulkOp();
+for (let i = 0; i < numDocs; i++) {
+    bulk.insert({x: i, padding: "x".repeat(100)});
+}
+assert.commandWorked(bulk.execute());
+
+assert.commandWorked(st.rs0.getPrimary().adminCommand({setParameter: 1, migrateCloneStreams: 4}));
+
+assert.commandWorked(st.s.adminCommand(
+    {moveChunk: ns, find: {x: 0}, to: st.shard1.shardName, _waitForDelete: true}));
+
+assert.eq(0, st.rs0.getPrimary().getCollection(ns).countDocuments({}));
+assert.eq(numDocs, st.rs1.getPrimary().getCollection(ns).countDocuments({}));
+assert.eq(numDocs, coll.find().itcount());
+
+// Moving the chunk back over a single stream still works
+assert.commandWorked(st.rs1.getPrimary().adminCommand({setParameter: 1, migrateCloneStreams: 1}));
+assert.commandWorked(st.s.adminCommand(
+    {moveChunk: ns, find: {x: 0}, to: st.shard0.shardName, _waitForDelete: true}));
+assert.eq(numDocs, st.rs0.getPrimary().getCollection(ns).countDocuments({}));
+
+st.stop();
+})();
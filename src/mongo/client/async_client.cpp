@@ -243,7 +243,7 @@ Future<void> AsyncDBClient::initWireVersion(const std::string& appName,
         });
 }
 
-Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+StatusWith<Message> AsyncDBClient::_prepareRequest(Message request, int32_t msgId) {
     auto swm = _compressorManager.compressMessage(request);
     if (!swm.isOK()) {
         return swm.getStatus();
@@ -260,7 +260,16 @@ Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHan
     OpMsg::appendChecksum(&request);
 #endif
 
-    return _session->asyncSinkMessage(request, baton);
+    return request;
+}
+
+Future<void> AsyncDBClient::_call(Message request, int32_t msgId, const BatonHandle& baton) {
+    auto swm = _prepareRequest(std::move(request), msgId);
+    if (!swm.isOK()) {
+        return swm.getStatus();
+    }
+
+    return _session->asyncSinkMessage(swm.getValue(), baton);
 }
 
 Future<Message> AsyncDBClient::_waitForResponse(boost::optional<int32_t> msgId,
@@ -323,6 +332,169 @@ Future<executor::RemoteCommandResponse> AsyncDBClient::runCommandRequest(
         });
 }
 
+Future<executor::RemoteCommandResponse> AsyncDBClient::runMultiplexedCommandRequest(
+    executor::RemoteCommandRequest request, int32_t msgId) {
+    invariant(_negotiatedProtocol);
+    invariant(request.fireAndForgetMode == executor::RemoteCommandRequest::FireAndForgetMode::kOff);
+
+    auto clkSource = _svcCtx->getPreciseClockSource();
+    auto start = clkSource->now();
+    auto requestMsg = rpc::messageFromOpMsgRequest(
+        *_negotiatedProtocol,
+        OpMsgRequest::fromDBAndBody(
+            std::move(request.dbname), std::move(request.cmdObj), std::move(request.metadata)));
+
+    auto pf = makePromiseFuture<Message>();
+    bool startWriting = false;
+    bool startReading = false;
+    {
+        stdx::lock_guard lk(_multiplexMutex);
+        if (!_multiplexStatus.isOK()) {
+            return _multiplexStatus;
+        }
+
+        // Requests are compressed in the order they go out on the wire, which stateful
+        // compressors rely on.
+        auto swm = _prepareRequest(std::move(requestMsg), msgId);
+        if (!swm.isOK()) {
+            return swm.getStatus();
+        }
+
+        _multiplexWriteQueue.push_back(std::move(swm.getValue()));
+        _multiplexPending.emplace(msgId, std::move(pf.promise));
+        startWriting = !std::exchange(_multiplexWriting, true);
+        startReading = !std::exchange(_multiplexReading, true);
+    }
+
+    if (startWriting) {
+        _writeMultiplexed();
+    }
+    if (startReading) {
+        _readMultiplexed();
+    }
+
+    return std::move(pf.future).then([start, clkSource](Message response) {
+        rpc::UniqueReply reply(response, rpc::makeReply(&response));
+        auto duration = duration_cast<Milliseconds>(clkSource->now() - start);
+        return executor::RemoteCommandResponse(*reply, duration);
+    });
+}
+
+void AsyncDBClient::cancelMultiplexedCommand(int32_t msgId, Status reason) {
+    boost::optional<Promise<Message>> promise;
+    {
+        stdx::lock_guard lk(_multiplexMutex);
+        auto it = _multiplexPending.find(msgId);
+        if (it == _multiplexPending.end()) {
+            return;
+        }
+
+        promise.emplace(std::move(it->second));
+        _multiplexPending.erase(it);
+        _multiplexCanceled = true;
+    }
+
+    promise->setError(std::move(reason));
+}
+
+Status AsyncDBClient::getMultiplexingStatus() {
+#ifdef MONGO_CONFIG_SSL
+    // A TLS stream can't have a read and a write in progress from different threads.
+    if (SSLPeerInfo::forSession(_session).isTLS) {
+        return {ErrorCodes::IllegalOperation, "Requests can't be multiplexed over TLS"};
+    }
+#endif
+
+    stdx::lock_guard lk(_multiplexMutex);
+    if (_multiplexStatus.isOK() && _multiplexCanceled) {
+        return {ErrorCodes::CallbackCanceled,
+                "A request multiplexed onto the connection was canceled"};
+    }
+
+    return _multiplexStatus;
+}
+
+void AsyncDBClient::_writeMultiplexed() {
+    std::vector<Message> batch;
+    {
+        stdx::lock_guard lk(_multiplexMutex);
+        if (_multiplexWriteQueue.empty()) {
+            _multiplexWriting = false;
+            return;
+        }
+
+        batch = std::exchange(_multiplexWriteQueue, {});
+    }
+
+    // Everything submitted while the previous write was in progress goes out in this one.
+    _session->asyncSinkMessages(std::move(batch))
+        .getAsync([this, anchor = shared_from_this()](Status status) {
+            if (!status.isOK()) {
+                _failMultiplexed(std::move(status));
+            }
+
+            _writeMultiplexed();
+        });
+}
+
+void AsyncDBClient::_readMultiplexed() {
+    _session->asyncSourceMessage().getAsync([this, anchor = shared_from_this()](
+                                                StatusWith<Message> swResponse) {
+        if (swResponse.isOK() && swResponse.getValue().operation() == dbCompressed) {
+            swResponse = _compressorManager.decompressMessage(swResponse.getValue());
+        }
+
+        if (!swResponse.isOK()) {
+            _failMultiplexed(swResponse.getStatus());
+
+            stdx::lock_guard lk(_multiplexMutex);
+            _multiplexReading = false;
+            return;
+        }
+
+        auto& response = swResponse.getValue();
+        boost::optional<Promise<Message>> promise;
+        bool keepReading;
+        {
+            stdx::lock_guard lk(_multiplexMutex);
+            auto it = _multiplexPending.find(response.header().getResponseToMsgId());
+            if (it != _multiplexPending.end()) {
+                promise.emplace(std::move(it->second));
+                _multiplexPending.erase(it);
+            }
+
+            keepReading = !_multiplexPending.empty();
+            _multiplexReading = keepReading;
+        }
+
+        // The reply to a canceled request has nobody waiting for it and is dropped.
+        if (promise) {
+            promise->emplaceValue(std::move(response));
+        }
+
+        if (keepReading) {
+            _readMultiplexed();
+        }
+    });
+}
+
+void AsyncDBClient::_failMultiplexed(Status status) {
+    stdx::unordered_map<int32_t, Promise<Message>> pending;
+    {
+        stdx::lock_guard lk(_multiplexMutex);
+        if (_multiplexStatus.isOK()) {
+            _multiplexStatus = status;
+        }
+
+        pending = std::exchange(_multiplexPending, {});
+        _multiplexWriteQueue.clear();
+    }
+
+    for (auto& [msgId, promise] : pending) {
+        promise.setError(status);
+    }
+}
+
 Future<executor::RemoteCommandResponse> AsyncDBClient::_continueReceiveExhaustResponse(
     ClockSource::StopWatch stopwatch, boost::optional<int32_t> msgId, const BatonHandle& baton) {
     return _waitForResponse(msgId, baton)
@@ -36,8 +36,10 @@
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/unique_message.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/transport_layer.h"
@@ -66,6 +68,40 @@ public:
                                         const BatonHandle& baton = nullptr,
                                         bool fireAndForget = false);
 
+    /**
+     * Runs a command on a connection that other commands may be multiplexed onto at the same time.
+     * Requests submitted while an earlier write is in progress are sent together in the next
+     * write, and each reply is matched to its request by its responseTo id. The server executes
+     * the requests on a connection one at a time, so a slow command delays the execution of the
+     * ones queued behind it, not just their replies.
+     *
+     * Fire-and-forget and exhaust requests cannot be multiplexed.
+     */
+    Future<executor::RemoteCommandResponse> runMultiplexedCommandRequest(
+        executor::RemoteCommandRequest request, int32_t msgId);
+
+    /**
+     * Fails the multiplexed request with the given id without waiting for its reply. Requests
+     * already submitted keep running, but since the reply is still on its way, the connection
+     * reports an error from getMultiplexingStatus() from then on.
+     */
+    void cancelMultiplexedCommand(int32_t msgId, Status reason);
+
+    /**
+     * Returns OK if requests can be multiplexed onto this connection, or the reason they can't.
+     * Once this returns an error, the connection should not be reused after the requests already
+     * multiplexed onto it have finished.
+     */
+    Status getMultiplexingStatus();
+
+    /**
+     * Uses 'protocol' for the commands run on this client, in place of the one initWireVersion()
+     * negotiates.
+     */
+    void setNegotiatedProtocolForTest(rpc::Protocol protocol) {
+        _negotiatedProtocol = protocol;
+    }
+
     Future<executor::RemoteCommandResponse> beginExhaustCommandRequest(
         executor::RemoteCommandRequest request, const BatonHandle& baton = nullptr);
     Future<executor::RemoteCommandResponse> runExhaustCommand(OpMsgRequest request,
@@ -101,6 +137,10 @@ private:
     Future<Message> _waitForResponse(boost::optional<int32_t> msgId,
                                      const BatonHandle& baton = nullptr);
     Future<void> _call(Message request, int32_t msgId, const BatonHandle& baton = nullptr);
+    StatusWith<Message> _prepareRequest(Message request, int32_t msgId);
+    void _writeMultiplexed();
+    void _readMultiplexed();
+    void _failMultiplexed(Status status);
     BSONObj _buildIsMasterRequest(const std::string& appName,
                                   executor::NetworkConnectionHook* hook);
     void _parseIsMasterResponse(BSONObj request,
@@ -112,6 +152,15 @@ private:
     ServiceContext* const _svcCtx;
     MessageCompressorManager _compressorManager;
     boost::optional<rpc::Protocol> _negotiatedProtocol;
+
+    // State of the requests multiplexed onto this connection
+    Mutex _multiplexMutex = MONGO_MAKE_LATCH("AsyncDBClient::_multiplexMutex");
+    Status _multiplexStatus = Status::OK();
+    bool _multiplexCanceled = false;
+    std::vector<Message> _multiplexWriteQueue;
+    stdx::unordered_map<int32_t, Promise<Message>> _multiplexPending;
+    bool _multiplexWriting = false;
+    bool _multiplexReading = false;
 };
 
 }  // namespace mongo
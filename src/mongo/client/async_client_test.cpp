@@ -0,0 +1,244 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/async_client.h"
+
+#include <deque>
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/mock_session.h"
+#include "mongo/transport/transport_layer_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A session whose reads and writes only complete when the test says so, and which keeps the
+ * messages written to it.
+ */
+class MultiplexingMockSession : public transport::MockSession {
+public:
+    explicit MultiplexingMockSession(transport::TransportLayer* tl) : MockSession(tl) {}
+
+    Future<Message> asyncSourceMessage(const BatonHandle& handle = nullptr) override {
+        auto pf = makePromiseFuture<Message>();
+        _reads.push_back(std::move(pf.promise));
+        return std::move(pf.future);
+    }
+
+    Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                   const BatonHandle& handle = nullptr) override {
+        auto pf = makePromiseFuture<void>();
+        _writes.push_back({std::move(messages), std::move(pf.promise)});
+        return std::move(pf.future);
+    }
+
+    /**
+     * Completes the oldest write in progress and returns the ids of the messages it sent.
+     */
+    std::vector<int32_t> completeWrite(Status status = Status::OK()) {
+        ASSERT_FALSE(_writes.empty());
+        auto write = std::move(_writes.front());
+        _writes.pop_front();
+
+        std::vector<int32_t> msgIds;
+        for (const auto& message : write.messages) {
+            msgIds.push_back(message.header().getId());
+        }
+        if (status.isOK()) {
+            write.promise.emplaceValue();
+        } else {
+            write.promise.setError(std::move(status));
+        }
+        return msgIds;
+    }
+
+    /**
+     * Completes the read in progress with a reply to the message with id 'responseTo', or with
+     * 'status' if it is an error.
+     */
+    void completeRead(int32_t responseTo, Status status = Status::OK()) {
+        ASSERT_FALSE(_reads.empty());
+        auto read = std::move(_reads.front());
+        _reads.pop_front();
+
+        if (!status.isOK()) {
+            read.setError(std::move(status));
+            return;
+        }
+
+        auto reply = OpMsg{BSON("ok" << 1 << "responseTo" << responseTo)}.serialize();
+        reply.header().setId(nextMessageId());
+        reply.header().setResponseToMsgId(responseTo);
+        read.emplaceValue(std::move(reply));
+    }
+
+    size_t numWritesInProgress() const {
+        return _writes.size();
+    }
+
+    size_t numReadsInProgress() const {
+        return _reads.size();
+    }
+
+    /**
+     * Fails every read and write still in progress.
+     */
+    void close() {
+        while (!_writes.empty()) {
+            completeWrite({ErrorCodes::SocketException, "Session closed"});
+        }
+        while (!_reads.empty()) {
+            completeRead(0, {ErrorCodes::SocketException, "Session closed"});
+        }
+    }
+
+private:
+    struct Write {
+        std::vector<Message> messages;
+        Promise<void> promise;
+    };
+
+    std::deque<Write> _writes;
+    std::deque<Promise<Message>> _reads;
+};
+
+class AsyncDBClientMultiplexingTest : public ServiceContextTest {
+public:
+    void setUp() override {
+        _session = std::make_shared<MultiplexingMockSession>(&_tl);
+        _client = std::make_shared<AsyncDBClient>(_host, _session, getServiceContext());
+        _client->setNegotiatedProtocolForTest(rpc::Protocol::kOpMsg);
+    }
+
+    void tearDown() override {
+        _session->close();
+        _client.reset();
+        _session.reset();
+    }
+
+    Future<executor::RemoteCommandResponse> runCommand(int32_t msgId) {
+        executor::RemoteCommandRequest request(_host, "admin", BSON("ping" << 1), nullptr);
+        return _client->runMultiplexedCommandRequest(std::move(request), msgId);
+    }
+
+    /**
+     * Sends the commands with the given ids on the client and completes the writes for them.
+     */
+    std::vector<Future<executor::RemoteCommandResponse>> sendCommands(
+        const std::vector<int32_t>& msgIds) {
+        std::vector<Future<executor::RemoteCommandResponse>> futures;
+        for (auto msgId : msgIds) {
+            futures.push_back(runCommand(msgId));
+        }
+
+        // The first request goes out on its own, and the others queued behind it together.
+        ASSERT(std::vector<int32_t>{msgIds.front()} == _session->completeWrite());
+        ASSERT(std::vector<int32_t>(msgIds.begin() + 1, msgIds.end()) == _session->completeWrite());
+        ASSERT_EQ(0U, _session->numWritesInProgress());
+        return futures;
+    }
+
+protected:
+    const HostAndPort _host{"localhost", 27017};
+    transport::TransportLayerMock _tl;
+    std::shared_ptr<MultiplexingMockSession> _session;
+    std::shared_ptr<AsyncDBClient> _client;
+};
+
+TEST_F(AsyncDBClientMultiplexingTest, RepliesAreMatchedToTheirRequests) {
+    auto futures = sendCommands({1, 2, 3});
+
+    _session->completeRead(3);
+    _session->completeRead(1);
+    _session->completeRead(2);
+
+    for (int32_t i = 0; i < 3; ++i) {
+        auto response = futures[i].get();
+        ASSERT_OK(response.status);
+        ASSERT_EQ(i + 1, response.data["responseTo"].numberInt());
+    }
+    ASSERT_OK(_client->getMultiplexingStatus());
+    ASSERT_EQ(0U, _session->numReadsInProgress());
+}
+
+TEST_F(AsyncDBClientMultiplexingTest, CancelFailsOnlyThatRequest) {
+    auto futures = sendCommands({1, 2});
+
+    _client->cancelMultiplexedCommand(1, {ErrorCodes::CallbackCanceled, "Canceled for test"});
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, futures[0].getNoThrow().getStatus());
+    ASSERT_FALSE(futures[1].isReady());
+
+    // The reply to the canceled request may still arrive, so no request may join the connection
+    ASSERT_EQ(ErrorCodes::CallbackCanceled, _client->getMultiplexingStatus());
+
+    // That reply is dropped, and the other request still gets its own.
+    _session->completeRead(1);
+    ASSERT_FALSE(futures[1].isReady());
+    _session->completeRead(2);
+    auto response = futures[1].get();
+    ASSERT_OK(response.status);
+    ASSERT_EQ(2, response.data["responseTo"].numberInt());
+}
+
+TEST_F(AsyncDBClientMultiplexingTest, ReadFailureFailsEveryRequest) {
+    auto futures = sendCommands({1, 2, 3});
+
+    _session->completeRead(2);
+    ASSERT_OK(futures[1].getNoThrow().getStatus());
+
+    _session->completeRead(0, {ErrorCodes::HostUnreachable, "Read failed for test"});
+    ASSERT_EQ(ErrorCodes::HostUnreachable, futures[0].getNoThrow().getStatus());
+    ASSERT_EQ(ErrorCodes::HostUnreachable, futures[2].getNoThrow().getStatus());
+
+    ASSERT_EQ(ErrorCodes::HostUnreachable, _client->getMultiplexingStatus());
+    ASSERT_EQ(ErrorCodes::HostUnreachable, runCommand(4).getNoThrow().getStatus());
+    ASSERT_EQ(0U, _session->numWritesInProgress());
+}
+
+TEST_F(AsyncDBClientMultiplexingTest, WriteFailureFailsEveryRequest) {
+    auto first = runCommand(1);
+    auto second = runCommand(2);
+
+    // The second request is still queued behind the first write and is never sent.
+    _session->completeWrite({ErrorCodes::SocketException, "Write failed for test"});
+    ASSERT_EQ(ErrorCodes::SocketException, first.getNoThrow().getStatus());
+    ASSERT_EQ(ErrorCodes::SocketException, second.getNoThrow().getStatus());
+    ASSERT_EQ(0U, _session->numWritesInProgress());
+
+    ASSERT_EQ(ErrorCodes::SocketException, _client->getMultiplexingStatus());
+    ASSERT_EQ(ErrorCodes::SocketException, runCommand(3).getNoThrow().getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
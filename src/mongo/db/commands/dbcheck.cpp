@@ -54,6 +54,7 @@ namespace mongo {
 namespace {
 constexpr uint64_t kBatchDocs = 5'000;
 constexpr uint64_t kBatchBytes = 20'000'000;
+constexpr int64_t kMerkleLeafDocs = 100;
 
 
 /**
@@ -66,6 +67,7 @@ struct DbCheckCollectionInfo {
     int64_t maxCount;
     int64_t maxSize;
     int64_t maxRate;
+    bool merkle;
 };
 
 /**
@@ -116,7 +118,8 @@ std::unique_ptr<DbCheckRun> singleCollectionRun(OperationContext* opCtx,
     auto maxCount = invocation.getMaxCount();
     auto maxSize = invocation.getMaxSize();
     auto maxRate = invocation.getMaxCountPerSecond();
-    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxRate};
+    auto merkle = invocation.getMerkle();
+    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxRate, merkle};
     auto result = std::make_unique<DbCheckRun>();
     result->push_back(info);
     return result;
@@ -137,6 +140,7 @@ std::unique_ptr<DbCheckRun> fullDatabaseRun(OperationContext* opCtx,
 
     int64_t max = std::numeric_limits<int64_t>::max();
     auto rate = invocation.getMaxCountPerSecond();
+    auto merkle = invocation.getMerkle();
 
     for (auto collIt = db->begin(opCtx); collIt != db->end(opCtx); ++collIt) {
         auto coll = *collIt;
@@ -144,7 +148,8 @@ std::unique_ptr<DbCheckRun> fullDatabaseRun(OperationContext* opCtx,
             break;
         }
 
-        DbCheckCollectionInfo info{coll->ns(), BSONKey::min(), BSONKey::max(), max, max, rate};
+        DbCheckCollectionInfo info{
+            coll->ns(), BSONKey::min(), BSONKey::max(), max, max, rate, merkle};
         result->push_back(info);
     }
 
@@ -411,6 +416,10 @@ private:
             return e.toStatus();
         }
 
+        if (info.merkle) {
+            hasher->splitLeavesEvery(kMerkleLeafDocs);
+        }
+
         Status status = hasher->hashAll();
 
         if (!status.isOK()) {
@@ -424,6 +433,9 @@ private:
         batch.setMd5(md5);
         batch.setMinKey(first);
         batch.setMaxKey(BSONKey(hasher->lastKey()));
+        if (info.merkle) {
+            batch.setMerkleLeaves(hasher->leaves());
+        }
 
         BatchStats result;
 
@@ -509,7 +521,8 @@ public:
                "              maxKey: <last key, inclusive>,\n"
                "              maxCount: <max number of docs>,\n"
                "              maxSize: <max size of docs>,\n"
-               "              maxCountPerSecond: <max rate in docs/sec> } "
+               "              maxCountPerSecond: <max rate in docs/sec>,\n"
+               "              merkle: <also hash batches as Merkle trees> } "
                "to check a collection.\n"
                "Invoke with {dbCheck: 1} to check all collections in the database.";
     }
@@ -228,6 +228,16 @@ void setUpOperationContextStateForGetMore(OperationContext* opCtx,
     if (!opCtx->getComment() && comment) {
         opCtx->setComment(comment.wrap());
     }
+
+    // Cursors opened at low priority keep running at low priority, including for the locks and
+    // tickets they reacquire after yielding during this batch.
+    auto priority = cursor.getOriginatingCommandObj()["priority"];
+    if (priority) {
+        auto swPriority = Locker::parsePriority(priority);
+        if (swPriority.isOK() && swPriority.getValue() == Locker::Priority::kLow) {
+            opCtx->lockState()->setPriority(Locker::Priority::kLow);
+        }
+    }
 }
 
 /**
@@ -287,7 +297,9 @@ public:
          *
          * Returns true if the cursor should be saved for subsequent getMores, and false otherwise.
          * Fills out *numResults with the number of documents in the batch, which must be
-         * initialized to zero by the caller.
+         * initialized to zero by the caller. For exhaust getMores, sets *nextBatchReady to whether
+         * the next getMore already has a result buffered, and ends the batch early once the
+         * responses the exhaust stream is holding back are due to be sent.
          *
          * Throws an exception on failure.
          */
@@ -296,21 +308,34 @@ public:
                            const GetMoreRequest& request,
                            const bool isTailable,
                            CursorResponseBuilder* nextBatch,
-                           std::uint64_t* numResults) {
+                           std::uint64_t* numResults,
+                           bool* nextBatchReady) {
             PlanExecutor* exec = cursor->getExecutor();
 
             // If an awaitData getMore is killed during this process due to our max time expiring at
             // an interrupt point, we just continue as normal and return rather than reporting a
             // timeout to the user.
             BSONObj obj;
-            PlanExecutor::ExecState state;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+
+            // The exhaust responses held back to be sent along with this one wait for this batch,
+            // so return it as soon as it has results once they are due.
+            const auto exhaustResponsesDeadline = opCtx->getExhaustResponsesDeadline();
+            auto clock = opCtx->getServiceContext()->getPreciseClockSource();
+            auto exhaustResponsesDue = [&] {
+                return *numResults > 0 && exhaustResponsesDeadline != Date_t::max() &&
+                    clock->now() >= exhaustResponsesDeadline;
+            };
+
             try {
                 while (!FindCommon::enoughForGetMore(request.batchSize.value_or(0), *numResults) &&
+                       !exhaustResponsesDue() &&
                        PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
                     // If adding this object will cause us to exceed the message size limit, then we
                     // stash it for later.
                     if (!FindCommon::haveSpaceForNext(obj, *numResults, nextBatch->bytesUsed())) {
                         exec->enqueue(obj);
+                        *nextBatchReady = true;
                         break;
                     }
 
@@ -322,6 +347,18 @@ public:
                     nextBatch->append(obj);
                     (*numResults)++;
                 }
+
+                // If this exhaust batch ended before reaching the end of the cursor, peek at the
+                // next result so the exhaust stream only holds this response back when the next
+                // one has a result to start from, rather than having to wait for a tailable
+                // cursor's new data or scan for a long time first. Having returned results, this
+                // operation no longer waits, so this never blocks.
+                if (opCtx->isExhaust() && !*nextBatchReady && *numResults > 0 &&
+                    state == PlanExecutor::ADVANCED &&
+                    PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+                    exec->enqueue(obj);
+                    *nextBatchReady = true;
+                }
             } catch (const ExceptionFor<ErrorCodes::CloseChangeStream>&) {
                 // This exception indicates that we should close the cursor without reporting an
                 // error.
@@ -548,6 +585,7 @@ public:
             CursorResponseBuilder nextBatch(reply, options);
             BSONObj obj;
             std::uint64_t numResults = 0;
+            bool nextBatchReady = false;
 
             // We report keysExamined and docsExamined to OpDebug for a given getMore operation. To
             // obtain these values we need to take a diff of the pre-execution and post-execution
@@ -597,7 +635,8 @@ public:
                                                         _request,
                                                         cursorPin->isTailable(),
                                                         &nextBatch,
-                                                        &numResults);
+                                                        &numResults,
+                                                        &nextBatchReady);
 
             PlanSummaryStats postExecutionStats;
             Explain::getSummaryStats(*exec, &postExecutionStats);
@@ -650,6 +689,7 @@ public:
                     // Indicate that an exhaust message should be generated and the previous BSONObj
                     // command parameters should be reused as the next BSONObj command parameters.
                     reply->setNextInvocation(boost::none);
+                    reply->setNextExhaustResponseReady(nextBatchReady);
                 }
             }
         }
@@ -32,7 +32,12 @@
 #include <benchmark/benchmark.h>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/command_generic_argument.h"
+#include "mongo/db/ops/insert.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/rpc/op_msg.h"
 
 namespace mongo {
 namespace {
@@ -70,9 +75,70 @@ void BM_IsReplyStripArgument(benchmark::State& state) {
     }
 }
 
+/**
+ * Builds an OP_MSG insert request carrying 'numDocs' documents of roughly 'docSize' bytes each in
+ * a "documents" sequence. Documents only get an _id when 'withId' is set, so that the server has to
+ * generate one otherwise.
+ */
+Message makeInsertMessage(int numDocs, int docSize, bool withId) {
+    const std::string filler(docSize, 'x');
+    OpMsgBuilder builder;
+    {
+        auto docs = builder.beginDocSequence("documents");
+        for (int i = 0; i < numDocs; ++i) {
+            BSONObjBuilder doc;
+            if (withId) {
+                doc.append("_id", i);
+            }
+            doc.append("filler", filler);
+            docs.append(doc.done());
+        }
+    }
+    builder.setBody(BSON("insert"
+                         << "coll"
+                         << "$db"
+                         << "test"));
+    return builder.finish();
+}
+
+/**
+ * Runs an insert request through the command layer, from parsing the OP_MSG to preparing the batch
+ * of InsertStatements that is handed to the storage layer, the same way performInserts() does.
+ */
+void BM_InsertCommandPath(benchmark::State& state) {
+    const int numDocs = state.range(0);
+    const bool withId = state.range(1);
+    const int kDocSize = 1024;
+    const auto message = makeInsertMessage(numDocs, kDocSize, withId);
+    auto service = getGlobalServiceContext();
+    state.SetLabel(withId ? "with _id" : "without _id");
+
+    for (auto _ : state) {
+        const auto op = InsertOp::parse(OpMsgRequest::parseOwned(message));
+        std::vector<InsertStatement> batch;
+        batch.reserve(op.getDocuments().size());
+        for (auto&& doc : op.getDocuments()) {
+            auto fixedDoc = fixDocumentForInsert(service, doc);
+            BSONObj toInsert =
+                fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
+            batch.emplace_back(std::move(toInsert));
+        }
+        benchmark::DoNotOptimize(batch.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numDocs);
+    state.SetBytesProcessed(state.iterations() * message.size());
+}
+
 BENCHMARK(BM_IsGeneric)->DenseRange(0, keys.size() - 1);
 BENCHMARK(BM_IsRequestStripArgument)->DenseRange(0, keys.size() - 1);
 BENCHMARK(BM_IsReplyStripArgument)->DenseRange(0, keys.size() - 1);
+BENCHMARK(BM_InsertCommandPath)
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({64, 0})
+    ->Args({64, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1});
 
 }  // namespace
 }  // namespace mongo
@@ -128,6 +128,45 @@ BENCHMARK_DEFINE_F(DConcurrencyTest, BM_CollectionIntentExclusiveLock)(benchmark
     }
 }
 
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_CollectionIntentExclusiveLockPerThreadCollection)
+(benchmark::State& state) {
+    std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
+
+    if (state.thread_index == 0) {
+        makeKClientsWithLockers(state.threads);
+        supportDocLocking = std::make_unique<ForceSupportsDocLocking>(true);
+    }
+
+    // Only the global and database locks are shared between the threads
+    const NamespaceString nss("test", str::stream() << "coll" << state.thread_index);
+
+    for (auto keepRunning : state) {
+        Lock::DBLock dlk(clients[state.thread_index].second.get(), "test", MODE_IX);
+        Lock::CollectionLock clk(clients[state.thread_index].second.get(), nss, MODE_IX);
+    }
+
+    if (state.thread_index == 0) {
+        clients.clear();
+    }
+}
+
+BENCHMARK_DEFINE_F(DConcurrencyTest, BM_NewLockerCollectionIntentSharedLock)
+(benchmark::State& state) {
+    const ResourceId resIdDb(RESOURCE_DATABASE, StringData("test"));
+    const ResourceId resIdColl(RESOURCE_COLLECTION, StringData("test.coll"));
+
+    // Every operation gets a new locker, so this includes the cost of setting up its requests
+    for (auto keepRunning : state) {
+        LockerImpl lockerForOp;
+        lockerForOp.lockGlobal(nullptr, MODE_IS);
+        lockerForOp.lock(resIdDb, MODE_IS);
+        lockerForOp.lock(resIdColl, MODE_IS);
+        lockerForOp.unlock(resIdColl);
+        lockerForOp.unlock(resIdDb);
+        lockerForOp.unlockGlobal();
+    }
+}
+
 BENCHMARK_DEFINE_F(DConcurrencyTest, BM_MMAPv1CollectionSharedLock)(benchmark::State& state) {
     std::unique_ptr<ForceSupportsDocLocking> supportDocLocking;
 
@@ -176,6 +215,11 @@ BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentSharedLock)
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentExclusiveLock)
     ->ThreadRange(1, kMaxPerfThreads);
 
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_CollectionIntentExclusiveLockPerThreadCollection)
+    ->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK_REGISTER_F(DConcurrencyTest, BM_NewLockerCollectionIntentSharedLock)
+    ->ThreadRange(1, kMaxPerfThreads);
+
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_MMAPv1CollectionSharedLock)
     ->ThreadRange(1, kMaxPerfThreads);
 BENCHMARK_REGISTER_F(DConcurrencyTest, BM_MMAPv1CollectionExclusiveLock)
@@ -203,6 +203,13 @@ public:
 
     FastMapNoAlloc() : _fastAccessUsedSize(0) {}
 
+    /**
+     * Creates a map with 'preallocCount' unused entries already in place, so that the first
+     * 'preallocCount' insertions do not need to allocate any memory.
+     */
+    explicit FastMapNoAlloc(size_type preallocCount)
+        : _fastAccess(preallocCount), _fastAccessUsedSize(0) {}
+
     /**
      * Inserts the specified entry in the map and returns a reference to the memory for the
      * entry just inserted.
@@ -29,6 +29,7 @@
 
 #include <boost/lexical_cast.hpp>
 #include <string>
+#include <vector>
 
 #include "mongo/db/concurrency/fast_map_noalloc.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
@@ -85,6 +86,26 @@ TEST(FastMapNoAlloc, NotEmpty) {
     ASSERT(!it);
 }
 
+TEST(FastMapNoAlloc, Preallocated) {
+    TestFastMapNoAlloc map(4);
+    ASSERT(map.empty());
+    ASSERT(map.begin().finished());
+
+    // Entries handed out from the preallocated slots must stay valid as the map grows past them
+    std::vector<TestStruct*> entries;
+    for (int i = 0; i < 6; i++) {
+        auto it = map.insert(ResourceId(RESOURCE_COLLECTION, i));
+        it->initNew(i, "Item" + boost::lexical_cast<std::string>(i));
+        entries.push_back(it.objAddr());
+    }
+
+    ASSERT_EQUALS(6U, map.size());
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQUALS(entries[i], map.find(ResourceId(RESOURCE_COLLECTION, i)).objAddr());
+        ASSERT_EQUALS(i, entries[i]->id);
+    }
+}
+
 TEST(FastMapNoAlloc, FindNonExisting) {
     TestFastMapNoAlloc map;
 
@@ -36,6 +36,10 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -45,6 +49,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 #include "mongo/util/timer.h"
@@ -90,6 +95,10 @@ static const int LockConflictsTable[] = {
 // Mask of modes
 const uint64_t intentModes = (1 << MODE_IS) | (1 << MODE_IX);
 
+// How many normal priority requests may go ahead of waiting low priority ones on a lock, before
+// they have to queue behind them again.
+const uint32_t kMaxLowPriorityOvertakes = 128;
+
 // Ensure we do not add new modes without updating the conflicts table
 MONGO_STATIC_ASSERT((sizeof(LockConflictsTable) / sizeof(LockConflictsTable[0])) == LockModesCount);
 
@@ -159,6 +168,9 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        lowPriorityConflictsCount = 0;
+        lowPriorityOvertakes = 0;
     }
 
     /**
@@ -203,23 +215,41 @@ struct LockHead {
         // request was initially partitioned.
 
         // New lock request. Queue after all granted modes and after any already requested
-        // conflicting modes
+        // conflicting modes, unless those only belong to low priority requests it may overtake.
         if (conflicts(request->mode, grantedModes) ||
-            (!compatibleFirstCount && conflicts(request->mode, conflictModes))) {
+            (!compatibleFirstCount && conflicts(request->mode, conflictModes) &&
+             !(mayOvertakeLowPriority(request) && onlyLowPriorityConflicts()))) {
             request->status = LockRequest::STATUS_WAITING;
 
             // Put it on the conflict queue. Conflicts are granted front to back.
             if (request->enqueueAtFront) {
                 conflictList.push_front(request);
+            } else if (mayOvertakeLowPriority(request) && conflictList._back &&
+                       conflictList._back->lowPriority) {
+                // Queue in front of the low priority requests at the end of the queue
+                LockRequest* next = conflictList._back;
+                while (next->prev && next->prev->lowPriority) {
+                    next = next->prev;
+                }
+                conflictList.insert_before(request, next);
+                lowPriorityOvertakes++;
             } else {
                 conflictList.push_back(request);
             }
 
             incConflictModeCount(request->mode);
+            if (request->lowPriority) {
+                lowPriorityConflictsCount++;
+            }
 
             return LOCK_WAITING;
         }
 
+        if (!compatibleFirstCount && conflicts(request->mode, conflictModes)) {
+            // Granted ahead of the low priority requests it conflicts with
+            lowPriorityOvertakes++;
+        }
+
         // No conflict, new request
         request->status = LockRequest::STATUS_GRANTED;
 
@@ -256,6 +286,42 @@ struct LockHead {
         }
     }
 
+    /**
+     * Whether 'request' may go ahead of low priority requests waiting on the conflict queue. Only
+     * normal priority requests may, and only kMaxLowPriorityOvertakes times between grants of low
+     * priority requests, so that a steady stream of normal priority requests cannot starve them.
+     */
+    bool mayOvertakeLowPriority(const LockRequest* request) const {
+        return !request->lowPriority && lowPriorityConflictsCount &&
+            lowPriorityOvertakes < kMaxLowPriorityOvertakes;
+    }
+
+    /**
+     * True iff every request on the conflict queue is low priority.
+     */
+    bool onlyLowPriorityConflicts() const {
+        uint32_t conflictsCount = 0;
+        for (uint32_t mode = 0; mode < LockModesCount; mode++) {
+            conflictsCount += conflictCounts[mode];
+        }
+        return conflictsCount == lowPriorityConflictsCount;
+    }
+
+    /**
+     * Removes 'request' from the conflict queue and maintains the counts which track it.
+     */
+    void removeConflict(LockRequest* request) {
+        conflictList.remove(request);
+        decConflictModeCount(request->mode);
+        if (request->lowPriority) {
+            invariant(lowPriorityConflictsCount > 0);
+            lowPriorityConflictsCount--;
+        }
+        if (!lowPriorityConflictsCount) {
+            lowPriorityOvertakes = 0;
+        }
+    }
+
     // Methods to maintain the conflict queue
     void incConflictModeCount(LockMode mode) {
         invariant(conflictCounts[mode] >= 0);
@@ -331,6 +397,17 @@ struct LockHead {
     // be switched to compatible-first. As long as this value is > 0, the policy will stay
     // compatible-first.
     uint32_t compatibleFirstCount;
+
+    //
+    // Priority
+    //
+
+    // Counts the low priority requests on the conflict queue.
+    uint32_t lowPriorityConflictsCount;
+
+    // Counts the normal priority requests granted or queued ahead of low priority ones since a
+    // low priority request was last granted.
+    uint32_t lowPriorityOvertakes;
 };
 
 /**
@@ -413,9 +490,25 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
+namespace {
+
 // Balance scalability of intent locks against potential added cost of conflicting locks.
 // The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+const unsigned kMinNumPartitions = 32;
+
+/**
+ * Intent requests use the partition of the CPU they are made on, so there should be at least one
+ * partition per CPU in order for no two CPUs to share one.
+ */
+unsigned computeNumPartitions() {
+    unsigned numPartitions = kMinNumPartitions;
+    while (numPartitions < stdx::thread::hardware_concurrency()) {
+        numPartitions *= 2;
+    }
+    return numPartitions;
+}
+
+}  // namespace
 
 // static
 std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serviceContext) {
@@ -443,7 +536,7 @@ std::map<LockerId, BSONObj> LockManager::getLockToClientMap(ServiceContext* serv
     return lockToClientMap;
 }
 
-LockManager::LockManager() {
+LockManager::LockManager() : _numPartitions(computeNumPartitions()) {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
 }
@@ -469,6 +562,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        request->partitionIndex = _choosePartition(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
         invariant(request->status == LockRequest::STATUS_NEW);
@@ -639,8 +733,7 @@ bool LockManager::unlock(LockRequest* request) {
         // This cancels a pending lock request
         invariant(request->recursiveCount == 0);
 
-        lock->conflictList.remove(request);
-        lock->decConflictModeCount(request->mode);
+        lock->removeConflict(request);
 
         _onLockModeChanged(lock, true);
     } else if (request->status == LockRequest::STATUS_CONVERTING) {
@@ -809,8 +902,10 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
         iter->status = LockRequest::STATUS_GRANTED;
 
         // Remove from the conflicts list
-        lock->conflictList.remove(iter);
-        lock->decConflictModeCount(iter->mode);
+        lock->removeConflict(iter);
+        if (iter->lowPriority) {
+            lock->lowPriorityOvertakes = 0;
+        }
 
         // Add to the granted list
         lock->grantedList.push_back(iter);
@@ -840,7 +935,20 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
 }
 
 LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+    return &_partitions[request->partitionIndex];
+}
+
+unsigned LockManager::_choosePartition(LockRequest* request) const {
+#if defined(__linux__)
+    // Threads running on the same CPU cannot race on a partition unless they are preempted in the
+    // middle of the short critical section, so the partition's mutex is effectively uncontended
+    // and its cache lines do not have to move between CPUs.
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return static_cast<unsigned>(cpu) % _numPartitions;
+    }
+#endif
+    return request->locker->getId() % _numPartitions;
 }
 
 void LockManager::dump() const {
@@ -895,6 +1003,7 @@ void LockManager::_buildLocksArray(const std::map<LockerId, BSONObj>& lockToClie
                     req.append("convertMode", modeName(iter->convertMode));
                     req.append("enqueueAtFront", iter->enqueueAtFront);
                     req.append("compatibleFirst", iter->compatibleFirst);
+                    req.append("lowPriority", iter->lowPriority);
                     req.append("debugInfo", iter->locker->getDebugInfo());
                     if (auto it = lockToClientMap.find(iter->locker->getId());
                         it != lockToClientMap.end()) {
@@ -973,10 +1082,12 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     enqueueAtFront = false;
     compatibleFirst = false;
+    lowPriority = false;
     recursiveCount = 1;
 
     lock = nullptr;
     partitionedLock = nullptr;
+    partitionIndex = 0;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
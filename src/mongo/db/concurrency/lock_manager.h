@@ -42,6 +42,7 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/new.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -164,10 +165,11 @@ private:
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
+    // Each CPU maps to a partition that is used for resources acquired in intent modes
     // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
-    struct Partition {
+    // contention on the regular LockHead in the lock manager. Partitions are cache line aligned,
+    // so that CPUs working on neighbouring partitions do not invalidate each other's caches.
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
         typedef stdx::unordered_map<ResourceId, PartitionedLockHead*> Map;
@@ -183,10 +185,18 @@ private:
 
 
     /**
-     * Retrieves the Partition that a particular LockRequest should use for intent locking.
+     * Retrieves the Partition on which a particular LockRequest was acquired in an intent mode.
+     * Only valid after _choosePartition has been called for the request.
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Returns the index of the Partition that a new intent LockRequest should use. This is the
+     * partition of the CPU the calling thread runs on, or the one of its locker where the current
+     * CPU cannot be determined.
+     */
+    unsigned _choosePartition(LockRequest* request) const;
+
     /**
      * The backend of `dump` and `getLockInfoBSON`.
      * If `mutableThis`, then we also clean the unused locks in the buckets while iterating.
@@ -219,7 +229,7 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
+    const unsigned _numPartitions;
     Partition* _partitions;
 };
 }  // namespace mongo
@@ -389,6 +389,15 @@ struct LockRequest {
     // No synchronization
     bool compatibleFirst;
 
+    // Whether this request belongs to a low priority operation. Normal priority requests which
+    // conflict only with low priority ones waiting on the conflict queue are granted ahead of them,
+    // and otherwise queue in front of them, up to a bound that keeps them from starving.
+    //
+    // Written at construction time by Locker
+    // Read by LockManager on any thread
+    // No synchronization
+    bool lowPriority;
+
     // When set, an attempt is made to execute this request using partitioned lockheads. This speeds
     // up the common case where all requested locking modes are compatible with each other, at the
     // cost of extra overhead for conflicting modes.
@@ -426,6 +435,15 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Index of the LockManager partition on which this request was granted, if it is partitioned.
+    // Partitions are chosen by the CPU the request is made on, so it needs to be remembered for
+    // the unlock, which may happen after the thread has moved to a different CPU.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    unsigned partitionIndex;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
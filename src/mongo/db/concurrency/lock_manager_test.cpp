@@ -29,6 +29,7 @@
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -952,4 +953,157 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+TEST(LockManager, LowPriorityWaiterIsOvertakenByCompatibleRequests) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestS, MODE_S));
+
+    LockerImpl lockerLow;
+    LockRequestCombo requestLow(&lockerLow);
+    requestLow.lowPriority = true;
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestLow, MODE_X));
+
+    // A normal priority request compatible with the granted modes doesn't wait for the low
+    // priority request it conflicts with
+    LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    // But another low priority one does
+    LockerImpl lockerLowIS;
+    LockRequestCombo requestLowIS(&lockerLowIS);
+    requestLowIS.lowPriority = true;
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestLowIS, MODE_IS));
+
+    ASSERT(lockMgr.unlock(&requestS));
+    ASSERT_EQ(LOCK_INVALID, requestLow.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT_EQ(LOCK_OK, requestLow.lastResult);
+    ASSERT_EQ(LOCK_INVALID, requestLowIS.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestLow));
+    ASSERT_EQ(LOCK_OK, requestLowIS.lastResult);
+
+    // Unlock all locks so we don't assert for leaked locks
+    ASSERT(lockMgr.unlock(&requestLowIS));
+}
+
+TEST(LockManager, LowPriorityWaitersQueueBehindNormalPriorityOnes) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestX, MODE_X));
+
+    LockerImpl lockerLow;
+    LockRequestCombo requestLow(&lockerLow);
+    requestLow.lowPriority = true;
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestLow, MODE_X));
+
+    LockerImpl lockerNormal;
+    LockRequestCombo requestNormal(&lockerNormal);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestNormal, MODE_X));
+
+    // The normal priority request was queued in front of the low priority one
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(LOCK_OK, requestNormal.lastResult);
+    ASSERT_EQ(LOCK_INVALID, requestLow.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestNormal));
+    ASSERT_EQ(LOCK_OK, requestLow.lastResult);
+
+    // Unlock all locks so we don't assert for leaked locks
+    ASSERT(lockMgr.unlock(&requestLow));
+}
+
+TEST(LockManager, LowPriorityWaiterIsNotStarved) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestS, MODE_S));
+
+    LockerImpl lockerLow;
+    LockRequestCombo requestLow(&lockerLow);
+    requestLow.lowPriority = true;
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestLow, MODE_X));
+
+    // Normal priority requests only overtake the low priority one so many times, after which
+    // they queue behind it again
+    std::vector<std::unique_ptr<LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    LockResult result = LOCK_OK;
+    while (result == LOCK_OK) {
+        lockers.push_back(std::make_unique<LockerImpl>());
+        requests.push_back(std::make_unique<LockRequestCombo>(lockers.back().get()));
+        result = lockMgr.lock(resId, requests.back().get(), MODE_IS);
+    }
+    ASSERT_EQ(LOCK_WAITING, result);
+    ASSERT_GT(requests.size(), 1U);
+
+    ASSERT(lockMgr.unlock(&requestS));
+    for (size_t i = 0; i < requests.size() - 1; i++) {
+        ASSERT(lockMgr.unlock(requests[i].get()));
+    }
+    ASSERT_EQ(LOCK_OK, requestLow.lastResult);
+    ASSERT_EQ(LOCK_INVALID, requests.back()->lastResult);
+
+    ASSERT(lockMgr.unlock(&requestLow));
+    ASSERT_EQ(LOCK_OK, requests.back()->lastResult);
+
+    // Unlock all locks so we don't assert for leaked locks
+    ASSERT(lockMgr.unlock(requests.back().get()));
+}
+
+TEST(LockManager, IntentLocksFromManyThreadsMigrateOnConflict) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    // Intent requests go to the partition of the CPU they are made on, so acquiring them from
+    // different threads spreads them over several partitions, none of which need to be the one
+    // of the thread releasing them.
+    const int kNumThreads = 8;
+    std::vector<std::unique_ptr<LockerImpl>> lockers;
+    std::vector<std::unique_ptr<LockRequestCombo>> requests;
+    for (int i = 0; i < kNumThreads; i++) {
+        lockers.push_back(std::make_unique<LockerImpl>());
+        requests.push_back(std::make_unique<LockRequestCombo>(lockers.back().get()));
+    }
+
+    std::vector<LockResult> results(kNumThreads, LOCK_INVALID);
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; i++) {
+        threads.emplace_back([&, i] {
+            results[i] = lockMgr.lock(resId, requests[i].get(), i % 2 ? MODE_IX : MODE_IS);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < kNumThreads; i++) {
+        ASSERT_EQ(LOCK_OK, results[i]);
+    }
+
+    // A conflicting request moves all intent requests to the regular lock head and waits for them
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    for (int i = 0; i < kNumThreads - 1; i++) {
+        ASSERT(lockMgr.unlock(requests[i].get()));
+        ASSERT_EQ(0, requestX.numNotifies);
+    }
+    ASSERT(lockMgr.unlock(requests.back().get()));
+    ASSERT_EQ(1, requestX.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestX));
+}
+
 }  // namespace mongo
@@ -76,6 +76,22 @@ public:
         }
     }
 
+    void insert_before(LockRequest* request, LockRequest* next) {
+        // Sanity check that we do not reuse entries without cleaning them up
+        invariant(request->next == nullptr);
+        invariant(request->prev == nullptr);
+
+        request->prev = next->prev;
+        request->next = next;
+
+        if (next->prev != nullptr) {
+            next->prev->next = request;
+        } else {
+            _front = request;
+        }
+        next->prev = request;
+    }
+
     void remove(LockRequest* request) {
         if (request->prev != nullptr) {
             request->prev->next = request->next;
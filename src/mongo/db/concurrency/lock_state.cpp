@@ -127,6 +127,9 @@ const Milliseconds MaxWaitTime = Milliseconds(500);
 // Dispenses unique LockerId identifiers
 AtomicWord<unsigned long long> idCounter(0);
 
+// Number of LockRequest slots each LockerImpl allocates up front
+const size_t kNumPreallocatedLockRequests = 8;
+
 // Tracks lock statistics across all Locker instances. Distributes stats across multiple buckets
 // indexed by LockerId in order to minimize concurrent access conflicts.
 PartitionedInstanceWideLockStats globalStats;
@@ -282,8 +285,29 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+StatusWith<Locker::Priority> Locker::parsePriority(const BSONElement& elem) {
+    if (elem.type() != String) {
+        return {ErrorCodes::TypeMismatch,
+                str::stream() << "'" << elem.fieldNameStringData() << "' must be a string"};
+    }
+    if (elem.valueStringData() == "low"_sd) {
+        return Priority::kLow;
+    }
+    if (elem.valueStringData() == "normal"_sd) {
+        return Priority::kNormal;
+    }
+    return {ErrorCodes::BadValue,
+            str::stream() << "'" << elem.fieldNameStringData()
+                          << "' must be \"low\" or \"normal\", got \"" << elem.valueStringData()
+                          << "\""};
+}
+
 LockerImpl::LockerImpl()
-    : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
+    : _id(idCounter.addAndFetch(1)),
+      _requests(kNumPreallocatedLockRequests),
+      _wuowNestingLevel(0),
+      _threadId(stdx::this_thread::get_id()) {}
 
 stdx::thread::id LockerImpl::getThreadId() const {
     return _threadId;
@@ -360,9 +384,10 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
             invariant(!opCtx->recoveryUnit()->isTimestamped());
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+        const auto priority = _hasYielded ? Priority::kLow : getPriority();
         if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+            holder->waitForTicket(interruptible, priority);
+        } else if (!holder->waitForTicketUntil(interruptible, deadline, priority)) {
             return false;
         }
         restoreStateOnErrorGuard.dismiss();
@@ -507,7 +532,7 @@ bool LockerImpl::releaseWriteUnitOfWorkAndUnlock(LockSnapshot* stateOut) {
 void LockerImpl::restoreWriteUnitOfWorkAndLock(OperationContext* opCtx,
                                                const LockSnapshot& stateToRestore) {
     if (stateToRestore.globalMode != MODE_NONE) {
-        restoreLockState(opCtx, stateToRestore);
+        _restoreLockState(opCtx, stateToRestore);
     }
 
     invariant(_numResourcesToUnlockAtEndUnitOfWork == 0);
@@ -779,6 +804,13 @@ bool LockerImpl::saveLockStateAndUnlock(Locker::LockSnapshot* stateOut) {
 }
 
 void LockerImpl::restoreLockState(OperationContext* opCtx, const Locker::LockSnapshot& state) {
+    // Only operations that run long enough to yield get here, transactions unstashing their locks
+    // go through restoreWriteUnitOfWorkAndLock() and keep their priority.
+    _hasYielded = true;
+    _restoreLockState(opCtx, state);
+}
+
+void LockerImpl::_restoreLockState(OperationContext* opCtx, const Locker::LockSnapshot& state) {
     // We shouldn't be restoring lock state from inside a WriteUnitOfWork.
     invariant(!inAWriteUnitOfWork());
     invariant(_modeForTicket == MODE_NONE);
@@ -820,6 +852,7 @@ LockResult LockerImpl::_lockBegin(OperationContext* opCtx, ResourceId resId, Loc
         scoped_spinlock scopedLock(_lock);
         LockRequestsMap::Iterator itNew = _requests.insert(resId);
         itNew->initNew(this, &_notify);
+        itNew->lowPriority = getPriority() == Priority::kLow;
 
         request = itNew.objAddr();
     } else {
@@ -315,6 +315,11 @@ private:
      */
     bool _acquireTicket(OperationContext* opCtx, LockMode mode, Date_t deadline);
 
+    /**
+     * Reacquires the locks in 'state', which were released by saveLockStateAndUnlock().
+     */
+    void _restoreLockState(OperationContext* opCtx, const LockSnapshot& state);
+
     void _setWaitingResource(ResourceId resId);
 
     // Used to disambiguate different lockers
@@ -329,6 +334,9 @@ private:
     // Note: this data structure must always guarantee the continued validity of pointers/references
     // to its contents (LockRequests). The LockManager maintains a LockRequestList of pointers to
     // the LockRequests managed by this data structure.
+    //
+    // It is created with enough LockRequest slots for the locks a typical operation holds (global,
+    // RSTL, database, collection and a few mutexes), so acquiring them does not allocate.
     LockRequestsMap _requests;
 
     // Reuse the notification object across requests so we don't have to create a new mutex
@@ -349,6 +357,12 @@ private:
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
+    // Whether this Locker has given up its locks to yield and reacquired them. Only long-running
+    // operations such as scans and index builds yield, so these wait for tickets at low priority
+    // whatever their priority class. The ticket holders only admit short operations ahead of them
+    // while wiredTigerAdaptiveConcurrency is on, and treat them as normal priority otherwise.
+    bool _hasYielded = false;
+
     // Track the thread who owns the lock for debugging purposes
     stdx::thread::id _threadId;
 
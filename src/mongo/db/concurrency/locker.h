@@ -37,6 +37,7 @@
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/ticketholder.h"
 
 namespace mongo {
 
@@ -491,6 +492,30 @@ public:
         return _shouldAcquireTicket;
     }
 
+    /**
+     * The priority classes of operations. Low priority operations, such as background analytics,
+     * are handed tickets after normal priority ones, queue behind them for conflicting locks and
+     * yield more often, so that they get out of the way of the latency-sensitive workload.
+     */
+    using Priority = TicketHolder::Priority;
+
+    /**
+     * Sets the priority class of the operation this Locker belongs to. Only affects locks and
+     * tickets requested afterwards.
+     */
+    void setPriority(Priority priority) {
+        _priority = priority;
+    }
+
+    Priority getPriority() const {
+        return _priority;
+    }
+
+    /**
+     * Parses the value of the 'priority' generic command argument, "low" or "normal".
+     */
+    static StatusWith<Priority> parsePriority(const BSONElement& elem);
+
     /**
      * Acquire a flow control admission ticket into the system. Flow control is used as a
      * backpressure mechanism to limit replication majority point lag.
@@ -539,6 +564,7 @@ protected:
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    Priority _priority = Priority::kNormal;
     std::string _debugInfo;  // Extra info about this locker for debugging purpose
 };
 
@@ -451,6 +451,10 @@ struct DbResponse {
     // The next invocation for an exhaust command. If this is boost::none, the previous invocation
     // should be reused for the next invocation.
     boost::optional<BSONObj> nextInvocation;
+
+    // For exhaust commands, indicates that the next invocation will produce its response without
+    // waiting for new data, so this response may be held back and sent together with that one.
+    bool nextExhaustResponseReady = false;
 };
 
 /**
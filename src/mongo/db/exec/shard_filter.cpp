@@ -60,6 +60,10 @@ ShardFilterStage::ShardFilterStage(ExpressionContext* expCtx,
 
 ShardFilterStage::~ShardFilterStage() {}
 
+void ShardFilterStage::setChildIndexScanBounds(const IndexEntry& index, const IndexBounds& bounds) {
+    _childResultsBelongToMe = _shardFilterer.indexBoundsBelongToMe(index, bounds);
+}
+
 bool ShardFilterStage::isEOF() {
     return child()->isEOF();
 }
@@ -76,7 +80,7 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // If we're sharded make sure that we don't return data that is not owned by us,
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
-        if (_shardFilterer.isCollectionSharded()) {
+        if (_shardFilterer.isCollectionSharded() && !_childResultsBelongToMe) {
             WorkingSetMember* member = _ws->get(*out);
             ShardFilterer::DocumentBelongsResult res = _shardFilterer.documentBelongsToMe(*member);
             if (res != ShardFilterer::DocumentBelongsResult::kBelongs) {
@@ -88,11 +88,21 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Tells the stage that its child only returns documents found by a scan over 'bounds' of
+     * 'index'. If every document in those bounds is known to belong to this shard, the child's
+     * results are passed through without extracting and checking their shard keys one by one.
+     */
+    void setChildIndexScanBounds(const IndexEntry& index, const IndexBounds& bounds);
+
     static const char* kStageType;
 
 private:
     WorkingSet* _ws;
 
+    // Set if the child can only return documents which belong to this shard.
+    bool _childResultsBelongToMe = false;
+
     // Stats
     ShardingFilterStats _specificStats;
 
@@ -48,8 +48,81 @@ ShardFilterer::DocumentBelongsResult ShardFiltererImpl::_shardKeyBelongsToMe(
         return DocumentBelongsResult::kNoShardKey;
     }
 
-    return _collectionFilter.keyBelongsToMe(shardKey) ? DocumentBelongsResult::kBelongs
-                                                      : DocumentBelongsResult::kDoesNotBelong;
+    if (!_lastChunkRange || !_lastChunkRange->containsKey(shardKey)) {
+        std::tie(_lastChunkRange, _lastChunkRangeBelongsToMe) =
+            _collectionFilter.getChunkRangeContaining(shardKey);
+    }
+
+    return _lastChunkRangeBelongsToMe ? DocumentBelongsResult::kBelongs
+                                      : DocumentBelongsResult::kDoesNotBelong;
+}
+
+bool ShardFiltererImpl::indexBoundsBelongToMe(const IndexEntry& index,
+                                              const IndexBounds& bounds) const {
+    if (!_collectionFilter.isSharded()) {
+        return true;
+    }
+
+    // Index keys are the shard keys of the documents only if the index is prefixed by exactly the
+    // shard key fields, including the same kind of hashing, and stores neither collation keys nor
+    // the elements of arrays (which a valid shard key cannot contain).
+    const auto& shardKeyPattern = _keyPattern->toBSON();
+    if (index.multikey || index.collator || bounds.isSimpleRange ||
+        bounds.fields.size() < size_t(shardKeyPattern.nFields())) {
+        return false;
+    }
+
+    BSONObjIterator indexKeyPatternIt(index.keyPattern);
+    for (auto&& shardKeyElt : shardKeyPattern) {
+        if (!indexKeyPatternIt.more() ||
+            shardKeyElt.woCompare(indexKeyPatternIt.next(), true /* considerFieldName */) != 0) {
+            return false;
+        }
+    }
+
+    // Bound the shard keys which the scan can return by the lowest and highest value each of the
+    // shard key fields can take. The intervals of a reverse scan are reversed, so they are not
+    // assumed to be in any particular order. Documents missing a shard key field are indexed as
+    // null and must still be dropped by the per-document check, so the bounds must exclude null.
+    BSONObjBuilder minBuilder;
+    BSONObjBuilder maxBuilder;
+    for (size_t i = 0; i < size_t(shardKeyPattern.nFields()); ++i) {
+        const auto& intervals = bounds.fields[i].intervals;
+        if (intervals.empty()) {
+            // The scan returns no documents at all.
+            return true;
+        }
+
+        BSONElement lowest;
+        bool lowestInclusive = false;
+        BSONElement highest;
+        for (const auto& interval : intervals) {
+            const bool isReversed = interval.start.woCompare(interval.end, false) > 0;
+            const auto& low = isReversed ? interval.end : interval.start;
+            const auto& high = isReversed ? interval.start : interval.end;
+            const bool lowInclusive = isReversed ? interval.endInclusive : interval.startInclusive;
+            const int lowCompare = lowest.eoo() ? -1 : low.woCompare(lowest, false);
+            if (lowCompare < 0) {
+                lowest = low;
+                lowestInclusive = lowInclusive;
+            } else if (lowCompare == 0) {
+                lowestInclusive = lowestInclusive || lowInclusive;
+            }
+            if (highest.eoo() || high.woCompare(highest, false) > 0) {
+                highest = high;
+            }
+        }
+
+        const int nullCompare = lowest.canonicalType() - canonicalizeBSONType(jstNULL);
+        if (nullCompare < 0 || (nullCompare == 0 && lowestInclusive)) {
+            return false;
+        }
+
+        minBuilder.appendAs(lowest, bounds.fields[i].name);
+        maxBuilder.appendAs(highest, bounds.fields[i].name);
+    }
+
+    return _collectionFilter.rangeBelongsToMe(minBuilder.obj(), maxBuilder.obj());
 }
 
 
@@ -31,6 +31,8 @@
 
 #include "mongo/db/exec/shard_filterer.h"
 #include "mongo/db/matcher/matchable.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/index_entry.h"
 #include "mongo/db/s/scoped_collection_metadata.h"
 
 namespace mongo {
@@ -51,9 +53,24 @@ public:
         return _keyPattern->getKeyPattern();
     }
 
+    /**
+     * Returns true if every document which a scan over 'bounds' of 'index' can return is known to
+     * belong to this shard, without looking at the documents themselves. This can only be the case
+     * if the index key pattern is prefixed by the shard key pattern, so that index keys and shard
+     * keys order the same way.
+     */
+    bool indexBoundsBelongToMe(const IndexEntry& index, const IndexBounds& bounds) const;
+
 private:
     DocumentBelongsResult _shardKeyBelongsToMe(BSONObj shardKey) const;
     ScopedCollectionFilter _collectionFilter;
     boost::optional<ShardKeyPattern> _keyPattern;
+
+    // The range of the chunk which contained the last shard key looked up, and whether it belongs
+    // to this shard. Scans mostly return documents in shard key order, or in an insertion order
+    // which follows it, so each shard key is first checked against this range before it is looked
+    // up in the routing table.
+    mutable boost::optional<ChunkRange> _lastChunkRange;
+    mutable bool _lastChunkRangeBelongsToMe{false};
 };
 }  // namespace mongo
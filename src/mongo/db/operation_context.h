@@ -456,6 +456,19 @@ public:
         return _exhaust;
     }
 
+    /**
+     * Sets the time by which the exhaust responses held back for this operation's response should
+     * be sent. An exhaust command should then return its response as soon as it has one once this
+     * time has passed. Date_t::max() means that there are no held back responses.
+     */
+    void setExhaustResponsesDeadline(Date_t deadline) {
+        _exhaustResponsesDeadline = deadline;
+    }
+
+    Date_t getExhaustResponsesDeadline() const {
+        return _exhaustResponsesDeadline;
+    }
+
     void storeMaxTimeMS(Microseconds maxTime) {
         _storedMaxTime = maxTime;
     }
@@ -606,6 +619,9 @@ private:
 
     // Whether this operation is an exhaust command.
     bool _exhaust = false;
+
+    // When the exhaust responses held back for this operation's response should be sent.
+    Date_t _exhaustResponsesDeadline = Date_t::max();
 };
 
 namespace repl {
@@ -144,7 +144,10 @@ StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj&
 
     BSONObjIterator i(doc);
 
-    BSONObjBuilder b(doc.objsize() + 16);
+    // Reserve room for a generated ObjectId _id element (type byte, "_id\0" and the 12 byte OID)
+    // so that rewriting a document which lacks an _id never has to grow the buffer.
+    const int kGeneratedIdElementSize = 1 + 4 + OID::kOIDSize;
+    BSONObjBuilder b(doc.objsize() + kGeneratedIdElementSize);
     if (firstElementIsId) {
         b.append(doc.firstElement());
         i.next();
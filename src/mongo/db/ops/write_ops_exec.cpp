@@ -578,8 +578,10 @@ WriteResult performInserts(OperationContext* opCtx,
                 }
             }
 
+            // Documents which need no fixup are inserted as-is. For OP_MSG document sequences they
+            // are views into the request message buffer, so no per-document copy is made here.
             BSONObj toInsert = fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
-            batch.emplace_back(stmtId, toInsert);
+            batch.emplace_back(stmtId, std::move(toInsert));
             bytesInBatch += batch.back().doc.objsize();
             if (!isLastDoc && batch.size() < maxBatchSize && bytesInBatch < maxBatchBytes)
                 continue;  // Add more to batch before inserting.
@@ -32,6 +32,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/ops/insert.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/ops/write_ops_parsers_test_helpers.h"
@@ -249,6 +250,31 @@ TEST(CommandWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, MultiInsertFromDocSequenceSharesMessageBuffer) {
+    const auto ns = NamespaceString("test", "foo");
+    const BSONObj obj0 = BSON("_id" << 0 << "x" << 0);
+    const BSONObj obj1 = BSON("_id" << 1 << "x" << 1);
+    auto cmd = BSON("insert" << ns.coll() << "documents" << BSON_ARRAY(obj0 << obj1));
+    const auto message = toOpMsg(ns.db(), cmd, true).serialize();
+
+    const auto op = InsertOp::parse(OpMsgRequest::parseOwned(message));
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+
+    // Documents from a sequence must be owned views into the message rather than copies of it.
+    const char* const begin = message.buf();
+    const char* const end = begin + message.size();
+    for (auto&& doc : op.getDocuments()) {
+        ASSERT(doc.isOwned());
+        ASSERT_GTE(doc.objdata(), begin);
+        ASSERT_LTE(doc.objdata() + doc.objsize(), end);
+
+        // A document whose _id is already first needs no rewrite before being inserted.
+        auto fixed = fixDocumentForInsert(nullptr, doc);
+        ASSERT_OK(fixed.getStatus());
+        ASSERT(fixed.getValue().isEmpty());
+    }
+}
+
 TEST(CommandWriteOpsParsers, MultiInsertWithStmtId) {
     const auto ns = NamespaceString("test", "foo");
     const BSONObj obj0 = BSON("x" << 0);
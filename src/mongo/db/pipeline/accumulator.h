@@ -42,6 +42,7 @@
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/hyper_log_log_sketch.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/util/summation.h"
 
@@ -177,6 +178,34 @@ private:
     int _maxMemUsageBytes;
 };
 
+/**
+ * Estimates the number of distinct values in a group using a HyperLogLog sketch. Unlike
+ * $addToSet followed by $size, the partial state sent from each shard to be merged is a sketch of
+ * at most a few kilobytes rather than every distinct value.
+ */
+class AccumulatorApproxCountDistinct final : public AccumulatorState {
+public:
+    explicit AccumulatorApproxCountDistinct(ExpressionContext* const expCtx);
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<AccumulatorState> create(ExpressionContext* const expCtx);
+
+    bool isAssociative() const final {
+        return true;
+    }
+
+    bool isCommutative() const final {
+        return true;
+    }
+
+private:
+    HyperLogLogSketch _sketch;
+};
+
 class AccumulatorFirst final : public AccumulatorState {
 public:
     explicit AccumulatorFirst(ExpressionContext* const expCtx);
@@ -357,6 +357,57 @@ TEST(Accumulators, AddToSetRespectsMaxMemoryConstraint) {
         ErrorCodes::ExceededMemoryLimit);
 }
 
+TEST(Accumulators, ApproxCountDistinct) {
+    auto expCtx = ExpressionContextForTest{};
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx,
+        {
+            // No documents evaluated.
+            {{}, Value(0LL)},
+            // Small counts are exact.
+            {{Value(1), Value(2), Value(3)}, Value(3LL)},
+            // Numerically equal values are counted once.
+            {{Value(1), Value(1LL), Value(1.0), Value("1"_sd)}, Value(2LL)},
+            // Null values are counted, missing values are ignored.
+            {{Value(BSONNULL), Value(), Value(BSONNULL)}, Value(1LL)},
+        });
+}
+
+TEST(Accumulators, ApproxCountDistinctRespectsCollation) {
+    auto expCtx = ExpressionContextForTest{};
+    auto collator =
+        std::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx.setCollator(std::move(collator));
+    assertExpectedResults<AccumulatorApproxCountDistinct>(
+        &expCtx, {{{Value("a"_sd), Value("b"_sd), Value("c"_sd)}, Value(1LL)}});
+}
+
+TEST(Accumulators, ApproxCountDistinctMergesPartialSketchesFromShards) {
+    auto expCtx = ExpressionContextForTest{};
+    const long long numValues = 100000;
+    const long long numShards = 4;
+
+    // Every value is seen by two shards.
+    auto merger = AccumulatorApproxCountDistinct::create(&expCtx);
+    for (long long shardId = 0; shardId < numShards; ++shardId) {
+        auto shard = AccumulatorApproxCountDistinct::create(&expCtx);
+        for (long long i = 0; i < numValues; ++i) {
+            if (i % numShards == shardId || (i + 1) % numShards == shardId) {
+                shard->process(Value(i), false);
+            }
+        }
+
+        // The partial state is a fixed size sketch rather than the distinct values.
+        auto partial = shard->getValue(true);
+        ASSERT_EQ(partial.getType(), BinData);
+        ASSERT_LTE(partial.getBinData().length, 1 + int(HyperLogLogSketch::kNumRegisters));
+        merger->process(partial, true);
+    }
+
+    auto estimate = merger->getValue(false).getLong();
+    ASSERT_LTE(std::abs(estimate - numValues), numValues / 20);
+}
+
 TEST(Accumulators, PushRespectsMaxMemoryConstraint) {
     auto expCtx = ExpressionContextForTest{};
     const int maxMemoryBytes = 20ull;
@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/init.h"
@@ -247,6 +248,45 @@ void lookupPipeValidator(const Pipeline& pipeline) {
 bool foreignShardedLookupAllowed() {
     return getTestCommandsEnabled() && internalQueryAllowShardedLookup.load();
 }
+
+/**
+ * Adds 'result' to the matches of one input document, enforcing the limit on their total size.
+ * 'resultsSize' holds the size of the matches added so far.
+ */
+void addLookupResult(const NamespaceString& fromNs,
+                     Document result,
+                     std::vector<Value>* results,
+                     long long* resultsSize) {
+    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+    long long safeSum = 0;
+    bool hasOverflowed = overflow::add(*resultsSize, result.getApproximateSize(), &safeSum);
+    uassert(4568,
+            str::stream() << "Total size of documents in " << fromNs.coll()
+                          << " matching pipeline's $lookup stage exceeds " << maxBytes << " bytes",
+
+            !hasOverflowed && *resultsSize <= maxBytes);
+    *resultsSize = safeSum;
+    results->emplace_back(std::move(result));
+}
+
+/**
+ * Returns true if the foreign documents matching a {$eq: 'value'} predicate are exactly the ones
+ * with a value equal to 'value' on the foreign field path, as enumerated by
+ * document_path_support::visitAllValuesAtPath(). This does not hold for arrays, which may also
+ * match an entire array in the foreign collection, for regular expressions, which must not be used
+ * in a $in query, and for null, which also matches missing fields.
+ */
+bool canMatchByHashing(const Value& value) {
+    switch (value.getType()) {
+        case BSONType::Array:
+        case BSONType::RegEx:
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+            return false;
+        default:
+            return true;
+    }
+}
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
@@ -254,17 +294,24 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
         return unwindResult();
     }
 
+    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
+    // '_unwindSrc' would be non-null, and we would not have made it here.
+    invariant(!_matchSrc);
+
+    // Drain any batch that has already been looked up, even if batching has since been disabled.
+    if (!_batchOutput.empty() || _batchEndResult || canLookUpInBatches()) {
+        return batchedResult();
+    }
+
     auto nextInput = pSource->getNext();
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
 
-    auto inputDoc = nextInput.releaseDocument();
-
-    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
-    // '_unwindSrc' would be non-null, and we would not have made it here.
-    invariant(!_matchSrc);
+    return lookUpSingle(nextInput.releaseDocument());
+}
 
+Document DocumentSourceLookUp::lookUpSingle(Document inputDoc) {
     if (!wasConstructedWithPipelineSyntax()) {
         auto matchStage =
             makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
@@ -272,9 +319,177 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
         _resolvedPipeline.back() = matchStage;
     }
 
-    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    auto pipeline = buildPipelineForLookup(inputDoc);
+
+    std::vector<Value> results;
+    long long objsize = 0;
+
+    while (auto result = pipeline->getNext()) {
+        addLookupResult(_fromNs, std::move(*result), &results, &objsize);
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+
+    MutableDocument output(std::move(inputDoc));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
+bool DocumentSourceLookUp::canLookUpInBatches() const {
+    if (wasConstructedWithPipelineSyntax() || internalLookupStageBatchSize.load() <= 1) {
+        return false;
+    }
+
+    // Numeric path components may refer to array positions, which the hash based matching of
+    // lookUpBatch() does not follow the same way the query does.
+    for (size_t i = 0; i < _foreignField->getPathLength(); ++i) {
+        if (str::parseUnsignedBase10Integer(_foreignField->getFieldName(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::batchedResult() {
+    if (_batchOutput.empty()) {
+        if (_batchEndResult) {
+            // Return the EOF or pause that ended the previous batch only after all of its
+            // documents.
+            auto endResult = std::move(*_batchEndResult);
+            _batchEndResult.reset();
+            return endResult;
+        }
+
+        const auto maxBatchSize = static_cast<size_t>(internalLookupStageBatchSize.load());
+        const auto maxBatchBytes = internalLookupStageBatchMaxSizeBytes.load();
+
+        std::vector<Document> batch;
+        long long batchBytes = 0;
+        while (batch.size() < maxBatchSize && batchBytes < maxBatchBytes) {
+            auto nextInput = pSource->getNext();
+            if (!nextInput.isAdvanced()) {
+                if (batch.empty()) {
+                    return nextInput;
+                }
+                _batchEndResult = std::move(nextInput);
+                break;
+            }
+            batch.push_back(nextInput.releaseDocument());
+            batchBytes += batch.back().getApproximateSize();
+        }
+
+        lookUpBatch(std::move(batch));
+    }
+
+    auto output = std::move(_batchOutput.front());
+    _batchOutput.pop_front();
+    if (!output.lookedUp) {
+        return lookUpSingle(std::move(output.doc));
+    }
+    return std::move(output.doc);
+}
+
+void DocumentSourceLookUp::lookUpBatch(std::vector<Document> batch) {
+    const auto maxQueryBytes = internalLookupStageBatchMaxSizeBytes.load();
+
+    // Maps every local field value in the batch to the input documents it was found in.
+    auto inputsByValue =
+        pExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    std::vector<bool> lookUpOnItsOwn(batch.size(), false);
+    BSONArrayBuilder valuesBuilder;
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        std::vector<Value> values;
+        document_path_support::visitAllValuesAtPath(
+            batch[i], *_localField, [&](const Value& nextValue) { values.push_back(nextValue); });
+
+        // Missing values are treated as null, which cannot be matched by hashing either. Also keep
+        // the $in query within the size limit by looking up any input that could overflow it on
+        // its own. The size of the whole input document bounds the size of its values.
+        const bool hashable =
+            !values.empty() && std::all_of(values.begin(), values.end(), canMatchByHashing);
+        if (!hashable ||
+            valuesBuilder.len() + static_cast<long long>(batch[i].getApproximateSize()) >
+                maxQueryBytes) {
+            lookUpOnItsOwn[i] = true;
+            continue;
+        }
+
+        for (auto&& value : values) {
+            auto& inputs = inputsByValue[value];
+            if (inputs.empty()) {
+                valuesBuilder << value;
+            }
+            if (inputs.empty() || inputs.back() != i) {
+                inputs.push_back(i);
+            }
+        }
+    }
+
+    std::vector<std::vector<Value>> results(batch.size());
+    if (!inputsByValue.empty()) {
+        // { <foreignFieldName> : { "$in" : <values> } }
+        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+        _resolvedPipeline.back() = BSON(
+            "$match" << BSON(_foreignField->fullPath() << BSON("$in" << valuesBuilder.arr())));
+
+        // There are no 'let' variables with this syntax, so any input document will do.
+        auto pipeline = buildPipelineForLookup(batch.front());
+
+        std::vector<long long> resultsSizes(batch.size(), 0);
+        long long batchResultsBytes = 0;
+        std::vector<size_t> matchedInputs;
+        while (auto result = pipeline->getNext()) {
+            matchedInputs.clear();
+            document_path_support::visitAllValuesAtPath(
+                *result, *_foreignField, [&](const Value& nextValue) {
+                    auto it = inputsByValue.find(nextValue);
+                    if (it != inputsByValue.end()) {
+                        matchedInputs.insert(
+                            matchedInputs.end(), it->second.begin(), it->second.end());
+                    }
+                });
+
+            // A foreign document may match the same input through several of its values.
+            std::sort(matchedInputs.begin(), matchedInputs.end());
+            matchedInputs.erase(std::unique(matchedInputs.begin(), matchedInputs.end()),
+                                matchedInputs.end());
+            if (matchedInputs.empty()) {
+                continue;
+            }
+
+            // Every input may still be matched by the foreign documents yet to come, so once the
+            // matches of the batch grow too large none of its inputs can be completed. Drop them
+            // all and look every input up on its own, one at a time as they are returned.
+            batchResultsBytes += result->getApproximateSize();
+            if (batchResultsBytes > maxQueryBytes) {
+                results.clear();
+                std::fill(lookUpOnItsOwn.begin(), lookUpOnItsOwn.end(), true);
+                break;
+            }
+
+            for (auto i : matchedInputs) {
+                addLookupResult(_fromNs, *result, &results[i], &resultsSizes[i]);
+            }
+        }
+        _usedDisk = _usedDisk || pipeline->usedDisk();
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (lookUpOnItsOwn[i]) {
+            _batchOutput.push_back({std::move(batch[i]), false});
+            continue;
+        }
+
+        MutableDocument output(std::move(batch[i]));
+        output.setNestedField(_as, Value(std::move(results[i])));
+        _batchOutput.push_back({output.freeze(), true});
+    }
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipelineForLookup(
+    const Document& inputDoc) {
     try {
-        pipeline = buildPipeline(inputDoc);
+        return buildPipeline(inputDoc);
     } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>& ex) {
         // If lookup on a sharded collection is disallowed and the foreign collection is sharded,
         // throw a custom exception.
@@ -286,28 +501,6 @@ DocumentSource::GetNextResult DocumentSourceLookUp::doGetNext() {
         }
         throw;
     }
-
-    std::vector<Value> results;
-    long long objsize = 0;
-    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
-
-    while (auto result = pipeline->getNext()) {
-        long long safeSum = 0;
-        bool hasOverflowed = overflow::add(objsize, result->getApproximateSize(), &safeSum);
-        uassert(4568,
-                str::stream() << "Total size of documents in " << _fromNs.coll()
-                              << " matching pipeline's $lookup stage exceeds " << maxBytes
-                              << " bytes",
-
-                !hasOverflowed && objsize <= maxBytes);
-        objsize = safeSum;
-        results.emplace_back(std::move(*result));
-    }
-    _usedDisk = _usedDisk || pipeline->usedDisk();
-
-    MutableDocument output(std::move(inputDoc));
-    output.setNestedField(_as, Value(std::move(results)));
-    return output.freeze();
 }
 
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
@@ -514,6 +707,8 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _batchOutput.clear();
+    _batchEndResult.reset();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/exec/document_value/value_comparator.h"
 #include "mongo/db/pipeline/document_source.h"
@@ -242,6 +243,41 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns true if the input documents can be looked up in batches rather than one at a time.
+     * This is the case for the localField/foreignField syntax, unless batching is disabled or the
+     * foreign field is a positional path.
+     */
+    bool canLookUpInBatches() const;
+
+    /**
+     * Returns the next input document with its matches, looking up a whole batch of input
+     * documents when none are buffered.
+     */
+    GetNextResult batchedResult();
+
+    /**
+     * Looks up all documents in 'batch' with a single $in query against the foreign collection and
+     * distributes the matches to the input documents by hashing the foreign field values. Input
+     * documents whose local field values cannot be matched by hashing are looked up on their own,
+     * as are all of them if the matches of the batch grow larger than
+     * 'internalLookupStageBatchMaxSizeBytes'. The results are appended to '_batchOutput' in input
+     * order.
+     */
+    void lookUpBatch(std::vector<Document> batch);
+
+    /**
+     * Runs the $lookup pipeline for a single input document and returns the document with the
+     * matches added to its 'as' field.
+     */
+    Document lookUpSingle(Document inputDoc);
+
+    /**
+     * Calls buildPipeline(), turning a stale shard version error for a sharded foreign collection
+     * into a user facing error if $lookup on sharded collections is not allowed.
+     */
+    std::unique_ptr<Pipeline, PipelineDeleter> buildPipelineForLookup(const Document& inputDoc);
+
     /**
      * Resolves let defined variables against 'localDoc' and stores the results in 'variables'.
      */
@@ -317,6 +353,19 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // An input document of the current batch, which either has its matches added already or is
+    // still to be looked up on its own, so that only one such lookup is held in memory at a time.
+    struct BatchedDocument {
+        Document doc;
+        bool lookedUp;
+    };
+
+    // The following members are used to hold onto state across getNext() calls when input
+    // documents are looked up in batches. '_batchOutput' holds the documents of the current batch
+    // which have not been returned yet, and '_batchEndResult' the EOF or pause which ended it.
+    std::deque<BatchedDocument> _batchOutput;
+    boost::optional<GetNextResult> _batchEndResult;
 };
 
 }  // namespace mongo
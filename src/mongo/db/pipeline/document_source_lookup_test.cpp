@@ -48,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -508,9 +509,13 @@ public:
 
         pipeline->addInitialSource(
             DocumentSourceMock::createForTest(_mockResults, pipeline->getContext()));
+        ++numPipelinesAttached;
         return pipeline;
     }
 
+    // The number of queries against the foreign collection.
+    int numPipelinesAttached = 0;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
@@ -569,6 +574,155 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, ShouldLookUpBatchOfInputDocumentsWithSingleQuery) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto mockLocalSource = DocumentSourceMock::createForTest(
+        {Document{{"_id", 0}, {"key", 0}},
+         Document{{"_id", 1}, {"key", 1LL}},
+         Document{{"_id", 2}, {"key", vector<Value>{Value(0), Value(2)}}},
+         Document{{"_id", 3}, {"key", BSONNULL}},
+         Document{{"_id", 4}},
+         Document{{"_id", 5}, {"key", 3}}},
+        expCtx);
+
+    // Mock out the foreign collection.
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", "a"_sd}, {"key", 0}},
+        Document{{"_id", "b"_sd}, {"key", vector<Value>{Value(1.0), Value(2)}}},
+        Document{{"_id", "c"_sd}}};
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "key"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    lookup->setSource(mockLocalSource.get());
+
+    const Value docA(Document{{"_id", "a"_sd}, {"key", 0}});
+    const Value docB(Document{{"_id", "b"_sd}, {"key", vector<Value>{Value(1.0), Value(2)}}});
+    const Value docC(Document{{"_id", "c"_sd}});
+    const vector<vector<Value>> expectedMatches{{docA}, {docB}, {docA, docB}, {docC}, {docC}, {}};
+
+    for (size_t i = 0; i < expectedMatches.size(); ++i) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_VALUE_EQ(doc["_id"], Value(static_cast<int>(i)));
+        ASSERT_VALUE_EQ(doc["foreignDocs"], Value(expectedMatches[i]));
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // The inputs with a null or missing local field need queries of their own, as null also
+    // matches missing foreign fields, all others are looked up together.
+    ASSERT_EQ(3, mongoProcessInterface->numPipelinesAttached);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldLookUpInputDocumentsOneByOneIfBatchMatchesAreTooLarge) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    std::deque<DocumentSource::GetNextResult> inputs;
+    long long inputBytes = 0;
+    for (int i = 0; i < 3; ++i) {
+        Document input{{"foreignId", i}};
+        inputBytes += input.getApproximateSize();
+        inputs.push_back(std::move(input));
+    }
+    auto mockLocalSource = DocumentSourceMock::createForTest(std::move(inputs), expCtx);
+
+    // The inputs and their values fit in a batch, but the matches of two of them do not.
+    const auto originalMaxBatchBytes = internalLookupStageBatchMaxSizeBytes.load();
+    internalLookupStageBatchMaxSizeBytes.store(2 * inputBytes);
+    ON_BLOCK_EXIT([&] { internalLookupStageBatchMaxSizeBytes.store(originalMaxBatchBytes); });
+
+    const std::string padding(inputBytes, 'x');
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (int i = 0; i < 3; ++i) {
+        mockForeignContents.push_back(Document{{"_id", i}, {"padding", padding}});
+    }
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    lookup->setSource(mockLocalSource.get());
+
+    // The batch query is abandoned, and each input is only looked up once it is returned.
+    for (int i = 0; i < 3; ++i) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_EQ(2 + i, mongoProcessInterface->numPipelinesAttached);
+        ASSERT_DOCUMENT_EQ(
+            next.releaseDocument(),
+            (Document{{"foreignId", i},
+                      {"foreignDocs",
+                       vector<Value>{Value(Document{{"_id", i}, {"padding", padding}})}}}));
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldLookUpInputDocumentsOneByOneIfBatchingIsDisabled) {
+    const auto originalBatchSize = internalLookupStageBatchSize.load();
+    internalLookupStageBatchSize.store(1);
+    ON_BLOCK_EXIT([&] { internalLookupStageBatchSize.store(originalBatchSize); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto mockLocalSource = DocumentSourceMock::createForTest(
+        {Document{{"foreignId", 0}}, Document{{"foreignId", 1}}}, expCtx);
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    auto mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoProcessInterface;
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    lookup->setSource(mockLocalSource.get());
+
+    for (int i = 0; i < 2; ++i) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                           (Document{{"foreignId", i},
+                                     {"foreignDocs", vector<Value>{Value(Document{{"_id", i}})}}}));
+    }
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_EQ(2, mongoProcessInterface->numPipelinesAttached);
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/hyper_log_log_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/base/data_view.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+// The first byte of a serialized sketch identifies its representation.
+constexpr char kSparseFormat = 0;
+constexpr char kDenseFormat = 1;
+
+// Approximate memory used by each hash in the sparse representation: the hash itself plus the
+// node and bucket pointers of the unordered set.
+constexpr size_t kSparseHashMemUsageBytes = sizeof(uint64_t) + 2 * sizeof(void*);
+
+}  // namespace
+
+HyperLogLogSketch HyperLogLogSketch::deserialize(StringData data) {
+    uassert(4859100, "Serialized HyperLogLog sketch is empty", !data.empty());
+
+    HyperLogLogSketch sketch;
+    const char* payload = data.rawData() + 1;
+    const size_t payloadSize = data.size() - 1;
+    if (data[0] == kSparseFormat) {
+        uassert(4859101,
+                str::stream() << "Serialized sparse HyperLogLog sketch has invalid size "
+                              << data.size(),
+                payloadSize % sizeof(uint64_t) == 0 &&
+                    payloadSize / sizeof(uint64_t) <= kMaxSparseHashes);
+        for (size_t offset = 0; offset < payloadSize; offset += sizeof(uint64_t)) {
+            sketch._sparseHashes.insert(
+                ConstDataView(payload).read<LittleEndian<uint64_t>>(offset));
+        }
+    } else {
+        uassert(4859102,
+                str::stream() << "Serialized HyperLogLog sketch has unknown format "
+                              << static_cast<int>(data[0]),
+                data[0] == kDenseFormat);
+        uassert(4859103,
+                str::stream() << "Serialized dense HyperLogLog sketch has invalid size "
+                              << data.size(),
+                payloadSize == kNumRegisters);
+        sketch._registers.assign(payload, payload + payloadSize);
+    }
+    return sketch;
+}
+
+void HyperLogLogSketch::add(uint64_t hash) {
+    if (isDense()) {
+        _addToRegisters(hash);
+        return;
+    }
+
+    _sparseHashes.insert(hash);
+    if (_sparseHashes.size() > kMaxSparseHashes) {
+        _convertToDense();
+    }
+}
+
+void HyperLogLogSketch::merge(const HyperLogLogSketch& other) {
+    if (!other.isDense()) {
+        for (auto hash : other._sparseHashes) {
+            add(hash);
+        }
+        return;
+    }
+
+    if (!isDense()) {
+        _convertToDense();
+    }
+    for (size_t i = 0; i < kNumRegisters; ++i) {
+        _registers[i] = std::max(_registers[i], other._registers[i]);
+    }
+}
+
+long long HyperLogLogSketch::estimate() const {
+    if (!isDense()) {
+        return _sparseHashes.size();
+    }
+
+    const double numRegisters = kNumRegisters;
+    double inverseSum = 0;
+    size_t numZeroRegisters = 0;
+    for (auto reg : _registers) {
+        inverseSum += std::ldexp(1.0, -reg);
+        if (reg == 0) {
+            ++numZeroRegisters;
+        }
+    }
+
+    const double alpha = 0.7213 / (1 + 1.079 / numRegisters);
+    double estimate = alpha * numRegisters * numRegisters / inverseSum;
+
+    // The raw estimate is biased for small cardinalities, where linear counting over the registers
+    // which are still empty is more accurate.
+    if (estimate <= 2.5 * numRegisters && numZeroRegisters != 0) {
+        estimate = numRegisters * std::log(numRegisters / numZeroRegisters);
+    }
+    return std::llround(estimate);
+}
+
+std::string HyperLogLogSketch::serialize() const {
+    std::string data(1, isDense() ? kDenseFormat : kSparseFormat);
+    if (isDense()) {
+        data.append(_registers.begin(), _registers.end());
+        return data;
+    }
+
+    data.resize(1 + _sparseHashes.size() * sizeof(uint64_t));
+    size_t offset = 1;
+    for (auto hash : _sparseHashes) {
+        DataView(&data[0]).write<LittleEndian<uint64_t>>(hash, offset);
+        offset += sizeof(uint64_t);
+    }
+    return data;
+}
+
+size_t HyperLogLogSketch::memUsageBytes() const {
+    return sizeof(*this) + _registers.capacity() + _sparseHashes.size() * kSparseHashMemUsageBytes;
+}
+
+void HyperLogLogSketch::_addToRegisters(uint64_t hash) {
+    // The top 'kPrecision' bits pick the register, which records the longest run of leading zeros
+    // seen in the remaining bits.
+    const size_t index = hash >> (64 - kPrecision);
+    const uint64_t remaining = hash << kPrecision;
+    const uint8_t rank = remaining == 0 ? 64 - kPrecision + 1 : countLeadingZeros64(remaining) + 1;
+    _registers[index] = std::max(_registers[index], rank);
+}
+
+void HyperLogLogSketch::_convertToDense() {
+    _registers.assign(kNumRegisters, 0);
+    for (auto hash : _sparseHashes) {
+        _addToRegisters(hash);
+    }
+    stdx::unordered_set<uint64_t>().swap(_sparseHashes);
+}
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+
+/**
+ * A HyperLogLog sketch estimating the number of distinct 64-bit hashes added to it.
+ *
+ * Small cardinalities are counted exactly by keeping the hashes themselves. Once that would take
+ * more space than the registers, the sketch switches to the dense HyperLogLog representation with
+ * 2^kPrecision one-byte registers, which has a standard error of about 1.6%.
+ *
+ * Sketches built from the same hash function can be merged, and the merged sketch estimates the
+ * cardinality of the union of their inputs. This is what allows the partial state of a distinct
+ * count to be computed on each shard and combined on mongos.
+ */
+class HyperLogLogSketch {
+public:
+    static constexpr int kPrecision = 12;
+    static constexpr size_t kNumRegisters = size_t{1} << kPrecision;
+
+    // Above this many distinct hashes the sketch switches to the dense representation.
+    static constexpr size_t kMaxSparseHashes = kNumRegisters / sizeof(uint64_t);
+
+    /**
+     * Reconstructs a sketch from the output of serialize(). Throws if 'data' is not a valid
+     * serialized sketch.
+     */
+    static HyperLogLogSketch deserialize(StringData data);
+
+    void add(uint64_t hash);
+
+    /**
+     * Adds all of the hashes in 'other' to this sketch.
+     */
+    void merge(const HyperLogLogSketch& other);
+
+    /**
+     * Returns the estimated number of distinct hashes added to this sketch.
+     */
+    long long estimate() const;
+
+    /**
+     * Returns a compact binary representation of this sketch, suitable for passing to
+     * deserialize().
+     */
+    std::string serialize() const;
+
+    /**
+     * Returns the approximate number of bytes of memory used by this sketch.
+     */
+    size_t memUsageBytes() const;
+
+    bool isDense() const {
+        return !_registers.empty();
+    }
+
+private:
+    void _addToRegisters(uint64_t hash);
+    void _convertToDense();
+
+    // The hashes seen so far while the sketch is sparse. Empty once the sketch is dense.
+    stdx::unordered_set<uint64_t> _sparseHashes;
+
+    // The HyperLogLog registers. Empty while the sketch is sparse.
+    std::vector<uint8_t> _registers;
+};
+
+}  // namespace mongo
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/hyper_log_log_sketch.h"
+
+#include <cmath>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// Four times the standard error of a sketch with 2^12 registers.
+const double kMaxRelativeError = 4 * 1.04 / std::sqrt(HyperLogLogSketch::kNumRegisters);
+
+void assertEstimateWithinError(const HyperLogLogSketch& sketch, long long expected) {
+    ASSERT_LTE(std::abs(sketch.estimate() - expected), kMaxRelativeError * expected)
+        << "estimate: " << sketch.estimate() << ", expected: " << expected;
+}
+
+TEST(HyperLogLogSketchTest, EmptySketchEstimatesZero) {
+    HyperLogLogSketch sketch;
+    ASSERT_EQ(sketch.estimate(), 0);
+    ASSERT_EQ(HyperLogLogSketch::deserialize(sketch.serialize()).estimate(), 0);
+}
+
+TEST(HyperLogLogSketchTest, SparseSketchCountsExactly) {
+    HyperLogLogSketch sketch;
+    PseudoRandom random(1);
+    std::vector<uint64_t> hashes;
+    for (size_t i = 0; i < HyperLogLogSketch::kMaxSparseHashes; ++i) {
+        hashes.push_back(random.nextInt64());
+    }
+
+    // Adding each hash twice does not change the count.
+    for (int round = 0; round < 2; ++round) {
+        for (auto hash : hashes) {
+            sketch.add(hash);
+        }
+    }
+    ASSERT_FALSE(sketch.isDense());
+    ASSERT_EQ(sketch.estimate(), static_cast<long long>(hashes.size()));
+}
+
+TEST(HyperLogLogSketchTest, DenseSketchEstimateIsWithinError) {
+    PseudoRandom random(2);
+    for (long long cardinality : {1000LL, 10000LL, 1000000LL}) {
+        HyperLogLogSketch sketch;
+        for (long long i = 0; i < cardinality; ++i) {
+            sketch.add(random.nextInt64());
+        }
+        ASSERT_TRUE(sketch.isDense());
+        assertEstimateWithinError(sketch, cardinality);
+    }
+}
+
+TEST(HyperLogLogSketchTest, MergedSketchEstimatesCardinalityOfUnion) {
+    PseudoRandom random(3);
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < 50000; ++i) {
+        hashes.push_back(random.nextInt64());
+    }
+
+    // Split the hashes over overlapping sketches, one of which stays sparse.
+    HyperLogLogSketch first;
+    HyperLogLogSketch second;
+    HyperLogLogSketch small;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        if (i < 30000) {
+            first.add(hashes[i]);
+        }
+        if (i >= 20000) {
+            second.add(hashes[i]);
+        }
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        small.add(hashes[i]);
+    }
+    ASSERT_FALSE(small.isDense());
+
+    HyperLogLogSketch merged;
+    merged.merge(small);
+    ASSERT_FALSE(merged.isDense());
+    merged.merge(first);
+    merged.merge(second);
+    ASSERT_TRUE(merged.isDense());
+    assertEstimateWithinError(merged, hashes.size());
+}
+
+TEST(HyperLogLogSketchTest, SerializationRoundTrips) {
+    PseudoRandom random(4);
+    HyperLogLogSketch sparse;
+    for (int i = 0; i < 10; ++i) {
+        sparse.add(random.nextInt64());
+    }
+    auto sparseCopy = HyperLogLogSketch::deserialize(sparse.serialize());
+    ASSERT_FALSE(sparseCopy.isDense());
+    ASSERT_EQ(sparseCopy.estimate(), 10);
+    ASSERT_EQ(sparse.serialize().size(), 1 + 10 * sizeof(uint64_t));
+
+    HyperLogLogSketch dense;
+    for (int i = 0; i < 10000; ++i) {
+        dense.add(random.nextInt64());
+    }
+    auto denseCopy = HyperLogLogSketch::deserialize(dense.serialize());
+    ASSERT_TRUE(denseCopy.isDense());
+    ASSERT_EQ(denseCopy.estimate(), dense.estimate());
+    ASSERT_EQ(dense.serialize().size(), 1 + HyperLogLogSketch::kNumRegisters);
+}
+
+TEST(HyperLogLogSketchTest, DeserializeRejectsInvalidData) {
+    ASSERT_THROWS_CODE(HyperLogLogSketch::deserialize(""), DBException, 4859100);
+    ASSERT_THROWS_CODE(
+        HyperLogLogSketch::deserialize(StringData("\0abc", 4)), DBException, 4859101);
+    ASSERT_THROWS_CODE(HyperLogLogSketch::deserialize("\x07"), DBException, 4859102);
+    ASSERT_THROWS_CODE(
+        HyperLogLogSketch::deserialize(StringData("\x01\0\0", 3)), DBException, 4859103);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -293,12 +293,25 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
             auto childStage = build(fn->children[0]);
 
             auto css = CollectionShardingState::get(_opCtx, _collection->ns());
-            return std::make_unique<ShardFilterStage>(
+            auto shardFilterStage = std::make_unique<ShardFilterStage>(
                 expCtx,
                 css->getOwnershipFilter(
                     _opCtx, CollectionShardingState::OrphanCleanupPolicy::kDisallowOrphanCleanup),
                 _ws,
                 std::move(childStage));
+
+            // If all the documents come from a single index scan, possibly fetched, the bounds of
+            // the scan may show that they all belong to this shard.
+            const QuerySolutionNode* scanNode = fn->children[0];
+            if (STAGE_FETCH == scanNode->getType()) {
+                scanNode = scanNode->children[0];
+            }
+            if (STAGE_IXSCAN == scanNode->getType()) {
+                const auto ixn = static_cast<const IndexScanNode*>(scanNode);
+                shardFilterStage->setChildIndexScanBounds(ixn->index, ixn->bounds);
+            }
+
+            return shardFilterStage;
         }
         case STAGE_DISTINCT_SCAN: {
             const DistinctNode* dn = static_cast<const DistinctNode*>(root);
@@ -72,6 +72,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_executor_factory.h"
+#include "mongo/db/query/plan_yield_policy_impl.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
@@ -1044,8 +1045,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getSlotBasedExe
     auto yieldPolicy =
         std::make_unique<PlanYieldPolicySBE>(requestedYieldPolicy,
                                              opCtx->getServiceContext()->getFastClockSource(),
-                                             internalQueryExecYieldIterations.load(),
-                                             Milliseconds{internalQueryExecYieldPeriodMS.load()});
+                                             PlanYieldPolicyImpl::getYieldIterations(opCtx),
+                                             PlanYieldPolicyImpl::getYieldPeriod(opCtx));
     SlotBasedPrepareExecutionHelper helper{
         opCtx, collection, cq.get(), yieldPolicy.get(), plannerOptions};
     auto executionResult = helper.prepare();
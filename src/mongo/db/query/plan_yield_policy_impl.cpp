@@ -42,6 +42,12 @@
 namespace mongo {
 namespace {
 MONGO_FAIL_POINT_DEFINE(setInterruptOnlyPlansCheckForInterruptHang);
+
+int getYieldFactor(OperationContext* opCtx) {
+    return opCtx->lockState()->getPriority() == Locker::Priority::kLow
+        ? internalQueryExecLowPriorityYieldFactor.load()
+        : 1;
+}
 }  // namespace
 
 PlanYieldPolicyImpl::PlanYieldPolicyImpl(PlanExecutorImpl* exec,
@@ -50,10 +56,18 @@ PlanYieldPolicyImpl::PlanYieldPolicyImpl(PlanExecutorImpl* exec,
                           ? PlanYieldPolicy::YieldPolicy::NO_YIELD
                           : policy,
                       exec->getOpCtx()->getServiceContext()->getFastClockSource(),
-                      internalQueryExecYieldIterations.load(),
-                      Milliseconds{internalQueryExecYieldPeriodMS.load()}),
+                      getYieldIterations(exec->getOpCtx()),
+                      getYieldPeriod(exec->getOpCtx())),
       _planYielding(exec) {}
 
+int PlanYieldPolicyImpl::getYieldIterations(OperationContext* opCtx) {
+    return std::max(1, internalQueryExecYieldIterations.load() / getYieldFactor(opCtx));
+}
+
+Milliseconds PlanYieldPolicyImpl::getYieldPeriod(OperationContext* opCtx) {
+    return Milliseconds{internalQueryExecYieldPeriodMS.load() / getYieldFactor(opCtx)};
+}
+
 Status PlanYieldPolicyImpl::yield(OperationContext* opCtx, std::function<void()> whileYieldingFn) {
     // Can't use writeConflictRetry since we need to call saveState before reseting the
     // transaction.
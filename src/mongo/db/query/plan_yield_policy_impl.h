@@ -38,6 +38,14 @@ class PlanYieldPolicyImpl final : public PlanYieldPolicy {
 public:
     PlanYieldPolicyImpl(PlanExecutorImpl* exec, PlanYieldPolicy::YieldPolicy policy);
 
+    /**
+     * Return the number of "should yield?" checks and the time between yields for the operation
+     * 'opCtx'. Low priority operations yield internalQueryExecLowPriorityYieldFactor times as
+     * often, so that they hold their ticket and locks for shorter stretches at a time.
+     */
+    static int getYieldIterations(OperationContext* opCtx);
+    static Milliseconds getYieldPeriod(OperationContext* opCtx);
+
 private:
     Status yield(OperationContext* opCtx, std::function<void()> whileYieldingFn = nullptr) override;
 
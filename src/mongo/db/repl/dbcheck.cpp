@@ -41,6 +41,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/dbcheck.h"
 #include "mongo/db/repl/dbcheck_gen.h"
+#include "mongo/db/repl/dbcheck_merkle_tree.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/storage/durable_catalog.h"
@@ -157,12 +158,17 @@ std::unique_ptr<HealthLogEntry> dbCheckBatchEntry(const NamespaceString& nss,
                                                   const std::string& foundHash,
                                                   const BSONKey& minKey,
                                                   const BSONKey& maxKey,
-                                                  const repl::OpTime& optime) {
+                                                  const repl::OpTime& optime,
+                                                  const std::vector<BSONObj>& divergentRanges) {
     auto hashes = expectedFound(expectedHash, foundHash);
 
-    auto data = BSON("success" << true << "count" << count << "bytes" << bytes << "md5"
-                               << hashes.second << "minKey" << minKey.elem() << "maxKey"
-                               << maxKey.elem() << "optime" << optime);
+    BSONObjBuilder builder;
+    builder << "success" << true << "count" << count << "bytes" << bytes << "md5" << hashes.second
+            << "minKey" << minKey.elem() << "maxKey" << maxKey.elem() << "optime" << optime;
+    if (!divergentRanges.empty()) {
+        builder << "divergentRanges" << divergentRanges;
+    }
+    auto data = builder.obj();
 
     auto severity = hashes.first ? SeverityEnum::Info : SeverityEnum::Error;
     std::string msg =
@@ -179,8 +185,9 @@ DbCheckHasher::DbCheckHasher(OperationContext* opCtx,
                              int64_t maxBytes)
     : _opCtx(opCtx), _maxKey(end), _maxCount(maxCount), _maxBytes(maxBytes) {
 
-    // Get the MD5 hasher set up.
+    // Get the MD5 hashers set up.
     md5_init(&_state);
+    md5_init(&_leafState);
 
     // Get the _id index.
     const IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
@@ -294,9 +301,10 @@ Status DbCheckHasher::hashAll(void) {
             return Status(ErrorCodes::NoSuchKey, "Document missing _id");
         }
 
-        // If this would put us over a limit, stop here.
+        // If this would put us over a limit, stop here. The leaf in progress is still finished
+        // below, so that the batch's last documents are covered by a leaf.
         if (!_canHash(currentObj)) {
-            return Status::OK();
+            break;
         }
 
         // Update `last` every time.
@@ -305,6 +313,18 @@ Status DbCheckHasher::hashAll(void) {
         _countSeen += 1;
 
         md5_append(&_state, md5Cast(currentObj.objdata()), currentObj.objsize());
+
+        // Close any leaves that end before this document.
+        while (_leaves.size() + 1 < _leafMaxKeys.size() && _last > _leafMaxKeys[_leaves.size()]) {
+            _finishLeaf(_leafMaxKeys[_leaves.size()]);
+        }
+
+        md5_append(&_leafState, md5Cast(currentObj.objdata()), currentObj.objsize());
+        _leafCountSeen += 1;
+
+        if (_leafDocs > 0 && _leafCountSeen >= _leafDocs) {
+            _finishLeaf(_last);
+        }
     }
 
     // If we got to the end of the collection, set the last key to MaxKey.
@@ -312,9 +332,47 @@ Status DbCheckHasher::hashAll(void) {
         _last = _maxKey;
     }
 
+    if (_leafDocs > 0) {
+        if (_leafCountSeen > 0) {
+            _finishLeaf(_last);
+        } else if (!_leaves.empty()) {
+            // The last leaf ended exactly on a batch boundary; stretch it to cover the rest of
+            // the range so that a node with extra documents there still hashes them into a leaf.
+            _leaves.back().setMaxKey(_last);
+        }
+    }
+
+    while (_leaves.size() < _leafMaxKeys.size()) {
+        _finishLeaf(_leafMaxKeys[_leaves.size()]);
+    }
+
     return Status::OK();
 }
 
+void DbCheckHasher::splitLeavesEvery(int64_t leafDocs) {
+    invariant(leafDocs > 0);
+    invariant(_leafMaxKeys.empty());
+    _leafDocs = leafDocs;
+}
+
+void DbCheckHasher::splitLeavesAt(std::vector<BSONKey> leafMaxKeys) {
+    invariant(_leafDocs == 0);
+    _leafMaxKeys = std::move(leafMaxKeys);
+}
+
+void DbCheckHasher::_finishLeaf(const BSONKey& maxKey) {
+    md5digest digest;
+    md5_finish(&_leafState, digest);
+
+    DbCheckMerkleLeaf leaf;
+    leaf.setMaxKey(maxKey);
+    leaf.setMd5(digestToString(digest));
+    _leaves.push_back(std::move(leaf));
+
+    md5_init(&_leafState);
+    _leafCountSeen = 0;
+}
+
 std::string DbCheckHasher::total(void) {
     md5digest digest;
     md5_finish(&_state, digest);
@@ -334,6 +392,10 @@ int64_t DbCheckHasher::docsSeen(void) const {
     return _countSeen;
 }
 
+const std::vector<DbCheckMerkleLeaf>& DbCheckHasher::leaves(void) const {
+    return _leaves;
+}
+
 bool DbCheckHasher::_canHash(const BSONObj& obj) {
     // Make sure we hash at least one document.
     if (_countSeen == 0) {
@@ -407,6 +469,37 @@ AutoGetCollectionForDbCheck::AutoGetCollectionForDbCheck(OperationContext* opCtx
 
 namespace {
 
+std::vector<std::string> leafHashes(const std::vector<DbCheckMerkleLeaf>& leaves) {
+    std::vector<std::string> hashes;
+    hashes.reserve(leaves.size());
+    for (const auto& leaf : leaves) {
+        hashes.push_back(leaf.getMd5().toString());
+    }
+    return hashes;
+}
+
+/**
+ * Compare the primary's Merkle leaves against ours, and describe the _id range of each leaf that
+ * differs.
+ */
+std::vector<BSONObj> merkleDivergentRanges(const BSONKey& minKey,
+                                           const std::vector<DbCheckMerkleLeaf>& expected,
+                                           const std::vector<DbCheckMerkleLeaf>& found) {
+    DbCheckMerkleTree expectedTree(leafHashes(expected));
+    DbCheckMerkleTree foundTree(leafHashes(found));
+
+    std::vector<BSONObj> ranges;
+    for (auto i : expectedTree.divergentLeaves(foundTree)) {
+        const BSONKey& rangeMin = i == 0 ? minKey : expected[i - 1].getMaxKey();
+        auto foundHash = i < found.size() ? found[i].getMd5() : StringData();
+        auto hashes = expectedFound(expected[i].getMd5().toString(), foundHash.toString());
+        ranges.push_back(BSON("minKey" << rangeMin.elem() << "maxKey"
+                                       << expected[i].getMaxKey().elem() << "md5"
+                                       << hashes.second));
+    }
+    return ranges;
+}
+
 Status dbCheckBatchOnSecondary(OperationContext* opCtx,
                                const repl::OpTime& optime,
                                const DbCheckOplogBatch& entry) {
@@ -430,6 +523,15 @@ Status dbCheckBatchOnSecondary(OperationContext* opCtx,
         return Status::OK();
     }
 
+    // hash the same Merkle leaves as the primary, if it sent any,
+    if (entry.getMerkleLeaves()) {
+        std::vector<BSONKey> leafMaxKeys;
+        for (const auto& leaf : *entry.getMerkleLeaves()) {
+            leafMaxKeys.push_back(leaf.getMaxKey());
+        }
+        hasher->splitLeavesAt(std::move(leafMaxKeys));
+    }
+
     // run the hasher.
     if (status.isOK()) {
         status = hasher->hashAll();
@@ -446,6 +548,13 @@ Status dbCheckBatchOnSecondary(OperationContext* opCtx,
     std::string expected = entry.getMd5().toString();
     std::string found = hasher->total();
 
+    // and if the batch is inconsistent, descend the Merkle trees to find the divergent ranges.
+    std::vector<BSONObj> divergentRanges;
+    if (expected != found && entry.getMerkleLeaves()) {
+        divergentRanges =
+            merkleDivergentRanges(entry.getMinKey(), *entry.getMerkleLeaves(), hasher->leaves());
+    }
+
     auto logEntry = dbCheckBatchEntry(entry.getNss(),
                                       hasher->docsSeen(),
                                       hasher->bytesSeen(),
@@ -453,7 +562,8 @@ Status dbCheckBatchOnSecondary(OperationContext* opCtx,
                                       found,
                                       entry.getMinKey(),
                                       hasher->lastKey(),
-                                      optime);
+                                      optime,
+                                      divergentRanges);
 
     HealthLog::get(opCtx).log(*logEntry);
 
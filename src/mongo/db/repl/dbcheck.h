@@ -65,7 +65,8 @@ std::unique_ptr<HealthLogEntry> dbCheckBatchEntry(const NamespaceString& nss,
                                                   const std::string& foundHash,
                                                   const BSONKey& minKey,
                                                   const BSONKey& maxKey,
-                                                  const repl::OpTime& optime);
+                                                  const repl::OpTime& optime,
+                                                  const std::vector<BSONObj>& divergentRanges = {});
 
 /**
  * The collection metadata dbCheck sends between nodes.
@@ -124,6 +125,19 @@ public:
                   int64_t maxCount = std::numeric_limits<int64_t>::max(),
                   int64_t maxBytes = std::numeric_limits<int64_t>::max());
 
+    /**
+     * Additionally hash the documents as Merkle tree leaves of `leafDocs` documents each. Must be
+     * called before hashAll().
+     */
+    void splitLeavesEvery(int64_t leafDocs);
+
+    /**
+     * Additionally hash the documents as Merkle tree leaves ending at the given keys, which must
+     * be in increasing order. Leaves with no documents are hashed as empty. Must be called before
+     * hashAll().
+     */
+    void splitLeavesAt(std::vector<BSONKey> leafMaxKeys);
+
     /**
      * Hash all of our documents.
      */
@@ -145,12 +159,23 @@ public:
 
     int64_t docsSeen(void) const;
 
+    /**
+     * The Merkle tree leaves hashed so far, in key order. Empty unless one of the splitLeaves
+     * functions was called.
+     */
+    const std::vector<DbCheckMerkleLeaf>& leaves(void) const;
+
 private:
     /**
      * Can we hash `obj` without going over our limits?
      */
     bool _canHash(const BSONObj& obj);
 
+    /**
+     * Finish the current Merkle leaf, ending at `maxKey`, and start a new one.
+     */
+    void _finishLeaf(const BSONKey& maxKey);
+
     OperationContext* _opCtx;
     std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _exec;
     md5_state_t _state;
@@ -163,6 +188,13 @@ private:
 
     int64_t _maxBytes = 0;
     int64_t _bytesSeen = 0;
+
+    // Merkle leaves are cut either every `_leafDocs` documents or at `_leafMaxKeys`.
+    int64_t _leafDocs = 0;
+    std::vector<BSONKey> _leafMaxKeys;
+    md5_state_t _leafState;
+    int64_t _leafCountSeen = 0;
+    std::vector<DbCheckMerkleLeaf> _leaves;
 };
 
 /**
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/dbcheck_merkle_tree.h"
+
+#include <numeric>
+
+#include "mongo/util/md5.hpp"
+
+namespace mongo {
+
+DbCheckMerkleTree::DbCheckMerkleTree(std::vector<std::string> leaves)
+    : _numLeaves(leaves.size()) {
+    if (leaves.empty()) {
+        _levels.push_back({md5simpledigest(std::string())});
+        return;
+    }
+
+    _levels.push_back(std::move(leaves));
+    while (_levels.back().size() > 1) {
+        const auto& children = _levels.back();
+        std::vector<std::string> parents;
+        parents.reserve((children.size() + 1) / 2);
+        for (size_t i = 0; i < children.size(); i += 2) {
+            if (i + 1 < children.size()) {
+                parents.push_back(md5simpledigest(children[i] + children[i + 1]));
+            } else {
+                parents.push_back(md5simpledigest(children[i]));
+            }
+        }
+        _levels.push_back(std::move(parents));
+    }
+}
+
+const std::string& DbCheckMerkleTree::root() const {
+    return _levels.back().front();
+}
+
+size_t DbCheckMerkleTree::numLeaves() const {
+    return _numLeaves;
+}
+
+std::vector<size_t> DbCheckMerkleTree::divergentLeaves(const DbCheckMerkleTree& other) const {
+    std::vector<size_t> result;
+
+    if (numLeaves() != other.numLeaves()) {
+        result.resize(numLeaves());
+        std::iota(result.begin(), result.end(), 0);
+        return result;
+    }
+
+    if (numLeaves() > 0) {
+        _collectDivergent(other, _levels.size() - 1, 0, &result);
+    }
+    return result;
+}
+
+void DbCheckMerkleTree::_collectDivergent(const DbCheckMerkleTree& other,
+                                          size_t level,
+                                          size_t index,
+                                          std::vector<size_t>* out) const {
+    if (_levels[level][index] == other._levels[level][index]) {
+        return;
+    }
+
+    if (level == 0) {
+        out->push_back(index);
+        return;
+    }
+
+    const auto& children = _levels[level - 1];
+    for (size_t child = 2 * index; child < std::min(2 * index + 2, children.size()); ++child) {
+        _collectDivergent(other, level - 1, child, out);
+    }
+}
+
+}  // namespace mongo
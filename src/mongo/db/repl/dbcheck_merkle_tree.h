@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace mongo {
+
+/**
+ * A binary Merkle tree over the leaf hashes of a dbCheck batch.
+ *
+ * Each leaf is the MD5 of the documents in one contiguous _id range; each interior node is the MD5
+ * of the concatenation of its children's hex digests, and a node without a sibling is hashed on
+ * its own. Two trees built from the same number of leaves can be compared by descending only into
+ * subtrees whose hashes differ, which pinpoints the divergent leaf ranges without comparing every
+ * leaf.
+ */
+class DbCheckMerkleTree {
+public:
+    /**
+     * Builds a tree over the given leaf digests, which must be hex-encoded MD5 strings as produced
+     * by digestToString().
+     */
+    explicit DbCheckMerkleTree(std::vector<std::string> leaves);
+
+    /**
+     * The root hash. For a tree with no leaves, this is the MD5 of the empty string.
+     */
+    const std::string& root() const;
+
+    size_t numLeaves() const;
+
+    /**
+     * Returns the indexes, in increasing order, of the leaves whose hashes differ from `other`'s.
+     *
+     * Only subtrees whose roots differ are visited. If the trees have a different number of leaves
+     * their shapes are not comparable, and every leaf index of this tree is returned.
+     */
+    std::vector<size_t> divergentLeaves(const DbCheckMerkleTree& other) const;
+
+private:
+    void _collectDivergent(const DbCheckMerkleTree& other,
+                           size_t level,
+                           size_t index,
+                           std::vector<size_t>* out) const;
+
+    size_t _numLeaves;
+
+    // _levels[0] holds the leaves, and _levels.back() holds the single root. A tree without
+    // leaves has a single level holding the root.
+    std::vector<std::vector<std::string>> _levels;
+};
+
+}  // namespace mongo
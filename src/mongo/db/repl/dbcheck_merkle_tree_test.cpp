@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/dbcheck_merkle_tree.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/md5.hpp"
+
+namespace mongo {
+namespace {
+
+std::vector<std::string> makeLeaves(size_t n) {
+    std::vector<std::string> leaves;
+    for (size_t i = 0; i < n; ++i) {
+        leaves.push_back(md5simpledigest("leaf" + std::to_string(i)));
+    }
+    return leaves;
+}
+
+TEST(DbCheckMerkleTreeTest, EmptyTreeHasStableRoot) {
+    DbCheckMerkleTree a({});
+    DbCheckMerkleTree b({});
+    ASSERT_EQ(0U, a.numLeaves());
+    ASSERT_EQ(a.root(), b.root());
+    ASSERT(a.divergentLeaves(b).empty());
+}
+
+TEST(DbCheckMerkleTreeTest, SingleLeafRootIsLeaf) {
+    auto leaves = makeLeaves(1);
+    DbCheckMerkleTree tree(leaves);
+    ASSERT_EQ(1U, tree.numLeaves());
+    ASSERT_EQ(leaves[0], tree.root());
+}
+
+TEST(DbCheckMerkleTreeTest, IdenticalTreesHaveNoDivergentLeaves) {
+    for (size_t n : {2, 3, 7, 8, 100}) {
+        DbCheckMerkleTree a(makeLeaves(n));
+        DbCheckMerkleTree b(makeLeaves(n));
+        ASSERT_EQ(a.root(), b.root());
+        ASSERT(a.divergentLeaves(b).empty());
+    }
+}
+
+TEST(DbCheckMerkleTreeTest, FindsDivergentLeaves) {
+    for (size_t n : {2, 3, 7, 8, 100}) {
+        auto leaves = makeLeaves(n);
+        std::vector<size_t> changed{0, n / 2, n - 1};
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+        auto otherLeaves = leaves;
+        for (auto i : changed) {
+            otherLeaves[i] = md5simpledigest("changed" + std::to_string(i));
+        }
+
+        DbCheckMerkleTree a(leaves);
+        DbCheckMerkleTree b(otherLeaves);
+        ASSERT_NE(a.root(), b.root());
+        ASSERT(changed == a.divergentLeaves(b));
+        ASSERT(changed == b.divergentLeaves(a));
+    }
+}
+
+TEST(DbCheckMerkleTreeTest, DifferentShapesDivergeEverywhere) {
+    DbCheckMerkleTree a(makeLeaves(4));
+    DbCheckMerkleTree b(makeLeaves(5));
+    ASSERT_NE(a.root(), b.root());
+    ASSERT(std::vector<size_t>({0, 1, 2, 3}) == a.divergentLeaves(b));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/dbcheck.h"
+
+#include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.dbCheck");
+
+class DbCheckHasherTest : public CatalogTestFixture {
+protected:
+    void setUp() override {
+        CatalogTestFixture::setUp();
+        ASSERT_OK(storageInterface()->createCollection(operationContext(), kNss, {}));
+
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_X);
+        for (int i = 0; i < 10; ++i) {
+            WriteUnitOfWork wuow(operationContext());
+            ASSERT_OK(autoColl.getCollection()->insertDocument(
+                operationContext(), InsertStatement(BSON("_id" << i)), nullptr));
+            wuow.commit();
+        }
+    }
+
+    static BSONKey key(int id) {
+        return BSONKey::parseFromBSON(BSON("_id" << id).firstElement());
+    }
+
+    // Hashes the documents up to 'end' split at the keys of 'leaves', as a secondary does to
+    // compare its documents with the primary's leaves, and checks that the leaves match.
+    void assertSameLeavesWhenSplitAt(const std::vector<DbCheckMerkleLeaf>& leaves,
+                                     const BSONKey& end) {
+        std::vector<BSONKey> leafMaxKeys;
+        for (const auto& leaf : leaves) {
+            leafMaxKeys.push_back(leaf.getMaxKey());
+        }
+
+        AutoGetCollectionForRead autoColl(operationContext(), kNss);
+        DbCheckHasher hasher(operationContext(), autoColl.getCollection(), BSONKey::min(), end);
+        hasher.splitLeavesAt(std::move(leafMaxKeys));
+        ASSERT_OK(hasher.hashAll());
+
+        ASSERT_EQ(leaves.size(), hasher.leaves().size());
+        for (size_t i = 0; i < leaves.size(); ++i) {
+            ASSERT(leaves[i].getMaxKey() == hasher.leaves()[i].getMaxKey());
+            ASSERT_EQ(leaves[i].getMd5(), hasher.leaves()[i].getMd5());
+        }
+    }
+};
+
+TEST_F(DbCheckHasherTest, BatchCutByCountLimitFinishesPartialLeaf) {
+    AutoGetCollectionForRead autoColl(operationContext(), kNss);
+    DbCheckHasher hasher(
+        operationContext(), autoColl.getCollection(), BSONKey::min(), BSONKey::max(), 5);
+    hasher.splitLeavesEvery(2);
+    ASSERT_OK(hasher.hashAll());
+
+    // The fifth document is in a leaf of its own even though the batch ends mid-leaf
+    ASSERT_EQ(5, hasher.docsSeen());
+    ASSERT(key(4) == hasher.lastKey());
+    ASSERT_EQ(3U, hasher.leaves().size());
+    ASSERT(key(1) == hasher.leaves()[0].getMaxKey());
+    ASSERT(key(3) == hasher.leaves()[1].getMaxKey());
+    ASSERT(key(4) == hasher.leaves()[2].getMaxKey());
+
+    assertSameLeavesWhenSplitAt(hasher.leaves(), hasher.lastKey());
+}
+
+TEST_F(DbCheckHasherTest, BatchCutByByteLimitFinishesPartialLeaf) {
+    const int64_t docSize = BSON("_id" << 0).objsize();
+
+    AutoGetCollectionForRead autoColl(operationContext(), kNss);
+    DbCheckHasher hasher(operationContext(),
+                         autoColl.getCollection(),
+                         BSONKey::min(),
+                         BSONKey::max(),
+                         std::numeric_limits<int64_t>::max(),
+                         3 * docSize);
+    hasher.splitLeavesEvery(2);
+    ASSERT_OK(hasher.hashAll());
+
+    ASSERT_EQ(3, hasher.docsSeen());
+    ASSERT_EQ(2U, hasher.leaves().size());
+    ASSERT(key(1) == hasher.leaves()[0].getMaxKey());
+    ASSERT(key(2) == hasher.leaves()[1].getMaxKey());
+
+    assertSameLeavesWhenSplitAt(hasher.leaves(), hasher.lastKey());
+}
+
+}  // namespace
+}  // namespace mongo
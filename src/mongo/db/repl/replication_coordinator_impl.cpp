@@ -199,62 +199,6 @@ constexpr StringData kQuiesceModeShutdownMessage =
 
 }  // namespace
 
-void ReplicationCoordinatorImpl::WaiterList::add_inlock(const OpTime& opTime,
-                                                        SharedWaiterHandle waiter) {
-    _waiters.emplace(opTime, std::move(waiter));
-}
-
-SharedSemiFuture<void> ReplicationCoordinatorImpl::WaiterList::add_inlock(
-    const OpTime& opTime, boost::optional<WriteConcernOptions> wc) {
-    auto pf = makePromiseFuture<void>();
-    _waiters.emplace(opTime, std::make_shared<Waiter>(std::move(pf.promise), std::move(wc)));
-    return std::move(pf.future);
-}
-
-bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(SharedWaiterHandle waiter) {
-    for (auto iter = _waiters.begin(); iter != _waiters.end(); iter++) {
-        if (iter->second == waiter) {
-            _waiters.erase(iter);
-            return true;
-        }
-    }
-    return false;
-}
-
-template <typename Func>
-void ReplicationCoordinatorImpl::WaiterList::setValueIf_inlock(Func&& func,
-                                                               boost::optional<OpTime> opTime) {
-    for (auto it = _waiters.begin(); it != _waiters.end() && (!opTime || it->first <= *opTime);) {
-        const auto& waiter = it->second;
-        try {
-            if (func(it->first, waiter)) {
-                waiter->promise.emplaceValue();
-                it = _waiters.erase(it);
-            } else {
-                ++it;
-            }
-        } catch (const DBException& e) {
-            waiter->promise.setError(e.toStatus());
-            it = _waiters.erase(it);
-        }
-    }
-}
-
-void ReplicationCoordinatorImpl::WaiterList::setValueAll_inlock() {
-    for (auto& [opTime, waiter] : _waiters) {
-        waiter->promise.emplaceValue();
-    }
-    _waiters.clear();
-}
-
-void ReplicationCoordinatorImpl::WaiterList::setErrorAll_inlock(Status status) {
-    invariant(!status.isOK());
-    for (auto& [opTime, waiter] : _waiters) {
-        waiter->promise.setError(status);
-    }
-    _waiters.clear();
-}
-
 namespace {
 ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
     if (settings.usingReplSets()) {
@@ -4559,31 +4503,44 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig(WithLock lk,
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters(WithLock lk, boost::optional<OpTime> opTime) {
-    _replicationWaiterList.setValueIf_inlock(
+    // Whether a write concern is satisfied is monotonic in the opTime waited for, so the scan can
+    // stop at the first waiter of each write concern that is still waiting.
+    _replicationWaiterList.setValueIfOrdered_inlock(
         [this](const OpTime& opTime, const SharedWaiterHandle& waiter) {
             invariant(waiter->writeConcern);
             return _doneWaitingForReplication_inlock(opTime, waiter->writeConcern.get());
         },
-        opTime);
+        opTime,
+        _deferredReadyWaiters);
 }
 
 Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePositionArgs& updates,
                                                                 long long* configVersion) {
+    // Waiters released by these updates are woken after _mutex is unlocked, declared first so that
+    // this also happens if we throw.
+    WaiterList::ReadyBatch readyWaiters;
     stdx::unique_lock<Latch> lock(_mutex);
     Status status = Status::OK();
     bool somethingChanged = false;
-    for (UpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
-         update != updates.updatesEnd();
-         ++update) {
-        status = _setLastOptime(lock, *update, configVersion);
-        if (!status.isOK()) {
-            break;
+    {
+        _deferredReadyWaiters = &readyWaiters;
+        ON_BLOCK_EXIT([&] { _deferredReadyWaiters = nullptr; });
+        for (UpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
+             update != updates.updatesEnd();
+             ++update) {
+            status = _setLastOptime(lock, *update, configVersion);
+            if (!status.isOK()) {
+                break;
+            }
+            somethingChanged = true;
         }
-        somethingChanged = true;
     }
 
-    if (somethingChanged && !_getMemberState_inlock().primary()) {
-        lock.unlock();
+    const bool forwardProgress = somethingChanged && !_getMemberState_inlock().primary();
+    lock.unlock();
+    readyWaiters.release();
+
+    if (forwardProgress) {
         // Must do this outside _mutex
         _externalState->forwardSlaveProgress();
     }
@@ -44,6 +44,7 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_external_state.h"
+#include "mongo/db/repl/replication_waiter_list.h"
 #include "mongo/db/repl/sync_source_resolver.h"
 #include "mongo/db/repl/topology_coordinator.h"
 #include "mongo/db/repl/update_position_args.h"
@@ -649,37 +650,9 @@ private:
         ReplicationCoordinator::OpsKillingStateTransitionEnum _stateTransition;
     };
 
-    struct Waiter {
-        Promise<void> promise;
-        boost::optional<WriteConcernOptions> writeConcern;
-        explicit Waiter(Promise<void> p, boost::optional<WriteConcernOptions> w = boost::none)
-            : promise(std::move(p)), writeConcern(w) {}
-    };
-
-    using SharedWaiterHandle = std::shared_ptr<Waiter>;
-
-    class WaiterList {
-    public:
-        // Adds waiter into the list.
-        void add_inlock(const OpTime& opTime, SharedWaiterHandle waiter);
-        // Adds a waiter into the list and returns the future of the waiter's promise.
-        SharedSemiFuture<void> add_inlock(const OpTime& opTime,
-                                          boost::optional<WriteConcernOptions> w = boost::none);
-        // Returns whether waiter is found and removed.
-        bool remove_inlock(SharedWaiterHandle waiter);
-        // Signals all waiters whose opTime is <= the given opTime (if any) that satisfy the
-        // condition in func.
-        template <typename Func>
-        void setValueIf_inlock(Func&& func, boost::optional<OpTime> opTime = boost::none);
-        // Signals all waiters from the list and fulfills promises with OK status.
-        void setValueAll_inlock();
-        // Signals all waiters from the list and fulfills promises with Error status.
-        void setErrorAll_inlock(Status status);
-
-    private:
-        // Waiters sorted by OpTime.
-        std::multimap<OpTime, SharedWaiterHandle> _waiters;
-    };
+    using Waiter = ReplicationWaiterList::Waiter;
+    using SharedWaiterHandle = ReplicationWaiterList::SharedWaiterHandle;
+    using WaiterList = ReplicationWaiterList;
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
 
@@ -924,6 +897,9 @@ private:
     /**
      * Helper to wake waiters in _replicationWaiterList waiting for opTime <= the opTime passed in
      * (or all waiters if opTime passed in is boost::none) that are doneWaitingForReplication.
+     *
+     * If a caller up the stack has installed _deferredReadyWaiters, the released waiters are added
+     * to it so that their promises are fulfilled after _mutex is unlocked.
      */
     void _wakeReadyWaiters(WithLock lk, boost::optional<OpTime> opTime = boost::none);
 
@@ -1540,6 +1516,11 @@ private:
     // Waiters in this list are checked and notified on self's lastApplied opTime updates.
     WaiterList _opTimeWaiterList;  // (M)
 
+    // When set, waiters released from _replicationWaiterList are collected here rather than being
+    // fulfilled under _mutex. Installed for the duration of processReplSetUpdatePosition(), which
+    // moves the commit point for w:majority writers and so may release a large number of waiters.
+    WaiterList::ReadyBatch* _deferredReadyWaiters = nullptr;  // (M)
+
     // Maps a horizon name to the promise waited on by awaitable isMaster requests when the node
     // has an initialized replica set config and is an active member of the replica set.
     StringMap<std::shared_ptr<SharedPromiseOfIsMasterResponse>>
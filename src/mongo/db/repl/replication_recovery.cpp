@@ -35,6 +35,9 @@
 
 #include "mongo/db/repl/replication_recovery.h"
 
+#include <deque>
+
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -44,6 +47,7 @@
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/oplog_interface_local.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
@@ -53,6 +57,10 @@
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -250,6 +258,116 @@ boost::optional<Timestamp> recoverFromOplogPrecursor(OperationContext* opCtx,
     return recoveryTS;
 }
 
+/**
+ * Reads batches of oplog entries from an OplogBuffer on its own thread, staying up to
+ * 'maxBatchesAhead' batches ahead of the caller. This overlaps the single-threaded scan of the
+ * local oplog with the parallel application of the previous batch by the writer pool.
+ *
+ * The OplogBuffer is started up and shut down on the reader thread, which owns the
+ * OperationContext the buffer's cursor is bound to.
+ */
+class RecoveryOplogBatchPrefetcher {
+    RecoveryOplogBatchPrefetcher(const RecoveryOplogBatchPrefetcher&) = delete;
+    RecoveryOplogBatchPrefetcher& operator=(const RecoveryOplogBatchPrefetcher&) = delete;
+
+public:
+    RecoveryOplogBatchPrefetcher(OplogApplier* oplogApplier,
+                                 OplogBuffer* oplogBuffer,
+                                 OplogApplier::BatchLimits batchLimits,
+                                 std::size_t maxBatchesAhead)
+        : _oplogApplier(oplogApplier),
+          _oplogBuffer(oplogBuffer),
+          _batchLimits(std::move(batchLimits)),
+          _maxBatchesAhead(maxBatchesAhead) {
+        invariant(_maxBatchesAhead > 0);
+        _thread = stdx::thread([this] { _run(); });
+    }
+
+    ~RecoveryOplogBatchPrefetcher() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _inShutdown = true;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    /**
+     * Returns the next batch to apply. An empty batch means the oplog buffer is exhausted. Throws
+     * if the reader thread failed.
+     */
+    std::vector<OplogEntry> getNextBatch() {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cv.wait(lk, [&] { return !_batches.empty() || !_status.isOK(); });
+        uassertStatusOK(_status);
+
+        auto batch = std::move(_batches.front());
+        _batches.pop_front();
+        _cv.notify_all();
+        return batch;
+    }
+
+    /**
+     * Whether the oplog buffer was empty when the reader thread produced its final, empty batch.
+     * Only meaningful once getNextBatch() has returned an empty batch.
+     */
+    bool bufferWasEmpty() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _bufferWasEmpty;
+    }
+
+private:
+    void _run() {
+        Client::initThread("ReplRecoveryOplogReader");
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+        auto opCtx = cc().makeOperationContext();
+
+        try {
+            // The buffer's cursor must not outlive this thread's OperationContext.
+            ON_BLOCK_EXIT([&] { _oplogBuffer->shutdown(opCtx.get()); });
+            _oplogBuffer->startup(opCtx.get());
+
+            bool exhausted = false;
+            while (!exhausted) {
+                auto batch =
+                    fassert(50764, _oplogApplier->getNextApplierBatch(opCtx.get(), _batchLimits));
+                exhausted = batch.empty();
+
+                const bool bufferWasEmpty = exhausted && _oplogBuffer->isEmpty();
+
+                stdx::unique_lock<Latch> lk(_mutex);
+                _cv.wait(lk, [&] { return _inShutdown || _batches.size() < _maxBatchesAhead; });
+                if (_inShutdown) {
+                    break;
+                }
+                _bufferWasEmpty = bufferWasEmpty;
+                _batches.push_back(std::move(batch));
+                _cv.notify_all();
+            }
+        } catch (const DBException& ex) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _status = ex.toStatus();
+            _cv.notify_all();
+        }
+    }
+
+    OplogApplier* const _oplogApplier;
+    OplogBuffer* const _oplogBuffer;
+    const OplogApplier::BatchLimits _batchLimits;
+    const std::size_t _maxBatchesAhead;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("RecoveryOplogBatchPrefetcher::_mutex");
+    stdx::condition_variable _cv;
+
+    // Batches read but not yet handed out, in oplog order.
+    std::deque<std::vector<OplogEntry>> _batches;
+    bool _bufferWasEmpty = false;
+    bool _inShutdown = false;
+    Status _status = Status::OK();
+
+    stdx::thread _thread;
+};
+
 }  // namespace
 
 ReplicationRecoveryImpl::ReplicationRecoveryImpl(StorageInterface* storageInterface,
@@ -581,7 +699,6 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
           "endPoint"_attr = endPoint);
 
     OplogBufferLocalOplog oplogBuffer(startPoint, endPoint);
-    oplogBuffer.startup(opCtx);
 
     RecoveryOplogApplierStats stats;
 
@@ -601,16 +718,31 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
 
     OpTime applyThroughOpTime;
     std::vector<OplogEntry> batch;
-    while (
-        !(batch = fassert(50763, oplogApplier.getNextApplierBatch(opCtx, batchLimits))).empty()) {
-        applyThroughOpTime = uassertStatusOK(oplogApplier.applyOplogBatch(opCtx, std::move(batch)));
+    bool bufferWasEmpty = false;
+    const auto batchesAhead = recoveryOplogPrefetchBatches.load();
+    if (batchesAhead > 0) {
+        RecoveryOplogBatchPrefetcher prefetcher(
+            &oplogApplier, &oplogBuffer, batchLimits, static_cast<std::size_t>(batchesAhead));
+        while (!(batch = prefetcher.getNextBatch()).empty()) {
+            applyThroughOpTime =
+                uassertStatusOK(oplogApplier.applyOplogBatch(opCtx, std::move(batch)));
+        }
+        bufferWasEmpty = prefetcher.bufferWasEmpty();
+    } else {
+        oplogBuffer.startup(opCtx);
+        while (!(batch = fassert(50763, oplogApplier.getNextApplierBatch(opCtx, batchLimits)))
+                    .empty()) {
+            applyThroughOpTime =
+                uassertStatusOK(oplogApplier.applyOplogBatch(opCtx, std::move(batch)));
+        }
+        bufferWasEmpty = oplogBuffer.isEmpty();
+        oplogBuffer.shutdown(opCtx);
     }
     stats.complete(applyThroughOpTime);
-    invariant(oplogBuffer.isEmpty(),
+    invariant(bufferWasEmpty,
               str::stream() << "Oplog buffer not empty after applying operations. Last operation "
                                "applied with optime: "
                             << applyThroughOpTime.toBSON());
-    oplogBuffer.shutdown(opCtx);
 
     // The applied up to timestamp will be null if no oplog entries were applied.
     if (applyThroughOpTime.isNull()) {
@@ -44,6 +44,7 @@
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/oplog_interface_local.h"
 #include "mongo/db/repl/replication_consistency_markers_mock.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/replication_recovery.h"
 #include "mongo/db/repl/storage_interface_impl.h"
@@ -56,6 +57,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace {
@@ -1290,6 +1292,34 @@ TEST_F(ReplicationRecoveryTest, RecoverFromOplogUpToEndOfOplog) {
     ASSERT_EQ(getConsistencyMarkers()->getAppliedThrough(opCtx), OpTime(Timestamp(10, 10), 1));
 }
 
+TEST_F(ReplicationRecoveryTest, RecoverFromOplogUpToInSingleOpBatchesWithPrefetch) {
+    const auto originalBatchLimit = replBatchLimitOperations.load();
+    const auto originalPrefetch = recoveryOplogPrefetchBatches.load();
+    ON_BLOCK_EXIT([&] {
+        replBatchLimitOperations.store(originalBatchLimit);
+        recoveryOplogPrefetchBatches.store(originalPrefetch);
+    });
+
+    ReplicationRecoveryImpl recovery(getStorageInterface(), getConsistencyMarkers());
+    auto opCtx = getOperationContext();
+
+    _setUpOplog(opCtx, getStorageInterface(), {2, 3, 4, 5, 6, 7, 8, 9, 10});
+    getStorageInterfaceRecovery()->setRecoveryTimestamp(Timestamp(2, 2));
+
+    // Read several single-operation batches ahead of the applier.
+    replBatchLimitOperations.store(1);
+    recoveryOplogPrefetchBatches.store(3);
+    recovery.recoverFromOplogUpTo(opCtx, Timestamp(6, 6));
+    _assertDocsInTestCollection(opCtx, {3, 4, 5, 6});
+    ASSERT_EQ(getConsistencyMarkers()->getAppliedThrough(opCtx), OpTime(Timestamp(6, 6), 1));
+
+    // Without prefetching, each batch is read only after the previous one has been applied.
+    recoveryOplogPrefetchBatches.store(0);
+    recovery.recoverFromOplogUpTo(opCtx, Timestamp(10, 10));
+    _assertDocsInTestCollection(opCtx, {3, 4, 5, 6, 7, 8, 9, 10});
+    ASSERT_EQ(getConsistencyMarkers()->getAppliedThrough(opCtx), OpTime(Timestamp(10, 10), 1));
+}
+
 TEST_F(ReplicationRecoveryTest, RecoverFromOplogUpToInvalidEndPoint) {
     ReplicationRecoveryImpl recovery(getStorageInterface(), getConsistencyMarkers());
     auto opCtx = getOperationContext();
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/replication_waiter_list.h"
+
+namespace mongo {
+namespace repl {
+
+ReplicationWaiterList::ReadyBatch::~ReadyBatch() {
+    release();
+}
+
+void ReplicationWaiterList::ReadyBatch::add(SharedWaiterHandle waiter, Status status) {
+    _waiters.emplace_back(std::move(waiter), std::move(status));
+}
+
+void ReplicationWaiterList::ReadyBatch::release() {
+    auto waiters = std::exchange(_waiters, {});
+    for (auto& [waiter, status] : waiters) {
+        if (status.isOK()) {
+            waiter->promise.emplaceValue();
+        } else {
+            waiter->promise.setError(std::move(status));
+        }
+    }
+}
+
+ReplicationWaiterList::WriteConcernKey ReplicationWaiterList::_keyFor(
+    const boost::optional<WriteConcernOptions>& wc) {
+    if (!wc) {
+        return {false, "", 0, 0, 0};
+    }
+    return {true,
+            wc->wMode,
+            wc->wNumNodes,
+            static_cast<int>(wc->syncMode),
+            static_cast<int>(wc->checkCondition)};
+}
+
+void ReplicationWaiterList::_add(const OpTime& opTime,
+                                 SharedWaiterHandle waiter,
+                                 bool deferrable) {
+    auto key = _keyFor(waiter->writeConcern);
+    _waiters[std::move(key)].emplace(opTime, Entry{std::move(waiter), deferrable});
+    ++_numWaiters;
+}
+
+void ReplicationWaiterList::_release(const Entry& entry, Status status, ReadyBatch* batch) {
+    if (batch && entry.deferrable) {
+        batch->add(entry.waiter, std::move(status));
+    } else if (status.isOK()) {
+        entry.waiter->promise.emplaceValue();
+    } else {
+        entry.waiter->promise.setError(std::move(status));
+    }
+}
+
+void ReplicationWaiterList::add_inlock(const OpTime& opTime, SharedWaiterHandle waiter) {
+    _add(opTime, std::move(waiter), false /* deferrable */);
+}
+
+SharedSemiFuture<void> ReplicationWaiterList::add_inlock(const OpTime& opTime,
+                                                         boost::optional<WriteConcernOptions> wc) {
+    auto pf = makePromiseFuture<void>();
+    _add(opTime,
+         std::make_shared<Waiter>(std::move(pf.promise), std::move(wc)),
+         true /* deferrable */);
+    return std::move(pf.future);
+}
+
+bool ReplicationWaiterList::remove_inlock(SharedWaiterHandle waiter) {
+    auto groupIt = _waiters.find(_keyFor(waiter->writeConcern));
+    if (groupIt == _waiters.end()) {
+        return false;
+    }
+    auto& group = groupIt->second;
+    for (auto iter = group.begin(); iter != group.end(); iter++) {
+        if (iter->second.waiter == waiter) {
+            group.erase(iter);
+            --_numWaiters;
+            if (group.empty()) {
+                _waiters.erase(groupIt);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReplicationWaiterList::setValueAll_inlock() {
+    for (auto& [key, group] : _waiters) {
+        for (auto& [opTime, entry] : group) {
+            entry.waiter->promise.emplaceValue();
+        }
+    }
+    _waiters.clear();
+    _numWaiters = 0;
+}
+
+void ReplicationWaiterList::setErrorAll_inlock(Status status) {
+    invariant(!status.isOK());
+    for (auto& [key, group] : _waiters) {
+        for (auto& [opTime, entry] : group) {
+            entry.waiter->promise.setError(status);
+        }
+    }
+    _waiters.clear();
+    _numWaiters = 0;
+}
+
+}  // namespace repl
+}  // namespace mongo
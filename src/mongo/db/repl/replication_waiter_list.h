@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/write_concern_options.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/future.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * The lists of waiters ReplicationCoordinatorImpl uses to wait for opTimes to be replicated or
+ * applied.
+ *
+ * Waiters are grouped by the replication progress that satisfies them (their write concern) and
+ * ordered by OpTime within each group. When the condition waited on is monotonic in the OpTime, as
+ * replication progress is, waking the ready waiters only visits the waiters that are released plus
+ * one per group, instead of every waiter below the new OpTime.
+ *
+ * This class does not provide synchronization. Callers serialize access with their own mutex, which
+ * is what the _inlock suffixes refer to.
+ */
+class ReplicationWaiterList {
+public:
+    struct Waiter {
+        Promise<void> promise;
+        boost::optional<WriteConcernOptions> writeConcern;
+        explicit Waiter(Promise<void> p, boost::optional<WriteConcernOptions> w = boost::none)
+            : promise(std::move(p)), writeConcern(w) {}
+    };
+
+    using SharedWaiterHandle = std::shared_ptr<Waiter>;
+
+    /**
+     * Waiters that have been removed from a list but whose promises have not been fulfilled yet.
+     *
+     * Fulfilling a promise wakes the thread blocked on its future, so releasing thousands of
+     * waiters at once is better done after the caller has dropped the mutex protecting the list.
+     * Waiters still in the batch when it is destroyed are released then.
+     */
+    class ReadyBatch {
+    public:
+        ReadyBatch() = default;
+        ReadyBatch(const ReadyBatch&) = delete;
+        ReadyBatch& operator=(const ReadyBatch&) = delete;
+        ~ReadyBatch();
+
+        void add(SharedWaiterHandle waiter, Status status);
+
+        /**
+         * Fulfills the promises of all waiters in the batch, with OK or with the error they were
+         * added with, and empties the batch.
+         */
+        void release();
+
+        size_t size() const {
+            return _waiters.size();
+        }
+
+    private:
+        std::vector<std::pair<SharedWaiterHandle, Status>> _waiters;
+    };
+
+    // Adds waiter into the list. The waiter's promise may have continuations that rely on the
+    // caller's mutex, so it is always fulfilled inline and never deferred into a ReadyBatch.
+    void add_inlock(const OpTime& opTime, SharedWaiterHandle waiter);
+    // Adds a waiter into the list and returns the future of the waiter's promise.
+    SharedSemiFuture<void> add_inlock(const OpTime& opTime,
+                                      boost::optional<WriteConcernOptions> w = boost::none);
+    // Returns whether waiter is found and removed.
+    bool remove_inlock(SharedWaiterHandle waiter);
+    // Signals all waiters whose opTime is <= the given opTime (if any) that satisfy the
+    // condition in func. If 'batch' is given, the waiters added through the future-returning
+    // add_inlock() are moved into it instead of being fulfilled inline.
+    template <typename Func>
+    void setValueIf_inlock(Func&& func,
+                           boost::optional<OpTime> opTime = boost::none,
+                           ReadyBatch* batch = nullptr);
+    // Same as setValueIf_inlock(), for a func that is monotonic in the waiter's opTime among
+    // waiters with the same write concern: once a waiter does not satisfy it, no later waiter with
+    // that write concern does either, so the scan of each group stops there.
+    template <typename Func>
+    void setValueIfOrdered_inlock(Func&& func,
+                                  boost::optional<OpTime> opTime = boost::none,
+                                  ReadyBatch* batch = nullptr);
+    // Signals all waiters from the list and fulfills promises with OK status.
+    void setValueAll_inlock();
+    // Signals all waiters from the list and fulfills promises with Error status.
+    void setErrorAll_inlock(Status status);
+    // Returns the number of waiters in the list.
+    size_t size_inlock() const {
+        return _numWaiters;
+    }
+
+private:
+    // The write concern fields that decide whether a waiter is satisfied: whether there is a write
+    // concern at all, wMode, wNumNodes, syncMode and checkCondition.
+    using WriteConcernKey = std::tuple<bool, std::string, int, int, int>;
+
+    struct Entry {
+        SharedWaiterHandle waiter;
+        // Whether the waiter may be fulfilled after the caller's mutex is released.
+        bool deferrable;
+    };
+
+    // Waiters sorted by OpTime.
+    using OrderedWaiters = std::multimap<OpTime, Entry>;
+
+    static WriteConcernKey _keyFor(const boost::optional<WriteConcernOptions>& wc);
+
+    void _add(const OpTime& opTime, SharedWaiterHandle waiter, bool deferrable);
+
+    static void _release(const Entry& entry, Status status, ReadyBatch* batch);
+
+    template <typename Func>
+    void _setValueIf(Func&& func,
+                     const boost::optional<OpTime>& opTime,
+                     ReadyBatch* batch,
+                     bool stopAtFirstUnsatisfied);
+
+    std::map<WriteConcernKey, OrderedWaiters> _waiters;
+    size_t _numWaiters = 0;
+};
+
+template <typename Func>
+void ReplicationWaiterList::setValueIf_inlock(Func&& func,
+                                              boost::optional<OpTime> opTime,
+                                              ReadyBatch* batch) {
+    _setValueIf(std::forward<Func>(func), opTime, batch, false /* stopAtFirstUnsatisfied */);
+}
+
+template <typename Func>
+void ReplicationWaiterList::setValueIfOrdered_inlock(Func&& func,
+                                                     boost::optional<OpTime> opTime,
+                                                     ReadyBatch* batch) {
+    _setValueIf(std::forward<Func>(func), opTime, batch, true /* stopAtFirstUnsatisfied */);
+}
+
+template <typename Func>
+void ReplicationWaiterList::_setValueIf(Func&& func,
+                                        const boost::optional<OpTime>& opTime,
+                                        ReadyBatch* batch,
+                                        bool stopAtFirstUnsatisfied) {
+    for (auto groupIt = _waiters.begin(); groupIt != _waiters.end();) {
+        auto& group = groupIt->second;
+        for (auto it = group.begin(); it != group.end() && (!opTime || it->first <= *opTime);) {
+            const auto& entry = it->second;
+            try {
+                if (func(it->first, entry.waiter)) {
+                    _release(entry, Status::OK(), batch);
+                } else if (stopAtFirstUnsatisfied) {
+                    break;
+                } else {
+                    ++it;
+                    continue;
+                }
+            } catch (const DBException& e) {
+                _release(entry, e.toStatus(), batch);
+            }
+            it = group.erase(it);
+            --_numWaiters;
+        }
+        groupIt = group.empty() ? _waiters.erase(groupIt) : std::next(groupIt);
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/repl/replication_waiter_list.h"
+#include "mongo/platform/mutex.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const WriteConcernOptions kMajority(WriteConcernOptions::kMajority,
+                                    WriteConcernOptions::SyncMode::NONE,
+                                    WriteConcernOptions::kNoTimeout);
+
+// How far the commit point moves on each simulated replSetUpdatePosition, in waiters.
+constexpr int kWaitersPerAdvance = 64;
+
+OpTime opTimeAt(int i) {
+    return OpTime(Timestamp(1, i + 1), 1);
+}
+
+/**
+ * Simulates 'state.range(0)' w:majority writers waiting on increasing opTimes while the commit
+ * point advances through them. As in ReplicationCoordinatorImpl::_setLastOptime(), every update
+ * considers the waiters up to the position the secondary reported, which is ahead of all of them,
+ * and only those at or below the commit point are ready.
+ */
+template <typename Wake>
+void runCommitPointAdvance(benchmark::State& state, Wake&& wake) {
+    const int numWaiters = state.range(0);
+    auto mutex = MONGO_MAKE_LATCH();
+    ReplicationWaiterList waiters;
+    std::vector<SharedSemiFuture<void>> futures;
+    futures.reserve(numWaiters);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        futures.clear();
+        for (int i = 0; i < numWaiters; ++i) {
+            futures.push_back(waiters.add_inlock(opTimeAt(i), kMajority));
+        }
+        state.ResumeTiming();
+
+        const auto secondaryPosition = opTimeAt(numWaiters);
+        for (int commitPoint = 0; commitPoint < numWaiters; commitPoint += kWaitersPerAdvance) {
+            const auto committed = opTimeAt(commitPoint);
+            auto isReady = [&](const OpTime& opTime, const auto&) { return opTime <= committed; };
+            wake(mutex, waiters, isReady, secondaryPosition);
+        }
+
+        state.PauseTiming();
+        waiters.setValueAll_inlock();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * numWaiters);
+}
+
+// The previous behavior: walk every waiter up to the reported position, fulfilling under the mutex.
+void BM_CommitPointAdvanceScanAll(benchmark::State& state) {
+    runCommitPointAdvance(state, [](auto& mutex, auto& waiters, auto& isReady, auto& position) {
+        stdx::lock_guard<Latch> lk(mutex);
+        waiters.setValueIf_inlock(isReady, position);
+    });
+}
+
+// Stop at the first waiter that is not ready, fulfilling under the mutex.
+void BM_CommitPointAdvanceOrdered(benchmark::State& state) {
+    runCommitPointAdvance(state, [](auto& mutex, auto& waiters, auto& isReady, auto& position) {
+        stdx::lock_guard<Latch> lk(mutex);
+        waiters.setValueIfOrdered_inlock(isReady, position);
+    });
+}
+
+// Stop at the first waiter that is not ready, fulfilling the batch after unlocking the mutex.
+void BM_CommitPointAdvanceOrderedBatched(benchmark::State& state) {
+    runCommitPointAdvance(state, [](auto& mutex, auto& waiters, auto& isReady, auto& position) {
+        ReplicationWaiterList::ReadyBatch batch;
+        stdx::unique_lock<Latch> lk(mutex);
+        waiters.setValueIfOrdered_inlock(isReady, position, &batch);
+        lk.unlock();
+        batch.release();
+    });
+}
+
+BENCHMARK(BM_CommitPointAdvanceScanAll)->Range(1 << 10, 20 << 10);
+BENCHMARK(BM_CommitPointAdvanceOrdered)->Range(1 << 10, 20 << 10);
+BENCHMARK(BM_CommitPointAdvanceOrderedBatched)->Range(1 << 10, 20 << 10);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/replication_waiter_list.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const WriteConcernOptions kMajority(WriteConcernOptions::kMajority,
+                                    WriteConcernOptions::SyncMode::NONE,
+                                    WriteConcernOptions::kNoTimeout);
+const WriteConcernOptions kW2(2,
+                              WriteConcernOptions::SyncMode::NONE,
+                              WriteConcernOptions::kNoTimeout);
+
+OpTime opTimeAt(unsigned int secs) {
+    return OpTime(Timestamp(secs, 1), 1);
+}
+
+TEST(ReplicationWaiterListTest, SetValueIfReleasesWaitersUpToOpTime) {
+    ReplicationWaiterList waiters;
+    auto f1 = waiters.add_inlock(opTimeAt(1), kMajority);
+    auto f2 = waiters.add_inlock(opTimeAt(2), kMajority);
+    auto f3 = waiters.add_inlock(opTimeAt(3), kMajority);
+    ASSERT_EQ(3U, waiters.size_inlock());
+
+    waiters.setValueIf_inlock([](const OpTime&, const auto&) { return true; }, opTimeAt(2));
+
+    ASSERT_TRUE(f1.isReady());
+    ASSERT_TRUE(f2.isReady());
+    ASSERT_FALSE(f3.isReady());
+    ASSERT_EQ(1U, waiters.size_inlock());
+}
+
+TEST(ReplicationWaiterListTest, OrderedScanStopsAtFirstUnsatisfiedWaiterOfEachWriteConcern) {
+    ReplicationWaiterList waiters;
+    auto majority1 = waiters.add_inlock(opTimeAt(1), kMajority);
+    auto majority2 = waiters.add_inlock(opTimeAt(2), kMajority);
+    auto majority3 = waiters.add_inlock(opTimeAt(3), kMajority);
+    auto w2First = waiters.add_inlock(opTimeAt(1), kW2);
+    auto w2Second = waiters.add_inlock(opTimeAt(4), kW2);
+
+    std::vector<OpTime> majorityChecked;
+    waiters.setValueIfOrdered_inlock(
+        [&](const OpTime& opTime, const ReplicationWaiterList::SharedWaiterHandle& waiter) {
+            if (waiter->writeConcern->wMode == WriteConcernOptions::kMajority) {
+                majorityChecked.push_back(opTime);
+                return opTime <= opTimeAt(1);
+            }
+            return true;
+        });
+
+    // The majority waiters after the first unsatisfied one are not looked at.
+    ASSERT_EQ(2U, majorityChecked.size());
+    ASSERT_TRUE(majority1.isReady());
+    ASSERT_FALSE(majority2.isReady());
+    ASSERT_FALSE(majority3.isReady());
+    // Other write concerns are still scanned.
+    ASSERT_TRUE(w2First.isReady());
+    ASSERT_TRUE(w2Second.isReady());
+    ASSERT_EQ(2U, waiters.size_inlock());
+}
+
+TEST(ReplicationWaiterListTest, ThrowingConditionFailsOnlyThatWaiter) {
+    ReplicationWaiterList waiters;
+    auto f1 = waiters.add_inlock(opTimeAt(1), kMajority);
+    auto f2 = waiters.add_inlock(opTimeAt(2), kMajority);
+
+    waiters.setValueIf_inlock([](const OpTime& opTime, const auto&) {
+        uassert(ErrorCodes::UnsatisfiableWriteConcern, "test", opTime != opTimeAt(1));
+        return false;
+    });
+
+    ASSERT_EQ(ErrorCodes::UnsatisfiableWriteConcern, f1.getNoThrow());
+    ASSERT_FALSE(f2.isReady());
+    ASSERT_EQ(1U, waiters.size_inlock());
+}
+
+TEST(ReplicationWaiterListTest, ReadyBatchDefersFutureWaitersUntilReleased) {
+    ReplicationWaiterList waiters;
+    auto deferred = waiters.add_inlock(opTimeAt(1), kMajority);
+
+    // Waiters added by handle may rely on the caller's mutex and are fulfilled inline.
+    auto pf = makePromiseFuture<void>();
+    waiters.add_inlock(opTimeAt(1),
+                       std::make_shared<ReplicationWaiterList::Waiter>(std::move(pf.promise),
+                                                                       kMajority));
+
+    ReplicationWaiterList::ReadyBatch batch;
+    waiters.setValueIfOrdered_inlock(
+        [](const OpTime&, const auto&) { return true; }, boost::none, &batch);
+
+    ASSERT_EQ(0U, waiters.size_inlock());
+    ASSERT_EQ(1U, batch.size());
+    ASSERT_TRUE(pf.future.isReady());
+    ASSERT_FALSE(deferred.isReady());
+
+    batch.release();
+    ASSERT_EQ(0U, batch.size());
+    ASSERT_TRUE(deferred.isReady());
+}
+
+TEST(ReplicationWaiterListTest, RemoveAndSetErrorAll) {
+    ReplicationWaiterList waiters;
+    auto pf = makePromiseFuture<void>();
+    auto handle = std::make_shared<ReplicationWaiterList::Waiter>(std::move(pf.promise));
+    waiters.add_inlock(opTimeAt(1), handle);
+    auto other = waiters.add_inlock(opTimeAt(1));
+
+    ASSERT_TRUE(waiters.remove_inlock(handle));
+    ASSERT_FALSE(waiters.remove_inlock(handle));
+    ASSERT_EQ(1U, waiters.size_inlock());
+
+    waiters.setErrorAll_inlock({ErrorCodes::InterruptedAtShutdown, "test"});
+    ASSERT_EQ(ErrorCodes::InterruptedAtShutdown, other.getNoThrow());
+    ASSERT_FALSE(pf.future.isReady());
+    ASSERT_EQ(0U, waiters.size_inlock());
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -172,13 +172,18 @@ void WaitForMajorityService::_periodicallyWaitForMajority(ServiceContext* servic
                 continue;
             }
 
+            // Fulfilling the promise wakes every caller waiting on this opTime, so do it after
+            // releasing _mutex to let new requests be queued in the meantime.
+            auto request = _queuedOpTimes.extract(lowestOpTimeIter);
+            lk.unlock();
+
             if (status.isOK()) {
-                lowestOpTimeIter->second.emplaceValue();
+                request.mapped().emplaceValue();
             } else {
-                lowestOpTimeIter->second.setError(status);
+                request.mapped().setError(status);
             }
 
-            _queuedOpTimes.erase(lowestOpTimeIter);
+            lk.lock();
         }
 
         try {
@@ -37,6 +37,7 @@
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/migration_source_manager.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
 
@@ -50,7 +51,7 @@ const auto getRegistry = ServiceContext::declareDecoration<ActiveMigrationsRegis
 ActiveMigrationsRegistry::ActiveMigrationsRegistry() = default;
 
 ActiveMigrationsRegistry::~ActiveMigrationsRegistry() {
-    invariant(!_activeMoveChunkState);
+    invariant(_activeMoveChunkStates.empty());
 }
 
 ActiveMigrationsRegistry& ActiveMigrationsRegistry::get(ServiceContext* service) {
@@ -74,7 +75,9 @@ void ActiveMigrationsRegistry::lock(OperationContext* opCtx, StringData reason)
 
     // Wait for any ongoing migrations to complete.
     opCtx->waitForConditionOrInterrupt(
-        _lockCond, lock, [this] { return !(_activeMoveChunkState || _activeReceiveChunkState); });
+        _lockCond, lock, [this] {
+            return _activeMoveChunkStates.empty() && !_activeReceiveChunkState;
+        });
 }
 
 void ActiveMigrationsRegistry::unlock(StringData reason) {
@@ -99,17 +102,31 @@ StatusWith<ScopedDonateChunk> ActiveMigrationsRegistry::registerDonateChunk(
         return _activeReceiveChunkState->constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        if (_activeMoveChunkState->args == args) {
-            return {ScopedDonateChunk(nullptr, false, _activeMoveChunkState->notification)};
+    const auto it = _activeMoveChunkStates.find(args.getNss());
+    if (it != _activeMoveChunkStates.end()) {
+        if (it->second.args == args) {
+            return {ScopedDonateChunk(nullptr, args.getNss(), false, it->second.notification)};
         }
 
-        return _activeMoveChunkState->constructErrorStatus();
+        return it->second.constructErrorStatus();
     }
 
-    _activeMoveChunkState.emplace(args);
+    for (const auto& [nss, activeMoveChunkState] : _activeMoveChunkStates) {
+        // The recipient would reject the second migration anyway, so fail it before it starts
+        if (activeMoveChunkState.args.getToShardId() == args.getToShardId()) {
+            return activeMoveChunkState.constructErrorStatus();
+        }
+    }
+
+    if (!_activeMoveChunkStates.empty() &&
+        _activeMoveChunkStates.size() >=
+            static_cast<size_t>(maxConcurrentChunkDonations.load())) {
+        return _activeMoveChunkStates.begin()->second.constructErrorStatus();
+    }
+
+    const auto inserted = _activeMoveChunkStates.emplace(args.getNss(), args).first;
 
-    return {ScopedDonateChunk(this, true, _activeMoveChunkState->notification)};
+    return {ScopedDonateChunk(this, args.getNss(), true, inserted->second.notification)};
 }
 
 StatusWith<ScopedReceiveChunk> ActiveMigrationsRegistry::registerReceiveChunk(
@@ -128,8 +145,8 @@ StatusWith<ScopedReceiveChunk> ActiveMigrationsRegistry::registerReceiveChunk(
         return _activeReceiveChunkState->constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->constructErrorStatus();
+    if (!_activeMoveChunkStates.empty()) {
+        return _activeMoveChunkStates.begin()->second.constructErrorStatus();
     }
 
     _activeReceiveChunkState.emplace(nss, chunkRange, fromShardId);
@@ -137,47 +154,44 @@ StatusWith<ScopedReceiveChunk> ActiveMigrationsRegistry::registerReceiveChunk(
     return {ScopedReceiveChunk(this)};
 }
 
-boost::optional<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNss() {
+std::vector<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNamespaces() {
     stdx::lock_guard<Latch> lk(_mutex);
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->args.getNss();
+
+    std::vector<NamespaceString> namespaces;
+    namespaces.reserve(_activeMoveChunkStates.size());
+    for (const auto& activeMoveChunkState : _activeMoveChunkStates) {
+        namespaces.push_back(activeMoveChunkState.first);
     }
 
-    return boost::none;
+    return namespaces;
 }
 
-BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContext* opCtx) {
-    boost::optional<NamespaceString> nss;
-    {
-        stdx::lock_guard<Latch> lk(_mutex);
-
-        if (_activeMoveChunkState) {
-            nss = _activeMoveChunkState->args.getNss();
-        }
-    }
+std::vector<BSONObj> ActiveMigrationsRegistry::getActiveMigrationStatusReports(
+    OperationContext* opCtx) {
+    const auto namespaces = getActiveDonateChunkNamespaces();
 
-    // The state of the MigrationSourceManager could change between taking and releasing the mutex
-    // above and then taking the collection lock here, but that's fine because it isn't important to
-    // return information on a migration that just ended or started. This is just best effort and
-    // desireable for reporting, and then diagnosing, migrations that are stuck.
-    if (nss) {
+    // The state of the MigrationSourceManagers could change between taking and releasing the mutex
+    // above and then taking the collection locks here, but that's fine because it isn't important
+    // to return information on a migration that just ended or started. This is just best effort
+    // and desireable for reporting, and then diagnosing, migrations that are stuck.
+    std::vector<BSONObj> reports;
+    for (const auto& nss : namespaces) {
         // Lock the collection so nothing changes while we're getting the migration report.
-        AutoGetCollection autoColl(opCtx, nss.get(), MODE_IS);
-        auto csr = CollectionShardingRuntime::get(opCtx, nss.get());
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        auto csr = CollectionShardingRuntime::get(opCtx, nss);
         auto csrLock = CollectionShardingRuntime::CSRLock::lockShared(opCtx, csr);
 
         if (auto msm = MigrationSourceManager::get(csr, csrLock)) {
-            return msm->getMigrationStatusReport();
+            reports.push_back(msm->getMigrationStatusReport());
         }
     }
 
-    return BSONObj();
+    return reports;
 }
 
-void ActiveMigrationsRegistry::_clearDonateChunk() {
+void ActiveMigrationsRegistry::_clearDonateChunk(const NamespaceString& nss) {
     stdx::lock_guard<Latch> lk(_mutex);
-    invariant(_activeMoveChunkState);
-    _activeMoveChunkState.reset();
+    invariant(_activeMoveChunkStates.erase(nss));
     _lockCond.notify_all();
 }
 
@@ -206,9 +220,11 @@ Status ActiveMigrationsRegistry::ActiveReceiveChunkState::constructErrorStatus()
 }
 
 ScopedDonateChunk::ScopedDonateChunk(ActiveMigrationsRegistry* registry,
+                                     NamespaceString nss,
                                      bool shouldExecute,
                                      std::shared_ptr<Notification<Status>> completionNotification)
     : _registry(registry),
+      _nss(std::move(nss)),
       _shouldExecute(shouldExecute),
       _completionNotification(std::move(completionNotification)) {}
 
@@ -216,7 +232,7 @@ ScopedDonateChunk::~ScopedDonateChunk() {
     if (_registry && _shouldExecute) {
         // If this is a newly started migration the caller must always signal on completion
         invariant(*_completionNotification);
-        _registry->_clearDonateChunk();
+        _registry->_clearDonateChunk(_nss);
     }
 }
 
@@ -228,6 +244,7 @@ ScopedDonateChunk& ScopedDonateChunk::operator=(ScopedDonateChunk&& other) {
     if (&other != this) {
         _registry = other._registry;
         other._registry = nullptr;
+        _nss = std::move(other._nss);
         _shouldExecute = other._shouldExecute;
         _completionNotification = std::move(other._completionNotification);
     }
@@ -30,7 +30,9 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/platform/mutex.h"
@@ -46,8 +48,10 @@ template <typename T>
 class StatusWith;
 
 /**
- * Thread-safe object that keeps track of the active migrations running on a node and limits them
- * to only one per shard. There is only one instance of this object per shard.
+ * Thread-safe object that keeps track of the active migrations running on a node. A shard can
+ * either receive a single chunk or donate up to 'maxConcurrentChunkDonations' chunks of different
+ * collections to different recipients at a time. There is only one instance of this object per
+ * shard.
  */
 class ActiveMigrationsRegistry {
     ActiveMigrationsRegistry(const ActiveMigrationsRegistry&) = delete;
@@ -70,13 +74,14 @@ public:
     void unlock(StringData reason);
 
     /**
-     * If there are no migrations running on this shard, registers an active migration with the
-     * specified arguments. Returns a ScopedDonateChunk, which must be signaled by the
-     * caller before it goes out of scope.
+     * If this shard is not receiving a chunk, is donating fewer than 'maxConcurrentChunkDonations'
+     * chunks and none of its active donations are for the same collection or to the same
+     * recipient, registers an active migration with the specified arguments. Returns a
+     * ScopedDonateChunk, which must be signaled by the caller before it goes out of scope.
      *
-     * If there is an active migration already running on this shard and it has the exact same
-     * arguments, returns a ScopedDonateChunk. The ScopedDonateChunk can be used to join the
-     * already running migration.
+     * If there is an active migration already running on this shard for the same collection and it
+     * has the exact same arguments, returns a ScopedDonateChunk. The ScopedDonateChunk can be used
+     * to join the already running migration.
      *
      * Otherwise returns a ConflictingOperationInProgress error.
      */
@@ -96,18 +101,18 @@ public:
                                                         const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk, returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of all migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active, in namespace order.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
-     * Returns a report on the active migration if there currently is one. Otherwise, returns an
-     * empty BSONObj.
+     * Returns a report for each active migration for which this shard is the donor, in namespace
+     * order. Returns an empty vector if there are none.
      *
-     * Takes an IS lock on the namespace of the active migration, if one is active.
+     * Takes an IS lock on the namespace of each active migration, one at a time.
      */
-    BSONObj getActiveMigrationStatusReport(OperationContext* opCtx);
+    std::vector<BSONObj> getActiveMigrationStatusReports(OperationContext* opCtx);
 
 private:
     friend class ScopedDonateChunk;
@@ -152,9 +157,9 @@ private:
 
     /**
      * Unregisters a previously registered namespace with an ongoing migration. Must only be called
-     * if a previous call to registerDonateChunk has succeeded.
+     * if a previous call to registerDonateChunk for that namespace has succeeded.
      */
-    void _clearDonateChunk();
+    void _clearDonateChunk(const NamespaceString& nss);
 
     /**
      * Unregisters a previously registered incoming migration. Must only be called if a previous
@@ -168,8 +173,9 @@ private:
 
     bool _migrationsBlocked{false};
 
-    // If there is an active moveChunk operation, this field contains the original request
-    boost::optional<ActiveMoveChunkState> _activeMoveChunkState;
+    // Contains the original request of each active moveChunk operation, keyed by the namespace of
+    // the chunk being donated
+    std::map<NamespaceString, ActiveMoveChunkState> _activeMoveChunkStates;
 
     // If there is an active chunk receive operation, this field contains the original session id
     boost::optional<ActiveReceiveChunkState> _activeReceiveChunkState;
@@ -205,6 +211,7 @@ class ScopedDonateChunk {
 
 public:
     ScopedDonateChunk(ActiveMigrationsRegistry* registry,
+                      NamespaceString nss,
                       bool shouldExecute,
                       std::shared_ptr<Notification<Status>> completionNotification);
     ~ScopedDonateChunk();
@@ -238,6 +245,9 @@ private:
     // Registry from which to unregister the migration. Not owned.
     ActiveMigrationsRegistry* _registry;
 
+    // Namespace of the donated chunk, under which the migration is registered
+    NamespaceString _nss;
+
     /**
      * Whether the holder is the first in line for a newly started migration (in which case the
      * destructor must unregister) or the caller is joining on an already-running migration
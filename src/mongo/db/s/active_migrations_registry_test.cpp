@@ -33,10 +33,12 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/client.h"
 #include "mongo/db/s/active_migrations_registry.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/s/request_types/move_chunk_request.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -58,7 +60,8 @@ protected:
     ServiceContext::UniqueOperationContext _opCtx;
 };
 
-MoveChunkRequest createMoveChunkRequest(const NamespaceString& nss) {
+MoveChunkRequest createMoveChunkRequest(const NamespaceString& nss,
+                                        const ShardId& toShardId = ShardId("shard0002")) {
     const ChunkVersion chunkVersion(1, 2, OID::gen());
 
     BSONObjBuilder builder;
@@ -68,7 +71,7 @@ MoveChunkRequest createMoveChunkRequest(const NamespaceString& nss) {
         chunkVersion,
         assertGet(ConnectionString::parse("TestConfigRS/CS1:12345,CS2:12345,CS3:12345")),
         ShardId("shard0001"),
-        ShardId("shard0002"),
+        toShardId,
         ChunkRange(BSON("Key" << -100), BSON("Key" << 100)),
         1024,
         MigrationSecondaryThrottleOptions::create(MigrationSecondaryThrottleOptions::kOff),
@@ -93,14 +96,16 @@ TEST_F(MoveChunkRegistration, ScopedDonateChunkMoveConstructorAndAssignment) {
 }
 
 TEST_F(MoveChunkRegistration, GetActiveMigrationNamespace) {
-    ASSERT(!_registry.getActiveDonateChunkNss());
+    ASSERT(_registry.getActiveDonateChunkNamespaces().empty());
 
     const NamespaceString nss("TestDB", "TestColl");
 
     auto originalScopedDonateChunk =
         assertGet(_registry.registerDonateChunk(operationContext(), createMoveChunkRequest(nss)));
 
-    ASSERT_EQ(nss.ns(), _registry.getActiveDonateChunkNss()->ns());
+    const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ(nss.ns(), namespaces[0].ns());
 
     // Need to signal the registered migration so the destructor doesn't invariant
     originalScopedDonateChunk.signalComplete(Status::OK());
@@ -118,6 +123,94 @@ TEST_F(MoveChunkRegistration, SecondMigrationReturnsConflictingOperationInProgre
     originalScopedDonateChunk.signalComplete(Status::OK());
 }
 
+TEST_F(MoveChunkRegistration, ConcurrentDonationsOfDifferentCollections) {
+    maxConcurrentChunkDonations.store(2);
+    ON_BLOCK_EXIT([] { maxConcurrentChunkDonations.store(1); });
+
+    const NamespaceString nss1("TestDB", "TestColl1");
+    const NamespaceString nss2("TestDB", "TestColl2");
+
+    auto firstScopedDonateChunk = assertGet(_registry.registerDonateChunk(
+        operationContext(), createMoveChunkRequest(nss1, ShardId("shard0002"))));
+    ASSERT(firstScopedDonateChunk.mustExecute());
+
+    {
+        auto secondScopedDonateChunk = assertGet(_registry.registerDonateChunk(
+            operationContext(), createMoveChunkRequest(nss2, ShardId("shard0003"))));
+        ASSERT(secondScopedDonateChunk.mustExecute());
+
+        const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+        ASSERT_EQ(2U, namespaces.size());
+        ASSERT_EQ(nss1.ns(), namespaces[0].ns());
+        ASSERT_EQ(nss2.ns(), namespaces[1].ns());
+
+        secondScopedDonateChunk.signalComplete(Status::OK());
+    }
+
+    // Completing one of the migrations leaves the other one registered
+    const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ(nss1.ns(), namespaces[0].ns());
+
+    firstScopedDonateChunk.signalComplete(Status::OK());
+}
+
+TEST_F(MoveChunkRegistration, ConcurrentDonationAboveLimitReturnsConflict) {
+    maxConcurrentChunkDonations.store(2);
+    ON_BLOCK_EXIT([] { maxConcurrentChunkDonations.store(1); });
+
+    auto firstScopedDonateChunk = assertGet(_registry.registerDonateChunk(
+        operationContext(),
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl1"), ShardId("shard0002"))));
+    auto secondScopedDonateChunk = assertGet(_registry.registerDonateChunk(
+        operationContext(),
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl2"), ShardId("shard0003"))));
+
+    auto thirdScopedDonateChunkStatus = _registry.registerDonateChunk(
+        operationContext(),
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl3"), ShardId("shard0004")));
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              thirdScopedDonateChunkStatus.getStatus());
+
+    firstScopedDonateChunk.signalComplete(Status::OK());
+    secondScopedDonateChunk.signalComplete(Status::OK());
+}
+
+TEST_F(MoveChunkRegistration, ConcurrentDonationToSameRecipientReturnsConflict) {
+    maxConcurrentChunkDonations.store(2);
+    ON_BLOCK_EXIT([] { maxConcurrentChunkDonations.store(1); });
+
+    auto firstScopedDonateChunk = assertGet(_registry.registerDonateChunk(
+        operationContext(),
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl1"), ShardId("shard0002"))));
+
+    auto secondScopedDonateChunkStatus = _registry.registerDonateChunk(
+        operationContext(),
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl2"), ShardId("shard0002")));
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              secondScopedDonateChunkStatus.getStatus());
+
+    firstScopedDonateChunk.signalComplete(Status::OK());
+}
+
+TEST_F(MoveChunkRegistration, ReceiveChunkConflictsWithConcurrentDonations) {
+    maxConcurrentChunkDonations.store(2);
+    ON_BLOCK_EXIT([] { maxConcurrentChunkDonations.store(1); });
+
+    auto firstScopedDonateChunk = assertGet(_registry.registerDonateChunk(
+        operationContext(),
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl1"), ShardId("shard0002"))));
+
+    auto scopedReceiveChunkStatus =
+        _registry.registerReceiveChunk(operationContext(),
+                                       NamespaceString("TestDB", "TestColl2"),
+                                       ChunkRange(BSON("Key" << -100), BSON("Key" << 100)),
+                                       ShardId("shard0003"));
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress, scopedReceiveChunkStatus.getStatus());
+
+    firstScopedDonateChunk.signalComplete(Status::OK());
+}
+
 TEST_F(MoveChunkRegistration, SecondMigrationWithSameArgumentsJoinsFirst) {
     auto originalScopedDonateChunk = assertGet(_registry.registerDonateChunk(
         operationContext(), createMoveChunkRequest(NamespaceString("TestDB", "TestColl"))));
@@ -34,6 +34,7 @@
 #include "mongo/db/s/balancer/balancer_chunk_selection_policy_impl.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -376,6 +377,13 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
     MigrateInfoVector candidateChunks;
     std::set<ShardId> usedShards;
 
+    // A shard donates at most one chunk of each collection, but may donate chunks of up to
+    // 'balancerMaxConcurrentDonationsPerShard' collections at the same time. Until it reaches that
+    // limit, it is only excluded from receiving chunks.
+    const int maxDonationsPerShard = balancerMaxConcurrentDonationsPerShard.load();
+    std::map<ShardId, int> numDonations;
+    std::set<ShardId> donorShards;
+
     std::shuffle(collections.begin(), collections.end(), _random);
 
     for (const auto& coll : collections) {
@@ -394,8 +402,9 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             continue;
         }
 
-        auto candidatesStatus =
-            _getMigrateCandidatesForCollection(opCtx, nss, shardStats, &usedShards);
+        auto collectionUsedShards = usedShards;
+        auto candidatesStatus = _getMigrateCandidatesForCollection(
+            opCtx, nss, shardStats, &collectionUsedShards, donorShards);
         if (candidatesStatus == ErrorCodes::NamespaceNotFound) {
             // Namespace got dropped before we managed to get to it, so just skip it
             continue;
@@ -408,6 +417,17 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             continue;
         }
 
+        for (const auto& migrateInfo : candidatesStatus.getValue()) {
+            usedShards.insert(migrateInfo.to);
+
+            if (++numDonations[migrateInfo.from] >= maxDonationsPerShard) {
+                donorShards.erase(migrateInfo.from);
+                usedShards.insert(migrateInfo.from);
+            } else {
+                donorShards.insert(migrateInfo.from);
+            }
+        }
+
         candidateChunks.insert(candidateChunks.end(),
                                std::make_move_iterator(candidatesStatus.getValue().begin()),
                                std::make_move_iterator(candidatesStatus.getValue().end()));
@@ -440,7 +460,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
 
     std::set<ShardId> usedShards;
 
-    auto candidatesStatus = _getMigrateCandidatesForCollection(opCtx, nss, shardStats, &usedShards);
+    auto candidatesStatus =
+        _getMigrateCandidatesForCollection(opCtx, nss, shardStats, &usedShards, {});
     if (!candidatesStatus.isOK()) {
         return candidatesStatus.getStatus();
     }
@@ -558,7 +579,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
     OperationContext* opCtx,
     const NamespaceString& nss,
     const ShardStatisticsVector& shardStats,
-    std::set<ShardId>* usedShards) {
+    std::set<ShardId>* usedShards,
+    const std::set<ShardId>& donorShards) {
     auto routingInfoStatus =
         Grid::get(opCtx)->catalogCache()->getShardedCollectionRoutingInfoWithRefresh(opCtx, nss);
     if (!routingInfoStatus.isOK()) {
@@ -615,7 +637,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         shardStats,
         distribution,
         usedShards,
-        Grid::get(opCtx)->getBalancerConfiguration()->attemptToBalanceJumboChunks());
+        Grid::get(opCtx)->getBalancerConfiguration()->attemptToBalanceJumboChunks(),
+        donorShards);
 }
 
 }  // namespace mongo
@@ -292,6 +292,18 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
     return worst;
 }
 
+// Returns the shards which cannot receive a chunk, because they are either already used for a
+// migration or donating chunks of other collections.
+set<ShardId> getExcludedRecipients(const set<ShardId>& usedShards,
+                                   const set<ShardId>& donorShards) {
+    if (donorShards.empty())
+        return usedShards;
+
+    set<ShardId> excludedRecipients(usedShards);
+    excludedRecipients.insert(donorShards.begin(), donorShards.end());
+    return excludedRecipients;
+}
+
 // Returns a random integer in [0, max) using a uniform random distribution.
 int getRandomIndex(int max) {
     std::default_random_engine gen(time(nullptr));
@@ -360,7 +372,8 @@ MigrateInfo chooseRandomMigration(const ShardStatisticsVector& shardStats,
 vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
                                             std::set<ShardId>* usedShards,
-                                            bool forceJumbo) {
+                                            bool forceJumbo,
+                                            const std::set<ShardId>& donorShards) {
     vector<MigrateInfo> migrations;
 
     if (MONGO_unlikely(balancerShouldReturnRandomMigrations.shouldFail()) &&
@@ -402,8 +415,8 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 const string tag = distribution.getTagForChunk(chunk);
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+                const ShardId to = _getLeastLoadedReceiverShard(
+                    shardStats, distribution, tag, getExcludedRecipients(*usedShards, donorShards));
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         LOGV2_WARNING(21889,
@@ -462,8 +475,8 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                     continue;
                 }
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+                const ShardId to = _getLeastLoadedReceiverShard(
+                    shardStats, distribution, tag, getExcludedRecipients(*usedShards, donorShards));
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         LOGV2_WARNING(21892,
@@ -534,6 +547,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   idealNumberOfChunksPerShardForTag,
                                   &migrations,
                                   usedShards,
+                                  donorShards,
                                   forceJumbo ? MoveChunkRequest::ForceJumbo::kForceBalancer
                                              : MoveChunkRequest::ForceJumbo::kDoNotForce))
             ;
@@ -564,6 +578,7 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
                                         size_t idealNumberOfChunksPerShardForTag,
                                         vector<MigrateInfo>* migrations,
                                         set<ShardId>* usedShards,
+                                        const set<ShardId>& donorShards,
                                         MoveChunkRequest::ForceJumbo forceJumbo) {
     const ShardId from = _getMostOverloadedShard(shardStats, distribution, tag, *usedShards);
     if (!from.isValid())
@@ -575,7 +590,8 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     if (max <= idealNumberOfChunksPerShardForTag)
         return false;
 
-    const ShardId to = _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+    const ShardId to = _getLeastLoadedReceiverShard(
+        shardStats, distribution, tag, getExcludedRecipients(*usedShards, donorShards));
     if (!to.isValid()) {
         if (migrations->empty()) {
             LOGV2(21882,
@@ -196,11 +196,16 @@ public:
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
      * shard.
+     *
+     * The donorShards parameter contains the shards, which are already donating chunks of other
+     * collections, but may donate more. These shards can be selected as donors, but never as
+     * recipients.
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
                                             std::set<ShardId>* usedShards,
-                                            bool forceJumbo);
+                                            bool forceJumbo,
+                                            const std::set<ShardId>& donorShards = {});
 
     /**
      * Using the specified distribution information, returns a suggested better location for the
@@ -247,6 +252,7 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards,
+                                   const std::set<ShardId>& donorShards,
                                    MoveChunkRequest::ForceJumbo forceJumbo);
 };
 
@@ -172,6 +172,28 @@ public:
         return _cm->keyBelongsToShard(key, _thisShardId);
     }
 
+    /**
+     * Returns the range of the chunk which contains 'key', which must be a complete shard key, and
+     * whether that chunk belongs to this shard. Callers checking many keys which are likely to fall
+     * in the same chunk can test them against the returned range instead of looking up each one.
+     */
+    std::pair<ChunkRange, bool> getChunkRangeContaining(const BSONObj& key) const {
+        invariant(isSharded());
+        const auto chunk = _cm->findIntersectingChunkWithSimpleCollation(key);
+        return {ChunkRange(chunk.getMin(), chunk.getMax()), chunk.getShardId() == _thisShardId};
+    }
+
+    /**
+     * Returns true if every chunk which overlaps the range [min, max] belongs to this shard. Please
+     * note the inclusive bounds on both sides.
+     */
+    bool rangeBelongsToMe(const BSONObj& min, const BSONObj& max) const {
+        invariant(isSharded());
+        std::set<ShardId> shardIds;
+        _cm->getShardIdsForRange(min, max, &shardIds);
+        return shardIds.size() == 1 && *shardIds.begin() == _thisShardId;
+    }
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
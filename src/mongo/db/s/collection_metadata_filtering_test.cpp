@@ -30,6 +30,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/exec/shard_filterer_impl.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/shard_server_test_fixture.h"
@@ -118,6 +120,41 @@ protected:
     std::shared_ptr<MetadataManager> _manager;
 };
 
+IndexEntry makeIndexEntry(const BSONObj& keyPattern) {
+    return IndexEntry(keyPattern,
+                      IndexNames::nameToType(IndexNames::findPluginName(keyPattern)),
+                      false /* multikey */,
+                      {},
+                      {},
+                      false /* sparse */,
+                      false /* unique */,
+                      IndexEntry::Identifier{"test_index"},
+                      nullptr /* filterExpr */,
+                      BSONObj(),
+                      nullptr /* collator */,
+                      nullptr /* wildcardProjection */);
+}
+
+/**
+ * Makes index bounds with a single interval per field. Each interval is given as a pair of its
+ * start and end, and includes its start but not its end.
+ */
+IndexBounds makeIndexBounds(const BSONObj& keyPattern,
+                            const std::vector<std::pair<BSONObj, BSONObj>>& startsAndEnds) {
+    IndexBounds bounds;
+    auto keyPatternIt = keyPattern.begin();
+    for (const auto& [start, end] : startsAndEnds) {
+        OrderedIntervalList oil((*keyPatternIt).fieldName());
+        BSONObjBuilder intervalBuilder;
+        intervalBuilder.appendAs(start.firstElement(), "");
+        intervalBuilder.appendAs(end.firstElement(), "");
+        oil.intervals.push_back(Interval(intervalBuilder.obj(), true, false));
+        bounds.fields.push_back(std::move(oil));
+        ++keyPatternIt;
+    }
+    return bounds;
+}
+
 // Verifies that right set of documents is visible
 TEST_F(CollectionMetadataFilteringTest, FilterDocumentsInTheFuture) {
     prepareTestData();
@@ -198,5 +235,81 @@ TEST_F(CollectionMetadataFilteringTest, FilterDocumentsTooFarInThePastThrowsStal
         operationContext(), CollectionShardingState::OrphanCleanupPolicy::kAllowOrphanCleanup));
 }
 
+// Verifies that documents are filtered correctly when consecutive shard keys fall in the same chunk
+TEST_F(CollectionMetadataFilteringTest, ShardFiltererChecksDocumentsAgainstChunkRanges) {
+    prepareTestData();
+
+    AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+    auto* const css = CollectionShardingState::get(operationContext(), kNss);
+    ShardFiltererImpl filterer(css->getOwnershipFilter(
+        operationContext(), CollectionShardingState::OrphanCleanupPolicy::kAllowOrphanCleanup));
+
+    const auto belongs = [&](int id) {
+        return filterer.documentBelongsToMe(Document{{"_id", id}}) ==
+            ShardFilterer::DocumentBelongsResult::kBelongs;
+    };
+
+    ASSERT_TRUE(belongs(-500));
+    ASSERT_TRUE(belongs(-101));
+    ASSERT_FALSE(belongs(-100));
+    ASSERT_FALSE(belongs(-1));
+    ASSERT_TRUE(belongs(0));
+    ASSERT_TRUE(belongs(99));
+    ASSERT_FALSE(belongs(100));
+    ASSERT_FALSE(belongs(500));
+    ASSERT_TRUE(belongs(50));
+    ASSERT_FALSE(belongs(-50));
+    ASSERT_TRUE(belongs(-500));
+
+    ASSERT(filterer.documentBelongsToMe(Document{{"a", 1}}) ==
+           ShardFilterer::DocumentBelongsResult::kNoShardKey);
+}
+
+// Verifies which index scans are known to only return documents owned by the shard
+TEST_F(CollectionMetadataFilteringTest, ShardFiltererChecksIndexBoundsAgainstOwnedRanges) {
+    prepareTestData();
+
+    AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+    auto* const css = CollectionShardingState::get(operationContext(), kNss);
+    ShardFiltererImpl filterer(css->getOwnershipFilter(
+        operationContext(), CollectionShardingState::OrphanCleanupPolicy::kAllowOrphanCleanup));
+
+    const auto idIndex = makeIndexEntry(BSON("_id" << 1));
+    const auto belongs = [&](const IndexEntry& index,
+                             const std::vector<std::pair<BSONObj, BSONObj>>& startsAndEnds) {
+        return filterer.indexBoundsBelongToMe(index,
+                                              makeIndexBounds(index.keyPattern, startsAndEnds));
+    };
+
+    // Scans within a single owned chunk.
+    ASSERT_TRUE(belongs(idIndex, {{BSON("" << 0), BSON("" << 99)}}));
+    ASSERT_TRUE(belongs(idIndex, {{BSON("" << -500), BSON("" << -200)}}));
+
+    // Scans over chunks which are not owned.
+    ASSERT_FALSE(belongs(idIndex, {{BSON("" << -50), BSON("" << 50)}}));
+    ASSERT_FALSE(belongs(idIndex, {{BSON("" << 150), BSON("" << 200)}}));
+    ASSERT_FALSE(belongs(idIndex, {{BSON("" << -500), BSON("" << 50)}}));
+
+    // Scans which could return documents missing the shard key.
+    ASSERT_FALSE(belongs(idIndex, {{BSON("" << BSONNULL), BSON("" << -200)}}));
+    ASSERT_FALSE(belongs(idIndex, {{BSON("" << MINKEY), BSON("" << -200)}}));
+
+    // Scans over an index prefixed by the shard key only consider the shard key fields.
+    ASSERT_TRUE(belongs(
+        makeIndexEntry(BSON("_id" << 1 << "a" << 1)),
+        {{BSON("" << 10), BSON("" << 50)}, {BSON("" << MINKEY), BSON("" << MAXKEY)}}));
+
+    // Scans over indexes which are not prefixed by the shard key.
+    ASSERT_FALSE(belongs(makeIndexEntry(BSON("a" << 1)), {{BSON("" << 10), BSON("" << 50)}}));
+    ASSERT_FALSE(belongs(makeIndexEntry(BSON("a" << 1 << "_id" << 1)),
+                         {{BSON("" << 10), BSON("" << 50)}, {BSON("" << 10), BSON("" << 50)}}));
+    ASSERT_FALSE(belongs(makeIndexEntry(BSON("_id" << -1)), {{BSON("" << 50), BSON("" << 10)}}));
+
+    // Reversed intervals, as used by backward scans.
+    IndexBounds reversedBounds =
+        makeIndexBounds(BSON("_id" << 1), {{BSON("" << 50), BSON("" << 10)}});
+    ASSERT_TRUE(filterer.indexBoundsBelongToMe(idIndex, reversedBounds));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/migration_source_manager.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
 #include "mongo/db/service_context.h"
@@ -68,6 +69,9 @@ const char kRecvChunkCommit[] = "_recvChunkCommit";
 const char kRecvChunkAbort[] = "_recvChunkAbort";
 
 const int kMaxObjectPerChunk{250000};
+
+// Chunks with fewer documents per stream than this are cloned over fewer streams
+const size_t kMinCloneLocsPerStream{1000};
 const Hours kMaxWaitToCommitCloneForJumboChunk(6);
 
 MONGO_FAIL_POINT_DEFINE(failTooMuchMemoryUsed);
@@ -295,7 +299,8 @@ Status MigrationChunkClonerSourceLegacy::startClone(OperationContext* opCtx,
                                             _args.getMinKey(),
                                             _args.getMaxKey(),
                                             _shardKeyPattern.toBSON(),
-                                            _args.getSecondaryThrottle());
+                                            _args.getSecondaryThrottle(),
+                                            getNumCloneStreams());
 
     // Commands sent to shards that accept writeConcern, must always have writeConcern. So if the
     // StartChunkCloneRequest didn't add writeConcern (from secondaryThrottle), then we add the
@@ -347,7 +352,7 @@ StatusWith<BSONObj> MigrationChunkClonerSourceLegacy::commitClone(OperationConte
             }
         } else {
             invariant(PlanExecutor::IS_EOF == _jumboChunkCloneState->clonerState);
-            invariant(_cloneLocs.empty());
+            invariant(_cloneLocsRemaining == 0);
         }
     }
 
@@ -654,64 +659,114 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
     _jumboChunkCloneState->clonerExec->detachFromOperationContext();
 }
 
-void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(OperationContext* opCtx,
-                                                                    Collection* collection,
-                                                                    BSONArrayBuilder* arrBuilder) {
+void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneLocs(
+    OperationContext* opCtx,
+    Collection* collection,
+    BSONArrayBuilder* arrBuilder,
+    boost::optional<int> streamId) {
     ElapsedTracker tracker(opCtx->getServiceContext()->getFastClockSource(),
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
+    if (streamId) {
+        _nextCloneBatchFromCloneStream(opCtx, collection, arrBuilder, *streamId, &tracker);
+        return;
+    }
+
+    // Without a stream id, the streams are drained one after the other. The number of streams
+    // cannot change once cloning has started, so it is safe to read it without the mutex.
+    for (size_t streamIdx = 0; streamIdx < _cloneStreams.size(); ++streamIdx) {
+        if (_nextCloneBatchFromCloneStream(opCtx, collection, arrBuilder, streamIdx, &tracker)) {
+            return;
+        }
+    }
+}
+
+bool MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneStream(OperationContext* opCtx,
+                                                                      Collection* collection,
+                                                                      BSONArrayBuilder* arrBuilder,
+                                                                      size_t streamIdx,
+                                                                      ElapsedTracker* tracker) {
     stdx::unique_lock<Latch> lk(_mutex);
-    auto iter = _cloneLocs.begin();
+    const size_t begin = _cloneStreams[streamIdx].next;
+    const size_t end = _cloneStreams[streamIdx].end;
+    lk.unlock();
 
-    for (; iter != _cloneLocs.end(); ++iter) {
+    // There is only one caller for each stream at a time and '_cloneLocs' is not modified while
+    // there are record ids left to transfer, so the stream's range can be read without the mutex.
+    size_t next = begin;
+    bool stoppedEarly = false;
+
+    for (; next < end; ++next) {
         // We must always make progress in this method by at least one document because empty
         // return indicates there is no more initial clone data.
-        if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+        if (arrBuilder->arrSize() && tracker->intervalHasElapsed()) {
+            stoppedEarly = true;
             break;
         }
 
-        auto nextRecordId = *iter;
-
-        lk.unlock();
-
         Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, nextRecordId, &doc)) {
+        if (collection->findDoc(opCtx, _cloneLocs[next], &doc)) {
             // Use the builder size instead of accumulating the document sizes directly so
             // that we take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
                 (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
-
+                stoppedEarly = true;
                 break;
             }
 
             arrBuilder->append(doc.value());
             ShardingStatistics::get(opCtx).countDocsClonedOnDonor.addAndFetch(1);
         }
+    }
 
-        lk.lock();
+    lk.lock();
+    _cloneStreams[streamIdx].next = next;
+    _cloneLocsRemaining -= next - begin;
+
+    // Release the record ids as soon as all of the streams are done with them
+    if (_cloneLocsRemaining == 0) {
+        _cloneLocs = std::vector<RecordId>();
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), iter);
+    return stoppedEarly;
 }
 
-uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
+uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize(
+    boost::optional<int> streamId) {
     stdx::lock_guard<Latch> sl(_mutex);
     if (_jumboChunkCloneState && _forceJumbo)
         return static_cast<uint64_t>(BSONObjMaxUserSize);
 
+    const size_t cloneLocsRemaining =
+        (streamId && *streamId >= 0 && static_cast<size_t>(*streamId) < _cloneStreams.size())
+        ? _cloneStreams[*streamId].end - _cloneStreams[*streamId].next
+        : _cloneLocsRemaining;
+
     return std::min(static_cast<uint64_t>(BSONObjMaxUserSize),
-                    _averageObjectSizeForCloneLocs * _cloneLocs.size());
+                    _averageObjectSizeForCloneLocs * cloneLocsRemaining);
+}
+
+int MigrationChunkClonerSourceLegacy::getNumCloneStreams() {
+    stdx::lock_guard<Latch> sl(_mutex);
+    return std::max(static_cast<int>(_cloneStreams.size()), 1);
 }
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                                                         Collection* collection,
-                                                        BSONArrayBuilder* arrBuilder) {
+                                                        BSONArrayBuilder* arrBuilder,
+                                                        boost::optional<int> streamId) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(_args.getNss(), MODE_IS));
 
     // If this chunk is too large to store records in _cloneLocs and the command args specify to
     // attempt to move it, scan the collection directly.
     if (_jumboChunkCloneState && _forceJumbo) {
+        if (streamId && *streamId != 0) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Clone stream " << *streamId
+                                  << " does not exist, jumbo chunks are cloned over one stream"};
+        }
+
         try {
             _nextCloneBatchFromIndexScan(opCtx, collection, arrBuilder);
             return Status::OK();
@@ -720,7 +775,13 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
         }
     }
 
-    _nextCloneBatchFromCloneLocs(opCtx, collection, arrBuilder);
+    if (streamId && (*streamId < 0 || *streamId >= getNumCloneStreams())) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Clone stream " << *streamId << " does not exist, there are "
+                              << getNumCloneStreams() << " clone streams"};
+    }
+
+    _nextCloneBatchFromCloneLocs(opCtx, collection, arrBuilder, streamId);
     return Status::OK();
 }
 
@@ -735,7 +796,7 @@ Status MigrationChunkClonerSourceLegacy::nextModsBatch(OperationContext* opCtx,
     {
         // All clone data must have been drained before starting to fetch the incremental changes.
         stdx::unique_lock<Latch> lk(_mutex);
-        invariant(_cloneLocs.empty());
+        invariant(_cloneLocsRemaining == 0);
 
         // The "snapshot" for delete and update list must be taken under a single lock. This is to
         // ensure that we will preserve the causal order of writes. Always consume the delete
@@ -885,14 +946,15 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
 
             if (!isLargeChunk) {
                 stdx::lock_guard<Latch> lk(_mutex);
-                _cloneLocs.insert(recordId);
+                _cloneLocs.push_back(recordId);
             }
 
             if (++recCount > maxRecsWhenFull) {
                 isLargeChunk = true;
 
                 if (_forceJumbo) {
-                    _cloneLocs.clear();
+                    stdx::lock_guard<Latch> lk(_mutex);
+                    _cloneLocs = std::vector<RecordId>();
                     break;
                 }
             }
@@ -918,6 +980,24 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     stdx::lock_guard<Latch> lk(_mutex);
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + 12;
 
+    // Sort the record ids, so that the documents are fetched in storage order. The index scan may
+    // have returned a document more than once if it moved within the chunk while yielding.
+    std::sort(_cloneLocs.begin(), _cloneLocs.end());
+    _cloneLocs.erase(std::unique(_cloneLocs.begin(), _cloneLocs.end()), _cloneLocs.end());
+    _cloneLocs.shrink_to_fit();
+    _cloneLocsRemaining = _cloneLocs.size();
+
+    // Split the record ids into contiguous ranges of at least kMinCloneLocsPerStream, one per clone
+    // stream, which the recipient can fetch concurrently
+    const size_t numStreams = std::max<size_t>(
+        1,
+        std::min<size_t>(migrateCloneStreams.load(),
+                         _cloneLocs.size() / kMinCloneLocsPerStream));
+    for (size_t i = 0; i < numStreams; ++i) {
+        _cloneStreams.push_back({_cloneLocs.size() * i / numStreams,
+                                 _cloneLocs.size() * (i + 1) / numStreams});
+    }
+
     return Status::OK();
 }
 
@@ -998,7 +1078,7 @@ Status MigrationChunkClonerSourceLegacy::_checkRecipientCloningStatus(OperationC
 
         stdx::lock_guard<Latch> sl(_mutex);
 
-        const std::size_t cloneLocsRemaining = _cloneLocs.size();
+        const std::size_t cloneLocsRemaining = _cloneLocsRemaining;
 
         if (_forceJumbo && _jumboChunkCloneState) {
             LOGV2(21992,
@@ -31,12 +31,13 @@
 
 #include <list>
 #include <memory>
-#include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/record_id.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_session_id.h"
@@ -53,7 +54,7 @@ class BSONArrayBuilder;
 class BSONObjBuilder;
 class Collection;
 class Database;
-class RecordId;
+class ElapsedTracker;
 
 /**
  * Used to commit work for LogOpForSharding. Used to keep track of changes in documents that are
@@ -139,14 +140,19 @@ public:
 
     /**
      * Called by the recipient shard. Used to estimate how many more bytes of clone data are
-     * remaining in the chunk cloner.
+     * remaining in the chunk cloner, or in the given clone stream.
      */
-    uint64_t getCloneBatchBufferAllocationSize();
+    uint64_t getCloneBatchBufferAllocationSize(boost::optional<int> streamId = boost::none);
 
     /**
      * Called by the recipient shard. Populates the passed BSONArrayBuilder with a set of documents,
-     * which are part of the initial clone sequence. Assumes that there is only one active caller
-     * to this method at a time (otherwise, it can cause corruption/crash).
+     * which are part of the initial clone sequence.
+     *
+     * The initial clone is split into getNumCloneStreams() streams, each covering a separate part
+     * of the chunk's documents, which can be fetched concurrently by passing their 'streamId'.
+     * Without a 'streamId', the streams are returned one after the other. Assumes that there is
+     * only one active caller for each stream at a time, and no caller of a specific stream while
+     * there is one without 'streamId' (otherwise, it can cause corruption/crash).
      *
      * Returns OK status on success. If there were documents returned in the result argument, this
      * method should be called more times until the result is empty. If it returns failure, it is
@@ -160,7 +166,14 @@ public:
      */
     Status nextCloneBatch(OperationContext* opCtx,
                           Collection* collection,
-                          BSONArrayBuilder* arrBuilder);
+                          BSONArrayBuilder* arrBuilder,
+                          boost::optional<int> streamId = boost::none);
+
+    /**
+     * Returns the number of streams over which the initial clone is served. Only valid after
+     * startClone has succeeded.
+     */
+    int getNumCloneStreams();
 
     /**
      * Called by the recipient shard. Transfers the accummulated local mods from source to
@@ -229,11 +242,23 @@ private:
 
     void _nextCloneBatchFromCloneLocs(OperationContext* opCtx,
                                       Collection* collection,
-                                      BSONArrayBuilder* arrBuilder);
+                                      BSONArrayBuilder* arrBuilder,
+                                      boost::optional<int> streamId);
+
+    /**
+     * Appends to 'arrBuilder' the documents of the given clone stream, starting from its current
+     * position, and advances the stream past them. Returns false if the stream was exhausted, or
+     * true if it stopped early because the batch is full or has taken long enough.
+     */
+    bool _nextCloneBatchFromCloneStream(OperationContext* opCtx,
+                                        Collection* collection,
+                                        BSONArrayBuilder* arrBuilder,
+                                        size_t streamIdx,
+                                        ElapsedTracker* tracker);
 
     /**
      * Get the disklocs that belong to the chunk migrated and sort them in _cloneLocs (to avoid
-     * seeking disk later).
+     * seeking disk later), then split them into the clone streams.
      *
      * Returns OK or any error status otherwise.
      */
@@ -347,8 +372,23 @@ private:
     // The current state of the cloner
     State _state{kNew};
 
-    // List of record ids that needs to be transferred (initial clone)
-    std::set<RecordId> _cloneLocs;
+    // Sorted record ids of the documents that need to be transferred (initial clone). Not
+    // modified while cloning, other than being released once all streams have been exhausted, so
+    // that the clone streams can read their part of it without holding the mutex.
+    std::vector<RecordId> _cloneLocs;
+
+    // The initial clone is split into contiguous ranges of '_cloneLocs', one per clone stream.
+    struct CloneStream {
+        // Position in '_cloneLocs' of the next record id to transfer
+        size_t next;
+
+        // Position in '_cloneLocs' past the last record id of the stream
+        size_t end;
+    };
+    std::vector<CloneStream> _cloneStreams;
+
+    // Number of record ids in '_cloneLocs' which have not been transferred yet
+    size_t _cloneLocsRemaining{0};
 
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
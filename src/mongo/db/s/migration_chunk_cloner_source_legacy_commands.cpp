@@ -64,40 +64,64 @@ public:
     AutoGetActiveCloner(OperationContext* opCtx,
                         const MigrationSessionId& migrationSessionId,
                         const bool holdCollectionLock) {
-        const auto nss = ActiveMigrationsRegistry::get(opCtx).getActiveDonateChunkNss();
-        uassert(ErrorCodes::NotYetInitialized, "No active migrations were found", nss);
+        const auto namespaces =
+            ActiveMigrationsRegistry::get(opCtx).getActiveDonateChunkNamespaces();
+        uassert(ErrorCodes::NotYetInitialized,
+                "No active migrations were found",
+                !namespaces.empty());
+
+        // Several chunks of different collections may be donated at the same time, so find the
+        // migration by its session id
+        std::vector<std::string> activeSessionIds;
+        for (const auto& nss : namespaces) {
+            // Once the collection is locked, the migration status cannot change
+            _autoColl.emplace(opCtx, nss, MODE_IS);
+
+            if (namespaces.size() == 1) {
+                uassert(ErrorCodes::NamespaceNotFound,
+                        str::stream() << "Collection " << nss.ns() << " does not exist",
+                        _autoColl->getCollection());
+            } else if (!_autoColl->getCollection()) {
+                continue;
+            }
 
-        // Once the collection is locked, the migration status cannot change
-        _autoColl.emplace(opCtx, *nss, MODE_IS);
+            auto csr = CollectionShardingRuntime::get(opCtx, nss);
+            auto csrLock = CollectionShardingRuntime::CSRLock::lockShared(opCtx, csr);
 
-        uassert(ErrorCodes::NamespaceNotFound,
-                str::stream() << "Collection " << nss->ns() << " does not exist",
-                _autoColl->getCollection());
+            auto msm = MigrationSourceManager::get(csr, csrLock);
+            if (!msm) {
+                if (namespaces.size() == 1) {
+                    uasserted(ErrorCodes::IllegalOperation,
+                              str::stream()
+                                  << "No active migrations were found for collection " << nss.ns());
+                }
+                continue;
+            }
 
-        {
-            auto csr = CollectionShardingRuntime::get(opCtx, *nss);
-            auto csrLock = CollectionShardingRuntime::CSRLock::lockShared(opCtx, csr);
+            // It is now safe to access the cloner
+            auto chunkCloner =
+                std::dynamic_pointer_cast<MigrationChunkClonerSourceLegacy,
+                                          MigrationChunkClonerSource>(msm->getCloner());
+            invariant(chunkCloner);
 
-            if (auto msm = MigrationSourceManager::get(csr, csrLock)) {
-                // It is now safe to access the cloner
-                _chunkCloner =
-                    std::dynamic_pointer_cast<MigrationChunkClonerSourceLegacy,
-                                              MigrationChunkClonerSource>(msm->getCloner());
-                invariant(_chunkCloner);
-            } else {
-                uasserted(ErrorCodes::IllegalOperation,
-                          str::stream()
-                              << "No active migrations were found for collection " << nss->ns());
+            if (migrationSessionId.matches(chunkCloner->getSessionId())) {
+                _chunkCloner = std::move(chunkCloner);
+                break;
             }
+
+            activeSessionIds.push_back(chunkCloner->getSessionId().toString());
         }
 
         // Ensure the session ids are correct
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "Requested migration session id " << migrationSessionId.toString()
-                              << " does not match active session id "
-                              << _chunkCloner->getSessionId().toString(),
-                migrationSessionId.matches(_chunkCloner->getSessionId()));
-
+        if (!_chunkCloner) {
+            str::stream errmsg;
+            errmsg << "Requested migration session id " << migrationSessionId.toString()
+                   << " does not match active session id";
+            for (size_t i = 0; i < activeSessionIds.size(); ++i) {
+                errmsg << (i == 0 ? " " : ", ") << activeSessionIds[i];
+            }
+            uasserted(ErrorCodes::IllegalOperation, errmsg);
+        }
 
         if (!holdCollectionLock)
             _autoColl = boost::none;
@@ -128,6 +152,8 @@ private:
 
 class InitialCloneCommand : public BasicCommand {
 public:
+    static constexpr StringData kStreamIdField = "streamId"_sd;
+
     InitialCloneCommand() : BasicCommand("_migrateClone") {}
 
     std::string help() const override {
@@ -161,6 +187,16 @@ public:
         const MigrationSessionId migrationSessionId(
             uassertStatusOK(MigrationSessionId::extractFromBSON(cmdObj)));
 
+        // Recipients which fetch the initial clone over several streams specify which one this
+        // request is for
+        boost::optional<int> streamId;
+        if (auto streamIdElem = cmdObj[kStreamIdField]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'" << kStreamIdField << "' must be a number",
+                    streamIdElem.isNumber());
+            streamId = streamIdElem.numberInt();
+        }
+
         boost::optional<BSONArrayBuilder> arrBuilder;
 
         // Try to maximize on the size of the buffer, which we are returning in order to have less
@@ -171,13 +207,14 @@ public:
             AutoGetActiveCloner autoCloner(opCtx, migrationSessionId, true);
 
             if (!arrBuilder) {
-                arrBuilder.emplace(autoCloner.getCloner()->getCloneBatchBufferAllocationSize());
+                arrBuilder.emplace(
+                    autoCloner.getCloner()->getCloneBatchBufferAllocationSize(streamId));
             }
 
             arrSizeAtPrevIteration = arrBuilder->arrSize();
 
             uassertStatusOK(autoCloner.getCloner()->nextCloneBatch(
-                opCtx, autoCloner.getColl(), arrBuilder.get_ptr()));
+                opCtx, autoCloner.getColl(), arrBuilder.get_ptr(), streamId));
         }
 
         invariant(arrBuilder);
@@ -189,10 +189,15 @@ bool opReplicatedEnough(OperationContext* opCtx,
  *
  * 'sessionId' unique identifier for this migration.
  */
-BSONObj createMigrateCloneRequest(const NamespaceString& nss, const MigrationSessionId& sessionId) {
+BSONObj createMigrateCloneRequest(const NamespaceString& nss,
+                                  const MigrationSessionId& sessionId,
+                                  boost::optional<int> streamId = boost::none) {
     BSONObjBuilder builder;
     builder.append("_migrateClone", nss.ns());
     sessionId.append(&builder);
+    if (streamId) {
+        builder.append("streamId", *streamId);
+    }
     return builder.obj();
 }
 
@@ -362,6 +367,7 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
     _min = cloneRequest.getMinKey();
     _max = cloneRequest.getMaxKey();
     _shardKeyPattern = cloneRequest.getShardKeyPattern();
+    _numCloneStreams = cloneRequest.getNumCloneStreams();
 
     _epoch = epoch;
 
@@ -459,6 +465,92 @@ repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
     return lastOpApplied;
 }
 
+repl::OpTime MigrationDestinationManager::cloneDocumentsFromDonor(
+    OperationContext* opCtx,
+    std::function<void(OperationContext*, BSONObj)> insertBatchFn,
+    std::function<BSONObj(OperationContext*, int)> fetchBatchFn,
+    int numStreams) {
+    invariant(numStreams >= 1);
+
+    auto makeStreamFetchBatchFn = [&fetchBatchFn](int streamId) {
+        return [&fetchBatchFn, streamId](OperationContext* opCtx) {
+            return fetchBatchFn(opCtx, streamId);
+        };
+    };
+
+    if (numStreams == 1) {
+        return cloneDocumentsFromDonor(opCtx, insertBatchFn, makeStreamFetchBatchFn(0));
+    }
+
+    // Protects the state below, which is shared between the streams
+    auto mutex = MONGO_MAKE_LATCH("MigrationDestinationManager::cloneDocumentsFromDonor::mutex");
+    std::vector<OperationContext*> streamOpCtxs;
+    boost::optional<Status> firstError;
+    repl::OpTime lastOpApplied;
+
+    // Interrupts all of the streams which are still running, in the same way that a stream's
+    // inserter thread interrupts its fetcher
+    auto interruptStreams = [&](WithLock) {
+        for (auto streamOpCtx : streamOpCtxs) {
+            stdx::lock_guard<Client> lk(*streamOpCtx->getClient());
+            streamOpCtx->getServiceContext()->killOperation(
+                lk, streamOpCtx, ErrorCodes::Error(51008));
+        }
+    };
+
+    auto runStream = [&](OperationContext* streamOpCtx, int streamId) {
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            if (firstError) {
+                return;
+            }
+            streamOpCtxs.push_back(streamOpCtx);
+        }
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<Latch> lk(mutex);
+            streamOpCtxs.erase(std::find(streamOpCtxs.begin(), streamOpCtxs.end(), streamOpCtx));
+        });
+
+        try {
+            const auto streamLastOpApplied = cloneDocumentsFromDonor(
+                streamOpCtx, insertBatchFn, makeStreamFetchBatchFn(streamId));
+
+            stdx::lock_guard<Latch> lk(mutex);
+            lastOpApplied = std::max(lastOpApplied, streamLastOpApplied);
+        } catch (const DBException& ex) {
+            stdx::lock_guard<Latch> lk(mutex);
+            if (!firstError) {
+                firstError = ex.toStatus();
+                interruptStreams(lk);
+            }
+        }
+    };
+
+    std::vector<stdx::thread> streamThreads;
+    for (int streamId = 1; streamId < numStreams; ++streamId) {
+        streamThreads.emplace_back([&, streamId] {
+            Client::initKillableThread("chunkCloneStream-" + std::to_string(streamId),
+                                       opCtx->getServiceContext());
+            auto streamOpCtx = Client::getCurrent()->makeOperationContext();
+            runStream(streamOpCtx.get(), streamId);
+        });
+    }
+
+    runStream(opCtx, 0);
+
+    for (auto& streamThread : streamThreads) {
+        streamThread.join();
+    }
+
+    if (firstError) {
+        uassertStatusOK(*firstError);
+    }
+
+    // This check is necessary because killOp is used to propagate errors between the streams
+    opCtx->checkForInterrupt();
+    return lastOpApplied;
+}
+
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
     stdx::lock_guard<Latch> sl(_mutex);
 
@@ -912,7 +1004,18 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
 
         _sessionMigration->start(opCtx->getServiceContext());
 
-        const BSONObj migrateCloneRequest = createMigrateCloneRequest(_nss, *_sessionId);
+        // The donor serves the initial clone over '_numCloneStreams' streams, which are fetched
+        // and inserted concurrently. A single stream is fetched without a stream id, as donors
+        // which predate clone streams expect.
+        std::vector<BSONObj> migrateCloneRequests;
+        if (_numCloneStreams == 1) {
+            migrateCloneRequests.push_back(createMigrateCloneRequest(_nss, *_sessionId));
+        } else {
+            for (int streamId = 0; streamId < _numCloneStreams; ++streamId) {
+                migrateCloneRequests.push_back(
+                    createMigrateCloneRequest(_nss, *_sessionId, streamId));
+            }
+        }
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
@@ -980,12 +1083,12 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
             }
         };
 
-        auto fetchBatchFn = [&](OperationContext* opCtx) {
+        auto fetchBatchFn = [&](OperationContext* opCtx, int streamId) {
             auto res = uassertStatusOKWithContext(
                 fromShard->runCommand(opCtx,
                                       ReadPreferenceSetting(ReadPreference::PrimaryOnly),
                                       "admin",
-                                      migrateCloneRequest,
+                                      migrateCloneRequests[streamId],
                                       Shard::RetryPolicy::kNoRetry),
                 "_migrateClone failed: ");
 
@@ -997,7 +1100,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx) {
 
         // If running on a replicated system, we'll need to flush the docs we cloned to the
         // secondaries
-        lastOpApplied = cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        lastOpApplied =
+            cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn, _numCloneStreams);
 
         timing.done(3);
         migrateThreadHangAtStep3.pauseWhileSet();
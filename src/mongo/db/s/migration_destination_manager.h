@@ -120,6 +120,18 @@ public:
         std::function<void(OperationContext*, BSONObj)> insertBatchFn,
         std::function<BSONObj(OperationContext*)> fetchBatchFn);
 
+    /**
+     * Clones documents from a donor shard over 'numStreams' concurrent streams. Each stream fetches
+     * batches by passing its stream id to 'fetchBatchFn' and inserts them as above, until it gets
+     * an empty batch. The first stream runs on the calling thread and the others on threads of
+     * their own. An error in any of the streams interrupts all of the others and is rethrown.
+     */
+    static repl::OpTime cloneDocumentsFromDonor(
+        OperationContext* opCtx,
+        std::function<void(OperationContext*, BSONObj)> insertBatchFn,
+        std::function<BSONObj(OperationContext*, int)> fetchBatchFn,
+        int numStreams);
+
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
      * specified session id. If the migration is already aborted, does nothing.
@@ -214,6 +226,9 @@ private:
     BSONObj _max;
     BSONObj _shardKeyPattern;
 
+    // The number of streams over which the donor serves the initial clone
+    int _numCloneStreams{1};
+
     OID _epoch;
 
     WriteConcernOptions _writeConcern;
@@ -156,5 +156,76 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrors) {
     ASSERT_EQ(operationContext()->getKillStatus(), 51008);
 }
 
+// Tests that each stream fetches and inserts its own documents when cloning over several streams.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorOverSeveralStreams) {
+    const int kNumStreams = 4;
+    const int kBatchesPerStream = 3;
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::vector<int> batchesFetched(kNumStreams, 0);
+    std::vector<int> resultIds;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx, int streamId) {
+        ASSERT_GTE(streamId, 0);
+        ASSERT_LT(streamId, kNumStreams);
+
+        // Stream s fetches ids s, s + kNumStreams, s + 2 * kNumStreams...
+        BSONArrayBuilder arrayBuilder;
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            const int batch = batchesFetched[streamId]++;
+            if (batch < kBatchesPerStream) {
+                arrayBuilder.append(createDocument(batch * kNumStreams + streamId));
+            }
+        }
+
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<Latch> lk(mutex);
+        for (auto&& docToClone : docs) {
+            resultIds.push_back(docToClone.Obj()["_id"].numberInt());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, kNumStreams);
+
+    std::sort(resultIds.begin(), resultIds.end());
+    ASSERT_EQ(size_t(kNumStreams * kBatchesPerStream), resultIds.size());
+    for (int i = 0; i < kNumStreams * kBatchesPerStream; ++i) {
+        ASSERT_EQ(i, resultIds[i]);
+    }
+}
+
+// Tests that an error in one of several streams stops the other streams and is thrown on the main
+// thread.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsOverSeveralStreamsThrowsFetchErrors) {
+    const int kNumStreams = 4;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx, int streamId) {
+        if (streamId == 2) {
+            uasserted(ErrorCodes::NetworkTimeout, "network error");
+        }
+
+        // The other streams never run out of documents, so they have to be interrupted
+        opCtx->checkForInterrupt();
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {};
+
+    ASSERT_THROWS_CODE_AND_WHAT(MigrationDestinationManager::cloneDocumentsFromDonor(
+                                    operationContext(), insertBatchFn, fetchBatchFn, kNumStreams),
+                                DBException,
+                                ErrorCodes::NetworkTimeout,
+                                "network error");
+}
+
 }  // namespace
 }  // namespace mongo
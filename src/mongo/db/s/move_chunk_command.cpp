@@ -78,6 +78,9 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 WriteConcernOptions::kWriteConcernTimeoutSharding);
 
+// Upper bound of the 'maxConcurrentChunkDonations' server parameter
+const int kMaxConcurrentChunkDonations = 16;
+
 // Tests can pause and resume moveChunk's progress at each step by enabling/disabling each failpoint
 MONGO_FAIL_POINT_DEFINE(moveChunkHangAtStep1);
 MONGO_FAIL_POINT_DEFINE(moveChunkHangAtStep2);
@@ -279,9 +282,9 @@ private:
             ThreadPool::Options options;
             options.poolName = "MoveChunk";
             options.minThreads = 0;
-            // We limit the size of the thread pool to a single thread because currently there can
-            // only be one moveChunk operation on a shard at a time.
-            options.maxThreads = 1;
+            // The number of concurrent moveChunk operations on a shard is limited by the
+            // 'maxConcurrentChunkDonations' parameter, the upper bound of which is used here.
+            options.maxThreads = kMaxConcurrentChunkDonations;
             executor = std::make_shared<ThreadPool>(std::move(options));
             executor->startup();
         }
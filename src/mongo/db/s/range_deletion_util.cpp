@@ -57,6 +57,7 @@
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/persistent_task_store.h"
 #include "mongo/db/s/range_deletion_task_gen.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/remove_saver.h"
@@ -64,6 +65,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/future_util.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -113,9 +115,93 @@ bool collectionUuidHasChanged(const NamespaceString& nss,
     return false;
 }
 
+/**
+ * Deletes up to numDocsToRemovePerBatch documents between the 'min' and 'max' keys of the shard key
+ * index in a single WriteUnitOfWork. The documents are located with an index scan first and then
+ * deleted together, so the document, index and oplog writes of the whole batch are committed in
+ * one storage transaction instead of one per document. Must be called under the collection lock.
+ *
+ * Returns the number of documents deleted, 0 if done with the range.
+ */
+int deleteNextBatchInBulk(OperationContext* opCtx,
+                          Collection* collection,
+                          const IndexDescriptor* descriptor,
+                          const BSONObj& min,
+                          const BSONObj& max,
+                          int numDocsToRemovePerBatch,
+                          long long* bytesDeleted) {
+    auto const& nss = collection->ns();
+
+    std::unique_ptr<RemoveSaver> removeSaver;
+    if (serverGlobalParams.moveParanoia) {
+        removeSaver = std::make_unique<RemoveSaver>("moveChunk", nss.ns(), "cleaning");
+    }
+
+    if (MONGO_unlikely(hangBeforeDoingDeletion.shouldFail())) {
+        LOGV2(4859015, "Hit hangBeforeDoingDeletion failpoint");
+        hangBeforeDoingDeletion.pauseWhileSet(opCtx);
+    }
+
+    if (throwWriteConflictExceptionInDeleteRange.shouldFail()) {
+        throw WriteConflictException();
+    }
+
+    if (throwInternalErrorInDeleteRange.shouldFail()) {
+        uasserted(ErrorCodes::InternalError, "Failing for test");
+    }
+
+    return writeConflictRetry(opCtx, "rangeDeletion", nss.ns(), [&] {
+        std::vector<RecordId> recordIds;
+        {
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   descriptor,
+                                                   min,
+                                                   max,
+                                                   BoundInclusion::kIncludeStartKeyOnly,
+                                                   PlanYieldPolicy::YieldPolicy::YIELD_MANUAL,
+                                                   InternalPlanner::FORWARD);
+
+            RecordId recordId;
+            while (recordIds.size() < static_cast<size_t>(numDocsToRemovePerBatch) &&
+                   exec->getNext(nullptr, &recordId) == PlanExecutor::ADVANCED) {
+                recordIds.push_back(recordId);
+            }
+        }
+
+        // The index scan and the deletions below share the same snapshot, so every record found by
+        // the scan still exists unless this shard itself removed it, in which case it is skipped.
+        int numDeleted = 0;
+        long long numBytes = 0;
+
+        WriteUnitOfWork wuow(opCtx);
+        for (const auto& recordId : recordIds) {
+            Snapshotted<BSONObj> doc;
+            if (!collection->findDoc(opCtx, recordId, &doc)) {
+                continue;
+            }
+
+            if (removeSaver) {
+                uassertStatusOK(removeSaver->goingToDelete(doc.value()));
+            }
+
+            numBytes += doc.value().objsize();
+            collection->deleteDocument(
+                opCtx, kUninitializedStmtId, recordId, nullptr, true /* fromMigrate */);
+            ++numDeleted;
+        }
+        wuow.commit();
+
+        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(numDeleted);
+        *bytesDeleted = numBytes;
+        return numDeleted;
+    });
+}
+
 /**
  * Performs the deletion of up to numDocsToRemovePerBatch entries within the range in progress. Must
- * be called under the collection lock.
+ * be called under the collection lock. The total size of the deleted documents is returned in
+ * 'bytesDeleted'.
  *
  * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
  * the range failed.
@@ -124,7 +210,8 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                                 Collection* collection,
                                 BSONObj const& keyPattern,
                                 ChunkRange const& range,
-                                int numDocsToRemovePerBatch) {
+                                int numDocsToRemovePerBatch,
+                                long long* bytesDeleted) {
     invariant(collection != nullptr);
 
     auto const& nss = collection->ns();
@@ -171,6 +258,13 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                             "namespace"_attr = nss.ns());
     }
 
+    *bytesDeleted = 0;
+
+    if (rangeDeleterBulkDelete.load()) {
+        return deleteNextBatchInBulk(
+            opCtx, collection, descriptor, min, max, numDocsToRemovePerBatch, bytesDeleted);
+    }
+
     auto deleteStageParams = std::make_unique<DeleteStageParams>();
     deleteStageParams->fromMigrate = true;
     deleteStageParams->isMulti = true;
@@ -230,6 +324,7 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
 
         invariant(PlanExecutor::ADVANCED == state);
         ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(1);
+        *bytesDeleted += deletedObj.objsize();
 
     } while (++numDeleted < numDocsToRemovePerBatch);
 
@@ -285,6 +380,20 @@ void ensureRangeDeletionTaskStillExists(OperationContext* opCtx, const UUID& mig
     // holding any locks.
 }
 
+/**
+ * Returns how long to wait after a batch, which deleted 'bytesDeleted' bytes of documents and took
+ * 'batchDuration', so that range deletion stays under rangeDeleterMaxBytesPerSecond.
+ */
+Milliseconds getDelayForMaxBytesPerSecond(long long bytesDeleted, Milliseconds batchDuration) {
+    const auto maxBytesPerSecond = rangeDeleterMaxBytesPerSecond.load();
+    if (maxBytesPerSecond <= 0 || bytesDeleted <= 0) {
+        return Milliseconds(0);
+    }
+
+    const Milliseconds minBatchDuration(bytesDeleted * 1000 / maxBytesPerSecond);
+    return std::max(minBatchDuration - batchDuration, Milliseconds(0));
+}
+
 /**
  * Delete the range in a sequence of batches until there are no more documents to
  * delete or deletion returns an error.
@@ -298,7 +407,10 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                                           int numDocsToRemovePerBatch,
                                           Milliseconds delayBetweenBatches) {
     return AsyncTry([=] {
-               return withTemporaryOperationContext([=](OperationContext* opCtx) {
+               Timer batchTimer;
+               long long bytesDeleted = 0;
+
+               auto numDeleted = withTemporaryOperationContext([&](OperationContext* opCtx) {
                    if (migrationId) {
                        ensureRangeDeletionTaskStillExists(opCtx, *migrationId);
                    }
@@ -313,8 +425,12 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
                            "deletion task. No need to delete documents.",
                            !collectionUuidHasChanged(nss, collection, collectionUuid));
 
-                   auto numDeleted = uassertStatusOK(deleteNextBatch(
-                       opCtx, collection, keyPattern, range, numDocsToRemovePerBatch));
+                   auto numDeleted = uassertStatusOK(deleteNextBatch(opCtx,
+                                                                     collection,
+                                                                     keyPattern,
+                                                                     range,
+                                                                     numDocsToRemovePerBatch,
+                                                                     &bytesDeleted));
 
                    LOGV2_DEBUG(
                        23769,
@@ -329,6 +445,23 @@ ExecutorFuture<void> deleteRangeInBatches(const std::shared_ptr<executor::TaskEx
 
                    return numDeleted;
                });
+
+               // Throttle the deletions after releasing the collection lock, so they do not take
+               // more than their share of the I/O from the user traffic
+               const auto delay =
+                   getDelayForMaxBytesPerSecond(bytesDeleted, Milliseconds(batchTimer.millis()));
+               if (delay <= Milliseconds(0)) {
+                   return ExecutorFuture<int>(executor, numDeleted);
+               }
+
+               LOGV2_DEBUG(4859016,
+                           2,
+                           "Throttling range deletion",
+                           "namespace"_attr = nss.ns(),
+                           "bytesDeleted"_attr = bytesDeleted,
+                           "delay"_attr = delay);
+
+               return sleepFor(executor, delay).then([numDeleted] { return numDeleted; });
            })
         .until([](StatusWith<int> swNumDeleted) {
             // Continue iterating until there are no more documents to delete, retrying on
@@ -61,7 +61,9 @@ extern AtomicWord<int> rangeDeleterBatchDelayMS;
  * 2. Waits for delayForActiveQueriesOnSecondariesToComplete seconds before deleting any documents,
  *    to give queries running on secondaries a chance to finish.
  * 3. Delete documents in a series of batches with up to numDocsToRemovePerBatch documents per
- *    batch, with a delay of delayBetweenBatches milliseconds in between batches.
+ *    batch, with a delay of delayBetweenBatches milliseconds in between batches. If
+ *    rangeDeleterMaxBytesPerSecond is set, the batches are further delayed to stay under that rate.
+ *    If rangeDeleterBulkDelete is set, each batch is deleted in a single storage transaction.
  */
 SharedSemiFuture<void> removeDocumentsInRange(
     const std::shared_ptr<executor::TaskExecutor>& executor,
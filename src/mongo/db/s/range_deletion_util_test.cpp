@@ -42,6 +42,7 @@
 #include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -695,6 +696,114 @@ TEST_F(RangeDeleterTest, RemoveDocumentsInRangeRespectsDelayInBetweenBatches) {
     ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 0);
 }
 
+TEST_F(RangeDeleterTest, RemoveDocumentsInRangeInBulkRemovesOnlyDocumentsInRange) {
+    rangeDeleterBulkDelete.store(true);
+    ON_BLOCK_EXIT([] { rangeDeleterBulkDelete.store(false); });
+
+    const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
+    // More documents in the range than the batch size.
+    const auto numDocsToRemovePerBatch = 2;
+    auto queriesComplete = SemiFuture<void>::makeReady();
+
+    setFilteringMetadataWithUUID(uuid());
+    DBDirectClient dbclient(operationContext());
+    for (auto i = -5; i < 15; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+
+    auto cleanupComplete =
+        removeDocumentsInRange(executor(),
+                               std::move(queriesComplete),
+                               kNss,
+                               uuid(),
+                               kShardKeyPattern,
+                               range,
+                               boost::none,
+                               numDocsToRemovePerBatch,
+                               Seconds(0) /* delayForActiveQueriesOnSecondariesToComplete */,
+                               Milliseconds(0) /* delayBetweenBatches */);
+
+    cleanupComplete.get();
+    ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 10);
+    ASSERT_EQUALS(dbclient.count(kNss, BSON(kShardKey << GTE << 0 << LT << 10)), 0);
+}
+
+TEST_F(RangeDeleterTest, RemoveDocumentsInRangeInBulkRetriesOnWriteConflictException) {
+    rangeDeleterBulkDelete.store(true);
+    ON_BLOCK_EXIT([] { rangeDeleterBulkDelete.store(false); });
+
+    globalFailPointRegistry()
+        .find("throwWriteConflictExceptionInDeleteRange")
+        ->setMode(FailPoint::nTimes, 3 /* Throw a few times before disabling. */);
+
+    const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
+    auto queriesComplete = SemiFuture<void>::makeReady();
+
+    setFilteringMetadataWithUUID(uuid());
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 5));
+
+    auto cleanupComplete =
+        removeDocumentsInRange(executor(),
+                               std::move(queriesComplete),
+                               kNss,
+                               uuid(),
+                               kShardKeyPattern,
+                               range,
+                               boost::none,
+                               10 /*numDocsToRemovePerBatch*/,
+                               Seconds(0) /* delayForActiveQueriesOnSecondariesToComplete */,
+                               Milliseconds(0) /* delayBetweenBatches */);
+
+    cleanupComplete.get();
+    ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 0);
+}
+
+TEST_F(RangeDeleterTest, RemoveDocumentsInRangeRespectsMaxBytesPerSecond) {
+    // Each document is more than 10 bytes, so every batch must be followed by a delay of more
+    // than one second.
+    rangeDeleterMaxBytesPerSecond.store(10);
+    ON_BLOCK_EXIT([] { rangeDeleterMaxBytesPerSecond.store(0); });
+
+    const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
+    // More documents than the batch size.
+    const auto numDocsToInsert = 3;
+    const auto numDocsToRemovePerBatch = 1;
+    auto queriesComplete = SemiFuture<void>::makeReady();
+
+    // Insert documents in range.
+    setFilteringMetadataWithUUID(uuid());
+    DBDirectClient dbclient(operationContext());
+    for (auto i = 0; i < numDocsToInsert; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+
+    auto cleanupComplete =
+        removeDocumentsInRange(executor(),
+                               std::move(queriesComplete),
+                               kNss,
+                               uuid(),
+                               kShardKeyPattern,
+                               range,
+                               boost::none,
+                               numDocsToRemovePerBatch,
+                               Seconds(0) /* delayForActiveQueriesOnSecondariesToComplete */,
+                               Milliseconds(0) /* delayBetweenBatches */);
+
+    // A best-effort check that cleanup has not completed without advancing the clock.
+    sleepsecs(1);
+    ASSERT_FALSE(cleanupComplete.isReady());
+
+    // Advance the time until cleanup is complete, as in the test for the delay between batches.
+    while (!cleanupComplete.isReady()) {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(network());
+        network()->advanceTime(network()->now() + Milliseconds(100));
+    }
+
+    cleanupComplete.get();
+    ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 0);
+}
+
 TEST_F(RangeDeleterTest, RemoveDocumentsInRangeRespectsOrphanCleanupDelay) {
     const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
     // More documents than the batch size.
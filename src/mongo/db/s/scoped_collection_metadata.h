@@ -104,6 +104,14 @@ public:
     bool keyBelongsToMe(const BSONObj& key) const {
         return _impl->get().keyBelongsToMe(key);
     }
+
+    std::pair<ChunkRange, bool> getChunkRangeContaining(const BSONObj& key) const {
+        return _impl->get().getChunkRangeContaining(key);
+    }
+
+    bool rangeBelongsToMe(const BSONObj& min, const BSONObj& max) const {
+        return _impl->get().rangeBelongsToMe(min, max);
+    }
 };
 
 }  // namespace mongo
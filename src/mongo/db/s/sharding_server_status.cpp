@@ -75,13 +75,19 @@ public:
             grid->getBalancerConfiguration()->getMaxChunkSizeBytes();
         result.append("maxChunkSizeInBytes", maxChunkSizeInBytes);
 
-        // Get a migration status report if a migration is active for which this is the source
-        // shard. The call to getActiveMigrationStatusReport will take an IS lock on the namespace
-        // of the active migration if there is one that is active.
-        BSONObj migrationStatus =
-            ActiveMigrationsRegistry::get(opCtx).getActiveMigrationStatusReport(opCtx);
-        if (!migrationStatus.isEmpty()) {
-            result.append("migrations", migrationStatus);
+        // Get a migration status report for each active migration for which this is the source
+        // shard. The call to getActiveMigrationStatusReports will take an IS lock on the namespace
+        // of each active migration. The 'migrations' field keeps reporting the first one, so that
+        // existing tools continue to work when the shard donates several chunks concurrently.
+        const auto migrationStatuses =
+            ActiveMigrationsRegistry::get(opCtx).getActiveMigrationStatusReports(opCtx);
+        if (!migrationStatuses.empty()) {
+            result.append("migrations", migrationStatuses.front());
+
+            BSONArrayBuilder activeMigrations(result.subarrayStart("activeMigrations"));
+            for (const auto& migrationStatus : migrationStatuses) {
+                activeMigrations.append(migrationStatus);
+            }
         }
 
         return result.obj();
@@ -50,6 +50,7 @@ const char kToShardId[] = "toShardName";
 const char kChunkMinKey[] = "min";
 const char kChunkMaxKey[] = "max";
 const char kShardKeyPattern[] = "shardKeyPattern";
+const char kNumCloneStreams[] = "cloneStreams";
 
 }  // namespace
 
@@ -152,6 +153,21 @@ StatusWith<StartChunkCloneRequest> StartChunkCloneRequest::createFromCommand(Nam
         }
     }
 
+    {
+        long long numCloneStreams;
+        Status status =
+            bsonExtractIntegerFieldWithDefault(obj, kNumCloneStreams, 1, &numCloneStreams);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (numCloneStreams < 1) {
+            return Status(ErrorCodes::BadValue, "The number of clone streams must be positive");
+        }
+
+        request._numCloneStreams = static_cast<int>(numCloneStreams);
+    }
+
     request._migrationId = UUID::parse(obj);
     request._lsid =
         LogicalSessionId::parse(IDLParserErrorContext("StartChunkCloneRequest"), obj[kLsid].Obj());
@@ -173,7 +189,8 @@ void StartChunkCloneRequest::appendAsCommand(
     const BSONObj& chunkMinKey,
     const BSONObj& chunkMaxKey,
     const BSONObj& shardKeyPattern,
-    const MigrationSecondaryThrottleOptions& secondaryThrottle) {
+    const MigrationSecondaryThrottleOptions& secondaryThrottle,
+    int numCloneStreams) {
     invariant(builder->asTempObj().isEmpty());
     invariant(nss.isValid());
     invariant(fromShardConnectionString.isValid());
@@ -192,6 +209,12 @@ void StartChunkCloneRequest::appendAsCommand(
     builder->append(kChunkMaxKey, chunkMaxKey);
     builder->append(kShardKeyPattern, shardKeyPattern);
     secondaryThrottle.append(builder);
+
+    // Only sent when there are several streams, so that a single stream migration looks the same
+    // as before to the recipient
+    if (numCloneStreams > 1) {
+        builder->append(kNumCloneStreams, numCloneStreams);
+    }
 }
 
 }  // namespace mongo
@@ -72,7 +72,8 @@ public:
                                 const BSONObj& chunkMinKey,
                                 const BSONObj& chunkMaxKey,
                                 const BSONObj& shardKeyPattern,
-                                const MigrationSecondaryThrottleOptions& secondaryThrottle);
+                                const MigrationSecondaryThrottleOptions& secondaryThrottle,
+                                int numCloneStreams = 1);
 
     const NamespaceString& getNss() const {
         return _nss;
@@ -127,6 +128,14 @@ public:
         return _secondaryThrottle;
     }
 
+    /**
+     * The number of streams over which the donor serves the initial clone. Donors which predate
+     * clone streams don't send it and serve a single stream.
+     */
+    int getNumCloneStreams() const {
+        return _numCloneStreams;
+    }
+
 private:
     StartChunkCloneRequest(NamespaceString nss,
                            MigrationSessionId sessionId,
@@ -158,6 +167,9 @@ private:
 
     // The parsed secondary throttle options
     MigrationSecondaryThrottleOptions _secondaryThrottle;
+
+    // The number of streams over which the donor serves the initial clone
+    int _numCloneStreams{1};
 };
 
 }  // namespace mongo
@@ -36,13 +36,16 @@
 #include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/s/server_transaction_coordinators_metrics.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/transaction_coordinator_document_gen.h"
 #include "mongo/db/s/transaction_coordinator_metrics_observer.h"
 #include "mongo/db/s/transaction_coordinator_test_fixture.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/log_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/tick_source_mock.h"
 
 namespace mongo {
@@ -637,6 +640,111 @@ protected:
         ASSERT_EQUALS(allCoordinatorDocs.size(), size_t(0));
     }
 
+    /**
+     * Persists the commit decision of transactions 1 to 'numTxns' on '_lsid' concurrently, where
+     * only the first 'numTxnsWithParticipantList' of them have a coordinator document. Checks that
+     * the decision of each of those was written and that all the others keep failing until the
+     * scheduler is shut down.
+     */
+    void persistConcurrentDecisionsExpectSuccessForTxnsWithParticipantList(
+        int numTxns, int numTxnsWithParticipantList) {
+        for (int i = 1; i <= numTxnsWithParticipantList; i++) {
+            txn::persistParticipantsList(*_aws, _lsid, TxnNumber{i}, _participants).get();
+        }
+
+        txn::CoordinatorCommitDecision decision(txn::CommitDecision::kCommit);
+        decision.setCommitTimestamp(_commitTimestamp);
+
+        std::vector<Future<repl::OpTime>> futures;
+        for (int i = 1; i <= numTxns; i++) {
+            futures.push_back(
+                txn::persistDecision(*_aws, _lsid, TxnNumber{i}, _participants, decision));
+        }
+
+        for (int i = 0; i < numTxnsWithParticipantList; i++) {
+            futures[i].get();
+        }
+
+        _aws->shutdown({ErrorCodes::TransactionCoordinatorSteppingDown, "Shutdown for test"});
+        for (int i = numTxnsWithParticipantList; i < numTxns; i++) {
+            ASSERT_THROWS_CODE(futures[i].get(),
+                               AssertionException,
+                               ErrorCodes::TransactionCoordinatorSteppingDown);
+        }
+
+        auto allCoordinatorDocs = txn::readAllCoordinatorDocs(operationContext());
+        ASSERT_EQUALS(allCoordinatorDocs.size(), size_t(numTxnsWithParticipantList));
+        for (const auto& doc : allCoordinatorDocs) {
+            assertDocumentMatches(doc,
+                                  _lsid,
+                                  *doc.getId().getTxnNumber(),
+                                  _participants,
+                                  txn::CommitDecision::kCommit,
+                                  _commitTimestamp);
+        }
+    }
+
+    /**
+     * Writes the commit decision of transactions 1 to 'numTxns' on '_lsid' from concurrent threads
+     * with batching enabled, holding the batch of transaction 1 until all the others are queued, so
+     * that those are written as a single batch. All transactions except
+     * 'txnWithoutParticipantList' have a coordinator document. Returns the optime or error of each.
+     */
+    std::vector<StatusWith<repl::OpTime>> persistDecisionsInOneBatch(
+        int numTxns, boost::optional<TxnNumber> txnWithoutParticipantList = boost::none) {
+        const auto originalMaxBatchSize = transactionCoordinatorDocumentWriteBatchMaxSize.load();
+        transactionCoordinatorDocumentWriteBatchMaxSize.store(numTxns);
+        ON_BLOCK_EXIT(
+            [&] { transactionCoordinatorDocumentWriteBatchMaxSize.store(originalMaxBatchSize); });
+
+        for (TxnNumber txnNumber = 1; txnNumber <= numTxns; txnNumber++) {
+            if (txnNumber != txnWithoutParticipantList) {
+                txn::persistParticipantsList(*_aws, _lsid, txnNumber, _participants).get();
+            }
+        }
+
+        txn::CoordinatorCommitDecision decision(txn::CommitDecision::kCommit);
+        decision.setCommitTimestamp(_commitTimestamp);
+
+        std::vector<StatusWith<repl::OpTime>> results(
+            numTxns, Status(ErrorCodes::InternalError, "Decision not written"));
+        auto persistDecision = [&](TxnNumber txnNumber) {
+            return stdx::thread([&, txnNumber] {
+                ThreadClient tc("PersistDecision", getServiceContext());
+                auto opCtx = tc->makeOperationContext();
+                try {
+                    results[txnNumber - 1] = txn::persistDecisionBlocking(
+                        opCtx.get(), _lsid, txnNumber, _participants, decision, true);
+                } catch (const DBException& ex) {
+                    results[txnNumber - 1] = ex.toStatus();
+                }
+            });
+        };
+
+        auto hangBeforeWritingBatch =
+            globalFailPointRegistry().find("hangBeforeWritingCoordinatorDocumentBatch");
+        auto timesEntered = hangBeforeWritingBatch->setMode(FailPoint::alwaysOn);
+
+        std::vector<stdx::thread> threads;
+        threads.push_back(persistDecision(1));
+        hangBeforeWritingBatch->waitForTimesEntered(timesEntered + 1);
+
+        for (TxnNumber txnNumber = 2; txnNumber <= numTxns; txnNumber++) {
+            threads.push_back(persistDecision(txnNumber));
+        }
+        while (txn::numCoordinatorDocumentWritesQueuedForTest(getServiceContext()) <
+               size_t(numTxns - 1)) {
+            sleepmillis(1);
+        }
+
+        hangBeforeWritingBatch->setMode(FailPoint::off);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        return results;
+    }
+
     const std::vector<ShardId> _participants{
         ShardId("shard0001"), ShardId("shard0002"), ShardId("shard0003")};
 
@@ -806,6 +914,72 @@ TEST_F(TransactionCoordinatorDriverPersistenceTest,
     assertDocumentMatches(allCoordinatorDocs[0], _lsid, txnNumber2, _participants);
 }
 
+TEST_F(TransactionCoordinatorDriverPersistenceTest,
+       PersistDecisionsForConcurrentTransactionsWritesThemInOneBatch) {
+    const auto results = persistDecisionsInOneBatch(10);
+
+    // Transaction 1 was written by itself, and all the others in the batch which queued behind it,
+    // which gave all of them the optime of the last write of the batch.
+    for (const auto& result : results) {
+        ASSERT_OK(result.getStatus());
+    }
+    ASSERT_LT(results[0].getValue(), results[1].getValue());
+    for (size_t i = 2; i < results.size(); i++) {
+        ASSERT_EQ(results[1].getValue(), results[i].getValue());
+    }
+
+    auto allCoordinatorDocs = txn::readAllCoordinatorDocs(operationContext());
+    ASSERT_EQUALS(allCoordinatorDocs.size(), results.size());
+    for (const auto& doc : allCoordinatorDocs) {
+        assertDocumentMatches(doc,
+                              _lsid,
+                              *doc.getId().getTxnNumber(),
+                              _participants,
+                              txn::CommitDecision::kCommit,
+                              _commitTimestamp);
+    }
+}
+
+TEST_F(TransactionCoordinatorDriverPersistenceTest,
+       PersistDecisionsForConcurrentTransactionsFailsOnlyForTransactionWithoutDocument) {
+    const auto results = persistDecisionsInOneBatch(10, TxnNumber{5});
+
+    // The batch failed as a whole, so its decisions were written one by one, and only the one for
+    // the transaction without a coordinator document failed.
+    ASSERT_EQ(results[4].getStatus().code(), ErrorCodes::Error(51026));
+    for (size_t i = 0; i < results.size(); i++) {
+        if (i != 4) {
+            ASSERT_OK(results[i].getStatus());
+        }
+    }
+    ASSERT_LT(results[1].getValue(), results[2].getValue());
+
+    auto allCoordinatorDocs = txn::readAllCoordinatorDocs(operationContext());
+    ASSERT_EQUALS(allCoordinatorDocs.size(), results.size() - 1);
+    for (const auto& doc : allCoordinatorDocs) {
+        assertDocumentMatches(doc,
+                              _lsid,
+                              *doc.getId().getTxnNumber(),
+                              _participants,
+                              txn::CommitDecision::kCommit,
+                              _commitTimestamp);
+    }
+}
+
+TEST_F(TransactionCoordinatorDriverPersistenceTest,
+       PersistDecisionsForConcurrentTransactionsSucceeds) {
+    persistConcurrentDecisionsExpectSuccessForTxnsWithParticipantList(10, 10);
+}
+
+TEST_F(TransactionCoordinatorDriverPersistenceTest,
+       PersistDecisionsForConcurrentTransactionsWithoutBatchingSucceeds) {
+    const auto originalMaxBatchSize = transactionCoordinatorDocumentWriteBatchMaxSize.load();
+    transactionCoordinatorDocumentWriteBatchMaxSize.store(1);
+    ON_BLOCK_EXIT(
+        [&] { transactionCoordinatorDocumentWriteBatchMaxSize.store(originalMaxBatchSize); });
+
+    persistConcurrentDecisionsExpectSuccessForTxnsWithParticipantList(10, 9);
+}
 
 using TransactionCoordinatorTest = TransactionCoordinatorTestBase;
 
@@ -33,6 +33,8 @@
 
 #include "mongo/db/s/transaction_coordinator_util.h"
 
+#include <deque>
+
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
@@ -40,12 +42,15 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/transaction_coordinator_futures_util.h"
 #include "mongo/db/s/transaction_coordinator_worker_curop_repository.h"
 #include "mongo/db/storage/flow_control.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -59,6 +64,7 @@ MONGO_FAIL_POINT_DEFINE(hangBeforeSendingCommit);
 MONGO_FAIL_POINT_DEFINE(hangBeforeSendingAbort);
 MONGO_FAIL_POINT_DEFINE(hangBeforeDeletingCoordinatorDoc);
 MONGO_FAIL_POINT_DEFINE(hangAfterDeletingCoordinatorDoc);
+MONGO_FAIL_POINT_DEFINE(hangBeforeWritingCoordinatorDocumentBatch);
 
 using ResponseStatus = executor::TaskExecutor::ResponseStatus;
 using CoordinatorAction = TransactionCoordinatorWorkerCurOpRepository::CoordinatorAction;
@@ -99,13 +105,261 @@ bool shouldRetryPersistingCoordinatorState(const StatusWith<T>& responseStatus)
         responseStatus != ErrorCodes::TransactionCoordinatorSteppingDown;
 }
 
+/**
+ * Group commit for the coordinator documents of concurrently committing transactions.
+ *
+ * Each caller queues its update and blocks on its own operation context until a batch containing
+ * the update has been written. Whichever caller finds no batch in progress writes the next one,
+ * on behalf of all the others, with a single update command, so the whole batch is made majority
+ * committed by waiting for a single optime. This only saves the command round trips and majority
+ * waits: the updates of a batch are still applied one storage transaction at a time, and all
+ * writes go through one batch at a time rather than running concurrently. So it is off unless
+ * 'transactionCoordinatorDocumentWriteBatchMaxSize' is raised above 1.
+ *
+ * If a batch cannot be applied as a whole (for example, because one of the documents does not
+ * match the state its update expects), the writer applies its updates one by one instead, and only
+ * the callers whose update fails on its own are told to write it themselves, which reports the
+ * error against the transaction it belongs to. The coordinator document updates are idempotent, so
+ * it does not matter if part of the batch had already been applied.
+ */
+class CoordinatorDocumentWriteBatcher {
+public:
+    static CoordinatorDocumentWriteBatcher& get(ServiceContext* service);
+
+    /**
+     * Returns the optime to wait for the update to be majority committed, or boost::none if it
+     * could not be applied as part of a batch and the caller must write it by itself.
+     */
+    boost::optional<repl::OpTime> write(OperationContext* opCtx, write_ops::UpdateOpEntry entry) {
+        auto pending = std::make_shared<PendingWrite>();
+        pending->entry = std::move(entry);
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _queue.push_back(pending);
+
+        while (!pending->done) {
+            try {
+                opCtx->waitForConditionOrInterrupt(
+                    _batchWrittenCV, lk, [&] { return pending->done || !_batchInProgress; });
+            } catch (const DBException&) {
+                auto it = std::find(_queue.begin(), _queue.end(), pending);
+                if (it != _queue.end()) {
+                    _queue.erase(it);
+                }
+                throw;
+            }
+
+            if (pending->done) {
+                break;
+            }
+
+            // Nobody else is writing, so write the next batch. It does not necessarily contain our
+            // own update, in which case we go back to waiting.
+            std::vector<std::shared_ptr<PendingWrite>> batch;
+            const size_t maxBatchSize = transactionCoordinatorDocumentWriteBatchMaxSize.load();
+            while (!_queue.empty() && batch.size() < maxBatchSize) {
+                batch.push_back(std::move(_queue.front()));
+                _queue.pop_front();
+            }
+
+            _batchInProgress = true;
+            lk.unlock();
+            _writeBatch(opCtx, batch);
+            lk.lock();
+            _batchInProgress = false;
+
+            for (auto& write : batch) {
+                write->done = true;
+            }
+            _batchWrittenCV.notify_all();
+        }
+
+        return pending->opTime;
+    }
+
+    size_t numQueued() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _queue.size();
+    }
+
+private:
+    struct PendingWrite {
+        write_ops::UpdateOpEntry entry;
+        bool done{false};
+        boost::optional<repl::OpTime> opTime;
+    };
+
+    /**
+     * Applies all the updates in 'batch' with a single update command and sets the optime of each
+     * to that of the last one. If the batch does not apply in full, applies the updates one by one
+     * instead, which leaves only those that fail by themselves without an optime.
+     */
+    static void _writeBatch(OperationContext* opCtx,
+                            const std::vector<std::shared_ptr<PendingWrite>>& batch) {
+        if (MONGO_unlikely(hangBeforeWritingCoordinatorDocumentBatch.shouldFail())) {
+            LOGV2(4859051, "Hit hangBeforeWritingCoordinatorDocumentBatch failpoint");
+            hangBeforeWritingCoordinatorDocumentBatch.pauseWhileSet(opCtx);
+        }
+
+        std::vector<write_ops::UpdateOpEntry> updates;
+        updates.reserve(batch.size());
+        for (const auto& write : batch) {
+            updates.push_back(write->entry);
+        }
+
+        if (_applyUpdates(opCtx, std::move(updates))) {
+            LOGV2_DEBUG(4859021,
+                        3,
+                        "Wrote batch of transaction coordinator documents",
+                        "batchSize"_attr = batch.size());
+
+            const auto opTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+            for (auto& write : batch) {
+                write->opTime = opTime;
+            }
+            return;
+        }
+
+        if (batch.size() == 1) {
+            return;
+        }
+
+        LOGV2_DEBUG(4859019,
+                    3,
+                    "Batch of transaction coordinator document writes was not applied in full, "
+                    "writing them one by one",
+                    "batchSize"_attr = batch.size());
+        for (auto& write : batch) {
+            if (_applyUpdates(opCtx, {write->entry})) {
+                write->opTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+            }
+        }
+    }
+
+    /**
+     * Applies 'updates' with a single update command and returns whether all of them matched or
+     * upserted a document.
+     */
+    static bool _applyUpdates(OperationContext* opCtx,
+                              std::vector<write_ops::UpdateOpEntry> updates) {
+        const auto numUpdates = updates.size();
+        try {
+            DBDirectClient client(opCtx);
+
+            const auto commandResponse = client.runCommand([&] {
+                write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
+                updateOp.setUpdates(std::move(updates));
+                return updateOp.serialize({});
+            }());
+
+            // Every update targets a single document by _id, so all of them applied if and only if
+            // each of them matched or upserted one.
+            const auto commandReply = commandResponse->getCommandReply();
+            return getStatusFromWriteCommandReply(commandReply).isOK() &&
+                commandReply.getIntField("n") == int(numUpdates);
+        } catch (const DBException& ex) {
+            LOGV2_DEBUG(4859020,
+                        3,
+                        "Failed to write transaction coordinator documents",
+                        "numDocuments"_attr = numUpdates,
+                        "error"_attr = ex.toStatus());
+            return false;
+        }
+    }
+
+    Mutex _mutex = MONGO_MAKE_LATCH("CoordinatorDocumentWriteBatcher::_mutex");
+
+    // Notified every time a batch has been written.
+    stdx::condition_variable _batchWrittenCV;
+
+    // Updates which have not yet been picked up by a batch, in arrival order.
+    std::deque<std::shared_ptr<PendingWrite>> _queue;
+
+    // Whether some caller is currently writing a batch.
+    bool _batchInProgress{false};
+};
+
+const auto getCoordinatorDocumentWriteBatcher =
+    ServiceContext::declareDecoration<CoordinatorDocumentWriteBatcher>();
+
+CoordinatorDocumentWriteBatcher& CoordinatorDocumentWriteBatcher::get(ServiceContext* service) {
+    return getCoordinatorDocumentWriteBatcher(service);
+}
+
+/**
+ * Applies 'entry' as part of a batch with the coordinator document updates of other transactions,
+ * if batching is enabled and 'allowBatching' is set. Returns boost::none if the caller must write
+ * it by itself.
+ */
+boost::optional<repl::OpTime> writeCoordinatorDocumentAsPartOfBatch(
+    OperationContext* opCtx, const write_ops::UpdateOpEntry& entry, bool allowBatching) {
+    if (!allowBatching || transactionCoordinatorDocumentWriteBatchMaxSize.load() <= 1) {
+        return boost::none;
+    }
+
+    return CoordinatorDocumentWriteBatcher::get(opCtx->getServiceContext()).write(opCtx, entry);
+}
+
+write_ops::UpdateOpEntry makeParticipantListUpdate(const OperationSessionInfo& sessionInfo,
+                                                   const std::vector<ShardId>& participantList) {
+    write_ops::UpdateOpEntry entry;
+
+    // Ensure that the document for the (lsid, txnNumber) either has no participant list or has
+    // the same participant list. The document may have the same participant list if an earlier
+    // attempt to write the participant list failed waiting for writeConcern.
+    BSONObj noParticipantList = BSON(TransactionCoordinatorDocument::kParticipantsFieldName
+                                     << BSON("$exists" << false));
+    BSONObj sameParticipantList =
+        BSON("$and" << buildParticipantListMatchesConditions(participantList));
+    entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                    << sessionInfo.toBSON() << "$or"
+                    << BSON_ARRAY(noParticipantList << sameParticipantList)));
+
+    // Update with participant list.
+    TransactionCoordinatorDocument doc;
+    doc.setId(sessionInfo);
+    doc.setParticipants(participantList);
+    entry.setU(doc.toBSON());
+
+    entry.setUpsert(true);
+    return entry;
+}
+
+write_ops::UpdateOpEntry makeDecisionUpdate(const OperationSessionInfo& sessionInfo,
+                                            const std::vector<ShardId>& participantList,
+                                            const txn::CoordinatorCommitDecision& decision) {
+    write_ops::UpdateOpEntry entry;
+
+    // Ensure that the document for the (lsid, txnNumber) has the same participant list and either
+    // has no decision or the same decision. The document may have the same decision if an earlier
+    // attempt to write the decision failed waiting for writeConcern.
+    BSONObj noDecision =
+        BSON(TransactionCoordinatorDocument::kDecisionFieldName << BSON("$exists" << false));
+    BSONObj sameDecision =
+        BSON(TransactionCoordinatorDocument::kDecisionFieldName << decision.toBSON());
+
+    entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                    << sessionInfo.toBSON() << "$and"
+                    << buildParticipantListMatchesConditions(participantList) << "$or"
+                    << BSON_ARRAY(noDecision << sameDecision)));
+
+    TransactionCoordinatorDocument doc;
+    doc.setId(sessionInfo);
+    doc.setParticipants(participantList);
+    doc.setDecision(decision);
+    entry.setU(doc.toBSON());
+
+    return entry;
+}
+
 }  // namespace
 
 namespace {
 repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
                                             const LogicalSessionId& lsid,
                                             TxnNumber txnNumber,
-                                            const std::vector<ShardId>& participantList) {
+                                            const std::vector<ShardId>& participantList,
+                                            bool allowBatching) {
     LOGV2_DEBUG(22463,
                 3,
                 "{sessionId}:{txnNumber} Going to write participant list",
@@ -122,34 +376,24 @@ repl::OpTime persistParticipantListBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
+    auto entry = makeParticipantListUpdate(sessionInfo, participantList);
+
+    if (auto opTime = writeCoordinatorDocumentAsPartOfBatch(opCtx, entry, allowBatching)) {
+        LOGV2_DEBUG(4859022,
+                    3,
+                    "{sessionId}:{txnNumber} Wrote participant list as part of a batch",
+                    "Wrote participant list as part of a batch",
+                    "sessionId"_attr = lsid.getId(),
+                    "txnNumber"_attr = txnNumber);
+        return *opTime;
+    }
+
     DBDirectClient client(opCtx);
 
     // Throws if serializing the request or deserializing the response fails.
     const auto commandResponse = client.runCommand([&] {
         write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
-
-            // Ensure that the document for the (lsid, txnNumber) either has no participant list or
-            // has the same participant list. The document may have the same participant list if an
-            // earlier attempt to write the participant list failed waiting for writeConcern.
-            BSONObj noParticipantList = BSON(TransactionCoordinatorDocument::kParticipantsFieldName
-                                             << BSON("$exists" << false));
-            BSONObj sameParticipantList =
-                BSON("$and" << buildParticipantListMatchesConditions(participantList));
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON() << "$or"
-                            << BSON_ARRAY(noParticipantList << sameParticipantList)));
-
-            // Update with participant list.
-            TransactionCoordinatorDocument doc;
-            doc.setId(std::move(sessionInfo));
-            doc.setParticipants(std::move(participantList));
-            entry.setU(doc.toBSON());
-
-            entry.setUpsert(true);
-            return entry;
-        }()});
+        updateOp.setUpdates({std::move(entry)});
         return updateOp.serialize({});
     }());
 
@@ -191,13 +435,22 @@ Future<repl::OpTime> persistParticipantsList(txn::AsyncWorkScheduler& scheduler,
         scheduler,
         boost::none /* no need for a backoff */,
         [](const StatusWith<repl::OpTime>& s) { return shouldRetryPersistingCoordinatorState(s); },
-        [&scheduler, lsid, txnNumber, participants] {
-            return scheduler.scheduleWork([lsid, txnNumber, participants](OperationContext* opCtx) {
-                FlowControl::Bypass flowControlBypass(opCtx);
-                getTransactionCoordinatorWorkerCurOpRepository()->set(
-                    opCtx, lsid, txnNumber, CoordinatorAction::kWritingParticipantList);
-                return persistParticipantListBlocking(opCtx, lsid, txnNumber, participants);
-            });
+        [&scheduler,
+         lsid,
+         txnNumber,
+         participants,
+         isFirstAttempt = std::make_shared<bool>(true)] {
+            // Retries are written individually, so that a write which keeps failing doesn't make
+            // every batch it joins fail too.
+            const bool allowBatching = std::exchange(*isFirstAttempt, false);
+            return scheduler.scheduleWork(
+                [lsid, txnNumber, participants, allowBatching](OperationContext* opCtx) {
+                    FlowControl::Bypass flowControlBypass(opCtx);
+                    getTransactionCoordinatorWorkerCurOpRepository()->set(
+                        opCtx, lsid, txnNumber, CoordinatorAction::kWritingParticipantList);
+                    return persistParticipantListBlocking(
+                        opCtx, lsid, txnNumber, participants, allowBatching);
+                });
         });
 }
 
@@ -293,12 +546,12 @@ Future<PrepareVoteConsensus> sendPrepare(ServiceContext* service,
         });
 }
 
-namespace {
 repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
                                      const LogicalSessionId& lsid,
                                      TxnNumber txnNumber,
                                      const std::vector<ShardId>& participantList,
-                                     const txn::CoordinatorCommitDecision& decision) {
+                                     const txn::CoordinatorCommitDecision& decision,
+                                     bool allowBatching) {
     const bool isCommit = decision.getDecision() == txn::CommitDecision::kCommit;
     LOGV2_DEBUG(22467,
                 3,
@@ -316,37 +569,25 @@ repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
+    auto entry = makeDecisionUpdate(sessionInfo, participantList, decision);
+
+    if (auto opTime = writeCoordinatorDocumentAsPartOfBatch(opCtx, entry, allowBatching)) {
+        LOGV2_DEBUG(4859023,
+                    3,
+                    "{sessionId}:{txnNumber} Wrote decision {decision} as part of a batch",
+                    "Wrote decision as part of a batch",
+                    "sessionId"_attr = lsid.getId(),
+                    "txnNumber"_attr = txnNumber,
+                    "decision"_attr = (isCommit ? "commit" : "abort"));
+        return *opTime;
+    }
+
     DBDirectClient client(opCtx);
 
     // Throws if serializing the request or deserializing the response fails.
     const auto commandResponse = client.runCommand([&] {
         write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
-
-            // Ensure that the document for the (lsid, txnNumber) has the same participant list and
-            // either has no decision or the same decision. The document may have the same decision
-            // if an earlier attempt to write the decision failed waiting for writeConcern.
-            BSONObj noDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                      << BSON("$exists" << false));
-            BSONObj sameDecision =
-                BSON(TransactionCoordinatorDocument::kDecisionFieldName << decision.toBSON());
-
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON() << "$and"
-                            << buildParticipantListMatchesConditions(participantList) << "$or"
-                            << BSON_ARRAY(noDecision << sameDecision)));
-
-            entry.setU([&] {
-                TransactionCoordinatorDocument doc;
-                doc.setId(sessionInfo);
-                doc.setParticipants(std::move(participantList));
-                doc.setDecision(decision);
-                return doc.toBSON();
-            }());
-
-            return entry;
-        }()});
+        updateOp.setUpdates({std::move(entry)});
         return updateOp.serialize({});
     }());
 
@@ -382,7 +623,6 @@ repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
 
     return repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
 }
-}  // namespace
 
 Future<repl::OpTime> persistDecision(txn::AsyncWorkScheduler& scheduler,
                                      const LogicalSessionId& lsid,
@@ -393,13 +633,21 @@ Future<repl::OpTime> persistDecision(txn::AsyncWorkScheduler& scheduler,
         scheduler,
         boost::none /* no need for a backoff */,
         [](const StatusWith<repl::OpTime>& s) { return shouldRetryPersistingCoordinatorState(s); },
-        [&scheduler, lsid, txnNumber, participants, decision] {
+        [&scheduler,
+         lsid,
+         txnNumber,
+         participants,
+         decision,
+         isFirstAttempt = std::make_shared<bool>(true)] {
+            // Retries are written individually, as for the participant list
+            const bool allowBatching = std::exchange(*isFirstAttempt, false);
             return scheduler.scheduleWork(
-                [lsid, txnNumber, participants, decision](OperationContext* opCtx) {
+                [lsid, txnNumber, participants, decision, allowBatching](OperationContext* opCtx) {
                     FlowControl::Bypass flowControlBypass(opCtx);
                     getTransactionCoordinatorWorkerCurOpRepository()->set(
                         opCtx, lsid, txnNumber, CoordinatorAction::kWritingDecision);
-                    return persistDecisionBlocking(opCtx, lsid, txnNumber, participants, decision);
+                    return persistDecisionBlocking(
+                        opCtx, lsid, txnNumber, participants, decision, allowBatching);
                 });
         });
 }
@@ -807,5 +1055,9 @@ std::string txnIdToString(const LogicalSessionId& lsid, TxnNumber txnNumber) {
     return str::stream() << lsid.getId() << ':' << txnNumber;
 }
 
+size_t numCoordinatorDocumentWritesQueuedForTest(ServiceContext* service) {
+    return CoordinatorDocumentWriteBatcher::get(service).numQueued();
+}
+
 }  // namespace txn
 }  // namespace mongo
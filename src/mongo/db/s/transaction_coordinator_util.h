@@ -180,6 +180,18 @@ std::vector<txn::TransactionCoordinatorDocument> readAllCoordinatorDocs(Operatio
 // These methods are used internally and are exposed for unit-testing purposes only
 //
 
+/**
+ * Writes the decision synchronously on 'opCtx', as part of a batch with the decisions of other
+ * transactions if 'allowBatching' is set and batching is enabled. This is the body of each attempt
+ * made by persistDecision, and throws the errors listed for it.
+ */
+repl::OpTime persistDecisionBlocking(OperationContext* opCtx,
+                                     const LogicalSessionId& lsid,
+                                     TxnNumber txnNumber,
+                                     const std::vector<ShardId>& participantList,
+                                     const txn::CoordinatorCommitDecision& decision,
+                                     bool allowBatching);
+
 /**
  * Sends prepare to the given shard and returns a future, which will be set with the vote.
  *
@@ -236,5 +248,11 @@ Future<void> sendDecisionToShard(ServiceContext* service,
  */
 std::string txnIdToString(const LogicalSessionId& lsid, TxnNumber txnNumber);
 
+/**
+ * Returns the number of coordinator document writes waiting to be written as part of the next
+ * batch (see 'transactionCoordinatorDocumentWriteBatchMaxSize').
+ */
+size_t numCoordinatorDocumentWritesQueuedForTest(ServiceContext* service);
+
 }  // namespace txn
 }  // namespace mongo
@@ -980,6 +980,8 @@ void execCommandDatabase(OperationContext* opCtx,
                 helpField = element;
             } else if (fieldName == "comment") {
                 opCtx->setComment(element.wrap());
+            } else if (fieldName == "priority") {
+                opCtx->lockState()->setPriority(uassertStatusOK(Locker::parsePriority(element)));
             } else if (fieldName == QueryRequest::queryOptionMaxTimeMS) {
                 uasserted(ErrorCodes::InvalidOptions,
                           "no such command option $maxTimeMs; use maxTimeMS instead");
@@ -1395,6 +1397,7 @@ DbResponse receivedCommands(OperationContext* opCtx,
         if (responseObj.getField("ok").trueValue()) {
             dbResponse.shouldRunAgainForExhaust = replyBuilder->shouldRunAgainForExhaust();
             dbResponse.nextInvocation = replyBuilder->getNextInvocation();
+            dbResponse.nextExhaustResponseReady = replyBuilder->isNextExhaustResponseReady();
         }
     }
 
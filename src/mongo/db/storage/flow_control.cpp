@@ -214,6 +214,23 @@ BSONObj FlowControl::generateSection(OperationContext* opCtx,
     bob.append("isLaggedCount", _isLaggedCount.load());
     bob.append("isLaggedTimeMicros", _isLaggedTimeMicros.load());
 
+    {
+        BSONObjBuilder predictive(bob.subobjStart("predictive"));
+        predictive.append("enabled", gFlowControlPredictive.load());
+        predictive.append("sustainerRate", _predictedSustainerRate.load());
+        predictive.append("predictedLagMillis", _predictedLagMillis.load());
+        predictive.append("isLagged", _isPredictedLagged.load());
+
+        BSONArrayBuilder members(predictive.subarrayStart("members"));
+        stdx::lock_guard<Latch> lk(_modelMutex);
+        for (auto&& [memberId, rates] : _memberRates) {
+            BSONObjBuilder member(members.subobjStart());
+            member.append("memberId", memberId);
+            member.append("applyRate", rates.applyRate);
+            member.append("durableRate", rates.durableRate);
+        }
+    }
+
     return bob.obj();
 }
 
@@ -318,6 +335,120 @@ int FlowControl::_calculateNewTicketsForLag(const std::vector<repl::MemberData>&
     return multiplyWithOverflowCheck(locksPerOp, sustainerAppliedPenalty, kMaxTickets);
 }
 
+void FlowControl::_updateMemberRates(const std::vector<repl::MemberData>& prevMemberData,
+                                     const std::vector<repl::MemberData>& currMemberData,
+                                     Milliseconds period) {
+    if (period <= Milliseconds(0)) {
+        return;
+    }
+
+    const double periodSeconds = durationCount<Milliseconds>(period) / 1000.0;
+    const double smoothing = gFlowControlPredictiveSmoothingFactor.load();
+
+    auto opsPerSecond = [&](const repl::OpTime& prev, const repl::OpTime& curr) -> double {
+        if (curr.getTimestamp() <= prev.getTimestamp()) {
+            return 0.0;
+        }
+
+        // -1 means both optimes fall between the same two samples, i.e. very few operations.
+        const auto ops = _approximateOpsBetween(prev.getTimestamp(), curr.getTimestamp());
+        return ops > 0 ? ops / periodSeconds : 0.0;
+    };
+
+    stdx::lock_guard<Latch> lk(_modelMutex);
+    stdx::unordered_map<int, MemberRates> newRates;
+    for (const auto& curr : currMemberData) {
+        auto prev = std::find_if(
+            prevMemberData.begin(), prevMemberData.end(), [&](const repl::MemberData& member) {
+                return member.getMemberId() == curr.getMemberId();
+            });
+        if (prev == prevMemberData.end()) {
+            continue;
+        }
+
+        double applyRate =
+            opsPerSecond(prev->getLastAppliedOpTime(), curr.getLastAppliedOpTime());
+        double durableRate =
+            opsPerSecond(prev->getLastDurableOpTime(), curr.getLastDurableOpTime());
+
+        // Members seen for the first time start from their first observation rather than zero.
+        auto it = _memberRates.find(curr.getMemberId().getData());
+        if (it != _memberRates.end()) {
+            applyRate = smoothing * applyRate + (1.0 - smoothing) * it->second.applyRate;
+            durableRate = smoothing * durableRate + (1.0 - smoothing) * it->second.durableRate;
+        }
+
+        newRates.emplace(curr.getMemberId().getData(), MemberRates(applyRate, durableRate));
+    }
+
+    // Members that left the config are forgotten.
+    _memberRates = std::move(newRates);
+}
+
+boost::optional<int> FlowControl::_calculateNewTicketsPredictive(std::int64_t opsLagged,
+                                                                 double locksPerOp,
+                                                                 std::uint64_t thresholdLagMillis,
+                                                                 int rampTickets) {
+    std::vector<double> applyRates;
+    {
+        stdx::lock_guard<Latch> lk(_modelMutex);
+        for (auto&& [memberId, rates] : _memberRates) {
+            applyRates.push_back(rates.applyRate);
+        }
+    }
+
+    if (applyRates.empty()) {
+        return boost::none;
+    }
+
+    // A majority of members apply at least as fast as this rate, so it is the rate at which the
+    // commit point can keep advancing. The fastest member is the primary itself.
+    std::sort(applyRates.begin(), applyRates.end());
+    const double sustainerRate = applyRates[(applyRates.size() - 1) / 2];
+    const double primaryRate = applyRates.back();
+
+    const double horizonSeconds = gFlowControlPredictiveHorizonSeconds.load();
+    const double lagOps = static_cast<double>(std::max(opsLagged, std::int64_t{0}));
+
+    // The backlog of operations the majority can carry while staying at the threshold lag, and
+    // the backlog at the end of the horizon if the primary keeps writing at its current rate.
+    const double budgetOps = sustainerRate * thresholdLagMillis / 1000.0;
+    const double predictedOps = lagOps + (primaryRate - sustainerRate) * horizonSeconds;
+
+    _predictedSustainerRate.store(sustainerRate);
+    if (sustainerRate > 0.0) {
+        _predictedLagMillis.store(
+            static_cast<std::int64_t>(std::max(predictedOps, 0.0) / sustainerRate * 1000.0));
+    } else {
+        _predictedLagMillis.store(predictedOps > 0.0 ? std::numeric_limits<std::int64_t>::max()
+                                                     : 0);
+    }
+
+    if (predictedOps <= budgetOps) {
+        _isPredictedLagged.store(false);
+        return rampTickets;
+    }
+
+    // Admit writes at the sustainer's pace, corrected so that the backlog converges on the budget
+    // by the end of the horizon. This slows the primary down smoothly as the lag approaches the
+    // threshold, rather than abruptly once it has been crossed.
+    _isPredictedLagged.store(true);
+    const double admitOps = std::max(
+        0.0, sustainerRate * gFlowControlFudgeFactor.load() + (budgetOps - lagOps) / horizonSeconds);
+
+    LOGV2_DEBUG(4859000,
+                DEBUG_LOG_LEVEL,
+                "Predictive flow control is throttling writes",
+                "sustainerRate"_attr = sustainerRate,
+                "primaryRate"_attr = primaryRate,
+                "opsLagged"_attr = opsLagged,
+                "budgetOps"_attr = budgetOps,
+                "predictedOps"_attr = predictedOps,
+                "admitOps"_attr = admitOps);
+
+    return std::min(rampTickets, multiplyWithOverflowCheck(locksPerOp, admitOps, kMaxTickets));
+}
+
 int FlowControl::getNumTickets(Date_t now) {
     // Flow control can be disabled until a certain deadline is passed.
     const Date_t disabledUntil = _disableUntil.load();
@@ -337,6 +468,10 @@ int FlowControl::getNumTickets(Date_t now) {
 
     // It's important to update the topology on each iteration.
     _updateTopologyData();
+    if (gFlowControlPredictive.load() && _lastTicketCalculation != Date_t()) {
+        _updateMemberRates(_prevMemberData, _currMemberData, now - _lastTicketCalculation);
+    }
+    _lastTicketCalculation = now;
     const repl::OpTimeAndWallTime myLastApplied = _replCoord->getMyLastAppliedOpTimeAndWallTime();
     const repl::OpTimeAndWallTime lastCommitted = _replCoord->getLastCommittedOpTimeAndWallTime();
     const double locksPerOp = _getLocksPerOp();
@@ -367,13 +502,15 @@ int FlowControl::getNumTickets(Date_t now) {
          _approximateOpsBetween(lastCommitted.opTime.getTimestamp(),
                                 myLastApplied.opTime.getTimestamp()) == -1);
 
+    // The add/multiply technique is used to ensure ticket allocation can ramp up quickly,
+    // particularly if there were very few tickets to begin with.
+    const int rampTickets = multiplyWithOverflowCheck(_lastTargetTicketsPermitted.load() +
+                                                          gFlowControlTicketAdderConstant.load(),
+                                                      gFlowControlTicketMultiplierConstant.load(),
+                                                      kMaxTickets);
+
     if (isHealthy) {
-        // The add/multiply technique is used to ensure ticket allocation can ramp up quickly,
-        // particularly if there were very few tickets to begin with.
-        ret = multiplyWithOverflowCheck(_lastTargetTicketsPermitted.load() +
-                                            gFlowControlTicketAdderConstant.load(),
-                                        gFlowControlTicketMultiplierConstant.load(),
-                                        kMaxTickets);
+        ret = rampTickets;
         _lastTimeSustainerAdvanced = Date_t::now();
         if (_isLagged.load()) {
             _isLagged.store(false);
@@ -405,6 +542,17 @@ int FlowControl::getNumTickets(Date_t now) {
         // variables here.
     }
 
+    // The predictive model, once it has rates to work with, decides the ticket count on its own.
+    // The _isLagged* variables above keep describing the observed lag.
+    if (gFlowControlPredictive.load() && !ignoreWallTimes) {
+        const auto opsLagged = _approximateOpsBetween(lastCommitted.opTime.getTimestamp(),
+                                                      myLastApplied.opTime.getTimestamp());
+        if (auto predicted = _calculateNewTicketsPredictive(
+                opsLagged, locksPerOp, thresholdLagMillis, rampTickets)) {
+            ret = *predicted;
+        }
+    }
+
     ret = std::max(ret, gFlowControlMinTicketsPerSecond.load());
 
     LOGV2_DEBUG(22220,
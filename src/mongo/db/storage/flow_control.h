@@ -38,6 +38,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -129,6 +130,26 @@ public:
                                    std::uint64_t thresholdLagMillis);
     void _trimSamples(const Timestamp trimSamplesTo);
 
+    /**
+     * Folds the progress each member made between two topology observations `period` apart into
+     * the exponentially weighted moving averages of the members' apply and durable rates.
+     */
+    void _updateMemberRates(const std::vector<repl::MemberData>& prevMemberData,
+                            const std::vector<repl::MemberData>& currMemberData,
+                            Milliseconds period);
+
+    /**
+     * Predicts the majority commit point lag `gFlowControlPredictiveHorizonSeconds` from now from
+     * the members' smoothed apply rates. If the predicted lag stays within the threshold, returns
+     * `rampTickets`. Otherwise returns the number of tickets that lets the lag settle at the
+     * threshold by the end of the horizon. Returns boost::none if there are no rates to predict
+     * from yet.
+     */
+    boost::optional<int> _calculateNewTicketsPredictive(std::int64_t opsLagged,
+                                                        double locksPerOp,
+                                                        std::uint64_t thresholdLagMillis,
+                                                        int rampTickets);
+
     // Sample of (timestamp, ops, lock acquisitions) where ops and lock acquisitions are
     // observations of the corresponding counter at (roughly) <timestamp>.
     typedef std::tuple<std::uint64_t, std::uint64_t, std::int64_t> Sample;
@@ -137,6 +158,17 @@ public:
     }
 
 private:
+    /**
+     * Smoothed per-member throughput, in operations per second, derived from the optimes members
+     * report through replSetUpdatePosition and heartbeats.
+     */
+    struct MemberRates {
+        MemberRates(double applyRate, double durableRate)
+            : applyRate(applyRate), durableRate(durableRate) {}
+        double applyRate;
+        double durableRate;
+    };
+
     repl::ReplicationCoordinator* _replCoord;
 
     // These values are updated with each flow control computation and are also surfaced in server
@@ -164,6 +196,14 @@ private:
 
     Date_t _lastTimeSustainerAdvanced;
 
+    // State of the predictive model. The rates are keyed by member id.
+    mutable Mutex _modelMutex = MONGO_MAKE_LATCH("FlowControl::_modelMutex");
+    stdx::unordered_map<int, MemberRates> _memberRates;
+    AtomicWord<double> _predictedSustainerRate{0.0};
+    AtomicWord<std::int64_t> _predictedLagMillis{0};
+    AtomicWord<bool> _isPredictedLagged{false};
+    Date_t _lastTicketCalculation;
+
     // This value is used for calculating server status metrics.
     std::uint64_t _startWaitTime = 0;
 
@@ -249,6 +249,77 @@ TEST_F(FlowControlTest, CalculatingTickets) {
                                                       thresholdLag));
 }
 
+TEST_F(FlowControlTest, PredictiveWithoutRates) {
+    ASSERT_FALSE(flowControl->_calculateNewTicketsPredictive(0, 1.0, 1000, 1000));
+}
+
+TEST_F(FlowControlTest, PredictiveCalculatingTickets) {
+    gFlowControlFudgeFactor.store(0.95);
+    gFlowControlPredictiveHorizonSeconds.store(5.0);
+    gFlowControlPredictiveSmoothingFactor.store(1.0);
+
+    // Constructs a member data instance for member `id` with an optime at term 1, timestamp `ts`.
+    auto constructMemberData = [](int id, Timestamp ts) -> repl::MemberData {
+        repl::MemberData ret;
+        ret.setMemberId(repl::MemberId(id));
+        ret.setLastAppliedOpTimeAndWallTime({{ts, 1}, Date_t()}, Date_t());
+        return ret;
+    };
+
+    // Construct samples where Timestamp X maps to operation number X.
+    for (int ts = 1; ts <= 4000; ++ts) {
+        flowControl->sample(Timestamp(ts), 1);
+    }
+
+    const double locksPerOp = 2.0;
+    const std::uint64_t thresholdLagMillis = 1000;
+    const int rampTickets = 100 * 1000;
+
+    // Over one second, every member applies 1,000 operations.
+    std::vector<repl::MemberData> prevMemberData;
+    prevMemberData.emplace_back(constructMemberData(0, Timestamp(1000)));
+    prevMemberData.emplace_back(constructMemberData(1, Timestamp(1000)));
+    prevMemberData.emplace_back(constructMemberData(2, Timestamp(1000)));
+
+    std::vector<repl::MemberData> currMemberData;
+    currMemberData.emplace_back(constructMemberData(0, Timestamp(2000)));
+    currMemberData.emplace_back(constructMemberData(1, Timestamp(2000)));
+    currMemberData.emplace_back(constructMemberData(2, Timestamp(2000)));
+
+    flowControl->_updateMemberRates(prevMemberData, currMemberData, Seconds(1));
+
+    // With no backlog and the primary no faster than the secondaries, the lag is predicted to stay
+    // small and tickets may keep ramping up.
+    auto healthy =
+        flowControl->_calculateNewTicketsPredictive(0, locksPerOp, thresholdLagMillis, rampTickets);
+    ASSERT(healthy);
+    ASSERT_EQ(rampTickets, *healthy);
+
+    // Over the next second, the secondaries apply 1,000 operations while the primary applies 2,000.
+    prevMemberData = currMemberData;
+    currMemberData.clear();
+    currMemberData.emplace_back(constructMemberData(0, Timestamp(4000)));
+    currMemberData.emplace_back(constructMemberData(1, Timestamp(3000)));
+    currMemberData.emplace_back(constructMemberData(2, Timestamp(3000)));
+
+    flowControl->_updateMemberRates(prevMemberData, currMemberData, Seconds(1));
+
+    // A backlog of one second's worth of sustainer operations is exactly at the threshold, and the
+    // primary is outpacing the secondaries. The primary should fall back to 95%
+    // (gFlowControlFudgeFactor) of the 1,000 operations per second the secondaries sustain, which
+    // at 2.0 locksPerOp is 1900 tickets.
+    auto lagged = flowControl->_calculateNewTicketsPredictive(
+        1000, locksPerOp, thresholdLagMillis, rampTickets);
+    ASSERT(lagged);
+    ASSERT_EQ(1900, *lagged);
+
+    // Twice the budget should drain the extra 1,000 operations over the 5 second horizon.
+    auto moreLagged = flowControl->_calculateNewTicketsPredictive(
+        2000, locksPerOp, thresholdLagMillis, rampTickets);
+    ASSERT(moreLagged);
+    ASSERT_EQ(1500, *moreLagged);
+}
+
 TEST_F(FlowControlTest, DisableUntil) {
     const int ticketOverride = 52319;
 
@@ -89,6 +89,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
@@ -482,8 +483,181 @@ private:
 namespace {
 TicketHolder openWriteTransaction(128);
 TicketHolder openReadTransaction(128);
+
+// Size the ticket pools above while wiredTigerAdaptiveConcurrency is on. Guarded by
+// adaptiveTransactionMutex, as serverStatus reports on them.
+Mutex adaptiveTransactionMutex = MONGO_MAKE_LATCH("WiredTigerKVEngine::adaptiveTransactionMutex");
+AdaptiveTicketController adaptiveWriteTransaction;
+AdaptiveTicketController adaptiveReadTransaction;
 }  // namespace
 
+Status onUpdateWiredTigerAdaptiveConcurrency(const bool& enabled) {
+    openWriteTransaction.setPrioritizeWaiters(enabled);
+    openReadTransaction.setPrioritizeWaiters(enabled);
+    return Status::OK();
+}
+
+/**
+ * Resizes the read and write ticket pools with an AdaptiveTicketController each, while
+ * wiredTigerAdaptiveConcurrency is on. The tickets in use and whether anyone is waiting for one
+ * are sampled every 10ms, and every 100ms the samples and whether application threads had to evict
+ * pages from the cache are handed to the controllers.
+ */
+class WiredTigerKVEngine::WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerTicketAdjuster(WT_CONNECTION* conn)
+        : BackgroundJob(false /* deleteSelf */),
+          _conn(conn),
+          _read{&openReadTransaction, &adaptiveReadTransaction},
+          _write{&openWriteTransaction, &adaptiveWriteTransaction} {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOGV2_DEBUG(4859044, 1, "starting {name} thread", "name"_attr = name());
+
+        WiredTigerSession session(_conn);
+        int samples = 0;
+        while (!_shuttingDown.load()) {
+            // Only sample at the full rate while adaptive concurrency is enabled, which is not the
+            // default, and otherwise just check back occasionally whether it has been.
+            const auto interval =
+                gWiredTigerAdaptiveConcurrency.load() ? kSampleInterval : kDisabledCheckInterval;
+            {
+                stdx::unique_lock<Latch> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(
+                    lock, interval.toSystemDuration(), [&] { return _shuttingDown.load(); });
+            }
+
+            if (!gWiredTigerAdaptiveConcurrency.load()) {
+                samples = 0;
+                continue;
+            }
+
+            if (samples == 0) {
+                _read.reset();
+                _write.reset();
+                _lastAppEvictions = _getAppEvictions(session);
+            }
+
+            _read.sample();
+            _write.sample();
+            if (++samples < kSamplesPerAdjustment) {
+                continue;
+            }
+            samples = 0;
+
+            // Application threads only evict pages once the cache is too full or dirty for the
+            // eviction threads to keep up, which means the workload outgrows the cache.
+            auto appEvictions = _getAppEvictions(session);
+            const bool cachePressure = appEvictions > _lastAppEvictions;
+            _lastAppEvictions = appEvictions;
+
+            const auto minTickets = gWiredTigerAdaptiveConcurrencyMinTickets.load();
+            const auto maxTickets =
+                std::max(minTickets, gWiredTigerAdaptiveConcurrencyMaxTickets.load());
+            _adjust(&_read, cachePressure, minTickets, maxTickets);
+            _adjust(&_write, cachePressure, minTickets, maxTickets);
+        }
+        LOGV2_DEBUG(4859045, 1, "stopping {name} thread", "name"_attr = name());
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    static constexpr Milliseconds kSampleInterval{10};
+    static constexpr Milliseconds kDisabledCheckInterval{1000};
+    static constexpr int kSamplesPerAdjustment = 10;
+
+    /**
+     * One ticket pool and what was sampled of it since the last adjustment.
+     */
+    struct Pool {
+        void reset() {
+            lastReleased = holder->numReleased();
+            inUse = 0;
+            samples = 0;
+            queued = false;
+        }
+
+        void sample() {
+            inUse += holder->used();
+            ++samples;
+            queued = queued || holder->waiting() > 0;
+        }
+
+        TicketHolder* holder;
+        AdaptiveTicketController* controller;
+        long long lastReleased = 0;
+        long long inUse = 0;
+        int samples = 0;
+        bool queued = false;
+    };
+
+    void _adjust(Pool* pool, bool cachePressure, int minTickets, int maxTickets) {
+        AdaptiveTicketController::Observation observation;
+        observation.interval = kSampleInterval * pool->samples;
+        observation.totalTickets = pool->holder->outof();
+        observation.released = pool->holder->numReleased() - pool->lastReleased;
+        observation.averageInUse = static_cast<double>(pool->inUse) / pool->samples;
+        observation.queued = pool->queued;
+        observation.cachePressure = cachePressure;
+
+        int target;
+        {
+            stdx::lock_guard<Latch> lock(adaptiveTransactionMutex);
+            target = pool->controller->update(observation, minTickets, maxTickets);
+        }
+        pool->reset();
+
+        if (target == observation.totalTickets) {
+            return;
+        }
+
+        LOGV2_DEBUG(4859046,
+                    2,
+                    "Resizing ticket pool",
+                    "from"_attr = observation.totalTickets,
+                    "to"_attr = target,
+                    "cachePressure"_attr = cachePressure);
+
+        // Shrinking waits for enough tickets to be released, so this must not hold a mutex.
+        auto status = pool->holder->resize(target);
+        if (!status.isOK()) {
+            LOGV2_WARNING(4859047, "Failed to resize ticket pool", "error"_attr = status);
+        }
+    }
+
+    long long _getAppEvictions(WiredTigerSession& session) {
+        auto result = WiredTigerUtil::getStatisticsValue(session.getSession(),
+                                                         "statistics:",
+                                                         "statistics=(fast)",
+                                                         WT_STAT_CONN_CACHE_EVICTION_APP);
+        return result.isOK() ? result.getValue() : _lastAppEvictions;
+    }
+
+    WT_CONNECTION* _conn;
+    AtomicWord<bool> _shuttingDown{false};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerTicketAdjuster::_mutex");  // protects _condvar
+    stdx::condition_variable _condvar;
+
+    Pool _read;
+    Pool _write;
+    long long _lastAppEvictions = 0;
+};
+
 OpenWriteTransactionParam::OpenWriteTransactionParam(StringData name, ServerParameterType spt)
     : ServerParameter(name, spt), _data(&openWriteTransaction) {}
 
@@ -743,6 +917,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 
+    _ticketAdjuster = std::make_unique<WiredTigerTicketAdjuster>(_conn);
+    _ticketAdjuster->go();
+
     _runTimeConfigParam.reset(new WiredTigerEngineRuntimeConfigParameter(
         "wiredTigerEngineRuntimeConfig", ServerParameterType::kRuntimeOnly));
     _runTimeConfigParam->_data.second = this;
@@ -775,6 +952,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        bbb.append("lowPriorityDeferrals", openWriteTransaction.numLowPriorityDeferrals());
         bbb.done();
     }
     {
@@ -782,6 +960,22 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        bbb.append("lowPriorityDeferrals", openReadTransaction.numLowPriorityDeferrals());
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("adaptive"));
+        bbb.append("enabled", gWiredTigerAdaptiveConcurrency.load());
+
+        stdx::lock_guard<Latch> lk(adaptiveTransactionMutex);
+        {
+            BSONObjBuilder bbbb(bbb.subobjStart("write"));
+            adaptiveWriteTransaction.appendStats(&bbbb);
+        }
+        {
+            BSONObjBuilder bbbb(bbb.subobjStart("read"));
+            adaptiveReadTransaction.appendStats(&bbbb);
+        }
         bbb.done();
     }
     bb.done();
@@ -871,6 +1065,11 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketAdjuster) {
+        LOGV2(4859048, "Shutting down ticket adjuster thread");
+        _ticketAdjuster->shutdown();
+        LOGV2(4859049, "Finished shutting down ticket adjuster thread");
+    }
     if (_sessionSweeper) {
         LOGV2(22318, "Shutting down session sweeper thread");
         _sessionSweeper->shutdown();
@@ -57,6 +57,12 @@ class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
 class WiredTigerEngineRuntimeConfigParameter;
 
+/**
+ * Lets the read and write ticket pools prioritize waiters while wiredTigerAdaptiveConcurrency is
+ * on.
+ */
+Status onUpdateWiredTigerAdaptiveConcurrency(const bool& enabled);
+
 struct WiredTigerFileVersion {
     // MongoDB 4.4+ will not open on datafiles left behind by 4.2.5 and earlier. MongoDB 4.4
     // shutting down in FCV 4.2 will leave data files that 4.2.6+ will understand
@@ -367,6 +373,7 @@ public:
 private:
     class WiredTigerSessionSweeper;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketAdjuster;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -456,6 +463,7 @@ private:
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
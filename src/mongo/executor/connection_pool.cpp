@@ -41,6 +41,7 @@
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/logv2/log.h"
 #include "mongo/logv2/log_severity_suppressor.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/destructor_guard.h"
@@ -241,13 +242,14 @@ public:
     auto guardCallback(Callback&& cb) {
         return
             [this, cb = std::forward<Callback>(cb), anchor = shared_from_this()](auto&&... args) {
-                stdx::lock_guard lk(_parent->_mutex);
+                stdx::lock_guard lk(_shard->mutex);
                 cb(std::forward<decltype(args)>(args)...);
                 updateState();
             };
     }
 
     SpecificPool(std::shared_ptr<ConnectionPool> parent,
+                 Shard* shard,
                  const HostAndPort& hostAndPort,
                  transport::ConnectSSLMode sslMode);
     ~SpecificPool();
@@ -256,6 +258,7 @@ public:
      * Create and initialize a SpecificPool
      */
     static auto make(std::shared_ptr<ConnectionPool> parent,
+                     Shard* shard,
                      const HostAndPort& hostAndPort,
                      transport::ConnectSSLMode sslMode);
 
@@ -269,7 +272,7 @@ public:
 
     /**
      * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * parent to preserve the lock on the shard mutex
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout);
 
@@ -395,6 +398,7 @@ private:
 
 private:
     const std::shared_ptr<ConnectionPool> _parent;
+    Shard* const _shard;
 
     const transport::ConnectSSLMode _sslMode;
     const HostAndPort _hostAndPort;
@@ -432,11 +436,12 @@ private:
 };
 
 auto ConnectionPool::SpecificPool::make(std::shared_ptr<ConnectionPool> parent,
+                                        Shard* shard,
                                         const HostAndPort& hostAndPort,
                                         transport::ConnectSSLMode sslMode) {
-    auto& controller = *parent->_controller;
+    auto& controller = *shard->controller;
 
-    auto pool = std::make_shared<SpecificPool>(std::move(parent), hostAndPort, sslMode);
+    auto pool = std::make_shared<SpecificPool>(std::move(parent), shard, hostAndPort, sslMode);
 
     // Inform the controller that we exist
     controller.addHost(pool->_id, hostAndPort);
@@ -456,14 +461,21 @@ ConnectionPool::ConnectionPool(std::shared_ptr<DependentTypeFactoryInterface> im
     : _name(std::move(name)),
       _factory(std::move(impl)),
       _options(std::move(options)),
-      _controller(_options.controllerFactory()),
       _manager(options.egressTagCloserManager) {
     if (_manager) {
         _manager->add(this);
     }
 
-    invariant(_controller);
-    _controller->init(this);
+    invariant(_options.shardCount > 0);
+    _shards.reserve(_options.shardCount);
+    for (size_t i = 0; i < _options.shardCount; ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->controller = _options.controllerFactory();
+
+        invariant(shard->controller);
+        shard->controller->init(this);
+        _shards.push_back(std::move(shard));
+    }
 }
 
 ConnectionPool::~ConnectionPool() {
@@ -479,58 +491,66 @@ ConnectionPool::~ConnectionPool() {
 void ConnectionPool::shutdown() {
     _factory->shutdown();
 
-    // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::lock_guard lk(_mutex);
-        return _pools;
-    }();
-
-    for (const auto& pair : pools) {
-        stdx::lock_guard lk(_mutex);
-        pair.second->triggerShutdown(
-            Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
+    for (auto& shard : _shards) {
+        // Grab all current pools (under the lock)
+        auto pools = [&] {
+            stdx::lock_guard lk(shard->mutex);
+            return shard->pools;
+        }();
+
+        for (const auto& pair : pools) {
+            stdx::lock_guard lk(shard->mutex);
+            pair.second->triggerShutdown(
+                Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
+        }
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::lock_guard lk(_mutex);
+    for (auto& shard : _shards) {
+        stdx::lock_guard lk(shard->mutex);
 
-    auto iter = _pools.find(hostAndPort);
+        auto iter = shard->pools.find(hostAndPort);
 
-    if (iter == _pools.end())
-        return;
+        if (iter == shard->pools.end())
+            continue;
 
-    auto& pool = iter->second;
-    pool->triggerShutdown(
-        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
+        auto& pool = iter->second;
+        pool->triggerShutdown(
+            Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
+    }
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
-    stdx::lock_guard lk(_mutex);
+    for (auto& shard : _shards) {
+        stdx::lock_guard lk(shard->mutex);
 
-    for (const auto& pair : _pools) {
-        auto& pool = pair.second;
+        for (const auto& pair : shard->pools) {
+            auto& pool = pair.second;
 
-        if (pool->matchesTags(tags))
-            continue;
+            if (pool->matchesTags(tags))
+                continue;
 
-        pool->triggerShutdown(
-            Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
+            pool->triggerShutdown(
+                Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
+        }
     }
 }
 
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const std::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::lock_guard lk(_mutex);
+    for (auto& shard : _shards) {
+        stdx::lock_guard lk(shard->mutex);
 
-    auto iter = _pools.find(hostAndPort);
+        auto iter = shard->pools.find(hostAndPort);
 
-    if (iter == _pools.end())
-        return;
+        if (iter == shard->pools.end())
+            continue;
 
-    auto pool = iter->second;
-    pool->mutateTags(mutateFunc);
+        auto pool = iter->second;
+        pool->mutateTags(mutateFunc);
+    }
 }
 
 void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
@@ -548,11 +568,12 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                                  transport::ConnectSSLMode sslMode,
                                                                  Milliseconds timeout) {
-    stdx::lock_guard lk(_mutex);
+    auto& shard = _getShard();
+    stdx::lock_guard lk(shard.mutex);
 
-    auto& pool = _pools[hostAndPort];
+    auto& pool = shard.pools[hostAndPort];
     if (!pool) {
-        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
+        pool = SpecificPool::make(shared_from_this(), &shard, hostAndPort, sslMode);
     } else {
         pool->fassertSSLModeIs(sslMode);
     }
@@ -566,37 +587,55 @@ SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPo
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::lock_guard lk(_mutex);
-
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
-
-        auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(),
-                                     pool->availableConnections(),
-                                     pool->createdConnections(),
-                                     pool->refreshingConnections()};
-        stats->updateStatsForHost(_name, host, hostStats);
+    // Stats for a host are accumulated, so a host with pools in several shards reports their sum
+    for (const auto& shard : _shards) {
+        stdx::lock_guard lk(shard->mutex);
+
+        for (const auto& kv : shard->pools) {
+            HostAndPort host = kv.first;
+
+            auto& pool = kv.second;
+            ConnectionStatsPer hostStats{pool->inUseConnections(),
+                                         pool->availableConnections(),
+                                         pool->createdConnections(),
+                                         pool->refreshingConnections()};
+            stats->updateStatsForHost(_name, host, hostStats);
+        }
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::lock_guard lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections();
+    size_t numConnections = 0;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard lk(shard->mutex);
+        auto iter = shard->pools.find(hostAndPort);
+        if (iter != shard->pools.end()) {
+            numConnections += iter->second->openConnections();
+        }
+    }
+
+    return numConnections;
+}
+
+auto ConnectionPool::_getShard() -> Shard& {
+    if (_shards.size() == 1) {
+        return *_shards.front();
     }
 
-    return 0;
+    // Keep each thread on one shard so that it keeps reusing the connections it returned
+    const auto threadHash = std::hash<stdx::thread::id>{}(stdx::this_thread::get_id());
+    return *_shards[threadHash % _shards.size()];
 }
 
 ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> parent,
+                                           Shard* shard,
                                            const HostAndPort& hostAndPort,
                                            transport::ConnectSSLMode sslMode)
     : _parent(std::move(parent)),
+      _shard(shard),
       _sslMode(sslMode),
       _hostAndPort(hostAndPort),
-      _id(_parent->_nextPoolId++),
+      _id(_parent->_nextPoolId.fetchAndAdd(1)),
       _readyPool(std::numeric_limits<size_t>::max()) {
     invariant(_parent);
     _eventTimer = _parent->_factory->makeTimer();
@@ -656,7 +695,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
         }
     }
 
-    auto pendingTimeout = _parent->_controller->pendingTimeout();
+    auto pendingTimeout = _shard->controller->pendingTimeout();
     if (timeout < Milliseconds(0) || timeout > pendingTimeout) {
         timeout = pendingTimeout;
     }
@@ -678,7 +717,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
     auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
-        stdx::lock_guard lk(_parent->_mutex);
+        stdx::lock_guard lk(_shard->mutex);
         returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
         updateState();
@@ -780,7 +819,7 @@ void ConnectionPool::SpecificPool::finishRefresh(ConnectionInterface* connPtr, S
 }
 
 void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr) {
-    auto needsRefreshTP = connPtr->getLastUsed() + _parent->_controller->toRefreshTimeout();
+    auto needsRefreshTP = connPtr->getLastUsed() + _shard->controller->toRefreshTimeout();
 
     auto conn = takeFromPool(_checkedOutPool, connPtr);
     invariant(conn);
@@ -811,7 +850,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
     if (needsRefreshTP <= now) {
         // If we need to refresh this connection
 
-        auto controls = _parent->_controller->getControls(_id);
+        auto controls = _shard->controller->getControls(_id);
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
             controls.targetConnections) {
             // If we already have minConnections, just let the connection lapse
@@ -831,7 +870,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
                     "Refreshing connection to {hostAndPort}",
                     "Refreshing connection",
                     "hostAndPort"_attr = _hostAndPort);
-        connPtr->refresh(_parent->_controller->pendingTimeout(),
+        connPtr->refresh(_shard->controller->pendingTimeout(),
                          guardCallback([this](auto conn, auto status) {
                              finishRefresh(std::move(conn), std::move(status));
                          }));
@@ -882,7 +921,7 @@ void ConnectionPool::SpecificPool::addToReady(OwnedConnection conn) {
 
         returnConnection(connPtr);
     });
-    connPtr->setTimeout(_parent->_controller->toRefreshTimeout(), std::move(returnConnectionFunc));
+    connPtr->setTimeout(_shard->controller->toRefreshTimeout(), std::move(returnConnectionFunc));
 }
 
 // Sets state to shutdown and kicks off the failure protocol to tank existing connections
@@ -901,8 +940,8 @@ void ConnectionPool::SpecificPool::triggerShutdown(const Status& status) {
     // Make sure the pool lifetime lasts until the end of this function,
     // it could be only in the map of pools
     auto anchor = shared_from_this();
-    _parent->_controller->removeHost(_id);
-    _parent->_pools.erase(_hostAndPort);
+    _shard->controller->removeHost(_id);
+    _shard->pools.erase(_hostAndPort);
 
     processFailure(status);
 
@@ -1001,7 +1040,7 @@ void ConnectionPool::SpecificPool::spawnConnections() {
         return;
     }
 
-    auto controls = _parent->_controller->getControls(_id);
+    auto controls = _shard->controller->getControls(_id);
     LOGV2_DEBUG(22575,
                 kDiagnosticLogLevel,
                 "Comparing connection state for {hostAndPort} to controls: {poolControls}",
@@ -1049,7 +1088,7 @@ void ConnectionPool::SpecificPool::spawnConnections() {
         ++_created;
 
         // Run the setup callback
-        handle->setup(_parent->_controller->pendingTimeout(),
+        handle->setup(_shard->controller->pendingTimeout(),
                       guardCallback([this](auto conn, auto status) {
                           finishRefresh(std::move(conn), std::move(status));
                       }));
@@ -1101,7 +1140,7 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
 
     // If our expiration comes before our next event, then it is the next event
     if (_requests.empty() && _checkedOutPool.empty()) {
-        _hostExpiration = _lastActiveTime + _parent->_controller->hostTimeout();
+        _hostExpiration = _lastActiveTime + _shard->controller->hostTimeout();
         if ((_hostExpiration > now) && (_hostExpiration < nextEventTime)) {
             nextEventTime = _hostExpiration;
         }
@@ -1149,7 +1188,7 @@ void ConnectionPool::SpecificPool::updateController() {
         return;
     }
 
-    auto& controller = *_parent->_controller;
+    auto& controller = *_shard->controller;
 
     // Update our own state
     HostState state{
@@ -1170,8 +1209,8 @@ void ConnectionPool::SpecificPool::updateController() {
     // If we can shutdown, then do so
     if (hostGroup.canShutdown) {
         for (const auto& host : hostGroup.hosts) {
-            auto it = _parent->_pools.find(host);
-            if (it == _parent->_pools.end()) {
+            auto it = _shard->pools.find(host);
+            if (it == _shard->pools.end()) {
                 continue;
             }
 
@@ -1207,8 +1246,8 @@ void ConnectionPool::SpecificPool::updateController() {
 
     // Make sure all related hosts exist
     for (const auto& host : hostGroup.hosts) {
-        if (auto& pool = _parent->_pools[host]; !pool) {
-            pool = SpecificPool::make(_parent, host, _sslMode);
+        if (auto& pool = _shard->pools[host]; !pool) {
+            pool = SpecificPool::make(_parent, _shard, host, _sslMode);
         }
     }
 
@@ -1238,7 +1277,7 @@ void ConnectionPool::SpecificPool::updateState() {
         .getAsync([this, anchor = shared_from_this()](Status&& status) mutable {
             invariant(status);
 
-            stdx::lock_guard lk(_parent->_mutex);
+            stdx::lock_guard lk(_shard->mutex);
             _updateScheduled = false;
             updateController();
         });
@@ -35,6 +35,7 @@
 
 #include "mongo/executor/egress_tag_closer.h"
 #include "mongo/executor/egress_tag_closer_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/session.h"
@@ -150,6 +151,15 @@ public:
          */
         bool skipAuthentication = false;
 
+        /**
+         * The number of independent shards to split the pool into. Each shard has its own mutex,
+         * its own per-host pools and its own controller from controllerFactory, and callers are
+         * routed to a shard by their thread. Per-host limits from the controller apply to each
+         * shard separately, so a host may see up to shardCount times as many connections. The
+         * sharding task executor pools take it from ShardingTaskExecutorPoolShardCount.
+         */
+        size_t shardCount = 1;
+
         std::function<std::shared_ptr<ControllerInterface>(void)> controllerFactory =
             &ConnectionPool::makeLimitController;
     };
@@ -254,18 +264,30 @@ public:
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
+    /**
+     * An independent slice of the pool with its own controller and set of specific pools
+     */
+    struct Shard {
+        // The mutex for specific pool access within this shard
+        mutable Mutex mutex =
+            MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
+        std::shared_ptr<ControllerInterface> controller;
+        stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> pools;
+    };
+
+    /**
+     * Returns the shard that serves requests from the calling thread
+     */
+    Shard& _getShard();
+
     std::string _name;
 
     const std::shared_ptr<DependentTypeFactoryInterface> _factory;
     Options _options;
 
-    std::shared_ptr<ControllerInterface> _controller;
-
-    // The global mutex for specific pool access and the generation counter
-    mutable Mutex _mutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
-    PoolId _nextPoolId = 0;
-    stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
+    // Pool ids are unique across all shards
+    AtomicWord<PoolId> _nextPoolId{0};
+    std::vector<std::unique_ptr<Shard>> _shards;
 
     EgressTagCloserManager* _manager;
 };
@@ -423,7 +445,8 @@ private:
  *
  * Generally speaking, a Controller will be given HostState via updateState and then return Controls
  * via getControls. A Controller is expected to not directly mutate its SpecificPool, including via
- * its ConnectionPool pointer. A Controller is expected to be given to only one ConnectionPool.
+ * its ConnectionPool pointer. A Controller is expected to be given to only one ConnectionPool. A
+ * ConnectionPool with several shards makes one Controller for each of them.
  */
 class ConnectionPool::ControllerInterface {
 public:
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/executor/connection_pool.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+/**
+ * A timer that never fires. Nothing in the benchmark runs long enough to need a refresh or an
+ * expiration, so none of the pool's timers has to go off.
+ */
+class BenchmarkTimer final : public ConnectionPool::TimerInterface {
+public:
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+};
+
+/**
+ * A connection that finishes its setup and refreshes successfully on the pool's executor.
+ */
+class BenchmarkConnection final : public ConnectionPool::ConnectionInterface {
+public:
+    BenchmarkConnection(const HostAndPort& hostAndPort,
+                        size_t generation,
+                        std::shared_ptr<OutOfLineExecutor> executor)
+        : ConnectionInterface(generation),
+          _hostAndPort(hostAndPort),
+          _executor(std::move(executor)) {}
+
+    const HostAndPort& getHostAndPort() const override {
+        return _hostAndPort;
+    }
+
+    transport::ConnectSSLMode getSslMode() const override {
+        return transport::kGlobalSSLMode;
+    }
+
+    bool isHealthy() override {
+        return true;
+    }
+
+    void setTimeout(Milliseconds timeout, TimeoutCallback cb) override {}
+
+    void cancelTimeout() override {}
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+private:
+    void setup(Milliseconds timeout, SetupCallback cb) override {
+        _executor->schedule([this, cb = std::move(cb)](Status) mutable { cb(this, Status::OK()); });
+    }
+
+    void refresh(Milliseconds timeout, RefreshCallback cb) override {
+        _executor->schedule([this, cb = std::move(cb)](Status) mutable { cb(this, Status::OK()); });
+    }
+
+    const HostAndPort _hostAndPort;
+    const std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class BenchmarkFactory final : public ConnectionPool::DependentTypeFactoryInterface {
+public:
+    explicit BenchmarkFactory(std::shared_ptr<OutOfLineExecutor> executor)
+        : _executor(std::move(executor)) {}
+
+    std::shared_ptr<ConnectionPool::ConnectionInterface> makeConnection(
+        const HostAndPort& hostAndPort,
+        transport::ConnectSSLMode sslMode,
+        size_t generation) override {
+        return std::make_shared<BenchmarkConnection>(hostAndPort, generation, _executor);
+    }
+
+    const std::shared_ptr<OutOfLineExecutor>& getExecutor() override {
+        return _executor;
+    }
+
+    std::shared_ptr<ConnectionPool::TimerInterface> makeTimer() override {
+        return std::make_shared<BenchmarkTimer>();
+    }
+
+    Date_t now() override {
+        return Date_t::now();
+    }
+
+    void shutdown() override {}
+
+private:
+    std::shared_ptr<OutOfLineExecutor> _executor;
+};
+
+class ConnectionPoolTest : public benchmark::Fixture {
+public:
+    void makePool(size_t shardCount) {
+        ThreadPool::Options threadPoolOptions;
+        threadPoolOptions.poolName = "ConnectionPoolBenchmark";
+        threadPoolOptions.minThreads = 1;
+        threadPoolOptions.maxThreads = 4;
+        threadPool = std::make_shared<ThreadPool>(threadPoolOptions);
+        threadPool->startup();
+
+        ConnectionPool::Options options;
+        options.shardCount = shardCount;
+        pool = std::make_shared<ConnectionPool>(
+            std::make_shared<BenchmarkFactory>(threadPool), "benchmark pool", options);
+    }
+
+    void destroyPool() {
+        pool->shutdown();
+        threadPool->shutdown();
+        threadPool->join();
+
+        pool.reset();
+        threadPool.reset();
+    }
+
+protected:
+    std::shared_ptr<ThreadPool> threadPool;
+    std::shared_ptr<ConnectionPool> pool;
+};
+
+/**
+ * Checks a connection to a single host out of the pool and returns it, from state.threads threads
+ * at once. The argument is the number of shards in the pool.
+ */
+BENCHMARK_DEFINE_F(ConnectionPoolTest, BM_CheckoutAndReturn)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        makePool(state.range(0));
+    }
+
+    const HostAndPort host("localhost", 27017);
+    for (auto keepRunning : state) {
+        auto conn = pool->get(host, transport::kGlobalSSLMode, Seconds(10)).get();
+        conn->indicateSuccess();
+    }
+
+    if (state.thread_index == 0) {
+        destroyPool();
+    }
+}
+
+BENCHMARK_REGISTER_F(ConnectionPoolTest, BM_CheckoutAndReturn)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -41,8 +41,11 @@
 #include <fmt/ostream.h>
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/notification.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -1439,6 +1442,128 @@ TEST_F(ConnectionPoolTest, DropConnectionsInMultipleViaManager) {
     dropConnectionsTest(pool, &manager);
 }
 
+TEST_F(ConnectionPoolTest, DropConnectionsSharded) {
+    ConnectionPool::Options options;
+    options.minConnections = 0;
+    options.shardCount = 4;
+    auto pool = makePool(options);
+
+    dropConnectionsTest(pool, pool);
+}
+
+/**
+ * Verify that a sharded pool makes a controller for each shard and still reuses connections.
+ */
+TEST_F(ConnectionPoolTest, ShardedPoolReusesConnections) {
+    size_t controllersMade = 0;
+    ConnectionPool::Options options;
+    options.shardCount = 4;
+    options.controllerFactory = [&] {
+        ++controllersMade;
+        return ConnectionPool::makeLimitController();
+    };
+    auto pool = makePool(options);
+    ASSERT_EQ(4ul, controllersMade);
+
+    size_t conn1Id = 0;
+    ConnectionImpl::pushSetup(Status::OK());
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          conn1Id = verifyAndGetId(swConn);
+                          doneWith(swConn.getValue());
+                      });
+
+    size_t conn2Id = 0;
+    pool->get_forTest(HostAndPort(),
+                      Milliseconds(5000),
+                      [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                          conn2Id = verifyAndGetId(swConn);
+                          doneWith(swConn.getValue());
+                      });
+
+    ASSERT(conn1Id);
+    ASSERT_EQ(conn1Id, conn2Id);
+    ASSERT_EQ(1ul, pool->getNumConnectionsPerHost(HostAndPort()));
+
+    pool->dropConnections(HostAndPort());
+    ASSERT_EQ(0ul, pool->getNumConnectionsPerHost(HostAndPort()));
+}
+
+/**
+ * Verify that the per-host stats and dropConnections of a sharded pool cover the connections made
+ * by threads which are routed to different shards.
+ */
+TEST_F(ConnectionPoolTest, ShardedPoolCoversConnectionsOfAllShards) {
+    ConnectionPool::Options options;
+    options.minConnections = 0;
+    options.shardCount = 2;
+    auto pool = makePool(options);
+
+    // The threads are kept alive until the end of the test so that none of them gets the id, and
+    // so the shard, of an earlier one.
+    Notification<void> done;
+    std::vector<stdx::thread> threads;
+    ON_BLOCK_EXIT([&] {
+        done.set();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    });
+
+    // Gets a connection from a new thread, returns it to the pool and returns its id. Only one
+    // thread uses the pool at a time, since the mock connections aren't thread-safe.
+    auto getAndReturnFromNewThread = [&] {
+        auto connId = std::make_shared<Notification<size_t>>();
+        threads.emplace_back([&, connId] {
+            size_t id = 0;
+            pool->get_forTest(HostAndPort(),
+                              Milliseconds(5000),
+                              [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                                  if (swConn.isOK()) {
+                                      id = getId(swConn.getValue());
+                                      doneWith(swConn.getValue());
+                                  }
+                              });
+            connId->set(id);
+            done.get();
+        });
+        return connId->get();
+    };
+
+    ConnectionImpl::pushSetup(Status::OK());
+    const auto conn1Id = getAndReturnFromNewThread();
+    ASSERT(conn1Id);
+
+    // Threads routed to the same shard reuse the first connection, so the first thread which
+    // gets a new one was routed to the other shard.
+    ConnectionImpl::pushSetup(Status::OK());
+    auto conn2Id = conn1Id;
+    for (int attempt = 0; attempt < 100 && conn2Id == conn1Id; ++attempt) {
+        conn2Id = getAndReturnFromNewThread();
+    }
+    ASSERT(conn2Id);
+    ASSERT_NE(conn1Id, conn2Id);
+
+    ASSERT_EQ(2ul, pool->getNumConnectionsPerHost(HostAndPort()));
+    {
+        ConnectionPoolStats stats;
+        pool->appendConnectionStats(&stats);
+        const auto& hostStats = stats.statsByHost[HostAndPort()];
+        ASSERT_EQ(0ul, hostStats.inUse);
+        ASSERT_EQ(2ul, hostStats.available);
+        ASSERT_EQ(2ul, hostStats.created);
+    }
+
+    pool->dropConnections(HostAndPort());
+    ASSERT_EQ(0ul, pool->getNumConnectionsPerHost(HostAndPort()));
+    {
+        ConnectionPoolStats stats;
+        pool->appendConnectionStats(&stats);
+        ASSERT_EQ(0ul, stats.totalAvailable);
+    }
+}
+
 TEST_F(ConnectionPoolTest, AsyncGet) {
     ConnectionPool::Options options;
     options.maxConnections = 1;
@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_stats.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace executor {
+
+namespace {
+const auto hostLatencyStatsDecoration = ServiceContext::declareDecoration<HostLatencyStats>();
+}  // namespace
+
+HostLatencyStats* HostLatencyStats::get(ServiceContext* service) {
+    return &hostLatencyStatsDecoration(service);
+}
+
+HostLatencyStats* HostLatencyStats::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+void HostLatencyStats::record(const HostAndPort& host,
+                              StringData commandName,
+                              Microseconds latency,
+                              Date_t now) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (auto sketch = _getOrCreateSketch(lk, host, commandName, now)) {
+        sketch->record(latency, now);
+    }
+}
+
+void HostLatencyStats::recordLowerBound(const HostAndPort& host,
+                                        StringData commandName,
+                                        Microseconds elapsed,
+                                        Date_t now) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (auto sketch = _getOrCreateSketch(lk, host, commandName, now)) {
+        sketch->recordLowerBound(elapsed, now);
+    }
+}
+
+size_t HostLatencyStats::size() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _sketches.size();
+}
+
+LatencySketch* HostLatencyStats::_getOrCreateSketch(WithLock,
+                                                    const HostAndPort& host,
+                                                    StringData commandName,
+                                                    Date_t now) {
+    // Hosts which left the replica set and commands which are no longer run would otherwise keep
+    // their sketches forever.
+    if (now - _lastEviction > kStaleAfter) {
+        for (auto it = _sketches.begin(); it != _sketches.end();) {
+            if (now - it->second.lastUpdated() > kStaleAfter) {
+                it = _sketches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _lastEviction = now;
+    }
+
+    auto key = std::make_pair(host, commandName.toString());
+    auto it = _sketches.find(key);
+    if (it != _sketches.end()) {
+        return &it->second;
+    }
+    if (_sketches.size() >= kMaxSketches) {
+        return nullptr;
+    }
+    return &_sketches[std::move(key)];
+}
+
+boost::optional<Microseconds> HostLatencyStats::getLatencyQuantile(const HostAndPort& host,
+                                                                   StringData commandName,
+                                                                   double quantile,
+                                                                   Date_t now) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _getLatencyQuantile(lk, host, commandName, quantile, now);
+}
+
+void HostLatencyStats::sortHostsByPredictedLatency(StringData commandName,
+                                                   Date_t now,
+                                                   std::vector<HostAndPort>* hosts) const {
+    if (hosts->size() < 2) {
+        return;
+    }
+
+    std::vector<std::pair<Microseconds, HostAndPort>> predicted;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto& host : *hosts) {
+            auto median = _getLatencyQuantile(lk, host, commandName, 0.5, now);
+            predicted.emplace_back(median.value_or(Microseconds(0)), std::move(host));
+        }
+    }
+
+    std::stable_sort(predicted.begin(), predicted.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    for (size_t i = 0; i < predicted.size(); ++i) {
+        (*hosts)[i] = std::move(predicted[i].second);
+    }
+}
+
+boost::optional<Microseconds> HostLatencyStats::_getLatencyQuantile(WithLock,
+                                                                    const HostAndPort& host,
+                                                                    StringData commandName,
+                                                                    double quantile,
+                                                                    Date_t now) const {
+    auto it = _sketches.find(std::make_pair(host, commandName.toString()));
+    if (it == _sketches.end() || now - it->second.lastUpdated() > kStaleAfter) {
+        return boost::none;
+    }
+    return it->second.quantile(quantile);
+}
+
+}  // namespace executor
+}  // namespace mongo
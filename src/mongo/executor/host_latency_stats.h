@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/executor/latency_sketch.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+namespace executor {
+
+/**
+ * Container for server-wide latency sketches of the remote commands run against each host, kept
+ * separately for each command name. The NetworkInterface records the round trip time of hedgeable
+ * reads, and these are used to target the replica with the lowest predicted latency and to decide
+ * how long to wait before hedging a read.
+ */
+class HostLatencyStats {
+    HostLatencyStats(const HostLatencyStats&) = delete;
+    HostLatencyStats& operator=(const HostLatencyStats&) = delete;
+
+public:
+    // Sketches which have not been updated for this long are not used for predictions, since the
+    // host is probably no longer being targeted and its latency may have changed since.
+    static constexpr Seconds kStaleAfter{30};
+
+    // Upper bound on the number of host and command pairs tracked at a time. Samples for further
+    // pairs are dropped until idle sketches have been evicted.
+    static constexpr size_t kMaxSketches = 10000;
+
+    HostLatencyStats() = default;
+
+    static HostLatencyStats* get(ServiceContext* service);
+    static HostLatencyStats* get(OperationContext* opCtx);
+
+    /**
+     * Records the round trip time of a command named 'commandName' run against 'host'.
+     */
+    void record(const HostAndPort& host,
+                StringData commandName,
+                Microseconds latency,
+                Date_t now);
+
+    /**
+     * Records that a command named 'commandName' run against 'host' did not complete within
+     * 'elapsed', because it was canceled after another host answered first or ran out of time.
+     * Without these, a host which always loses the race to a hedged request would never get an
+     * estimate.
+     */
+    void recordLowerBound(const HostAndPort& host,
+                          StringData commandName,
+                          Microseconds elapsed,
+                          Date_t now);
+
+    /**
+     * Returns the estimated latency quantile of the command against the host, or boost::none if
+     * there are too few recent samples to estimate it.
+     */
+    boost::optional<Microseconds> getLatencyQuantile(const HostAndPort& host,
+                                                     StringData commandName,
+                                                     double quantile,
+                                                     Date_t now) const;
+
+    /**
+     * Stably sorts 'hosts' by their median latency for the command. Hosts without a recent
+     * estimate are placed first, so that they get sampled again.
+     */
+    void sortHostsByPredictedLatency(StringData commandName,
+                                     Date_t now,
+                                     std::vector<HostAndPort>* hosts) const;
+
+    /**
+     * Returns the number of host and command pairs currently tracked.
+     */
+    size_t size() const;
+
+private:
+    /**
+     * Returns the sketch for the host and command, creating it if there is room for it, or
+     * nullptr otherwise. Evicts the sketches which have gone stale, at most once per
+     * 'kStaleAfter'.
+     */
+    LatencySketch* _getOrCreateSketch(WithLock,
+                                      const HostAndPort& host,
+                                      StringData commandName,
+                                      Date_t now);
+
+    boost::optional<Microseconds> _getLatencyQuantile(WithLock,
+                                                      const HostAndPort& host,
+                                                      StringData commandName,
+                                                      double quantile,
+                                                      Date_t now) const;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("HostLatencyStats::_mutex");
+
+    std::map<std::pair<HostAndPort, std::string>, LatencySketch> _sketches;
+    Date_t _lastEviction;
+};
+
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/host_latency_stats.h"
+
+#include "mongo/executor/latency_sketch.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+const Date_t kNow = Date_t::fromMillisSinceEpoch(100000);
+
+TEST(LatencySketchTest, NoQuantileBeforeMinSamples) {
+    LatencySketch sketch;
+    for (uint32_t i = 1; i < LatencySketch::kMinSamplesForQuantile; ++i) {
+        sketch.record(Milliseconds(1), kNow);
+    }
+    ASSERT_FALSE(sketch.quantile(0.5));
+
+    sketch.record(Milliseconds(1), kNow);
+    ASSERT_TRUE(sketch.quantile(0.5));
+}
+
+TEST(LatencySketchTest, QuantilesAreWithinFivePercent) {
+    LatencySketch sketch;
+    for (int i = 1; i <= 1000; i += 2) {
+        sketch.record(Microseconds(i * 1000), kNow);
+    }
+
+    for (auto [quantile, expected] : {std::make_pair(0.5, Milliseconds(500)),
+                                      std::make_pair(0.95, Milliseconds(950)),
+                                      std::make_pair(0.99, Milliseconds(990))}) {
+        auto estimate = durationCount<Microseconds>(*sketch.quantile(quantile));
+        auto expectedMicros = durationCount<Microseconds>(expected);
+        ASSERT_GTE(estimate, expectedMicros * 0.95) << quantile;
+        ASSERT_LTE(estimate, expectedMicros * 1.05) << quantile;
+    }
+}
+
+TEST(LatencySketchTest, DecayFollowsLatencyChanges) {
+    LatencySketch sketch;
+    for (uint32_t i = 0; i < LatencySketch::kDecaySamples; ++i) {
+        sketch.record(Milliseconds(1), kNow);
+    }
+
+    // After the host slows down, the old samples are decayed away and the median follows.
+    for (uint32_t i = 0; i < 2 * LatencySketch::kDecaySamples; ++i) {
+        sketch.record(Milliseconds(100), kNow);
+    }
+    ASSERT_GTE(*sketch.quantile(0.5), Milliseconds(95));
+    ASSERT_LT(sketch.count(), LatencySketch::kDecaySamples);
+}
+
+TEST(HostLatencyStatsTest, QuantilesAreTrackedPerHostAndCommand) {
+    HostLatencyStats stats;
+    const HostAndPort host1("host1", 27017);
+    const HostAndPort host2("host2", 27017);
+    for (int i = 0; i < 100; ++i) {
+        stats.record(host1, "find", Milliseconds(10), kNow);
+        stats.record(host1, "count", Milliseconds(100), kNow);
+    }
+
+    ASSERT_LTE(*stats.getLatencyQuantile(host1, "find", 0.5, kNow), Milliseconds(11));
+    ASSERT_GTE(*stats.getLatencyQuantile(host1, "count", 0.5, kNow), Milliseconds(95));
+    ASSERT_FALSE(stats.getLatencyQuantile(host2, "find", 0.5, kNow));
+}
+
+TEST(HostLatencyStatsTest, StaleSketchesAreIgnored) {
+    HostLatencyStats stats;
+    const HostAndPort host("host1", 27017);
+    for (int i = 0; i < 100; ++i) {
+        stats.record(host, "find", Milliseconds(10), kNow);
+    }
+
+    ASSERT_TRUE(stats.getLatencyQuantile(host, "find", 0.5, kNow + HostLatencyStats::kStaleAfter));
+    ASSERT_FALSE(stats.getLatencyQuantile(
+        host, "find", 0.5, kNow + HostLatencyStats::kStaleAfter + Milliseconds(1)));
+}
+
+TEST(HostLatencyStatsTest, SortHostsByPredictedLatency) {
+    HostLatencyStats stats;
+    const HostAndPort slow("slow", 27017);
+    const HostAndPort fast("fast", 27017);
+    const HostAndPort unknown1("unknown1", 27017);
+    const HostAndPort unknown2("unknown2", 27017);
+    for (int i = 0; i < 100; ++i) {
+        stats.record(slow, "find", Milliseconds(50), kNow);
+        stats.record(fast, "find", Milliseconds(5), kNow);
+    }
+
+    std::vector<HostAndPort> hosts{slow, unknown1, fast, unknown2};
+    stats.sortHostsByPredictedLatency("find", kNow, &hosts);
+    ASSERT(hosts == std::vector<HostAndPort>({unknown1, unknown2, fast, slow}));
+}
+
+TEST(HostLatencyStatsTest, HostThatAlwaysLosesMovesOutOfFirstPlace) {
+    HostLatencyStats stats;
+    const HostAndPort slow("slow", 27017);
+    const HostAndPort fast("fast", 27017);
+    std::vector<HostAndPort> hosts{slow, fast};
+
+    // The slow host is targeted first, but the hedged request to the fast host always answers
+    // before it, at which point the request to the slow host is canceled.
+    for (int i = 0; i < 100; ++i) {
+        stats.record(fast, "find", Milliseconds(5), kNow);
+        stats.recordLowerBound(slow, "find", Milliseconds(5), kNow);
+    }
+
+    ASSERT_GT(*stats.getLatencyQuantile(slow, "find", 0.5, kNow),
+              *stats.getLatencyQuantile(fast, "find", 0.5, kNow));
+    stats.sortHostsByPredictedLatency("find", kNow, &hosts);
+    ASSERT(hosts == std::vector<HostAndPort>({fast, slow}));
+}
+
+TEST(HostLatencyStatsTest, IdleSketchesAreEvicted) {
+    HostLatencyStats stats;
+    const HostAndPort gone("gone", 27017);
+    const HostAndPort host("host", 27017);
+    stats.record(gone, "find", Milliseconds(10), kNow);
+    stats.record(host, "find", Milliseconds(10), kNow);
+    ASSERT_EQ(2U, stats.size());
+
+    const auto later = kNow + HostLatencyStats::kStaleAfter + Seconds(1);
+    stats.record(host, "find", Milliseconds(10), later);
+    ASSERT_EQ(1U, stats.size());
+    ASSERT_FALSE(stats.getLatencyQuantile(gone, "find", 0.5, later));
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
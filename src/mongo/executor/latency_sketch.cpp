@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/latency_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace executor {
+
+namespace {
+
+const double kBucketGrowth = 1.1;
+const double kLogBucketGrowth = std::log(kBucketGrowth);
+
+}  // namespace
+
+void LatencySketch::record(Microseconds latency, Date_t now) {
+    _recordInBucket(_bucketFor(latency), now);
+}
+
+void LatencySketch::recordLowerBound(Microseconds lowerBound, Date_t now) {
+    _recordInBucket(std::min(_bucketFor(lowerBound) + 1, kNumBuckets - 1), now);
+}
+
+void LatencySketch::_recordInBucket(size_t bucket, Date_t now) {
+    ++_buckets[bucket];
+    _lastUpdated = now;
+
+    if (++_count < kDecaySamples) {
+        return;
+    }
+
+    _count = 0;
+    for (auto& bucketCount : _buckets) {
+        bucketCount /= 2;
+        _count += bucketCount;
+    }
+}
+
+boost::optional<Microseconds> LatencySketch::quantile(double quantile) const {
+    invariant(quantile >= 0 && quantile <= 1);
+    if (_count < kMinSamplesForQuantile) {
+        return boost::none;
+    }
+
+    // The rank of the sample at the given quantile, counting from 1.
+    const auto rank = std::max<uint32_t>(1, std::ceil(quantile * _count));
+    uint32_t seen = 0;
+    for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+        seen += _buckets[bucket];
+        if (seen >= rank) {
+            return _bucketValue(bucket);
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+size_t LatencySketch::_bucketFor(Microseconds latency) {
+    if (latency <= Microseconds(1)) {
+        return 0;
+    }
+    const auto bucket =
+        static_cast<size_t>(std::log(static_cast<double>(latency.count())) / kLogBucketGrowth);
+    return std::min(bucket, kNumBuckets - 1);
+}
+
+Microseconds LatencySketch::_bucketValue(size_t bucket) {
+    // The geometric middle of the bucket, which is within 5% of every latency in it.
+    return Microseconds(std::llround(std::pow(kBucketGrowth, bucket + 0.5)));
+}
+
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+#include <cstdint>
+
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace executor {
+
+/**
+ * Approximates the distribution of the latencies recorded into it, so that quantiles such as the
+ * median or the 95th percentile can be estimated cheaply.
+ *
+ * Latencies are counted in exponentially sized buckets, each 10% wider than the previous, so any
+ * quantile is estimated to within about 5% of the true latency regardless of its magnitude. Once
+ * enough samples have been recorded, all of the counts are halved, so that the sketch follows
+ * changes in the latency of the host rather than averaging over its whole history.
+ *
+ * Not thread safe.
+ */
+class LatencySketch {
+public:
+    // Quantiles are not estimated from fewer samples than this.
+    static constexpr uint32_t kMinSamplesForQuantile = 20;
+
+    // When the number of samples reaches this, the counts are halved.
+    static constexpr uint32_t kDecaySamples = 1000;
+
+    void record(Microseconds latency, Date_t now);
+
+    /**
+     * Records a sample of which only a lower bound is known, such as a request that was canceled
+     * or timed out before the host answered. The latency was strictly greater than 'lowerBound',
+     * so the sample is counted in the bucket above the one 'lowerBound' falls into.
+     */
+    void recordLowerBound(Microseconds lowerBound, Date_t now);
+
+    /**
+     * Returns the estimated latency below which the given fraction of the samples fall, or
+     * boost::none if too few samples have been recorded. 'quantile' must be in [0, 1].
+     */
+    boost::optional<Microseconds> quantile(double quantile) const;
+
+    uint32_t count() const {
+        return _count;
+    }
+
+    Date_t lastUpdated() const {
+        return _lastUpdated;
+    }
+
+private:
+    // Bucket i counts the latencies in [1.1^i, 1.1^(i+1)) microseconds, with the last bucket
+    // holding everything above about three minutes.
+    static constexpr size_t kNumBuckets = 200;
+
+    void _recordInBucket(size_t bucket, Date_t now);
+
+    static size_t _bucketFor(Microseconds latency);
+    static Microseconds _bucketValue(size_t bucket);
+
+    std::array<uint32_t, kNumBuckets> _buckets{};
+    uint32_t _count = 0;
+    Date_t _lastUpdated;
+};
+
+}  // namespace executor
+}  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_integration_fixture.h"
+#include "mongo/executor/network_interface_tl_gen.h"
 #include "mongo/executor/test_network_connection_hook.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -659,6 +660,27 @@ TEST_F(NetworkInterfaceTest, FireAndForget) {
     assertNumOps(0u, 0u, 0u, 5u);
 }
 
+TEST_F(NetworkInterfaceTest, MultiplexedCommandsGetTheirOwnReplies) {
+    gMaxMultiplexedRequestsPerConnection.store(8);
+    ON_BLOCK_EXIT([] { gMaxMultiplexedRequestsPerConnection.store(1); });
+
+    // Start the commands back to back so that most of them share a connection.
+    const int numRequests = 16;
+    std::vector<Future<RemoteCommandResponse>> futures;
+    for (int i = 0; i < numRequests; ++i) {
+        auto request = makeTestCommand(kNoTimeout, BSON("echo" << 1 << "i" << i));
+        futures.push_back(runCommand(makeCallbackHandle(), std::move(request)));
+    }
+
+    for (int i = 0; i < numRequests; ++i) {
+        auto res = futures[i].get();
+        uassertStatusOK(res.status);
+        ASSERT_EQ(1, res.data.getIntField("ok"));
+        ASSERT_EQ(i, res.data.getObjectField("echo").getIntField("i"));
+    }
+    assertNumOps(0u, 0u, 0u, static_cast<uint64_t>(numRequests));
+}
+
 TEST_F(NetworkInterfaceInternalClientTest, StartCommandOnAny) {
     // The echo command below uses hedging so after a response is returned, we will issue
     // a _killOperations command to kill the pending operation. As a result, the number of
@@ -36,6 +36,8 @@
 #include "mongo/db/server_options.h"
 #include "mongo/executor/connection_pool_tl.h"
 #include "mongo/executor/hedging_metrics.h"
+#include "mongo/executor/host_latency_stats.h"
+#include "mongo/executor/network_interface_tl_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/transport/transport_layer_manager.h"
@@ -98,7 +100,31 @@ private:
 namespace {
 const Status kNetworkInterfaceShutdownInProgress = {ErrorCodes::ShutdownInProgress,
                                                     "NetworkInterface shutdown in progress"};
+
+/**
+ * Returns false for commands which may wait on the remote host for something other than their own
+ * work, such as new data or a majority commit point. The host runs the commands on a connection
+ * one at a time, so these would hold up every command multiplexed behind them for as long.
+ */
+bool canMultiplexCommand(const BSONObj& cmdObj) {
+    // A getMore on a tailable awaitData cursor waits for new results, and the command does not
+    // tell whether its cursor is one.
+    const auto commandName = cmdObj.firstElementFieldNameStringData();
+    if (commandName == "getMore"_sd) {
+        return false;
+    }
+
+    if (cmdObj["tailable"].trueValue() || cmdObj["awaitData"].trueValue() ||
+        cmdObj.hasField("maxAwaitTimeMS")) {
+        return false;
+    }
+
+    const auto readConcern = cmdObj["readConcern"];
+    return readConcern.type() != Object ||
+        (!readConcern.Obj().hasField("afterClusterTime") &&
+         !readConcern.Obj().hasField("afterOpTime"));
 }
+}  // namespace
 
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
@@ -367,6 +393,14 @@ void NetworkInterfaceTL::RequestState::returnConnection(Status status) noexcept
 
     auto connToReturn = std::exchange(conn, {});
 
+    if (multiplexedConn) {
+        // The connection goes back to the pool with the last request sharing it. Network errors,
+        // timeouts and cancellation have already stopped multiplexing on it by now, and that
+        // status is what the pool is told then.
+        interface()->_leaveMultiplexedConnection(std::exchange(multiplexedConn, {}));
+        return;
+    }
+
     if (!status.isOK()) {
         connToReturn->indicateFailure(std::move(status));
         return;
@@ -429,11 +463,26 @@ void NetworkInterfaceTL::CommandStateBase::tryFinish(Status status) noexcept {
 void NetworkInterfaceTL::RequestState::cancel() noexcept {
     auto connToCancel = weakConn.lock();
     if (auto clientPtr = getClient(connToCancel)) {
+        if (multiplexedMsgId) {
+            // Only cancel this request, the others sharing the connection keep running
+            clientPtr->cancelMultiplexedCommand(
+                *multiplexedMsgId,
+                Status(ErrorCodes::CallbackCanceled, "Multiplexed request was canceled"));
+            return;
+        }
+
         // If we have a client, cancel it
         clientPtr->cancel(cmdState->baton);
     }
 }
 
+void NetworkInterfaceTL::RequestState::setMultiplexedConnection(
+    std::shared_ptr<MultiplexedConnection> connection) noexcept {
+    conn = ConnectionHandle(connection, connection->conn.get());
+    multiplexedConn = std::move(connection);
+    multiplexedMsgId = nextMessageId();
+}
+
 NetworkInterfaceTL::RequestState::~RequestState() {
     invariant(!conn);
 }
@@ -478,6 +527,10 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         cmdState->deadline = cmdState->stopwatch.start() + cmdState->requestOnAny.timeout;
     }
     cmdState->baton = baton;
+    cmdState->canMultiplex = gMaxMultiplexedRequestsPerConnection.load() > 1 &&
+        !request.hedgeOptions && request.target.size() == 1 &&
+        request.fireAndForgetMode == RemoteCommandRequest::FireAndForgetMode::kOff &&
+        !targetHostsInAlphabeticalOrder && canMultiplexCommand(request.cmdObj);
 
     if (_svcCtx && cmdState->requestOnAny.hedgeOptions) {
         auto hm = HedgingMetrics::get(_svcCtx);
@@ -534,6 +587,15 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
         return Status::OK();
     }
 
+    // Share a connection another command to the same host is using, if there is room on one
+    if (cmdState->canMultiplex) {
+        if (auto multiplexedConn =
+                _joinMultiplexedConnection(request.target.front(), request.sslMode)) {
+            cmdState->requestManager->sendMultiplexed(std::move(multiplexedConn));
+            return Status::OK();
+        }
+    }
+
     // Attempt to get a connection to every target host
     for (size_t idx = 0; idx < request.target.size(); ++idx) {
         auto connFuture = _pool->get(request.target[idx], request.sslMode, request.timeout);
@@ -572,8 +634,13 @@ Future<RemoteCommandResponse> NetworkInterfaceTL::CommandState::sendRequest(
     std::shared_ptr<RequestState> requestState) {
     return makeReadyFutureWith([this, requestState] {
                setTimer();
-               return RequestState::getClient(requestState->conn)
-                   ->runCommandRequest(*requestState->request, baton);
+               auto client = RequestState::getClient(requestState->conn);
+               if (requestState->multiplexedMsgId) {
+                   return client->runMultiplexedCommandRequest(*requestState->request,
+                                                               *requestState->multiplexedMsgId);
+               }
+
+               return client->runCommandRequest(*requestState->request, baton);
            })
         .then([this, requestState](RemoteCommandResponse response) {
             doMetadataHook(RemoteCommandOnAnyResponse(requestState->host, response));
@@ -706,6 +773,7 @@ void NetworkInterfaceTL::RequestManager::trySend(
     }
 
     std::shared_ptr<RequestState> requestState;
+    Milliseconds hedgeDelay{0};
 
     {
         stdx::lock_guard<Latch> lk(mutex);
@@ -725,10 +793,24 @@ void NetworkInterfaceTL::RequestManager::trySend(
 
         requestState = std::make_shared<RequestState>(this, cmdState->shared_from_this(), idx);
         requestState->isHedge = currentSentIdx > 0;
+        hedgeDelay = requestState->isHedge ? cmdState->requestOnAny.hedgeOptions->delay
+                                           : Milliseconds(0);
 
         // Set conn/weakConn+request under the lock so they will always be observed during cancel.
-        requestState->conn = std::move(swConn.getValue());
-        requestState->weakConn = requestState->conn;
+        // A delayed hedge only publishes weakConn once it is sent, so that it isn't sent a
+        // _killOperations or cancelled for a command it never ran.
+        auto& conn = swConn.getValue();
+        if (cmdState->canMultiplex) {
+            if (auto multiplexedConn = cmdState->interface->_makeMultiplexedConnection(conn)) {
+                requestState->setMultiplexedConnection(std::move(multiplexedConn));
+            }
+        }
+        if (!requestState->conn) {
+            requestState->conn = std::move(conn);
+        }
+        if (hedgeDelay <= Milliseconds(0)) {
+            requestState->weakConn = requestState->conn;
+        }
 
         requestState->request = RemoteCommandRequest(cmdState->requestOnAny, idx);
         requestState->host = requestState->request->target;
@@ -760,13 +842,99 @@ void NetworkInterfaceTL::RequestManager::trySend(
                     "requestId"_attr = cmdState->requestOnAny.id,
                     "target"_attr = cmdState->requestOnAny.target[idx]);
 
-        if (cmdState->interface->_svcCtx) {
-            auto hm = HedgingMetrics::get(cmdState->interface->_svcCtx);
-            invariant(hm);
-            hm->incrementNumTotalHedgedOperations();
+        if (hedgeDelay > Milliseconds(0)) {
+            sendAfterDelay(std::move(requestState), hedgeDelay);
+            return;
         }
     }
 
+    send(std::move(requestState));
+}
+
+void NetworkInterfaceTL::RequestManager::sendAfterDelay(std::shared_ptr<RequestState> requestState,
+                                                        Milliseconds delay) noexcept {
+    LOGV2_DEBUG(4859017,
+                2,
+                "Delaying hedged request",
+                "delay"_attr = delay,
+                "requestId"_attr = requestState->request->id,
+                "target"_attr = requestState->request->target);
+
+    // The timer runs its callback on the reactor, from which the connection may be returned.
+    auto& reactor = cmdState->interface->_reactor;
+    requestState->hedgeTimer = reactor->makeTimer();
+    requestState->hedgeTimer->waitUntil(reactor->now() + delay)
+        .getAsync([this, requestState](Status status) {
+            bool shouldSend;
+            {
+                stdx::lock_guard<Latch> lk(mutex);
+                shouldSend = status.isOK() && !isLocked && !cmdState->finishLine.isReady();
+                if (shouldSend) {
+                    requestState->weakConn = requestState->conn;
+                }
+            }
+
+            if (!shouldSend) {
+                // The command finished, or the timer was canceled on shutdown, before the delay
+                // elapsed. The connection was never used, so it is returned as is.
+                LOGV2_DEBUG(4859018,
+                            2,
+                            "Not sending delayed hedged request",
+                            "requestId"_attr = requestState->request->id,
+                            "target"_attr = requestState->request->target,
+                            "timerStatus"_attr = status);
+                requestState->returnConnection(Status::OK());
+                return;
+            }
+
+            send(requestState);
+        });
+}
+
+void NetworkInterfaceTL::RequestManager::sendMultiplexed(
+    std::shared_ptr<MultiplexedConnection> multiplexedConn) noexcept {
+    std::shared_ptr<RequestState> requestState;
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+
+        ++connsResolved;
+
+        if (!isLocked) {
+            sentIdx++;
+
+            requestState = std::make_shared<RequestState>(this, cmdState->shared_from_this(), 0);
+            requestState->setMultiplexedConnection(std::move(multiplexedConn));
+            requestState->weakConn = requestState->conn;
+
+            requestState->request = RemoteCommandRequest(cmdState->requestOnAny, 0);
+            requestState->host = requestState->request->target;
+
+            requests.at(0) = requestState;
+        }
+    }
+
+    if (!requestState) {
+        // The command finished before it could be sent.
+        cmdState->interface->_leaveMultiplexedConnection(std::move(multiplexedConn));
+        return;
+    }
+
+    LOGV2_DEBUG(4859043,
+                2,
+                "Sending request on a multiplexed connection",
+                "requestId"_attr = cmdState->requestOnAny.id,
+                "target"_attr = requestState->host);
+
+    send(std::move(requestState));
+}
+
+void NetworkInterfaceTL::RequestManager::send(std::shared_ptr<RequestState> requestState) noexcept {
+    if (requestState->isHedge && cmdState->interface->_svcCtx) {
+        auto hm = HedgingMetrics::get(cmdState->interface->_svcCtx);
+        invariant(hm);
+        hm->incrementNumTotalHedgedOperations();
+    }
+
     networkInterfaceHangCommandsAfterAcquireConn.pauseWhileSet();
 
     // We have a connection and the command hasn't already been attempted
@@ -780,6 +948,7 @@ void NetworkInterfaceTL::RequestManager::trySend(
         counters->recordSent();
     }
 
+    requestState->sendTimer.reset();
     requestState->resolve(cmdState->sendRequest(requestState));
 }
 
@@ -808,6 +977,27 @@ void NetworkInterfaceTL::RequestState::resolve(Future<RemoteCommandResponse> fut
             returnConnection(status);
 
             auto commandStatus = getStatusFromCommandResult(response.data);
+
+            // Track the round trip time of hedgeable reads, which is used to target them and to
+            // decide when to hedge them. A request cut short by maxTimeMS, or canceled because
+            // another host answered first, only tells that the host would have taken longer than
+            // it ran for, so that is recorded as a lower bound.
+            auto svcCtx = interface()->_svcCtx;
+            if (svcCtx && request->hedgeOptions) {
+                const bool timedOut = commandStatus == ErrorCodes::MaxTimeMSExpired;
+                const bool lostRace = !status.isOK() &&
+                    (ErrorCodes::isCancelationError(status) || cmdState->finishLine.isReady());
+                auto latencyStats = HostLatencyStats::get(svcCtx);
+                const auto commandName = request->cmdObj.firstElementFieldNameStringData();
+                const auto now = svcCtx->getFastClockSource()->now();
+                if (timedOut || lostRace) {
+                    latencyStats->recordLowerBound(
+                        host, commandName, Microseconds(sendTimer.micros()), now);
+                } else if (status.isOK()) {
+                    latencyStats->record(host, commandName, Microseconds(sendTimer.micros()), now);
+                }
+            }
+
             // Ignore maxTimeMS expiration errors for hedged reads without triggering the finish
             // line.
             if (isHedge && commandStatus == ErrorCodes::MaxTimeMSExpired) {
@@ -1082,6 +1272,79 @@ Status NetworkInterfaceTL::_killOperation(std::shared_ptr<RequestState> requestS
     return ex.toStatus();
 }
 
+NetworkInterfaceTL::MultiplexedConnection::~MultiplexedConnection() {
+    auto client = checked_cast<connection_pool_tl::TLConnection*>(conn.get())->client();
+    if (auto status = client->getMultiplexingStatus(); !status.isOK()) {
+        // The connection failed, or the reply to a canceled request may still arrive on it.
+        conn->indicateFailure(std::move(status));
+    } else {
+        conn->indicateUsed();
+        conn->indicateSuccess();
+    }
+
+    // Return the connection to the pool from the networking thread
+    auto& reactor = interface->_reactor;
+    if (!reactor->onReactorThread()) {
+        reactor->schedule([conn = std::move(conn)](Status) {});
+    }
+}
+
+auto NetworkInterfaceTL::_makeMultiplexedConnection(ConnectionPool::ConnectionHandle& conn)
+    -> std::shared_ptr<MultiplexedConnection> {
+    auto client = checked_cast<connection_pool_tl::TLConnection*>(conn.get())->client();
+    if (!client->getMultiplexingStatus().isOK()) {
+        return nullptr;
+    }
+
+    auto multiplexedConn = std::make_shared<MultiplexedConnection>(this, std::move(conn));
+    multiplexedConn->requests = 1;
+
+    stdx::lock_guard lk(_multiplexMutex);
+    _multiplexedConns[multiplexedConn->conn->getHostAndPort()] = multiplexedConn;
+    return multiplexedConn;
+}
+
+auto NetworkInterfaceTL::_joinMultiplexedConnection(const HostAndPort& host,
+                                                    transport::ConnectSSLMode sslMode)
+    -> std::shared_ptr<MultiplexedConnection> {
+    stdx::lock_guard lk(_multiplexMutex);
+    auto it = _multiplexedConns.find(host);
+    if (it == _multiplexedConns.end()) {
+        return nullptr;
+    }
+
+    auto multiplexedConn = it->second.lock();
+    if (!multiplexedConn) {
+        _multiplexedConns.erase(it);
+        return nullptr;
+    }
+
+    auto client =
+        checked_cast<connection_pool_tl::TLConnection*>(multiplexedConn->conn.get())->client();
+    if (multiplexedConn->requests >=
+            static_cast<size_t>(gMaxMultiplexedRequestsPerConnection.load()) ||
+        multiplexedConn->conn->getSslMode() != sslMode ||
+        !client->getMultiplexingStatus().isOK()) {
+        return nullptr;
+    }
+
+    ++multiplexedConn->requests;
+    return multiplexedConn;
+}
+
+void NetworkInterfaceTL::_leaveMultiplexedConnection(
+    std::shared_ptr<MultiplexedConnection> multiplexedConn) {
+    {
+        stdx::lock_guard lk(_multiplexMutex);
+        invariant(multiplexedConn->requests > 0);
+        --multiplexedConn->requests;
+    }
+
+    // If this was the last reference, the connection goes back to the pool here, outside of
+    // _multiplexMutex.
+    multiplexedConn.reset();
+}
+
 Status NetworkInterfaceTL::schedule(unique_function<void(Status)> action) {
     if (inShutdown()) {
         return kNetworkInterfaceShutdownInProgress;
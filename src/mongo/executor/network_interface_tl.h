@@ -44,6 +44,7 @@
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/hierarchical_acquisition.h"
 #include "mongo/util/strong_weak_finish_line.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace executor {
@@ -104,6 +105,7 @@ public:
 private:
     struct RequestState;
     struct RequestManager;
+    struct MultiplexedConnection;
 
     struct CommandStateBase : public std::enable_shared_from_this<CommandStateBase> {
         CommandStateBase(NetworkInterfaceTL* interface_,
@@ -178,6 +180,9 @@ private:
         StrongWeakFinishLine finishLine;
 
         boost::optional<UUID> operationKey;
+
+        // True if this command may share its connection with other commands to the same host.
+        bool canMultiplex{false};
     };
 
     struct CommandState final : public CommandStateBase {
@@ -233,6 +238,23 @@ private:
         RequestManager(CommandStateBase* cmdState);
 
         void trySend(StatusWith<ConnectionPool::ConnectionHandle> swConn, size_t idx) noexcept;
+
+        /**
+         * Sends the request on the connection it has acquired.
+         */
+        void send(std::shared_ptr<RequestState> requestState) noexcept;
+
+        /**
+         * Sends the hedged request once 'delay' has passed, unless the command has finished by
+         * then, in which case its connection is returned to the pool unused.
+         */
+        void sendAfterDelay(std::shared_ptr<RequestState> requestState,
+                            Milliseconds delay) noexcept;
+
+        /**
+         * Sends the request on a connection that other commands are already using.
+         */
+        void sendMultiplexed(std::shared_ptr<MultiplexedConnection> multiplexedConn) noexcept;
         void cancelRequests();
         void killOperationsForPendingRequests();
 
@@ -281,6 +303,11 @@ private:
          */
         void resolve(Future<RemoteCommandResponse> future) noexcept;
 
+        /**
+         * Use a connection shared with other commands for this request.
+         */
+        void setMultiplexedConnection(std::shared_ptr<MultiplexedConnection> connection) noexcept;
+
         NetworkInterfaceTL* interface() noexcept {
             return cmdState->interface;
         }
@@ -289,6 +316,12 @@ private:
 
         ClockSource::StopWatch stopwatch;
 
+        // Measures the round trip time of the request from when it is sent.
+        Timer sendTimer;
+
+        // Used to wait out the hedging delay before sending a hedged request.
+        std::unique_ptr<transport::ReactorTimer> hedgeTimer;
+
         RequestManager* const requestManager{nullptr};
 
         boost::optional<RemoteCommandRequest> request;
@@ -296,6 +329,10 @@ private:
         ConnectionHandle conn;
         WeakConnectionHandle weakConn;
 
+        // Set if 'conn' is shared with other commands, along with the message id of the request.
+        std::shared_ptr<MultiplexedConnection> multiplexedConn;
+        boost::optional<int32_t> multiplexedMsgId;
+
         // Internal id of this request as tracked by the RequestManager.
         size_t reqId;
 
@@ -308,6 +345,24 @@ private:
         bool fulfilledPromise{false};
     };
 
+    /**
+     * A pooled connection that commands to the same host share while
+     * maxMultiplexedRequestsPerConnection is more than 1. It goes back to the pool once the last
+     * command using it has finished.
+     */
+    struct MultiplexedConnection {
+        MultiplexedConnection(NetworkInterfaceTL* interface_,
+                              ConnectionPool::ConnectionHandle conn_)
+            : interface(interface_), conn(std::move(conn_)) {}
+        ~MultiplexedConnection();
+
+        NetworkInterfaceTL* const interface;
+        ConnectionPool::ConnectionHandle conn;
+
+        // The number of requests using the connection, guarded by _multiplexMutex
+        size_t requests{0};
+    };
+
     struct AlarmState {
         AlarmState(Date_t when_,
                    TaskExecutor::CallbackHandle cbHandle_,
@@ -333,6 +388,22 @@ private:
 
     Status _killOperation(std::shared_ptr<RequestState> requestStateToKill);
 
+    /**
+     * Shares the given freshly acquired connection with later commands to the same host, unless
+     * it can't carry multiplexed requests, in which case 'conn' is left untouched.
+     */
+    std::shared_ptr<MultiplexedConnection> _makeMultiplexedConnection(
+        ConnectionPool::ConnectionHandle& conn);
+
+    /**
+     * Returns a connection to 'host' that another command is using and that has room for one more
+     * request, if there is one.
+     */
+    std::shared_ptr<MultiplexedConnection> _joinMultiplexedConnection(
+        const HostAndPort& host, transport::ConnectSSLMode sslMode);
+
+    void _leaveMultiplexedConnection(std::shared_ptr<MultiplexedConnection> multiplexedConn);
+
     std::string _instanceName;
     ServiceContext* _svcCtx = nullptr;
     transport::TransportLayer* _tl = nullptr;
@@ -369,6 +440,9 @@ private:
     stdx::unordered_map<TaskExecutor::CallbackHandle, std::shared_ptr<AlarmState>>
         _inProgressAlarms;
 
+    Mutex _multiplexMutex = MONGO_MAKE_LATCH("NetworkInterfaceTL::_multiplexMutex");
+    stdx::unordered_map<HostAndPort, std::weak_ptr<MultiplexedConnection>> _multiplexedConns;
+
     stdx::condition_variable _workReadyCond;
     bool _isExecutorRunnable = false;
 };
@@ -147,6 +147,7 @@ std::string RemoteCommandRequestImpl<T>::toString() const {
     if (hedgeOptions) {
         invariant(operationKey);
         out << " hedgeOptions.count: " << hedgeOptions->count;
+        out << " hedgeOptions.delay: " << hedgeOptions->delay;
         out << " operationKey: " << operationKey.get();
     }
 
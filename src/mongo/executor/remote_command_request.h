@@ -46,6 +46,9 @@ struct RemoteCommandRequestBase {
     struct HedgeOptions {
         size_t count = 0;
         int maxTimeMSForHedgedReads = 0;
+
+        // How long to wait for a response to the first request before sending the hedged ones.
+        Milliseconds delay{0};
     };
 
     enum FireAndForgetMode { kOn, kOff };
@@ -103,5 +103,13 @@ void ReplyBuilderInterface::setNextInvocation(boost::optional<BSONObj> nextInvoc
     _nextInvocation = nextInvocation;
 }
 
+bool ReplyBuilderInterface::isNextExhaustResponseReady() const {
+    return _nextExhaustResponseReady;
+}
+
+void ReplyBuilderInterface::setNextExhaustResponseReady(bool ready) {
+    _nextExhaustResponseReady = ready;
+}
+
 }  // namespace rpc
 }  // namespace mongo
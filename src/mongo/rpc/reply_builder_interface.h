@@ -155,6 +155,13 @@ public:
      */
     virtual void setNextInvocation(boost::optional<BSONObj> nextInvocation);
 
+    /**
+     * For exhaust commands, returns whether the next invocation is known to produce its response
+     * without waiting for new data, so that this response may be sent together with it.
+     */
+    virtual bool isNextExhaustResponseReady() const;
+    virtual void setNextExhaustResponseReady(bool ready);
+
 protected:
     ReplyBuilderInterface() = default;
 
@@ -165,6 +172,9 @@ private:
     // The next invocation for an exhaust command. If this is boost::none, the previous invocation
     // should be reused for the next invocation.
     boost::optional<BSONObj> _nextInvocation;
+
+    // For exhaust commands, indicates whether the next invocation can respond without waiting.
+    bool _nextExhaustResponseReady = false;
 };
 
 }  // namespace rpc
@@ -212,6 +212,10 @@ auto AsyncRequestsSender::RemoteData::scheduleRemoteCommand(std::vector<HostAndP
         });
 
     auto hedgeOptions = extractHedgeOptions(_cmdObj, _ars->_readPreference);
+    if (hedgeOptions) {
+        applyObservedLatencies(
+            _ars->_opCtx->getServiceContext(), _cmdObj, &hostAndPorts, &*hedgeOptions);
+    }
     executor::RemoteCommandRequestOnAny request(std::move(hostAndPorts),
                                                 _ars->_db,
                                                 _cmdObj,
@@ -777,6 +777,14 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
             return;
         }
 
+        const bool routingInfoChanged = newRoutingInfo
+            ? (!existingRoutingInfo ||
+               existingRoutingInfo->getSequenceNumber() != newRoutingInfo->getSequenceNumber())
+            : bool(existingRoutingInfo);
+        if (routingInfoChanged) {
+            _cacheLoader.onRoutingTableRefreshed(nss, newRoutingInfo);
+        }
+
         stdx::lock_guard<Latch> lg(_mutex);
 
         collEntry->epochHasChanged = false;
@@ -45,6 +45,7 @@ namespace mongo {
 
 class NamespaceString;
 class OperationContext;
+class RoutingTableHistory;
 
 /**
  * Interface through which the sharding catalog cache requests the set of changed chunks to be
@@ -161,6 +162,17 @@ public:
 
     virtual void waitForDatabaseFlush(OperationContext* opCtx, StringData dbName) = 0;
 
+    /**
+     * Invoked by the catalog cache after a refresh has produced a new routing table for 'nss', or
+     * found the collection to be no longer sharded, in which case 'routingTable' is nullptr. Must
+     * not block, because it is called from the thread which completes the refresh.
+     *
+     * Loaders which keep a copy of the routing tables of their own may use this to update it. The
+     * default implementation does nothing.
+     */
+    virtual void onRoutingTableRefreshed(const NamespaceString& nss,
+                                         std::shared_ptr<RoutingTableHistory> routingTable) {}
+
     /**
      * Only used for unit-tests, clears a previously-created catalog cache loader from the specified
      * service context, so that 'create' can be called again.
@@ -33,6 +33,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <cstring>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -118,39 +120,18 @@ std::vector<std::shared_ptr<ChunkInfo>> flatten(const std::vector<ChunkType>& ch
 
 ShardVersionMap ChunkMap::constructShardVersionMap() const {
     ShardVersionMap shardVersions;
-    ChunkVector::const_iterator current = _chunkMap.cbegin();
 
     boost::optional<BSONObj> firstMin = boost::none;
     boost::optional<BSONObj> lastMax = boost::none;
 
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = *current;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt =
-                shardVersions.emplace(currentRangeShardId, _collectionVersion.epoch()).first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second.shardVersion;
+    // The current range of consecutive chunks residing on the same shard
+    const ChunkInfo* firstChunkInRange = nullptr;
+    const ChunkInfo* rangeLast = nullptr;
 
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId, &maxShardVersion](const auto& currentChunk) {
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
-
-                             if (currentChunk->getLastmod() > maxShardVersion)
-                                 maxShardVersion = currentChunk->getLastmod();
-
-                             return false;
-                         });
-
-        const auto rangeLast = *std::prev(current);
+    // Tracks the max shard version for the shard on which the current range resides
+    ChunkVersion* maxShardVersion = nullptr;
 
+    auto finishRange = [&] {
         const auto& rangeMin = firstChunkInRange->getMin();
         const auto& rangeMax = rangeLast->getMax();
 
@@ -175,10 +156,37 @@ ShardVersionMap ChunkMap::constructShardVersionMap() const {
 
         // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
         // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
+        invariant(maxShardVersion->isSet());
+    };
+
+    forEach([&](const std::shared_ptr<ChunkInfo>& currentChunk) {
+        const auto& currentShardId = currentChunk->getShardIdAt(boost::none);
+
+        if (!firstChunkInRange || firstChunkInRange->getShardIdAt(boost::none) != currentShardId) {
+            if (firstChunkInRange)
+                finishRange();
+
+            firstChunkInRange = currentChunk.get();
+
+            auto shardVersionIt = shardVersions.find(currentShardId);
+            if (shardVersionIt == shardVersions.end()) {
+                shardVersionIt =
+                    shardVersions.emplace(currentShardId, _collectionVersion.epoch()).first;
+            }
+            maxShardVersion = &shardVersionIt->second.shardVersion;
+        }
+
+        if (currentChunk->getLastmod() > *maxShardVersion)
+            *maxShardVersion = currentChunk->getLastmod();
 
-    if (!_chunkMap.empty()) {
+        rangeLast = currentChunk.get();
+        return true;
+    });
+
+    if (firstChunkInRange)
+        finishRange();
+
+    if (_size > 0) {
         invariant(!shardVersions.empty());
         invariant(firstMin.is_initialized());
         invariant(lastMax.is_initialized());
@@ -190,17 +198,73 @@ ShardVersionMap ChunkMap::constructShardVersionMap() const {
     return shardVersions;
 }
 
-void ChunkMap::appendChunk(const std::shared_ptr<ChunkInfo>& chunk) {
-    appendChunkTo(_chunkMap, chunk);
+void ChunkMap::PackedKeyStrings::reserve(size_t numKeys, size_t numBytes) {
+    _ends.reserve(numKeys);
+    _buffer.reserve(numBytes);
+}
+
+void ChunkMap::PackedKeyStrings::append(StringData keyString) {
+    _buffer.append(keyString.rawData(), keyString.size());
+    _ends.push_back(_buffer.size());
+}
+
+void ChunkMap::PackedKeyStrings::popBack() {
+    _ends.pop_back();
+    _buffer.resize(_ends.empty() ? 0 : _ends.back());
+}
+
+size_t ChunkMap::PackedKeyStrings::upperBound(StringData keyString, bool orEqual) const {
+    // Binary search comparing 'keyString' against the packed keys in place, with the same ordering
+    // as std::string::compare().
+    auto lessThanKeyAt = [&](size_t i) {
+        const size_t begin = i == 0 ? 0 : _ends[i - 1];
+        const size_t size = _ends[i] - begin;
+        const int cmp = std::memcmp(
+            keyString.rawData(), _buffer.data() + begin, std::min(keyString.size(), size));
+        if (cmp != 0)
+            return cmp < 0;
+        return orEqual ? keyString.size() <= size : keyString.size() < size;
+    };
+
+    size_t low = 0;
+    size_t high = _ends.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (lessThanKeyAt(mid)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+ChunkMap::Block::Block(ChunkVector chunks)
+    : _chunks(std::move(chunks)), _maxVersion(_chunks.front()->getLastmod()) {
+    size_t numBytes = 0;
+    for (const auto& chunk : _chunks) {
+        numBytes += chunk->getMaxKeyString().size();
+    }
+
+    _maxKeyStrings.reserve(_chunks.size(), numBytes);
+    for (const auto& chunk : _chunks) {
+        _maxKeyStrings.append(chunk->getMaxKeyString());
+        _maxVersion = std::max(_maxVersion, chunk->getLastmod());
+    }
+}
 
-    _collectionVersion = std::max(_collectionVersion, chunk->getLastmod());
+void ChunkMap::_appendBlock(std::shared_ptr<const Block> block) {
+    _blockMaxKeyStrings.append(block->lastMaxKeyString());
+    _size += block->chunks().size();
+    _collectionVersion = std::max(_collectionVersion, block->getMaxVersion());
+    _blocks.push_back(std::move(block));
 }
 
 std::shared_ptr<ChunkInfo> ChunkMap::findIntersectingChunk(const BSONObj& shardKey) const {
-    const auto it = _findIntersectingChunk(shardKey);
+    const auto pos = _findIntersectingChunk(shardKey);
 
-    if (it != _chunkMap.end())
-        return *it;
+    if (pos.block < _blocks.size())
+        return _blocks[pos.block]->chunks()[pos.chunk];
 
     return std::shared_ptr<ChunkInfo>();
 }
@@ -215,89 +279,173 @@ void validateChunk(const std::shared_ptr<ChunkInfo>& chunk, const ChunkVersion&
 }
 
 ChunkMap ChunkMap::createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) {
-    size_t chunkMapIndex = 0;
+    size_t blockIndex = 0;
+    size_t chunkIndex = 0;
     size_t changedChunkIndex = 0;
 
-    ChunkMap updatedChunkMap(getVersion().epoch(), _chunkMap.size() + changedChunks.size());
+    ChunkMap updatedChunkMap(getVersion().epoch(), _size + changedChunks.size());
+
+    // Chunks appended to the updated map which are not yet part of one of its blocks
+    ChunkVector pending;
+    pending.reserve(kChunksPerBlock);
 
-    while (chunkMapIndex < _chunkMap.size() || changedChunkIndex < changedChunks.size()) {
-        if (chunkMapIndex >= _chunkMap.size()) {
+    auto sealPending = [&] {
+        if (!pending.empty()) {
+            updatedChunkMap._appendBlock(std::make_shared<Block>(std::move(pending)));
+            pending = ChunkVector();
+            pending.reserve(kChunksPerBlock);
+        }
+    };
+
+    auto lastAppended = [&]() -> const ChunkInfo* {
+        if (!pending.empty())
+            return pending.back().get();
+        if (!updatedChunkMap._blocks.empty())
+            return updatedChunkMap._blocks.back()->chunks().back().get();
+        return nullptr;
+    };
+
+    auto appendChunk = [&](const std::shared_ptr<ChunkInfo>& chunk) {
+        if (pending.empty() && !updatedChunkMap._blocks.empty() &&
+            chunk->getRange().overlaps(lastAppended()->getRange())) {
+            // The chunk replaces or is replaced by the last chunk of a sealed block, so reopen it
+            auto lastBlock = std::move(updatedChunkMap._blocks.back());
+            updatedChunkMap._blocks.pop_back();
+            updatedChunkMap._blockMaxKeyStrings.popBack();
+            updatedChunkMap._size -= lastBlock->chunks().size();
+            pending = lastBlock->chunks();
+        }
+
+        appendChunkTo(pending, chunk);
+        updatedChunkMap._collectionVersion =
+            std::max(updatedChunkMap._collectionVersion, chunk->getLastmod());
+
+        if (pending.size() >= kChunksPerBlock) {
+            sealPending();
+        }
+    };
+
+    while (blockIndex < _blocks.size() || changedChunkIndex < changedChunks.size()) {
+        if (blockIndex >= _blocks.size()) {
             validateChunk(changedChunks[changedChunkIndex], getVersion());
-            updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
+            appendChunk(changedChunks[changedChunkIndex++]);
+            continue;
+        }
+
+        const auto& block = _blocks[blockIndex];
+
+        if (chunkIndex == 0 &&
+            (changedChunkIndex >= changedChunks.size() ||
+             changedChunks[changedChunkIndex]->getMin().woCompare(
+                 block->chunks().back()->getMax()) >= 0) &&
+            (!lastAppended() ||
+             !lastAppended()->getRange().overlaps(block->chunks().front()->getRange()))) {
+            // None of the remaining changed chunks overlap this block, so share it with the updated
+            // map as a whole. Small pending runs are merged into it rather than left as a block of
+            // their own.
+            if (!pending.empty() &&
+                pending.size() + block->chunks().size() <= 2 * kChunksPerBlock) {
+                pending.insert(pending.end(), block->chunks().begin(), block->chunks().end());
+                updatedChunkMap._collectionVersion =
+                    std::max(updatedChunkMap._collectionVersion, block->getMaxVersion());
+                sealPending();
+            } else {
+                sealPending();
+                updatedChunkMap._appendBlock(block);
+            }
+            ++blockIndex;
             continue;
         }
 
+        const auto& chunkInfo = block->chunks()[chunkIndex];
+        auto advanceChunk = [&] {
+            if (++chunkIndex == block->chunks().size()) {
+                chunkIndex = 0;
+                ++blockIndex;
+            }
+        };
+
         if (changedChunkIndex >= changedChunks.size()) {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
+            appendChunk(chunkInfo);
+            advanceChunk();
             continue;
         }
 
-        auto overlap = _chunkMap[chunkMapIndex]->getRange().overlaps(
-            changedChunks[changedChunkIndex]->getRange());
+        auto overlap = chunkInfo->getRange().overlaps(changedChunks[changedChunkIndex]->getRange());
 
         if (overlap) {
             auto& changedChunk = changedChunks[changedChunkIndex++];
-            auto& chunkInfo = _chunkMap[chunkMapIndex];
 
             auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
             changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
 
             validateChunk(changedChunk, getVersion());
-            updatedChunkMap.appendChunk(changedChunk);
+            appendChunk(changedChunk);
         } else {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
+            appendChunk(chunkInfo);
+            advanceChunk();
         }
     }
 
+    sealPending();
+
     return updatedChunkMap;
 }
 
+size_t ChunkMap::numSharedBlocks(const ChunkMap& other) const {
+    std::set<const Block*> otherBlocks;
+    for (const auto& block : other._blocks) {
+        otherBlocks.insert(block.get());
+    }
+
+    return std::count_if(_blocks.begin(), _blocks.end(), [&](const auto& block) {
+        return otherBlocks.count(block.get());
+    });
+}
+
 BSONObj ChunkMap::toBSON() const {
     BSONObjBuilder builder;
 
     builder.append("startingVersion"_sd, getVersion().toBSON());
-    builder.append("chunkCount", static_cast<int64_t>(_chunkMap.size()));
+    builder.append("chunkCount", static_cast<int64_t>(_size));
 
     {
         BSONArrayBuilder arrayBuilder(builder.subarrayStart("chunks"_sd));
-        for (const auto& chunk : _chunkMap) {
+        forEach([&](const auto& chunk) {
             arrayBuilder.append(chunk->toString());
-        }
+            return true;
+        });
     }
 
     return builder.obj();
 }
 
-ChunkMap::ChunkVector::const_iterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
-                                                                       bool isMaxInclusive) const {
+ChunkMap::Position ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
+                                                    bool isMaxInclusive) const {
     auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
 
-    if (!isMaxInclusive) {
-        return std::lower_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const auto& chunkInfo, const BSONObj& shardKey) {
-                                    return chunkInfo->getMaxKeyString() < shardKeyString;
-                                });
-    } else {
-        return std::upper_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const BSONObj& shardKey, const auto& chunkInfo) {
-                                    return shardKeyString < chunkInfo->getMaxKeyString();
-                                });
+    // The first chunk whose max key is greater than the shard key (or equal to it, if the max is
+    // not inclusive) is in the first block whose last max key is.
+    const size_t block = _blockMaxKeyStrings.upperBound(shardKeyString, !isMaxInclusive);
+    if (block == _blocks.size()) {
+        return _end();
     }
+
+    return {block, _blocks[block]->upperBound(shardKeyString, !isMaxInclusive)};
 }
 
-std::pair<ChunkMap::ChunkVector::const_iterator, ChunkMap::ChunkVector::const_iterator>
-ChunkMap::_overlappingBounds(const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
-    const auto itMin = _findIntersectingChunk(min);
-    const auto itMax = [&]() {
-        auto it = _findIntersectingChunk(max, isMaxInclusive);
-        return it == _chunkMap.end() ? it : ++it;
+std::pair<ChunkMap::Position, ChunkMap::Position> ChunkMap::_overlappingBounds(
+    const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
+    const auto posMin = _findIntersectingChunk(min);
+    const auto posMax = [&]() {
+        auto pos = _findIntersectingChunk(max, isMaxInclusive);
+        if (pos.block < _blocks.size()) {
+            ++pos.chunk;
+        }
+        return pos;
     }();
 
-    return {itMin, itMax};
+    return {posMin, posMax};
 }
 
 ShardVersionTargetingInfo::ShardVersionTargetingInfo(const OID& epoch)
@@ -67,17 +67,80 @@ using ShardVersionMap = stdx::unordered_map<ShardId, ShardVersionTargetingInfo,
 // This class serves as a Facade around how the mapping of ranges to chunks is represented. It also
 // provides a simpler, high-level interface for domain specific operations without exposing the
 // underlying implementation.
+//
+// The chunks, ordered by max key, are kept in immutable blocks of consecutive chunks, forming a
+// two-level B-tree. Each block packs the KeyStrings of its chunks' max keys into one contiguous
+// buffer, and the map packs the max key of each block the same way, so targeting a key is two
+// binary searches with memcmp over contiguous memory rather than one dereferencing a ChunkInfo
+// per probe. Maps created through createMerged() share the blocks the changed chunks do not touch
+// with the map they were created from.
 class ChunkMap {
-    // Vector of chunks ordered by max key.
     using ChunkVector = std::vector<std::shared_ptr<ChunkInfo>>;
 
+    // Sorted KeyStrings stored back to back in a single buffer.
+    class PackedKeyStrings {
+    public:
+        void reserve(size_t numKeys, size_t numBytes);
+        void append(StringData keyString);
+        void popBack();
+
+        size_t size() const {
+            return _ends.size();
+        }
+
+        // Index of the first key greater than 'keyString' (or >= if 'orEqual'), or size().
+        size_t upperBound(StringData keyString, bool orEqual = false) const;
+
+    private:
+        std::string _buffer;
+        std::vector<uint32_t> _ends;
+    };
+
+    // A run of consecutive chunks, ordered by max key.
+    class Block {
+    public:
+        explicit Block(ChunkVector chunks);
+
+        const ChunkVector& chunks() const {
+            return _chunks;
+        }
+
+        const std::string& lastMaxKeyString() const {
+            return _chunks.back()->getMaxKeyString();
+        }
+
+        // Index of the first chunk whose max key is greater than 'keyString' (or >= if 'orEqual').
+        size_t upperBound(StringData keyString, bool orEqual = false) const {
+            return _maxKeyStrings.upperBound(keyString, orEqual);
+        }
+
+        const ChunkVersion& getMaxVersion() const {
+            return _maxVersion;
+        }
+
+    private:
+        ChunkVector _chunks;
+        PackedKeyStrings _maxKeyStrings;
+        ChunkVersion _maxVersion;
+    };
+
+    // Identifies a chunk by its block and its index within the block. The position past the last
+    // chunk is {_blocks.size(), 0}.
+    struct Position {
+        size_t block;
+        size_t chunk;
+    };
+
 public:
+    // Blocks are sealed once they reach this many chunks.
+    static constexpr size_t kChunksPerBlock = 128;
+
     explicit ChunkMap(OID epoch, size_t initialCapacity = 0) : _collectionVersion(0, 0, epoch) {
-        _chunkMap.reserve(initialCapacity);
+        _blocks.reserve(initialCapacity / kChunksPerBlock + 1);
     }
 
     size_t size() const {
-        return _chunkMap.size();
+        return _size;
     }
 
     ChunkVersion getVersion() const {
@@ -86,12 +149,8 @@ public:
 
     template <typename Callable>
     void forEach(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
-        auto it = shardKey.isEmpty() ? _chunkMap.begin() : _findIntersectingChunk(shardKey);
-
-        for (; it != _chunkMap.end(); ++it) {
-            if (!handler(*it))
-                break;
-        }
+        const auto first = shardKey.isEmpty() ? Position{0, 0} : _findIntersectingChunk(shardKey);
+        _forEachBetween(first, _end(), handler);
     }
 
     template <typename Callable>
@@ -100,28 +159,59 @@ public:
                                  bool isMaxInclusive,
                                  Callable&& handler) const {
         const auto bounds = _overlappingBounds(min, max, isMaxInclusive);
-
-        for (auto it = bounds.first; it != bounds.second; ++it) {
-            if (!handler(*it))
-                break;
-        }
+        _forEachBetween(bounds.first, bounds.second, handler);
     }
 
     ShardVersionMap constructShardVersionMap() const;
     std::shared_ptr<ChunkInfo> findIntersectingChunk(const BSONObj& shardKey) const;
 
-    void appendChunk(const std::shared_ptr<ChunkInfo>& chunk);
     ChunkMap createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks);
 
+    /**
+     * Returns the number of blocks shared with 'other', for tests and benchmarks.
+     */
+    size_t numSharedBlocks(const ChunkMap& other) const;
+
+    size_t numBlocks() const {
+        return _blocks.size();
+    }
+
     BSONObj toBSON() const;
 
 private:
-    ChunkVector::const_iterator _findIntersectingChunk(const BSONObj& shardKey,
-                                                       bool isMaxInclusive = true) const;
-    std::pair<ChunkVector::const_iterator, ChunkVector::const_iterator> _overlappingBounds(
-        const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
+    Position _end() const {
+        return {_blocks.size(), 0};
+    }
+
+    // Calls 'handler' on the chunks from 'first' up to, but excluding, 'last', until it returns
+    // false.
+    template <typename Callable>
+    void _forEachBetween(Position first, Position last, Callable& handler) const {
+        for (size_t b = first.block; b < _blocks.size() && b <= last.block; ++b) {
+            const auto& chunks = _blocks[b]->chunks();
+            const size_t begin = (b == first.block) ? first.chunk : 0;
+            const size_t end = (b == last.block) ? std::min(last.chunk, chunks.size())
+                                                 : chunks.size();
+            for (size_t i = begin; i < end; ++i) {
+                if (!handler(chunks[i]))
+                    return;
+            }
+        }
+    }
+
+    void _appendBlock(std::shared_ptr<const Block> block);
+
+    Position _findIntersectingChunk(const BSONObj& shardKey, bool isMaxInclusive = true) const;
+    std::pair<Position, Position> _overlappingBounds(const BSONObj& min,
+                                                     const BSONObj& max,
+                                                     bool isMaxInclusive) const;
+
+    std::vector<std::shared_ptr<const Block>> _blocks;
+
+    // The KeyString of the last max key of each block in _blocks.
+    PackedKeyStrings _blockMaxKeyStrings;
 
-    ChunkVector _chunkMap;
+    size_t _size = 0;
 
     // Max version across all chunks
     ChunkVersion _collectionVersion;
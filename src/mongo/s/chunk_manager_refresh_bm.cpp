@@ -336,6 +336,50 @@ void BM_RangeOverlapsChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+// Moves 'nMoves' chunks spread across the key space to other shards, one refresh per move, so
+// that targeting is measured against a routing table built by incremental refreshes.
+auto makeChunkManagerAfterIncrementalRefreshes(int nShards, uint32_t nChunks, int nMoves) {
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+    auto version = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+
+    PseudoRandom rand(12345);
+    for (int i = 0; i < nMoves; ++i) {
+        version.incMajor();
+        const int chunk = rand.nextInt32(nChunks);
+        std::vector<ChunkType> newChunks;
+        newChunks.emplace_back(collName,
+                               getRangeForChunk(chunk, nChunks),
+                               version,
+                               ShardId(str::stream() << "shard" << (i % nShards)));
+        cm = runIncrementalUpdate(*cm, newChunks);
+    }
+    return cm;
+}
+
+void BM_FindIntersectingChunkAfterIncrementalRefreshes(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    const int nMoves = 100;
+
+    auto cm = makeChunkManagerAfterIncrementalRefreshes(nShards, nChunks, nMoves);
+    auto keys = makeKeys(nChunks);
+    auto keysIter = makeCircularIterator(keys);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(
+            cm->getChunkManager()->findIntersectingChunkWithSimpleCollation(*keysIter));
+        ++keysIter;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FindIntersectingChunkAfterIncrementalRefreshes)
+    ->Args({2, 50000})
+    ->Args({100, 50000})
+    ->Args({2, 500000});
+
 // The following was adapted from the BENCHMARK_CAPTURE() macro where the
 // benchmark::internal::Benchmark* is returned rather than declared as a static variable.
 #define REGISTER_BENCHMARK_CAPTURE(func, test_case_name, ...) \
@@ -375,6 +419,7 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({10, 50000})
             ->Args({100, 50000})
             ->Args({1000, 50000})
+            ->Args({2, 500000})
             ->Args({2, 2});
     }
 
@@ -38,6 +38,7 @@ namespace {
 
 const NamespaceString kNss("TestDB", "TestColl");
 const ShardId kThisShard("testShard");
+const int kChunksPerBlock = ChunkMap::kChunksPerBlock;
 
 class ChunkMapTest : public unittest::Test {
 public:
@@ -45,6 +46,40 @@ public:
         return _shardKeyPattern;
     }
 
+    std::shared_ptr<ChunkInfo> makeChunk(const BSONObj& min,
+                                         const BSONObj& max,
+                                         const ChunkVersion& version) const {
+        return std::make_shared<ChunkInfo>(
+            ChunkType{kNss, ChunkRange{min, max}, version, kThisShard});
+    }
+
+    // Returns a map of 'numChunks' chunks, the i-th of which (except the first and last) covers
+    // [a: (i - 1) * 10, a: i * 10).
+    ChunkMap makeChunkMap(const OID& epoch, int numChunks) const {
+        std::vector<std::shared_ptr<ChunkInfo>> chunks;
+        for (int i = 0; i < numChunks; ++i) {
+            auto min = i == 0 ? getShardKeyPattern().globalMin() : BSON("a" << (i - 1) * 10);
+            auto max = i == numChunks - 1 ? getShardKeyPattern().globalMax() : BSON("a" << i * 10);
+            chunks.push_back(makeChunk(min, max, ChunkVersion{1, uint32_t(i), epoch}));
+        }
+        return ChunkMap{epoch}.createMerged(chunks);
+    }
+
+    // Asserts that the chunks of 'chunkMap' are contiguous from MinKey to MaxKey.
+    void assertContiguous(const ChunkMap& chunkMap) const {
+        size_t count = 0;
+        auto lastMax = getShardKeyPattern().globalMin();
+        chunkMap.forEach([&](const auto& chunkInfo) {
+            ASSERT_BSONOBJ_EQ(lastMax, chunkInfo->getMin());
+            lastMax = chunkInfo->getMax();
+            count++;
+            return true;
+        });
+        ASSERT_BSONOBJ_EQ(getShardKeyPattern().globalMax(), lastMax);
+        ASSERT_EQ(count, chunkMap.size());
+        chunkMap.constructShardVersionMap();
+    }
+
 private:
     KeyPattern _shardKeyPattern{BSON("a" << 1)};
 };
@@ -165,4 +200,77 @@ TEST_F(ChunkMapTest, TestEnumerateOverlappingChunks) {
     ASSERT_EQ(count, 3);
 }
 
-}  // namespace mongo
\ No newline at end of file
+TEST_F(ChunkMapTest, TestIntersectingChunkAcrossBlocks) {
+    const OID epoch = OID::gen();
+    const int numChunks = 5 * kChunksPerBlock + 3;
+    auto chunkMap = makeChunkMap(epoch, numChunks);
+
+    ASSERT_EQ(chunkMap.size(), numChunks);
+    ASSERT_GT(chunkMap.numBlocks(), 1U);
+    assertContiguous(chunkMap);
+
+    for (int key = -5; key < numChunks * 10; key += 5) {
+        auto shardKey = BSON("a" << key);
+        auto chunk = chunkMap.findIntersectingChunk(shardKey);
+        ASSERT(chunk);
+        ASSERT(chunk->containsKey(shardKey));
+    }
+
+    // The max bound of a chunk belongs to the next chunk.
+    auto boundary = BSON("a" << kChunksPerBlock * 10);
+    ASSERT_BSONOBJ_EQ(boundary, chunkMap.findIntersectingChunk(boundary)->getMin());
+
+    int count = 0;
+    chunkMap.forEachOverlappingChunk(BSON("a" << 5), boundary, false, [&](const auto& chunk) {
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, kChunksPerBlock);
+
+    count = 0;
+    chunkMap.forEachOverlappingChunk(BSON("a" << 5), boundary, true, [&](const auto& chunk) {
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, kChunksPerBlock + 1);
+}
+
+TEST_F(ChunkMapTest, TestIncrementalMergeSharesUntouchedBlocks) {
+    const OID epoch = OID::gen();
+    auto chunkMap = makeChunkMap(epoch, 10 * kChunksPerBlock);
+
+    // Split a chunk in the middle of the map.
+    const int splitChunk = 5 * kChunksPerBlock + 7;
+    const auto min = BSON("a" << (splitChunk - 1) * 10);
+    const auto mid = BSON("a" << (splitChunk - 1) * 10 + 5);
+    const auto max = BSON("a" << splitChunk * 10);
+    auto newChunkMap = chunkMap.createMerged({makeChunk(min, mid, ChunkVersion{2, 0, epoch}),
+                                              makeChunk(mid, max, ChunkVersion{2, 1, epoch})});
+
+    ASSERT_EQ(newChunkMap.size(), chunkMap.size() + 1);
+    ASSERT_EQ(newChunkMap.getVersion(), (ChunkVersion{2, 1, epoch}));
+    assertContiguous(newChunkMap);
+    ASSERT_GTE(newChunkMap.numSharedBlocks(chunkMap), chunkMap.numBlocks() - 2);
+    auto upperHalf = newChunkMap.findIntersectingChunk(BSON("a" << (splitChunk - 1) * 10 + 6));
+    ASSERT_BSONOBJ_EQ(mid, upperHalf->getMin());
+}
+
+TEST_F(ChunkMapTest, TestIncrementalMergeAcrossBlockBoundary) {
+    const OID epoch = OID::gen();
+    auto chunkMap = makeChunkMap(epoch, 4 * kChunksPerBlock);
+
+    // Merge the chunks on either side of the boundary between the first two blocks.
+    const int boundaryChunk = kChunksPerBlock;
+    const auto min = BSON("a" << (boundaryChunk - 2) * 10);
+    const auto max = BSON("a" << (boundaryChunk + 1) * 10);
+    auto newChunkMap = chunkMap.createMerged({makeChunk(min, max, ChunkVersion{2, 0, epoch})});
+
+    ASSERT_EQ(newChunkMap.size(), chunkMap.size() - 2);
+    assertContiguous(newChunkMap);
+
+    auto merged = newChunkMap.findIntersectingChunk(BSON("a" << boundaryChunk * 10));
+    ASSERT_BSONOBJ_EQ(min, merged->getMin());
+    ASSERT_BSONOBJ_EQ(max, merged->getMax());
+}
+
+}  // namespace mongo
@@ -1081,6 +1081,7 @@ DbResponse Strategy::clientCommand(OperationContext* opCtx, const Message& m) {
         if (responseObj.getField("ok").trueValue()) {
             dbResponse.shouldRunAgainForExhaust = reply->shouldRunAgainForExhaust();
             dbResponse.nextInvocation = reply->getNextInvocation();
+            dbResponse.nextExhaustResponseReady = reply->isNextExhaustResponseReady();
         }
     }
     dbResponse.response = reply->done();
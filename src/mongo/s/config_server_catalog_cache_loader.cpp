@@ -29,6 +29,10 @@
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kSharding
 
+#define LOGV2_FOR_CATALOG_REFRESH(ID, DLEVEL, MESSAGE, ...) \
+    LOGV2_DEBUG_OPTIONS(                                    \
+        ID, DLEVEL, {logv2::LogComponent::kShardingCatalogRefresh}, MESSAGE, ##__VA_ARGS__)
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/s/config_server_catalog_cache_loader.h"
@@ -37,9 +41,12 @@
 
 #include "mongo/db/client.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/logv2/log.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
+#include "mongo/s/chunk_manager.h"
 #include "mongo/s/database_version_helpers.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/routing_table_cache_file_store.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -92,10 +99,15 @@ QueryAndSort createConfigDiffQuery(const NamespaceString& nss, ChunkVersion coll
 
 /**
  * Blocking method, which returns the chunks which changed since the specified version.
+ *
+ * If 'fileStore' is set and the caller has no chunks for the collection yet, the routing table
+ * persisted in 'fileStore' is used as the starting point, if it is for the current collection
+ * epoch, so that only the chunks which changed since it was written need to be fetched.
  */
 CollectionAndChangedChunks getChangedChunks(OperationContext* opCtx,
                                             const NamespaceString& nss,
-                                            ChunkVersion sinceVersion) {
+                                            ChunkVersion sinceVersion,
+                                            const RoutingTableCacheFileStore* fileStore) {
     const auto catalogClient = Grid::get(opCtx)->catalogClient();
 
     // Decide whether to do a full or partial load based on the state of the collection
@@ -104,6 +116,24 @@ CollectionAndChangedChunks getChangedChunks(OperationContext* opCtx,
             str::stream() << "Collection " << nss.ns() << " is dropped.",
             !coll.getDropped());
 
+    boost::optional<RoutingTableCacheFileStore::PersistedRoutingTable> persisted;
+    if (fileStore && sinceVersion.epoch() != coll.getEpoch()) {
+        persisted = fileStore->load(nss);
+
+        // A persisted routing table is only used once. The refresh writes back its result, and if
+        // the persisted routing table turns out to be inconsistent the retried refresh won't
+        // start from it again.
+        if (persisted) {
+            fileStore->remove(nss);
+        }
+
+        if (persisted && persisted->collectionVersion.epoch() == coll.getEpoch()) {
+            sinceVersion = persisted->collectionVersion;
+        } else {
+            persisted.reset();
+        }
+    }
+
     // If the collection's epoch has changed, do a full refresh
     const ChunkVersion startingCollectionVersion = (sinceVersion.epoch() == coll.getEpoch())
         ? sinceVersion
@@ -114,7 +144,7 @@ CollectionAndChangedChunks getChangedChunks(OperationContext* opCtx,
 
     // Query the chunks which have changed
     repl::OpTime opTime;
-    const std::vector<ChunkType> changedChunks = uassertStatusOK(
+    std::vector<ChunkType> changedChunks = uassertStatusOK(
         Grid::get(opCtx)->catalogClient()->getChunks(opCtx,
                                                      diffQuery.query,
                                                      diffQuery.sort,
@@ -126,6 +156,26 @@ CollectionAndChangedChunks getChangedChunks(OperationContext* opCtx,
             "No chunks were found for the collection",
             !changedChunks.empty());
 
+    if (persisted) {
+        LOGV2_FOR_CATALOG_REFRESH(4859013,
+                                  1,
+                                  "Starting collection refresh from persisted routing table",
+                                  "namespace"_attr = nss,
+                                  "persistedCollectionVersion"_attr = persisted->collectionVersion,
+                                  "numPersistedChunks"_attr =
+                                      persisted->collectionAndChunks.changedChunks.size(),
+                                  "numChangedChunks"_attr = changedChunks.size());
+
+        // The persisted chunks all have versions lower than the changed ones, so appending the
+        // changed chunks keeps the list sorted by version and lets them replace any persisted
+        // chunks they overlap.
+        auto& chunks = persisted->collectionAndChunks.changedChunks;
+        chunks.insert(chunks.end(),
+                      std::make_move_iterator(changedChunks.begin()),
+                      std::make_move_iterator(changedChunks.end()));
+        changedChunks = std::move(chunks);
+    }
+
     return CollectionAndChangedChunks(coll.getUUID(),
                                       coll.getEpoch(),
                                       coll.getKeyPattern().toBSON(),
@@ -137,7 +187,11 @@ CollectionAndChangedChunks getChangedChunks(OperationContext* opCtx,
 }  // namespace
 
 ConfigServerCatalogCacheLoader::ConfigServerCatalogCacheLoader()
-    : _threadPool(makeDefaultThreadPoolOptions()) {
+    : ConfigServerCatalogCacheLoader(nullptr) {}
+
+ConfigServerCatalogCacheLoader::ConfigServerCatalogCacheLoader(
+    std::unique_ptr<RoutingTableCacheFileStore> fileStore)
+    : _threadPool(makeDefaultThreadPoolOptions()), _fileStore(std::move(fileStore)) {
     _threadPool.startup();
 }
 
@@ -189,14 +243,20 @@ std::shared_ptr<Notification<void>> ConfigServerCatalogCacheLoader::getChunksSin
     const NamespaceString& nss, ChunkVersion version, GetChunksSinceCallbackFn callbackFn) {
     auto notify = std::make_shared<Notification<void>>();
 
-    _threadPool.schedule([ nss, version, notify, callbackFn ](auto status) noexcept {
+    _threadPool.schedule([
+        nss,
+        version,
+        notify,
+        callbackFn,
+        fileStore = _fileStore.get()
+    ](auto status) noexcept {
         invariant(status);
 
         auto opCtx = Client::getCurrent()->makeOperationContext();
 
         auto swCollAndChunks = [&]() -> StatusWith<CollectionAndChangedChunks> {
             try {
-                return getChangedChunks(opCtx.get(), nss, version);
+                return getChangedChunks(opCtx.get(), nss, version, fileStore);
             } catch (const DBException& ex) {
                 return ex.toStatus();
             }
@@ -234,4 +294,59 @@ void ConfigServerCatalogCacheLoader::getDatabase(
     });
 }
 
+void ConfigServerCatalogCacheLoader::onRoutingTableRefreshed(
+    const NamespaceString& nss, std::shared_ptr<RoutingTableHistory> routingTable) {
+    if (!_fileStore) {
+        return;
+    }
+
+    stdx::lock_guard<Latch> lg(_mutex);
+    if (_inShutdown) {
+        return;
+    }
+
+    _pendingRoutingTables[nss] = std::move(routingTable);
+    if (_persistScheduled) {
+        return;
+    }
+
+    _persistScheduled = true;
+    _threadPool.schedule([this](auto status) {
+        if (!status.isOK()) {
+            // The pool is shutting down, in which case the pending routing tables are dropped
+            return;
+        }
+        _persistPendingRoutingTables();
+    });
+}
+
+void ConfigServerCatalogCacheLoader::_persistPendingRoutingTables() {
+    while (true) {
+        std::map<NamespaceString, std::shared_ptr<RoutingTableHistory>> routingTables;
+        {
+            stdx::lock_guard<Latch> lg(_mutex);
+            if (_pendingRoutingTables.empty() || _inShutdown) {
+                _persistScheduled = false;
+                return;
+            }
+            routingTables.swap(_pendingRoutingTables);
+        }
+
+        for (const auto& [nss, routingTable] : routingTables) {
+            if (!routingTable) {
+                _fileStore->remove(nss);
+                continue;
+            }
+
+            auto status = _fileStore->save(*routingTable);
+            if (!status.isOK()) {
+                LOGV2_WARNING(4859014,
+                              "Failed to persist routing table",
+                              "namespace"_attr = nss,
+                              "error"_attr = redact(status));
+            }
+        }
+    }
+}
+
 }  // namespace mongo
@@ -29,14 +29,27 @@
 
 #pragma once
 
+#include <map>
+
+#include "mongo/db/namespace_string.h"
 #include "mongo/s/catalog_cache_loader.h"
 #include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 
+class RoutingTableCacheFileStore;
+
 class ConfigServerCatalogCacheLoader final : public CatalogCacheLoader {
 public:
     ConfigServerCatalogCacheLoader();
+
+    /**
+     * Constructs a loader which writes the routing tables it is notified of to 'fileStore' and,
+     * when asked for a collection's chunks from scratch, starts from the routing table persisted
+     * there and only fetches the chunks which changed since from the config server.
+     */
+    explicit ConfigServerCatalogCacheLoader(std::unique_ptr<RoutingTableCacheFileStore> fileStore);
+
     ~ConfigServerCatalogCacheLoader();
 
     /**
@@ -59,7 +72,16 @@ public:
         StringData dbName,
         std::function<void(OperationContext*, StatusWith<DatabaseType>)> callbackFn) override;
 
+    void onRoutingTableRefreshed(const NamespaceString& nss,
+                                 std::shared_ptr<RoutingTableHistory> routingTable) override;
+
 private:
+    /**
+     * Writes the routing tables in '_pendingRoutingTables' to the file store until there are no
+     * more left. Runs on the thread pool.
+     */
+    void _persistPendingRoutingTables();
+
     // Thread pool to be used to perform metadata load
     ThreadPool _threadPool;
 
@@ -68,6 +90,17 @@ private:
 
     // True if shutDown was called.
     bool _inShutdown{false};
+
+    // Where routing tables are persisted, if anywhere
+    const std::unique_ptr<RoutingTableCacheFileStore> _fileStore;
+
+    // Routing tables waiting to be persisted, by namespace. A nullptr routing table means the one
+    // persisted for the namespace should be removed. Only the latest routing table of each
+    // namespace is kept, so that a burst of refreshes results in a single write.
+    std::map<NamespaceString, std::shared_ptr<RoutingTableHistory>> _pendingRoutingTables;
+
+    // Whether a task to persist '_pendingRoutingTables' is scheduled or running
+    bool _persistScheduled{false};
 };
 
 }  // namespace mongo
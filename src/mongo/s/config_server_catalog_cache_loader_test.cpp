@@ -0,0 +1,207 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_request.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/catalog_cache_test_fixture.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/s/config_server_catalog_cache_loader.h"
+#include "mongo/s/routing_table_cache_file_store.h"
+#include "mongo/unittest/temp_dir.h"
+
+namespace mongo {
+namespace {
+
+using executor::RemoteCommandRequest;
+using unittest::assertGet;
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+class ConfigServerCatalogCacheLoaderTest : public CatalogCacheTestFixture {
+protected:
+    void setUp() override {
+        CatalogCacheTestFixture::setUp();
+
+        setupNShards(2);
+    }
+
+    // Schedules a refresh of 'kNss' from 'loader' for a caller which has no routing table yet.
+    executor::NetworkTestEnv::FutureHandle<CatalogCacheLoader::CollectionAndChangedChunks>
+    scheduleGetChunksSince(ConfigServerCatalogCacheLoader& loader) {
+        return launchAsync([&loader] {
+            boost::optional<StatusWith<CatalogCacheLoader::CollectionAndChangedChunks>> result;
+            loader
+                .getChunksSince(kNss,
+                                ChunkVersion::UNSHARDED(),
+                                [&](OperationContext*, auto swCollAndChunks) {
+                                    result.emplace(std::move(swCollAndChunks));
+                                })
+                ->get();
+            return uassertStatusOK(std::move(*result));
+        });
+    }
+
+    const ShardKeyPattern _shardKeyPattern{BSON("_id" << 1)};
+    const OID _epoch = OID::gen();
+    unittest::TempDir _tempDir{"config_server_catalog_cache_loader_test"};
+};
+
+TEST_F(ConfigServerCatalogCacheLoaderTest, RefreshStartsFromPersistedRoutingTable) {
+    // Persist a routing table of [MinKey, 0) on shard "0" and [0, MaxKey) on shard "1"
+    {
+        ChunkType chunk1(kNss,
+                         {_shardKeyPattern.getKeyPattern().globalMin(), BSON("_id" << 0)},
+                         ChunkVersion(1, 0, _epoch),
+                         {"0"});
+        ChunkType chunk2(kNss,
+                         {BSON("_id" << 0), _shardKeyPattern.getKeyPattern().globalMax()},
+                         ChunkVersion(1, 1, _epoch),
+                         {"1"});
+        const auto routingTable =
+            RoutingTableHistory::makeNew(kNss,
+                                         UUID::gen(),
+                                         _shardKeyPattern.getKeyPattern(),
+                                         nullptr,
+                                         false,
+                                         _epoch,
+                                         {chunk1, chunk2});
+
+        RoutingTableCacheFileStore fileStore(_tempDir.path());
+        ASSERT_OK(fileStore.initialize());
+        ASSERT_OK(fileStore.save(*routingTable));
+    }
+
+    ConfigServerCatalogCacheLoader loader(
+        std::make_unique<RoutingTableCacheFileStore>(_tempDir.path()));
+    auto future = scheduleGetChunksSince(loader);
+
+    // Only the chunks which changed since the persisted collection version are fetched: here the
+    // [0, MaxKey) chunk was split since the routing table was persisted
+    expectGetCollection(kNss, _epoch, _shardKeyPattern);
+    onFindCommand([&](const RemoteCommandRequest& request) {
+        const auto diffQuery =
+            assertGet(QueryRequest::makeFromFindCommand(kNss, request.cmdObj, false));
+        ASSERT_BSONOBJ_EQ(
+            BSON("ns" << kNss.ns() << "lastmod" << BSON("$gte" << Timestamp(1, 1))),
+            diffQuery->getFilter());
+
+        ChunkType chunk3(kNss,
+                         {BSON("_id" << 0), BSON("_id" << 100)},
+                         ChunkVersion(1, 2, _epoch),
+                         {"1"});
+        chunk3.setName(OID::gen());
+        ChunkType chunk4(kNss,
+                         {BSON("_id" << 100), _shardKeyPattern.getKeyPattern().globalMax()},
+                         ChunkVersion(1, 3, _epoch),
+                         {"1"});
+        chunk4.setName(OID::gen());
+
+        return std::vector<BSONObj>{chunk3.toConfigBSON(), chunk4.toConfigBSON()};
+    });
+
+    // The persisted chunks come first, followed by the changed chunks which supersede them
+    const auto collAndChunks = future.default_timed_get();
+    ASSERT_EQ(_epoch, collAndChunks.epoch);
+    ASSERT_EQ(4U, collAndChunks.changedChunks.size());
+    for (size_t i = 0; i < collAndChunks.changedChunks.size(); ++i) {
+        ASSERT_EQ(ChunkVersion(1, uint32_t(i), _epoch),
+                  collAndChunks.changedChunks[i].getVersion());
+    }
+
+    const auto routingTable = RoutingTableHistory::makeNew(kNss,
+                                                           collAndChunks.uuid,
+                                                           _shardKeyPattern.getKeyPattern(),
+                                                           nullptr,
+                                                           false,
+                                                           _epoch,
+                                                           collAndChunks.changedChunks);
+    ASSERT_EQ(3, routingTable->numChunks());
+    ASSERT_EQ(ChunkVersion(1, 3, _epoch), routingTable->getVersion());
+    ASSERT_EQ(ChunkVersion(1, 0, _epoch), routingTable->getVersion({"0"}));
+    ASSERT_EQ(ChunkVersion(1, 3, _epoch), routingTable->getVersion({"1"}));
+
+    // The persisted routing table is consumed by the refresh
+    RoutingTableCacheFileStore fileStore(_tempDir.path());
+    ASSERT(!fileStore.load(kNss));
+}
+
+TEST_F(ConfigServerCatalogCacheLoaderTest, PersistedRoutingTableOfOtherEpochIsIgnored) {
+    {
+        ChunkType chunk(kNss,
+                        {_shardKeyPattern.getKeyPattern().globalMin(),
+                         _shardKeyPattern.getKeyPattern().globalMax()},
+                        ChunkVersion(5, 0, OID::gen()),
+                        {"0"});
+        const auto routingTable =
+            RoutingTableHistory::makeNew(kNss,
+                                         UUID::gen(),
+                                         _shardKeyPattern.getKeyPattern(),
+                                         nullptr,
+                                         false,
+                                         chunk.getVersion().epoch(),
+                                         {chunk});
+
+        RoutingTableCacheFileStore fileStore(_tempDir.path());
+        ASSERT_OK(fileStore.initialize());
+        ASSERT_OK(fileStore.save(*routingTable));
+    }
+
+    ConfigServerCatalogCacheLoader loader(
+        std::make_unique<RoutingTableCacheFileStore>(_tempDir.path()));
+    auto future = scheduleGetChunksSince(loader);
+
+    // The collection was dropped and recreated since, so all of its chunks are fetched
+    expectGetCollection(kNss, _epoch, _shardKeyPattern);
+    onFindCommand([&](const RemoteCommandRequest& request) {
+        const auto diffQuery =
+            assertGet(QueryRequest::makeFromFindCommand(kNss, request.cmdObj, false));
+        ASSERT_BSONOBJ_EQ(
+            BSON("ns" << kNss.ns() << "lastmod" << BSON("$gte" << Timestamp(0, 0))),
+            diffQuery->getFilter());
+
+        ChunkType chunk(kNss,
+                        {_shardKeyPattern.getKeyPattern().globalMin(),
+                         _shardKeyPattern.getKeyPattern().globalMax()},
+                        ChunkVersion(1, 0, _epoch),
+                        {"1"});
+        chunk.setName(OID::gen());
+
+        return std::vector<BSONObj>{chunk.toConfigBSON()};
+    });
+
+    const auto collAndChunks = future.default_timed_get();
+    ASSERT_EQ(1U, collAndChunks.changedChunks.size());
+    ASSERT_EQ(ChunkVersion(1, 0, _epoch), collAndChunks.changedChunks[0].getVersion());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -29,6 +29,8 @@
 
 #include "mongo/s/hedge_options_util.h"
 
+#include "mongo/db/service_context.h"
+#include "mongo/executor/host_latency_stats.h"
 #include "mongo/s/mongos_server_parameters_gen.h"
 
 namespace mongo {
@@ -63,4 +65,29 @@ boost::optional<executor::RemoteCommandRequestOnAny::HedgeOptions> extractHedgeO
     return boost::none;
 }
 
+void applyObservedLatencies(ServiceContext* service,
+                            const BSONObj& cmdObj,
+                            std::vector<HostAndPort>* hosts,
+                            executor::RemoteCommandRequestOnAny::HedgeOptions* hedgeOptions) {
+    auto stats = executor::HostLatencyStats::get(service);
+    auto cmdName = cmdObj.firstElementFieldNameStringData();
+    auto now = service->getFastClockSource()->now();
+
+    if (gReadHedgingLatencyAwareTargeting.load()) {
+        stats->sortHostsByPredictedLatency(cmdName, now, hosts);
+    }
+
+    auto delayPercentile = gReadHedgingDelayPercentile.load();
+    if (delayPercentile == 0 || hosts->empty()) {
+        return;
+    }
+
+    // Without enough recent samples for the first host, hedge right away as we would otherwise.
+    if (auto latency =
+            stats->getLatencyQuantile(hosts->front(), cmdName, delayPercentile / 100.0, now)) {
+        // Round up, so that sub-millisecond latencies still give the first host a chance.
+        hedgeOptions->delay = Milliseconds((durationCount<Microseconds>(*latency) + 999) / 1000);
+    }
+}
+
 }  // namespace mongo
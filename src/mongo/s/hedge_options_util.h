@@ -30,11 +30,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
 #include "mongo/client/read_preference.h"
 #include "mongo/executor/remote_command_request.h"
 
 namespace mongo {
 
+class ServiceContext;
+
 /**
  * Constructs and returns hedge options based on the given cmd object and read preference
  * setting. If no hedging should be performed, returns boost::none.
@@ -42,4 +46,15 @@ namespace mongo {
 boost::optional<executor::RemoteCommandRequestOnAny::HedgeOptions> extractHedgeOptions(
     const BSONObj& cmdObj, const ReadPreferenceSetting& readPref);
 
+/**
+ * Uses the latencies recently observed for the command to reorder 'hosts' so that the one expected
+ * to respond soonest is targeted first, and to set how long to wait for it before hedging. Each is
+ * only done if enabled by the 'readHedgingLatencyAwareTargeting' and 'readHedgingDelayPercentile'
+ * server parameters respectively.
+ */
+void applyObservedLatencies(ServiceContext* service,
+                            const BSONObj& cmdObj,
+                            std::vector<HostAndPort>* hosts,
+                            executor::RemoteCommandRequestOnAny::HedgeOptions* hedgeOptions);
+
 }  // namespace mongo
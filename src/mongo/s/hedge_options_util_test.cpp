@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/client/read_preference.h"
+#include "mongo/executor/host_latency_stats.h"
 #include "mongo/s/hedge_options_util.h"
 #include "mongo/s/mongos_server_parameters_gen.h"
 #include "mongo/unittest/unittest.h"
@@ -86,6 +87,25 @@ protected:
         }
     }
 
+    /**
+     * Records 'numSamples' latencies of the given command against 'host', evenly spread from
+     * 1ms to 'maxLatency'.
+     */
+    void recordLatencies(const HostAndPort& host,
+                         StringData commandName,
+                         Milliseconds maxLatency,
+                         int numSamples = 100) {
+        auto stats = executor::HostLatencyStats::get(getServiceContext());
+        auto now = getServiceContext()->getFastClockSource()->now();
+        for (int i = 1; i <= numSamples; ++i) {
+            stats->record(host, commandName, maxLatency * i / numSamples, now);
+        }
+    }
+
+    ServiceContext* getServiceContext() {
+        return _serviceCtx.get();
+    }
+
     static inline const std::string kCollName = "testColl";
     static inline const StringData mapJavascript = "map!"_sd;
     static inline const StringData reduceJavascript = "reduce!"_sd;
@@ -93,10 +113,20 @@ protected:
     static inline const std::string kReadHedgingModeFieldName = "readHedgingMode";
     static inline const std::string kMaxTimeMSForHedgedReadsFieldName = "maxTimeMSForHedgedReads";
     static inline const int kMaxTimeMSForHedgedReadsDefault = 10;
+    static inline const std::string kReadHedgingLatencyAwareTargetingFieldName =
+        "readHedgingLatencyAwareTargeting";
+    static inline const std::string kReadHedgingDelayPercentileFieldName =
+        "readHedgingDelayPercentile";
 
     static inline const BSONObj kDefaultParameters =
         BSON(kReadHedgingModeFieldName << "on" << kMaxTimeMSForHedgedReadsFieldName
-                                       << kMaxTimeMSForHedgedReadsDefault);
+                                       << kMaxTimeMSForHedgedReadsDefault
+                                       << kReadHedgingLatencyAwareTargetingFieldName << false
+                                       << kReadHedgingDelayPercentileFieldName << 0);
+
+    static inline const HostAndPort kHost1{"host1", 27017};
+    static inline const HostAndPort kHost2{"host2", 27017};
+    static inline const HostAndPort kHost3{"host3", 27017};
 
 private:
     ServiceContext::UniqueServiceContext _serviceCtx = ServiceContext::make();
@@ -191,5 +221,53 @@ TEST_F(HedgeOptionsUtilTestFixture, MaxTimeMSForHedgedReads) {
     checkHedgeOptions(parameters, cmdObj, rspObj, true, 100);
 }
 
+TEST_F(HedgeOptionsUtilTestFixture, ObservedLatenciesNotAppliedByDefault) {
+    recordLatencies(kHost1, "find", Milliseconds(50));
+    recordLatencies(kHost2, "find", Milliseconds(5));
+
+    std::vector<HostAndPort> hosts{kHost1, kHost2};
+    executor::RemoteCommandRequestOnAny::HedgeOptions hedgeOptions;
+    applyObservedLatencies(getServiceContext(), BSON("find" << kCollName), &hosts, &hedgeOptions);
+
+    ASSERT(hosts == std::vector<HostAndPort>({kHost1, kHost2}));
+    ASSERT_EQ(hedgeOptions.delay, Milliseconds(0));
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, LatencyAwareTargetingOrdersHostsByObservedLatency) {
+    setParameters(BSON(kReadHedgingLatencyAwareTargetingFieldName << true));
+    recordLatencies(kHost1, "find", Milliseconds(50));
+    recordLatencies(kHost2, "find", Milliseconds(5));
+
+    // Latencies are tracked per command, so the slow count on host2 doesn't affect finds.
+    recordLatencies(kHost2, "count", Milliseconds(500));
+
+    // The host with no observed latency is targeted first, so that it gets sampled.
+    std::vector<HostAndPort> hosts{kHost1, kHost2, kHost3};
+    executor::RemoteCommandRequestOnAny::HedgeOptions hedgeOptions;
+    applyObservedLatencies(getServiceContext(), BSON("find" << kCollName), &hosts, &hedgeOptions);
+
+    ASSERT(hosts == std::vector<HostAndPort>({kHost3, kHost2, kHost1}));
+    ASSERT_EQ(hedgeOptions.delay, Milliseconds(0));
+}
+
+TEST_F(HedgeOptionsUtilTestFixture, HedgingDelayIsObservedLatencyPercentileOfFirstHost) {
+    setParameters(BSON(kReadHedgingDelayPercentileFieldName << 95));
+    recordLatencies(kHost1, "find", Milliseconds(100));
+
+    std::vector<HostAndPort> hosts{kHost1, kHost2};
+    executor::RemoteCommandRequestOnAny::HedgeOptions hedgeOptions;
+    applyObservedLatencies(getServiceContext(), BSON("find" << kCollName), &hosts, &hedgeOptions);
+
+    // The sketch estimates the 95th percentile of 1ms..100ms to within 5%.
+    ASSERT_GTE(hedgeOptions.delay, Milliseconds(90));
+    ASSERT_LTE(hedgeOptions.delay, Milliseconds(100));
+
+    // Without enough samples for the first host the hedge is sent right away.
+    hosts = {kHost2, kHost1};
+    hedgeOptions = {};
+    applyObservedLatencies(getServiceContext(), BSON("find" << kCollName), &hosts, &hedgeOptions);
+    ASSERT_EQ(hedgeOptions.delay, Milliseconds(0));
+}
+
 }  // namespace
 }  // namespace mongo
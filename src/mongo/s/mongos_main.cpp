@@ -91,6 +91,7 @@
 #include "mongo/s/mongos_topology_coordinator.h"
 #include "mongo/s/query/cluster_cursor_cleanup_job.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/routing_table_cache_file_store.h"
 #include "mongo/s/service_entry_point_mongos.h"
 #include "mongo/s/session_catalog_router.h"
 #include "mongo/s/sessions_collection_sharded.h"
@@ -418,8 +419,16 @@ Status initializeSharding(OperationContext* opCtx) {
     auto shardFactory =
         std::make_unique<ShardFactory>(std::move(buildersMap), std::move(targeterFactory));
 
-    CatalogCacheLoader::set(opCtx->getServiceContext(),
-                            std::make_unique<ConfigServerCatalogCacheLoader>());
+    std::unique_ptr<RoutingTableCacheFileStore> routingTableFileStore;
+    if (!gRoutingTableCacheDirectory.empty()) {
+        routingTableFileStore =
+            std::make_unique<RoutingTableCacheFileStore>(gRoutingTableCacheDirectory);
+        uassertStatusOK(routingTableFileStore->initialize());
+    }
+
+    CatalogCacheLoader::set(
+        opCtx->getServiceContext(),
+        std::make_unique<ConfigServerCatalogCacheLoader>(std::move(routingTableFileStore)));
 
     auto catalogCache = std::make_unique<CatalogCache>(CatalogCacheLoader::get(opCtx));
 
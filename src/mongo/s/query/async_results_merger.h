@@ -35,7 +35,9 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -67,6 +69,10 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * If 'internalQueryAsyncResultsMergerPrefetchRatio' is set, the getMore for a non-tailable remote
+ * is scheduled once its buffer drains below that fraction of its last batch, so that the next
+ * batch is usually in flight before the merge runs out of results from that remote.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -308,6 +314,15 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The sort keys of the results in 'docBuffer', in the same order, encoded as KeyStrings so
+        // that the merge compares them with memcmp. Only populated for sorted merges whose sort
+        // pattern can be expressed as an Ordering; empty otherwise.
+        std::queue<KeyString::Value> sortKeyBuffer;
+
+        // The number of results in the last batch received from this remote. Used to decide when to
+        // prefetch the next batch.
+        size_t lastBatchSize = 0;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -324,8 +339,12 @@ private:
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareKeyStrings)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareKeyStrings(compareKeyStrings) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -338,6 +357,10 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When '_compareKeyStrings' is true, the remotes are compared by the front of their
+        // 'sortKeyBuffer' rather than by the $sortKey of the front of their 'docBuffer'.
+        const bool _compareKeyStrings;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -372,6 +395,15 @@ private:
      */
     Status _askForNextBatch(WithLock, size_t remoteIndex);
 
+    /**
+     * Schedules a getMore on the given remote ahead of its buffer running empty if prefetching is
+     * enabled and the number of buffered results has dropped below the prefetch watermark. Must
+     * only be called after a result was consumed from the remote. Does nothing if there is already
+     * a request outstanding for the remote. Any error scheduling the request is stored in the
+     * remote's status.
+     */
+    void _prefetchNextBatchIfBelowWatermark(WithLock, size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -480,6 +512,11 @@ private:
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // The Ordering used to encode sort keys as KeyStrings. Is boost::none if there is no sort or if
+    // the sort pattern has too many fields to be represented as an Ordering, in which case the
+    // merge falls back to comparing the BSON sort keys.
+    const boost::optional<Ordering> _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable Mutex _mutex = MONGO_MAKE_LATCH("AsyncResultsMerger::_mutex");
 
@@ -42,9 +42,11 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/query/async_results_merger_knobs_gen.h"
 #include "mongo/s/query/results_merger_test_fixture.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -526,6 +528,162 @@ TEST_F(AsyncResultsMergerTest, HasFirstBatch) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchOnceBufferDrainsToWatermark) {
+    const double originalPrefetchRatio = internalQueryAsyncResultsMergerPrefetchRatio.load();
+    internalQueryAsyncResultsMergerPrefetchRatio.store(0.75);
+    ON_BLOCK_EXIT(
+        [&] { internalQueryAsyncResultsMergerPrefetchRatio.store(originalPrefetchRatio); });
+
+    std::vector<BSONObj> firstBatch = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // Three of the four results are still buffered, which is not below the watermark of three, so
+    // no getMore is scheduled yet.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Draining the buffer below the watermark schedules the getMore while results remain buffered.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+    ASSERT_EQ(getNthPendingRequest(0u).cmdObj["getMore"].numberLong(), 5);
+    ASSERT_TRUE(arm->ready());
+
+    scheduleNetworkResponse(CursorResponse(kTestNss, CursorId(0), {fromjson("{_id: 5}")}));
+    ASSERT_TRUE(arm->remotesExhausted());
+
+    // The prefetched batch is returned after the results that were already buffered.
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchedBatchesAreMergedInSortOrder) {
+    const double originalPrefetchRatio = internalQueryAsyncResultsMergerPrefetchRatio.load();
+    internalQueryAsyncResultsMergerPrefetchRatio.store(1.0);
+    ON_BLOCK_EXIT(
+        [&] { internalQueryAsyncResultsMergerPrefetchRatio.store(originalPrefetchRatio); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0],
+        kTestShardHosts[0],
+        CursorResponse(kTestNss, 5, {fromjson("{$sortKey: [1]}"), fromjson("{$sortKey: [4]}")})));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1],
+        kTestShardHosts[1],
+        CursorResponse(kTestNss, 6, {fromjson("{$sortKey: [2]}"), fromjson("{$sortKey: [3]}")})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    // Each remote is asked for its next batch as soon as a result is taken from its buffer.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [1]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [2]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_EQ(getNthPendingRequest(0u).cmdObj["getMore"].numberLong(), 5);
+    ASSERT_EQ(getNthPendingRequest(1u).cmdObj["getMore"].numberLong(), 6);
+
+    // Both remotes respond while they still have buffered results.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: [5]}"), fromjson("{$sortKey: [7]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch1);
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: [6]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+    ASSERT_TRUE(arm->remotesExhausted());
+
+    // The newly received results are merged behind the buffered ones in sort order.
+    for (int expected : {3, 4, 5, 6, 7}) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON_ARRAY(expected)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchingKeepsAtMostOneGetMoreOutstanding) {
+    const double originalPrefetchRatio = internalQueryAsyncResultsMergerPrefetchRatio.load();
+    internalQueryAsyncResultsMergerPrefetchRatio.store(1.0);
+    ON_BLOCK_EXIT(
+        [&] { internalQueryAsyncResultsMergerPrefetchRatio.store(originalPrefetchRatio); });
+
+    std::vector<BSONObj> firstBatch = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+
+    // The remote's cursor stays open and returns batches of one result. Receiving a batch doesn't
+    // prefetch the next one, however high the ratio.
+    scheduleNetworkResponse(CursorResponse(kTestNss, 5, {fromjson("{_id: 3}")}));
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_FALSE(arm->remotesExhausted());
+
+    // One result buffered is not below the watermark of one result
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Once the buffer is empty the getMore is scheduled as without prefetching
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_TRUE(networkHasReadyRequests());
+    scheduleNetworkResponse(CursorResponse(kTestNss, 5, {fromjson("{_id: 4}")}));
+    ASSERT_FALSE(networkHasReadyRequests());
+    executor()->waitForEvent(readyEvent);
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Kill the cursor on the remote which is still open
+    auto killEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killEvent);
+}
+
+TEST_F(AsyncResultsMergerTest, NoPrefetchWhileMaxBufferedResultsAreBuffered) {
+    const double originalPrefetchRatio = internalQueryAsyncResultsMergerPrefetchRatio.load();
+    internalQueryAsyncResultsMergerPrefetchRatio.store(1.0);
+    const int originalMaxBuffered =
+        internalQueryAsyncResultsMergerPrefetchMaxBufferedResults.load();
+    internalQueryAsyncResultsMergerPrefetchMaxBufferedResults.store(2);
+    ON_BLOCK_EXIT([&] {
+        internalQueryAsyncResultsMergerPrefetchRatio.store(originalPrefetchRatio);
+        internalQueryAsyncResultsMergerPrefetchMaxBufferedResults.store(originalMaxBuffered);
+    });
+
+    std::vector<BSONObj> firstBatch = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // The ratio alone would prefetch as soon as a result is taken
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+
+    scheduleNetworkResponse(CursorResponse(kTestNss, CursorId(0), {fromjson("{_id: 5}")}));
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 4}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 5}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, OneShardHasInitialBatchOtherShardExhausted) {
     std::vector<BSONObj> firstBatch = {
         fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
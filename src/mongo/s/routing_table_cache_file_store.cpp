@@ -0,0 +1,319 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kShardingCatalogRefresh
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/routing_table_cache_file_store.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_validated.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/object_check.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/md5.hpp"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+using PersistedRoutingTable = RoutingTableCacheFileStore::PersistedRoutingTable;
+
+// Bumped whenever the layout of the persisted files changes, so that files written by a different
+// version are ignored rather than misinterpreted.
+const int kFormatVersion = 1;
+
+const char kFormatVersionField[] = "formatVersion";
+const char kNsField[] = "ns";
+const char kUuidField[] = "uuid";
+const char kEpochField[] = "epoch";
+const char kKeyPatternField[] = "key";
+const char kDefaultCollationField[] = "defaultCollation";
+const char kUniqueField[] = "unique";
+const char kCollectionVersionField[] = "collectionVersion";
+const char kNumChunksField[] = "numChunks";
+
+StatusWith<PersistedRoutingTable> parseRoutingTable(const NamespaceString& nss,
+                                                    const std::vector<char>& buffer) {
+    ConstDataRangeCursor cursor(buffer.data(), buffer.size());
+
+    auto swHeader = cursor.readAndAdvanceNoThrow<Validated<BSONObj>>();
+    if (!swHeader.isOK()) {
+        return swHeader.getStatus();
+    }
+    const BSONObj header = swHeader.getValue();
+
+    long long formatVersion;
+    Status status = bsonExtractIntegerField(header, kFormatVersionField, &formatVersion);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (formatVersion != kFormatVersion) {
+        return {ErrorCodes::UnsupportedFormat,
+                str::stream() << "Unsupported routing table file format version " << formatVersion};
+    }
+
+    std::string ns;
+    status = bsonExtractStringField(header, kNsField, &ns);
+    if (!status.isOK()) {
+        return status;
+    }
+    if (ns != nss.ns()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Routing table file is for namespace " << ns};
+    }
+
+    PersistedRoutingTable persisted;
+    auto& collAndChunks = persisted.collectionAndChunks;
+
+    if (auto uuidElem = header[kUuidField]) {
+        auto swUuid = UUID::parse(uuidElem);
+        if (!swUuid.isOK()) {
+            return swUuid.getStatus();
+        }
+        collAndChunks.uuid = swUuid.getValue();
+    }
+
+    status = bsonExtractOIDField(header, kEpochField, &collAndChunks.epoch);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    BSONElement elem;
+    status = bsonExtractTypedField(header, kKeyPatternField, Object, &elem);
+    if (!status.isOK()) {
+        return status;
+    }
+    collAndChunks.shardKeyPattern = elem.Obj().getOwned();
+
+    status = bsonExtractTypedField(header, kDefaultCollationField, Object, &elem);
+    if (!status.isOK()) {
+        return status;
+    }
+    collAndChunks.defaultCollation = elem.Obj().getOwned();
+
+    status = bsonExtractBooleanField(header, kUniqueField, &collAndChunks.shardKeyIsUnique);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    auto swVersion = ChunkVersion::parseWithField(header, kCollectionVersionField);
+    if (!swVersion.isOK()) {
+        return swVersion.getStatus();
+    }
+    persisted.collectionVersion = swVersion.getValue();
+    if (persisted.collectionVersion.epoch() != collAndChunks.epoch) {
+        return {ErrorCodes::BadValue, "Routing table file has an inconsistent collection version"};
+    }
+
+    long long numChunks;
+    status = bsonExtractIntegerField(header, kNumChunksField, &numChunks);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // Each chunk takes up at least an empty document, which bounds how many the rest of the file
+    // can hold and so how much memory a corrupt header can make us reserve.
+    const auto maxChunks = static_cast<long long>(cursor.length() / BSONObj::kMinBSONLength);
+    if (numChunks <= 0 || numChunks > maxChunks) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Routing table file has an invalid chunk count " << numChunks};
+    }
+
+    collAndChunks.changedChunks.reserve(numChunks);
+    while (!cursor.empty()) {
+        auto swChunkObj = cursor.readAndAdvanceNoThrow<Validated<BSONObj>>();
+        if (!swChunkObj.isOK()) {
+            return swChunkObj.getStatus();
+        }
+
+        auto swChunk = ChunkType::fromShardBSON(swChunkObj.getValue(), collAndChunks.epoch);
+        if (!swChunk.isOK()) {
+            return swChunk.getStatus();
+        }
+        swChunk.getValue().setNS(nss);
+        collAndChunks.changedChunks.push_back(std::move(swChunk.getValue()));
+    }
+
+    if (collAndChunks.changedChunks.size() != static_cast<size_t>(numChunks)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Routing table file is truncated, expected " << numChunks
+                              << " chunks but found " << collAndChunks.changedChunks.size()};
+    }
+
+    return persisted;
+}
+
+}  // namespace
+
+RoutingTableCacheFileStore::RoutingTableCacheFileStore(boost::filesystem::path directory)
+    : _directory(std::move(directory)) {}
+
+Status RoutingTableCacheFileStore::initialize() const {
+    try {
+        boost::filesystem::create_directories(_directory);
+    } catch (const boost::filesystem::filesystem_error& ex) {
+        return {ErrorCodes::FileNotOpen,
+                str::stream() << "Unable to create routing table cache directory "
+                              << _directory.string() << ": " << ex.what()};
+    }
+    return Status::OK();
+}
+
+boost::optional<PersistedRoutingTable> RoutingTableCacheFileStore::load(
+    const NamespaceString& nss) const {
+    const auto path = _pathFor(nss);
+
+    std::vector<char> buffer;
+    try {
+        if (!boost::filesystem::exists(path)) {
+            return boost::none;
+        }
+
+        buffer.resize(boost::filesystem::file_size(path));
+
+        std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+        ifs.read(buffer.data(), buffer.size());
+        if (!ifs) {
+            LOGV2_WARNING(4859010,
+                          "Unable to read persisted routing table",
+                          "namespace"_attr = nss,
+                          "path"_attr = path.string());
+            return boost::none;
+        }
+    } catch (const std::exception& ex) {
+        LOGV2_WARNING(4859011,
+                      "Unable to read persisted routing table",
+                      "namespace"_attr = nss,
+                      "path"_attr = path.string(),
+                      "error"_attr = ex.what());
+        return boost::none;
+    }
+
+    auto swPersisted = parseRoutingTable(nss, buffer);
+    if (!swPersisted.isOK()) {
+        LOGV2_WARNING(4859012,
+                      "Ignoring invalid persisted routing table",
+                      "namespace"_attr = nss,
+                      "path"_attr = path.string(),
+                      "error"_attr = redact(swPersisted.getStatus()));
+
+        // Otherwise every refresh of the namespace would read and reject the same file again
+        remove(nss);
+        return boost::none;
+    }
+
+    return std::move(swPersisted.getValue());
+}
+
+Status RoutingTableCacheFileStore::save(const RoutingTableHistory& routingTable) const {
+    const auto& nss = routingTable.getns();
+    const auto path = _pathFor(nss);
+    const auto tempPath = boost::filesystem::path(path.string() + ".tmp");
+
+    BSONObjBuilder headerBuilder;
+    headerBuilder.append(kFormatVersionField, kFormatVersion);
+    headerBuilder.append(kNsField, nss.ns());
+    if (auto uuid = routingTable.getUUID()) {
+        uuid->appendToBuilder(&headerBuilder, kUuidField);
+    }
+    headerBuilder.append(kEpochField, routingTable.getVersion().epoch());
+    headerBuilder.append(kKeyPatternField, routingTable.getShardKeyPattern().toBSON());
+    headerBuilder.append(kDefaultCollationField,
+                         routingTable.getDefaultCollator()
+                             ? routingTable.getDefaultCollator()->getSpec().toBSON()
+                             : BSONObj());
+    headerBuilder.append(kUniqueField, routingTable.isUnique());
+    routingTable.getVersion().appendWithField(&headerBuilder, kCollectionVersionField);
+    headerBuilder.append(kNumChunksField, static_cast<long long>(routingTable.numChunks()));
+    const BSONObj header = headerBuilder.obj();
+
+    {
+        std::ofstream ofs(tempPath.c_str(),
+                          std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        if (!ofs) {
+            return {ErrorCodes::FileNotOpen,
+                    str::stream() << "Failed to open " << tempPath.string() << ": "
+                                  << errnoWithDescription()};
+        }
+
+        ofs.write(header.objdata(), header.objsize());
+        routingTable.forEachChunk([&](const std::shared_ptr<ChunkInfo>& chunk) {
+            ChunkType chunkType(
+                nss, chunk->getRange(), chunk->getLastmod(), chunk->getShardIdAt(boost::none));
+            chunkType.setHistory(chunk->getHistory());
+
+            const BSONObj chunkObj = chunkType.toShardBSON();
+            ofs.write(chunkObj.objdata(), chunkObj.objsize());
+            return bool(ofs);
+        });
+
+        ofs.flush();
+        if (!ofs) {
+            return {ErrorCodes::FileStreamFailed,
+                    str::stream() << "Failed to write routing table to " << tempPath.string()
+                                  << ": " << errnoWithDescription()};
+        }
+    }
+
+    // The file is not fsync'ed before the rename: a file torn by a crash fails validation on load
+    // and is simply treated as absent.
+    try {
+        boost::filesystem::rename(tempPath, path);
+    } catch (const boost::filesystem::filesystem_error& ex) {
+        return {ErrorCodes::FileRenameFailed,
+                str::stream() << "Failed to rename " << tempPath.string() << " to "
+                              << path.string() << ": " << ex.what()};
+    }
+
+    return Status::OK();
+}
+
+void RoutingTableCacheFileStore::remove(const NamespaceString& nss) const {
+    boost::system::error_code ec;
+    boost::filesystem::remove(_pathFor(nss), ec);
+}
+
+boost::filesystem::path RoutingTableCacheFileStore::_pathFor(const NamespaceString& nss) const {
+    // Namespaces may contain characters which aren't valid in file names and can be longer than
+    // the file name limit, so name the files after a digest of the namespace instead. The header
+    // records the full namespace and is checked on load.
+    return _directory / (md5simpledigest(nss.ns()) + ".bson");
+}
+
+}  // namespace mongo
@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+
+#include "mongo/s/catalog_cache_loader.h"
+
+namespace mongo {
+
+class NamespaceString;
+class RoutingTableHistory;
+
+/**
+ * Persists routing tables to local files, one per sharded collection, so that a restarted router
+ * only needs to fetch from the config servers the chunks which changed since its routing tables
+ * were last written, rather than the full chunk metadata of every collection it routes to.
+ *
+ * Each file is a sequence of BSON documents: a header describing the collection and the routing
+ * table version, followed by one document per chunk in the format used by the shards'
+ * config.cache.chunks.<ns> collections. Files are replaced by writing a temporary file and renaming
+ * it over the previous one. Since the contents are only a cache, any file which cannot be read or
+ * fails validation is ignored and the routing table is fetched in full instead.
+ */
+class RoutingTableCacheFileStore {
+public:
+    struct PersistedRoutingTable {
+        CatalogCacheLoader::CollectionAndChangedChunks collectionAndChunks;
+
+        // The collection version of the routing table at the time it was written.
+        ChunkVersion collectionVersion;
+    };
+
+    explicit RoutingTableCacheFileStore(boost::filesystem::path directory);
+
+    /**
+     * Creates the store directory if it doesn't already exist.
+     */
+    Status initialize() const;
+
+    /**
+     * Returns the routing table last persisted for 'nss', or boost::none if there isn't one or it
+     * could not be read back.
+     */
+    boost::optional<PersistedRoutingTable> load(const NamespaceString& nss) const;
+
+    /**
+     * Persists 'routingTable', replacing any routing table previously persisted for its namespace.
+     */
+    Status save(const RoutingTableHistory& routingTable) const;
+
+    /**
+     * Removes the routing table persisted for 'nss', if any.
+     */
+    void remove(const NamespaceString& nss) const;
+
+private:
+    boost::filesystem::path _pathFor(const NamespaceString& nss) const;
+
+    const boost::filesystem::path _directory;
+};
+
+}  // namespace mongo
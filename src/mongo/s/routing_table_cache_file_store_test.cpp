@@ -0,0 +1,265 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <limits>
+
+#include "mongo/base/data_view.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/s/routing_table_cache_file_store.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const ShardId kShard0("shard0");
+const ShardId kShard1("shard1");
+
+class RoutingTableCacheFileStoreTest : public unittest::Test {
+protected:
+    // Returns a routing table of 'numChunks' chunks alternating between two shards, the i-th of
+    // which (except the first and last) covers [a: (i - 1) * 10, a: i * 10).
+    std::shared_ptr<RoutingTableHistory> makeRoutingTable(const NamespaceString& nss,
+                                                          int numChunks) const {
+        const KeyPattern shardKeyPattern(BSON("a" << 1));
+
+        std::vector<ChunkType> chunks;
+        for (int i = 0; i < numChunks; ++i) {
+            auto min = i == 0 ? shardKeyPattern.globalMin() : BSON("a" << (i - 1) * 10);
+            auto max = i == numChunks - 1 ? shardKeyPattern.globalMax() : BSON("a" << i * 10);
+            const auto& shard = i % 2 ? kShard1 : kShard0;
+
+            ChunkType chunk(nss, ChunkRange{min, max}, ChunkVersion{1, uint32_t(i), _epoch}, shard);
+            chunk.setHistory({ChunkHistory(Timestamp(100, i), shard)});
+            chunks.push_back(std::move(chunk));
+        }
+
+        return RoutingTableHistory::makeNew(
+            nss, _uuid, shardKeyPattern, nullptr, false, _epoch, chunks);
+    }
+
+    // Returns the only file in the store directory.
+    boost::filesystem::path getPersistedFile() {
+        std::vector<boost::filesystem::path> files;
+        for (const auto& entry : boost::filesystem::directory_iterator(_tempDir.path())) {
+            files.push_back(entry.path());
+        }
+        ASSERT_EQ(1U, files.size());
+        return files.front();
+    }
+
+    // Returns the offsets of the BSON documents in the file at 'path'.
+    static std::vector<size_t> getDocumentOffsets(const boost::filesystem::path& path) {
+        std::vector<char> buffer(boost::filesystem::file_size(path));
+        std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+        ifs.read(buffer.data(), buffer.size());
+        ASSERT(ifs);
+
+        std::vector<size_t> offsets;
+        for (size_t offset = 0; offset < buffer.size();
+             offset += ConstDataView(buffer.data() + offset).read<LittleEndian<int32_t>>()) {
+            offsets.push_back(offset);
+        }
+        return offsets;
+    }
+
+    const OID _epoch = OID::gen();
+    const UUID _uuid = UUID::gen();
+    unittest::TempDir _tempDir{"routing_table_cache_file_store_test"};
+    RoutingTableCacheFileStore _store{_tempDir.path()};
+};
+
+TEST_F(RoutingTableCacheFileStoreTest, LoadWithoutSave) {
+    ASSERT_OK(_store.initialize());
+    ASSERT(!_store.load(kNss));
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, SaveAndLoad) {
+    const auto routingTable = makeRoutingTable(kNss, 1000);
+    ASSERT_OK(_store.save(*routingTable));
+
+    const auto persisted = _store.load(kNss);
+    ASSERT(persisted);
+    ASSERT_EQ(routingTable->getVersion(), persisted->collectionVersion);
+
+    const auto& collAndChunks = persisted->collectionAndChunks;
+    ASSERT(collAndChunks.uuid);
+    ASSERT_EQ(_uuid, *collAndChunks.uuid);
+    ASSERT_EQ(_epoch, collAndChunks.epoch);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), collAndChunks.shardKeyPattern);
+    ASSERT_BSONOBJ_EQ(BSONObj(), collAndChunks.defaultCollation);
+    ASSERT(!collAndChunks.shardKeyIsUnique);
+    ASSERT_EQ(routingTable->numChunks(), collAndChunks.changedChunks.size());
+
+    size_t i = 0;
+    routingTable->forEachChunk([&](const std::shared_ptr<ChunkInfo>& chunk) {
+        const auto& loaded = collAndChunks.changedChunks[i++];
+        ASSERT_EQ(kNss, loaded.getNS());
+        ASSERT_BSONOBJ_EQ(chunk->getMin(), loaded.getMin());
+        ASSERT_BSONOBJ_EQ(chunk->getMax(), loaded.getMax());
+        ASSERT_EQ(chunk->getLastmod(), loaded.getVersion());
+        ASSERT_EQ(chunk->getShardIdAt(boost::none), loaded.getShard());
+        ASSERT(chunk->getHistory() == loaded.getHistory());
+        return true;
+    });
+
+    // The loaded chunks must be usable to rebuild the same routing table.
+    const auto reloaded = RoutingTableHistory::makeNew(kNss,
+                                                       collAndChunks.uuid,
+                                                       KeyPattern(collAndChunks.shardKeyPattern),
+                                                       nullptr,
+                                                       collAndChunks.shardKeyIsUnique,
+                                                       collAndChunks.epoch,
+                                                       collAndChunks.changedChunks);
+    ASSERT_EQ(routingTable->getVersion(), reloaded->getVersion());
+    ASSERT_EQ(routingTable->getVersion(kShard0), reloaded->getVersion(kShard0));
+    ASSERT_EQ(routingTable->getVersion(kShard1), reloaded->getVersion(kShard1));
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, SaveReplacesPreviousRoutingTable) {
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 10)));
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 20)));
+
+    const auto persisted = _store.load(kNss);
+    ASSERT(persisted);
+    ASSERT_EQ(20U, persisted->collectionAndChunks.changedChunks.size());
+    getPersistedFile();
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, NamespacesAreStoredSeparately) {
+    const NamespaceString otherNss("TestDB", "Other/Coll");
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 10)));
+    ASSERT_OK(_store.save(*makeRoutingTable(otherNss, 20)));
+
+    ASSERT_EQ(10U, _store.load(kNss)->collectionAndChunks.changedChunks.size());
+    ASSERT_EQ(20U, _store.load(otherNss)->collectionAndChunks.changedChunks.size());
+
+    _store.remove(otherNss);
+    ASSERT(_store.load(kNss));
+    ASSERT(!_store.load(otherNss));
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, TruncatedFileIsIgnored) {
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 100)));
+    const auto path = getPersistedFile();
+    const auto fileSize = boost::filesystem::file_size(path);
+
+    // Truncated in the middle of a document
+    boost::filesystem::resize_file(path, fileSize - 1);
+    ASSERT(!_store.load(kNss));
+
+    // Truncated at a document boundary, which only the chunk count in the header can detect
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 100)));
+    const auto offsets = getDocumentOffsets(path);
+    ASSERT_EQ(101U, offsets.size());
+    boost::filesystem::resize_file(path, offsets.back());
+    ASSERT(!_store.load(kNss));
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, CorruptFileIsIgnored) {
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 100)));
+    const auto path = getPersistedFile();
+
+    // Corrupt the size of a chunk document in the middle of the file
+    {
+        std::fstream fs(path.c_str(),
+                        std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        fs.seekp(getDocumentOffsets(path)[50]);
+        fs.write("\xff\xff\xff\x7f", 4);
+        ASSERT(fs);
+    }
+    ASSERT(!_store.load(kNss));
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, InvalidChunkCountInHeaderIsIgnored) {
+    for (long long numChunks : {0LL, -1LL, 1LL << 40, std::numeric_limits<long long>::max()}) {
+        ASSERT_OK(_store.save(*makeRoutingTable(kNss, 10)));
+        const auto path = getPersistedFile();
+
+        // Replace the header with one which claims 'numChunks' chunks, keeping the chunks
+        std::vector<char> buffer(boost::filesystem::file_size(path));
+        {
+            std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+            ifs.read(buffer.data(), buffer.size());
+            ASSERT(ifs);
+        }
+        const BSONObj header(buffer.data());
+        BSONObjBuilder headerBuilder;
+        for (const auto& elem : header) {
+            if (elem.fieldNameStringData() == "numChunks"_sd) {
+                headerBuilder.append("numChunks", numChunks);
+            } else {
+                headerBuilder.append(elem);
+            }
+        }
+        const BSONObj corruptHeader = headerBuilder.obj();
+        {
+            std::ofstream ofs(path.c_str(),
+                              std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            ofs.write(corruptHeader.objdata(), corruptHeader.objsize());
+            ofs.write(buffer.data() + header.objsize(), buffer.size() - header.objsize());
+            ASSERT(ofs);
+        }
+
+        ASSERT(!_store.load(kNss));
+
+        // The invalid file is removed rather than read again by every later load
+        ASSERT(!boost::filesystem::exists(path));
+    }
+}
+
+TEST_F(RoutingTableCacheFileStoreTest, FileOfOtherNamespaceIsIgnored) {
+    const NamespaceString otherNss("TestDB", "OtherColl");
+    ASSERT_OK(_store.save(*makeRoutingTable(otherNss, 10)));
+    const auto path = getPersistedFile();
+
+    // Make the file look like it belongs to 'kNss'
+    ASSERT_OK(_store.save(*makeRoutingTable(kNss, 10)));
+    const auto nssPath = [&] {
+        for (const auto& entry : boost::filesystem::directory_iterator(_tempDir.path())) {
+            if (entry.path() != path) {
+                return entry.path();
+            }
+        }
+        MONGO_UNREACHABLE;
+    }();
+    boost::filesystem::remove(nssPath);
+    boost::filesystem::copy_file(path, nssPath);
+
+    ASSERT(!_store.load(kNss));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -195,6 +195,7 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.controllerFactory = []() noexcept {
         return std::make_shared<ShardingTaskExecutorPoolController>();
     };
+    connPoolOptions.shardCount = ShardingTaskExecutorPoolController::gParameters.poolShardCount;
 
     auto network = executor::makeNetworkInterface(
         "ShardRegistry", std::make_unique<ShardingNetworkConnectionHook>(), hookBuilder());
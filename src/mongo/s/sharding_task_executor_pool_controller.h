@@ -89,6 +89,8 @@ public:
 
         synchronized_value<std::string> matchingStrategyString;
         AtomicWord<MatchingStrategy> matchingStrategy;
+
+        int poolShardCount;
     };
 
     static inline Parameters gParameters;
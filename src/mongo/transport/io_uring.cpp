@@ -0,0 +1,255 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/io_uring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// The io_uring system call numbers are shared by every architecture that uses the generic syscall
+// table, as well as by x86_64.
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+int sysSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sysEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(
+        ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int sysRegister(int fd, unsigned opcode, const void* arg, unsigned nrArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+}
+
+template <typename T>
+T* ringPtr(void* ring, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+}  // namespace
+
+IoUring::~IoUring() {
+    _unmap();
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+bool IoUring::isSupported() {
+    IoUring ring;
+    if (ring.init(4) != 0) {
+        return false;
+    }
+
+    // The transport layer needs socket-level opcodes which first appeared alongside the
+    // IORING_REGISTER_PROBE interface.
+    return ring.isOpCodeSupported(IORING_OP_ACCEPT) && ring.isOpCodeSupported(IORING_OP_RECV) &&
+        ring.isOpCodeSupported(IORING_OP_SEND) && ring.isOpCodeSupported(IORING_OP_LINK_TIMEOUT) &&
+        ring.isOpCodeSupported(IORING_OP_ASYNC_CANCEL) &&
+        ring.isOpCodeSupported(IORING_OP_READ_FIXED) && ring.isOpCodeSupported(IORING_OP_READ);
+}
+
+int IoUring::init(unsigned entries) {
+    if (_fd >= 0) {
+        return -EBUSY;
+    }
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = sysSetup(entries, &params);
+    if (fd < 0) {
+        return -errno;
+    }
+    _fd = fd;
+    _features = params.features;
+
+    _sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (_features & IORING_FEAT_SINGLE_MMAP) {
+        _sqRingSize = _cqRingSize = std::max(_sqRingSize, _cqRingSize);
+    }
+
+    _sqRing = ::mmap(nullptr,
+                     _sqRingSize,
+                     PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE,
+                     _fd,
+                     IORING_OFF_SQ_RING);
+    if (_sqRing == MAP_FAILED) {
+        _sqRing = nullptr;
+        int err = errno;
+        _unmap();
+        return -err;
+    }
+
+    if (_features & IORING_FEAT_SINGLE_MMAP) {
+        _cqRing = _sqRing;
+    } else {
+        _cqRing = ::mmap(nullptr,
+                         _cqRingSize,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         _fd,
+                         IORING_OFF_CQ_RING);
+        if (_cqRing == MAP_FAILED) {
+            _cqRing = nullptr;
+            int err = errno;
+            _unmap();
+            return -err;
+        }
+    }
+
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr,
+                        _sqesSize,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE,
+                        _fd,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        _unmap();
+        return -err;
+    }
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    _sqHead = ringPtr<unsigned>(_sqRing, params.sq_off.head);
+    _sqTail = ringPtr<unsigned>(_sqRing, params.sq_off.tail);
+    _sqMask = ringPtr<unsigned>(_sqRing, params.sq_off.ring_mask);
+    _sqArray = ringPtr<unsigned>(_sqRing, params.sq_off.array);
+    _sqEntries = params.sq_entries;
+
+    _cqHead = ringPtr<unsigned>(_cqRing, params.cq_off.head);
+    _cqTail = ringPtr<unsigned>(_cqRing, params.cq_off.tail);
+    _cqMask = ringPtr<unsigned>(_cqRing, params.cq_off.ring_mask);
+    _cqes = ringPtr<io_uring_cqe>(_cqRing, params.cq_off.cqes);
+
+    // Probe for opcode support. Kernels without IORING_REGISTER_PROBE are treated as supporting
+    // nothing, which makes isSupported() reject them.
+    const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<char> probeBuf(probeSize, 0);
+    auto probe = reinterpret_cast<io_uring_probe*>(probeBuf.data());
+    _supportedOps.assign(256, false);
+    if (sysRegister(_fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+        for (unsigned i = 0; i < probe->ops_len && i < 256; ++i) {
+            if (probe->ops[i].flags & IO_URING_OP_SUPPORTED) {
+                _supportedOps[probe->ops[i].op] = true;
+            }
+        }
+    }
+
+    return 0;
+}
+
+bool IoUring::isOpCodeSupported(uint8_t opcode) const {
+    return opcode < _supportedOps.size() && _supportedOps[opcode];
+}
+
+io_uring_sqe* IoUring::getSqe() {
+    const unsigned head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+    if (_sqeTail - head >= _sqEntries) {
+        return nullptr;
+    }
+
+    auto sqe = &_sqes[_sqeTail & *_sqMask];
+    ++_sqeTail;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IoUring::submitAndWait(unsigned minComplete) {
+    // Publish the entries handed out since the last submission. Since entries are always handed
+    // out in ring order, the index array is the identity mapping.
+    unsigned tail = *_sqTail;
+    for (; _sqeHead != _sqeTail; ++_sqeHead, ++tail) {
+        _sqArray[tail & *_sqMask] = _sqeHead & *_sqMask;
+    }
+    __atomic_store_n(_sqTail, tail, __ATOMIC_RELEASE);
+
+    // Anything the kernel has not consumed yet, including entries left over from a previous
+    // partial submission, is submitted now.
+    const unsigned toSubmit = tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+
+    if (toSubmit == 0 && minComplete == 0) {
+        return 0;
+    }
+
+    const unsigned flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+    int ret = sysEnter(_fd, toSubmit, minComplete, flags);
+    if (ret < 0) {
+        return -errno;
+    }
+    return ret;
+}
+
+int IoUring::registerBuffers(const iovec* iovecs, unsigned count) {
+    if (sysRegister(_fd, IORING_REGISTER_BUFFERS, iovecs, count) < 0) {
+        return -errno;
+    }
+    return 0;
+}
+
+void IoUring::_unmap() {
+    if (_sqes) {
+        ::munmap(_sqes, _sqesSize);
+        _sqes = nullptr;
+    }
+    if (_cqRing && _cqRing != _sqRing) {
+        ::munmap(_cqRing, _cqRingSize);
+    }
+    _cqRing = nullptr;
+    if (_sqRing) {
+        ::munmap(_sqRing, _sqRingSize);
+        _sqRing = nullptr;
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
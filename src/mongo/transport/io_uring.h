@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <vector>
+
+// Older kernel headers predate some of the flags used by the io_uring transport layer. The values
+// are part of the kernel ABI, so it is safe to define them here; kernels that do not understand
+// them reject the request with -EINVAL, which callers handle.
+#ifndef IORING_ACCEPT_MULTISHOT
+#define IORING_ACCEPT_MULTISHOT (1U << 0)
+#endif
+#ifndef IORING_CQE_F_MORE
+#define IORING_CQE_F_MORE (1U << 1)
+#endif
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A minimal wrapper around a single io_uring submission/completion queue pair.
+ *
+ * This talks to the kernel through the raw io_uring_setup(2), io_uring_enter(2) and
+ * io_uring_register(2) system calls so that no additional third-party library is required. All
+ * functions that can fail return a negated errno value, mirroring the kernel interface.
+ *
+ * An IoUring is not thread safe; it is meant to be owned and driven by a single thread.
+ */
+class IoUring {
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    /**
+     * Returns true if the running kernel supports io_uring with the features this wrapper relies
+     * on.
+     */
+    static bool isSupported();
+
+    /**
+     * Creates the ring with room for at least 'entries' submissions. Returns 0 on success or a
+     * negated errno value.
+     */
+    int init(unsigned entries);
+
+    bool isInitialized() const {
+        return _fd >= 0;
+    }
+
+    /**
+     * Returns true if the kernel reported support for the given IORING_OP_* opcode.
+     */
+    bool isOpCodeSupported(uint8_t opcode) const;
+
+    /**
+     * Returns a zeroed submission queue entry to fill in, or nullptr if the submission queue is
+     * full. Entries are handed to the kernel by the next call to submitAndWait().
+     */
+    io_uring_sqe* getSqe();
+
+    /**
+     * Returns the number of entries getSqe() can hand out before the next submission.
+     */
+    unsigned sqSpaceLeft() const {
+        return _sqEntries - (_sqeTail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE));
+    }
+
+    /**
+     * Submits all queued entries with a single io_uring_enter(2) call and, if 'minComplete' is
+     * non-zero, blocks until at least that many completions are available. Returns the number of
+     * entries submitted or a negated errno value.
+     */
+    int submitAndWait(unsigned minComplete);
+
+    /**
+     * Registers 'count' fixed buffers for use with IORING_OP_READ_FIXED/IORING_OP_WRITE_FIXED.
+     * Returns 0 on success or a negated errno value.
+     */
+    int registerBuffers(const iovec* iovecs, unsigned count);
+
+    /**
+     * Invokes 'fn' with each available completion queue entry, then releases the entries back to
+     * the kernel. 'fn' may queue new submissions. Returns the number of completions consumed.
+     */
+    template <typename Callable>
+    unsigned forEachCompletion(Callable&& fn) {
+        unsigned head = *_cqHead;
+        const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+        unsigned consumed = 0;
+        for (; head != tail; ++head, ++consumed) {
+            // Copy the entry out so that the slot may be reused as soon as the head advances.
+            const io_uring_cqe cqe = _cqes[head & *_cqMask];
+            __atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
+            fn(cqe);
+        }
+        return consumed;
+    }
+
+private:
+    void _unmap();
+
+    int _fd = -1;
+    unsigned _features = 0;
+
+    void* _sqRing = nullptr;
+    size_t _sqRingSize = 0;
+    void* _cqRing = nullptr;
+    size_t _cqRingSize = 0;
+    io_uring_sqe* _sqes = nullptr;
+    size_t _sqesSize = 0;
+
+    unsigned* _sqHead = nullptr;
+    unsigned* _sqTail = nullptr;
+    unsigned* _sqMask = nullptr;
+    unsigned* _sqArray = nullptr;
+    unsigned _sqEntries = 0;
+
+    // Entries handed out by getSqe() but not yet published to the kernel.
+    unsigned _sqeHead = 0;
+    unsigned _sqeTail = 0;
+
+    unsigned* _cqHead = nullptr;
+    unsigned* _cqTail = nullptr;
+    unsigned* _cqMask = nullptr;
+    io_uring_cqe* _cqes = nullptr;
+
+    std::vector<bool> _supportedOps;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/platform/atomic_word.h"
 
+#include <memory>
 #include <type_traits>
 
 namespace mongo {
@@ -42,6 +43,7 @@ enum class MessageCompressor : uint8_t {
     kSnappy = 1,
     kZlib = 2,
     kZstd = 3,
+    kZstdStream = 4,
     kExtended = 255,
 };
 
@@ -89,6 +91,41 @@ public:
      */
     virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
 
+    /*
+     * State that a compressor keeps for a single session (connection), such as codec contexts
+     * that are reused between messages or a compression window that spans messages.
+     */
+    class SessionContext {
+    public:
+        virtual ~SessionContext() = default;
+    };
+
+    /*
+     * Returns a new context for a session, or nullptr if this compressor keeps no per-session
+     * state. The MessageCompressorManager of a session creates it the first time the compressor
+     * is used, and passes it to every subsequent compressSessionData/decompressSessionData call.
+     */
+    virtual std::unique_ptr<SessionContext> makeSessionContext() {
+        return nullptr;
+    }
+
+    /*
+     * Like compressData and decompressData, but using the given session context. Messages must be
+     * decompressed in the same order in which the peer compressed them. The default implementations
+     * ignore the context.
+     */
+    virtual StatusWith<std::size_t> compressSessionData(SessionContext* context,
+                                                        ConstDataRange input,
+                                                        DataRange output) {
+        return compressData(input, output);
+    }
+
+    virtual StatusWith<std::size_t> decompressSessionData(SessionContext* context,
+                                                          ConstDataRange input,
+                                                          DataRange output) {
+        return decompressData(input, output);
+    }
+
     /*
      * This returns the number of bytes passed in the input for compressData
      */
@@ -131,7 +131,7 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto sws = compressor->compressSessionData(_getSessionContext(compressor), input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -189,7 +189,7 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
 
     DataRangeCursor output(outMessage.data(), outMessage.data() + outMessage.dataLen());
 
-    auto sws = compressor->decompressData(input, output);
+    auto sws = compressor->decompressSessionData(_getSessionContext(compressor), input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -324,6 +324,20 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
     }
 }
 
+MessageCompressorBase::SessionContext* MessageCompressorManager::_getSessionContext(
+    MessageCompressorBase* compressor) {
+    for (auto& [id, context] : _sessionContexts) {
+        if (id == compressor->getId()) {
+            return context.get();
+        }
+    }
+
+    auto context = compressor->makeSessionContext();
+    auto contextPtr = context.get();
+    _sessionContexts.emplace_back(compressor->getId(), std::move(context));
+    return contextPtr;
+}
+
 MessageCompressorManager& MessageCompressorManager::forSession(
     const transport::SessionHandle& session) {
     return getForSession(session.get());
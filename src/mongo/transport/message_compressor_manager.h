@@ -33,6 +33,8 @@
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace mongo {
@@ -127,8 +129,20 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    /*
+     * Returns this session's context for 'compressor', creating it on first use. Returns nullptr
+     * for compressors which keep no per-session state.
+     */
+    MessageCompressorBase::SessionContext* _getSessionContext(MessageCompressorBase* compressor);
+
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
+
+    // Per-session compressor state, keyed by compressor id. A session only ever uses a handful of
+    // compressors, so a flat list is enough.
+    std::vector<std::pair<MessageCompressorId,
+                          std::unique_ptr<MessageCompressorBase::SessionContext>>>
+        _sessionContexts;
 };
 
 }  // namespace mongo
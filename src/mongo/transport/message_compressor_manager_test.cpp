@@ -240,6 +240,11 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdStreamMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, std::make_unique<ZstdStreamMessageCompressor>());
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<SnappyMessageCompressor>());
 }
@@ -252,6 +257,60 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(std::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdStreamMessageCompressor, Overflow) {
+    checkOverflow(std::make_unique<ZstdStreamMessageCompressor>());
+}
+
+TEST(ZstdStreamMessageCompressor, StreamSpansMessages) {
+    MessageCompressorRegistry registry;
+    auto compressor = std::make_unique<ZstdStreamMessageCompressor>();
+    const auto compressorName = compressor->getName();
+    registry.setSupportedCompressors({compressorName});
+    registry.registerImplementation(std::move(compressor));
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager clientManager(&registry);
+    MessageCompressorManager serverManager(&registry);
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientOutput.done(), &serverOutput);
+    clientManager.clientFinish(serverOutput.done());
+
+    const auto body = BSON("find"
+                           << "coll"
+                           << "filter" << BSON("x" << std::string(512, 'a')) << "$db"
+                           << "test");
+    const auto bufferSize = MsgData::MsgDataHeaderSize + body.objsize();
+    auto buf = SharedBuffer::allocate(bufferSize);
+    MsgData::View view(buf.get());
+    view.setId(123456);
+    view.setResponseToMsgId(0);
+    view.setOperation(dbMsg);
+    view.setLen(bufferSize);
+    memcpy(view.data(), body.objdata(), body.objsize());
+    const Message original{buf};
+
+    // The same message sent again on the stream is mostly a back reference to the first one.
+    std::vector<Message> sent;
+    for (int i = 0; i < 3; ++i) {
+        sent.push_back(assertOk(clientManager.compressMessage(original)));
+    }
+    ASSERT_LT(sent[1].size(), sent[0].size());
+    ASSERT_LTE(sent[2].size(), sent[1].size());
+
+    for (const auto& compressed : sent) {
+        auto decompressed = assertOk(serverManager.decompressMessage(compressed));
+        ASSERT_EQ(decompressed.size(), original.size());
+        ASSERT_EQ(memcmp(decompressed.singleData().data(), body.objdata(), body.objsize()), 0);
+    }
+
+    // A later message can't be decompressed without the messages which preceded it.
+    MessageCompressorManager otherManager(&registry);
+    ASSERT_NOT_OK(otherManager.decompressMessage(sent[1]).getStatus());
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
@@ -33,11 +33,318 @@
 
 #include <zstd.h>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
 
 namespace mongo {
+namespace {
+
+// Window size of the zstdStream compressor, which bounds the memory each session needs for every
+// direction of its stream. Decompression rejects streams which ask for a larger window.
+constexpr int kStreamWindowLog = 18;
+
+// Room for the last block header of a flushed stream message, on top of the bound for a frame.
+constexpr std::size_t kStreamFlushOverhead = 32;
+
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+        ZSTD_freeCCtx(cctx);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* dctx) const {
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+struct CDictDeleter {
+    void operator()(ZSTD_CDict* cdict) const {
+        ZSTD_freeCDict(cdict);
+    }
+};
+
+struct DDictDeleter {
+    void operator()(ZSTD_DDict* ddict) const {
+        ZSTD_freeDDict(ddict);
+    }
+};
+
+using UniqueCCtx = std::unique_ptr<ZSTD_CCtx, CCtxDeleter>;
+using UniqueDCtx = std::unique_ptr<ZSTD_DCtx, DCtxDeleter>;
+
+Status makeCompressError(StringData reason) {
+    return {ErrorCodes::BadValue, str::stream() << "Could not compress input: " << reason};
+}
+
+Status makeDecompressError(StringData reason) {
+    return {ErrorCodes::BadValue, str::stream() << "Could not decompress message: " << reason};
+}
+
+/**
+ * Builds the raw content dictionary of the zstdStream compressor from the BSON of the command
+ * requests and replies most connections carry: replication, CRUD, cursors and handshakes. The most
+ * common shapes come last, where zstd matches them most cheaply. Since both ends of a connection
+ * have to build the very same bytes, this must never change.
+ */
+std::string buildStreamDictionary() {
+    const char zeroes[20] = {};
+    const BSONBinData uuid(zeroes, 16, newUUID);
+    const BSONBinData hash(zeroes, 20, BinDataGeneral);
+    const Timestamp ts;
+    const OID oid;
+    const Date_t wall;
+
+    const auto opTime = BSON("ts" << ts << "t" << 1LL);
+    const auto clusterTime =
+        BSON("clusterTime" << ts << "signature" << BSON("hash" << hash << "keyId" << 0LL));
+    const auto lsid = BSON("id" << uuid);
+    const auto readPreference = BSON("mode"
+                                     << "secondaryPreferred");
+
+    const std::vector<BSONObj> samples = {
+        BSON("isMaster" << 1 << "$db"
+                        << "admin"),
+        BSON("ismaster" << true << "topologyVersion" << BSON("processId" << oid << "counter" << 0LL)
+                        << "maxBsonObjectSize" << 16777216 << "maxMessageSizeBytes" << 48000000
+                        << "maxWriteBatchSize" << 100000 << "localTime" << wall
+                        << "logicalSessionTimeoutMinutes" << 30 << "connectionId" << 1
+                        << "minWireVersion" << 0 << "maxWireVersion" << 9 << "readOnly" << false
+                        << "ok" << 1.0),
+        BSON("aggregate"
+             << "coll"
+             << "pipeline" << BSON_ARRAY(BSON("$match" << BSONObj())) << "cursor" << BSONObj()
+             << "lsid" << lsid << "$clusterTime" << clusterTime << "$readPreference"
+             << readPreference << "$db"
+             << "test"),
+        BSON("delete"
+             << "coll"
+             << "deletes" << BSON_ARRAY(BSON("q" << BSONObj() << "limit" << 0)) << "ordered"
+             << true << "lsid" << lsid << "txnNumber" << 1LL << "$clusterTime" << clusterTime
+             << "$db"
+             << "test"),
+        BSON("update"
+             << "coll"
+             << "updates"
+             << BSON_ARRAY(BSON("q" << BSONObj() << "u" << BSON("$set" << BSONObj()) << "multi"
+                                    << false << "upsert" << false))
+             << "ordered" << true << "lsid" << lsid << "txnNumber" << 1LL << "$clusterTime"
+             << clusterTime << "$db"
+             << "test"),
+        BSON("insert"
+             << "coll"
+             << "ordered" << true << "lsid" << lsid << "txnNumber" << 1LL << "$clusterTime"
+             << clusterTime << "writeConcern"
+             << BSON("w"
+                     << "majority"
+                     << "wtimeout" << 0)
+             << "$db"
+             << "test"),
+        BSON("n" << 1 << "nModified" << 1 << "electionId" << oid << "opTime" << opTime << "ok"
+                 << 1.0 << "$gleStats" << BSON("lastOpTime" << ts << "electionId" << oid)
+                 << "lastCommittedOpTime" << ts << "$configServerState"
+                 << BSON("opTime" << opTime) << "$clusterTime" << clusterTime << "operationTime"
+                 << ts),
+        BSON("find"
+             << "coll"
+             << "filter" << BSONObj() << "limit" << 1 << "batchSize" << 1 << "singleBatch" << true
+             << "shardVersion" << BSON_ARRAY(ts << oid) << "readConcern"
+             << BSON("level"
+                     << "majority"
+                     << "afterClusterTime" << ts)
+             << "lsid" << lsid << "$clusterTime" << clusterTime << "$readPreference"
+             << readPreference << "$db"
+             << "test"),
+        BSON("cursor" << BSON("firstBatch" << BSONArray() << "id" << 0LL << "ns"
+                                           << "test.coll")
+                      << "ok" << 1.0 << "$clusterTime" << clusterTime << "operationTime" << ts),
+        BSON("getMore" << 0LL << "collection"
+                       << "oplog.rs"
+                       << "batchSize" << 13981010 << "maxTimeMS" << 5000LL << "term" << 1LL
+                       << "lastKnownCommittedOpTime" << opTime << "$replData" << 1
+                       << "$oplogQueryData" << 1 << "$readPreference" << readPreference
+                       << "$clusterTime" << clusterTime << "$db"
+                       << "local"),
+        BSON("op"
+             << "u"
+             << "ns"
+             << "test.coll"
+             << "ui" << uuid << "o" << BSON("$v" << 1 << "$set" << BSONObj()) << "o2"
+             << BSON("_id" << oid) << "ts" << ts << "t" << 1LL << "v" << 2 << "wall" << wall),
+        BSON("op"
+             << "i"
+             << "ns"
+             << "test.coll"
+             << "ui" << uuid << "o" << BSON("_id" << oid) << "ts" << ts << "t" << 1LL << "v" << 2
+             << "wall" << wall),
+        BSON("cursor" << BSON("nextBatch" << BSONArray() << "id" << 0LL << "ns"
+                                          << "local.oplog.rs")
+                      << "$replData"
+                      << BSON("term" << 1LL << "lastOpCommitted" << opTime << "lastCommittedWall"
+                                     << wall << "lastOpVisible" << opTime << "configVersion" << 1
+                                     << "replicaSetId" << oid << "primaryIndex" << 0
+                                     << "syncSourceIndex" << -1)
+                      << "$oplogQueryData"
+                      << BSON("lastOpCommitted" << opTime << "lastCommittedWall" << wall
+                                                << "lastOpApplied" << opTime << "rbid" << 1
+                                                << "primaryIndex" << 0 << "syncSourceIndex" << -1)
+                      << "ok" << 1.0 << "$clusterTime" << clusterTime << "operationTime" << ts),
+    };
+
+    std::string dictionary;
+    for (const auto& sample : samples) {
+        dictionary.append(sample.objdata(), sample.objsize());
+    }
+    return dictionary;
+}
+
+/**
+ * The digested zstdStream dictionary, shared by the contexts of all sessions.
+ */
+class StreamDictionary {
+public:
+    static const StreamDictionary& get() {
+        static const StreamDictionary dictionary;
+        return dictionary;
+    }
+
+    ZSTD_CDict* cdict() const {
+        return _cdict.get();
+    }
+
+    ZSTD_DDict* ddict() const {
+        return _ddict.get();
+    }
+
+private:
+    StreamDictionary() {
+        const auto content = buildStreamDictionary();
+        _cdict.reset(ZSTD_createCDict(content.data(), content.size(), ZSTD_CLEVEL_DEFAULT));
+        _ddict.reset(ZSTD_createDDict(content.data(), content.size()));
+        invariant(_cdict && _ddict);
+    }
+
+    std::unique_ptr<ZSTD_CDict, CDictDeleter> _cdict;
+    std::unique_ptr<ZSTD_DDict, DDictDeleter> _ddict;
+};
+
+class ZstdSessionContext final : public MessageCompressorBase::SessionContext {
+public:
+    ZSTD_CCtx* cctx() {
+        if (!_cctx) {
+            _cctx.reset(ZSTD_createCCtx());
+            invariant(_cctx);
+        }
+        return _cctx.get();
+    }
+
+    ZSTD_DCtx* dctx() {
+        if (!_dctx) {
+            _dctx.reset(ZSTD_createDCtx());
+            invariant(_dctx);
+        }
+        return _dctx.get();
+    }
+
+private:
+    UniqueCCtx _cctx;
+    UniqueDCtx _dctx;
+};
+
+/**
+ * The two streams of a zstdStream session. Each direction is set up the first time it is used.
+ */
+class ZstdStreamSessionContext final : public MessageCompressorBase::SessionContext {
+public:
+    ZSTD_CCtx* cctx() {
+        if (!_cctx) {
+            _cctx.reset(ZSTD_createCCtx());
+            invariant(_cctx);
+            invariantZstd(ZSTD_CCtx_setParameter(_cctx.get(), ZSTD_c_windowLog, kStreamWindowLog));
+            invariantZstd(ZSTD_CCtx_refCDict(_cctx.get(), StreamDictionary::get().cdict()));
+        }
+        return _cctx.get();
+    }
+
+    ZSTD_DCtx* dctx() {
+        if (!_dctx) {
+            _dctx.reset(ZSTD_createDCtx());
+            invariant(_dctx);
+            invariantZstd(
+                ZSTD_DCtx_setParameter(_dctx.get(), ZSTD_d_windowLogMax, kStreamWindowLog));
+            invariantZstd(ZSTD_DCtx_refDDict(_dctx.get(), StreamDictionary::get().ddict()));
+        }
+        return _dctx.get();
+    }
+
+private:
+    static void invariantZstd(size_t ret) {
+        invariant(!ZSTD_isError(ret), ZSTD_getErrorName(ret));
+    }
+
+    UniqueCCtx _cctx;
+    UniqueDCtx _dctx;
+};
+
+/**
+ * Compresses 'input' onto the stream of 'cctx' and flushes it, so that the peer can decompress the
+ * whole message without waiting for the next one.
+ */
+StatusWith<std::size_t> compressStreamMessage(ZSTD_CCtx* cctx,
+                                              ConstDataRange input,
+                                              DataRange output) {
+    ZSTD_inBuffer in{input.data(), input.length(), 0};
+    ZSTD_outBuffer out{const_cast<char*>(output.data()), output.length(), 0};
+
+    size_t remaining;
+    do {
+        remaining = ZSTD_compressStream2(cctx, &out, &in, ZSTD_e_flush);
+        if (ZSTD_isError(remaining)) {
+            return makeCompressError(ZSTD_getErrorName(remaining));
+        }
+    } while (remaining && out.pos < out.size);
+
+    if (remaining) {
+        return makeCompressError("Destination buffer is too small");
+    }
+    return {out.pos};
+}
+
+/**
+ * Decompresses one flushed message from the stream of 'dctx'. The message must fill 'output'
+ * exactly.
+ */
+StatusWith<std::size_t> decompressStreamMessage(ZSTD_DCtx* dctx,
+                                                ConstDataRange input,
+                                                DataRange output) {
+    ZSTD_inBuffer in{input.data(), input.length(), 0};
+    ZSTD_outBuffer out{const_cast<char*>(output.data()), output.length(), 0};
+
+    while (in.pos < in.size || out.pos < out.size) {
+        const auto inPos = in.pos;
+        const auto outPos = out.pos;
+        size_t ret = ZSTD_decompressStream(dctx, &out, &in);
+        if (ZSTD_isError(ret)) {
+            return makeDecompressError(ZSTD_getErrorName(ret));
+        }
+        if (in.pos == inPos && out.pos == outPos) {
+            break;
+        }
+    }
+
+    if (in.pos < in.size) {
+        return makeDecompressError("Destination buffer is too small");
+    }
+    if (out.pos < out.size) {
+        return makeDecompressError("Src size is incorrect");
+    }
+    return {out.pos};
+}
+
+}  // namespace
 
 ZstdMessageCompressor::ZstdMessageCompressor() : MessageCompressorBase(MessageCompressor::kZstd) {}
 
@@ -54,8 +361,7 @@ StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input
                                ZSTD_CLEVEL_DEFAULT);
 
     if (ZSTD_isError(ret)) {
-        return Status{ErrorCodes::BadValue,
-                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+        return makeCompressError(ZSTD_getErrorName(ret));
     }
     counterHitCompress(input.length(), ret);
     return {ret};
@@ -67,14 +373,97 @@ StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange inp
         const_cast<char*>(output.data()), output.length(), input.data(), input.length());
 
     if (ZSTD_isError(ret)) {
-        return Status{ErrorCodes::BadValue,
-                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+        return makeDecompressError(ZSTD_getErrorName(ret));
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
+
+std::unique_ptr<MessageCompressorBase::SessionContext> ZstdMessageCompressor::makeSessionContext() {
+    return std::make_unique<ZstdSessionContext>();
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressSessionData(SessionContext* context,
+                                                                   ConstDataRange input,
+                                                                   DataRange output) {
+    size_t ret = ZSTD_compressCCtx(checked_cast<ZstdSessionContext*>(context)->cctx(),
+                                   const_cast<char*>(output.data()),
+                                   output.length(),
+                                   input.data(),
+                                   input.length(),
+                                   ZSTD_CLEVEL_DEFAULT);
+
+    if (ZSTD_isError(ret)) {
+        return makeCompressError(ZSTD_getErrorName(ret));
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressSessionData(SessionContext* context,
+                                                                     ConstDataRange input,
+                                                                     DataRange output) {
+    size_t ret = ZSTD_decompressDCtx(checked_cast<ZstdSessionContext*>(context)->dctx(),
+                                     const_cast<char*>(output.data()),
+                                     output.length(),
+                                     input.data(),
+                                     input.length());
+
+    if (ZSTD_isError(ret)) {
+        return makeDecompressError(ZSTD_getErrorName(ret));
     }
 
     counterHitDecompress(input.length(), ret);
     return {ret};
 }
 
+ZstdStreamMessageCompressor::ZstdStreamMessageCompressor()
+    : MessageCompressorBase(MessageCompressor::kZstdStream) {}
+
+std::size_t ZstdStreamMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize) + kStreamFlushOverhead;
+}
+
+StatusWith<std::size_t> ZstdStreamMessageCompressor::compressData(ConstDataRange input,
+                                                                  DataRange output) {
+    ZstdStreamSessionContext context;
+    return compressSessionData(&context, input, output);
+}
+
+StatusWith<std::size_t> ZstdStreamMessageCompressor::decompressData(ConstDataRange input,
+                                                                    DataRange output) {
+    ZstdStreamSessionContext context;
+    return decompressSessionData(&context, input, output);
+}
+
+std::unique_ptr<MessageCompressorBase::SessionContext>
+ZstdStreamMessageCompressor::makeSessionContext() {
+    return std::make_unique<ZstdStreamSessionContext>();
+}
+
+StatusWith<std::size_t> ZstdStreamMessageCompressor::compressSessionData(SessionContext* context,
+                                                                         ConstDataRange input,
+                                                                         DataRange output) {
+    auto ret = compressStreamMessage(
+        checked_cast<ZstdStreamSessionContext*>(context)->cctx(), input, output);
+    if (ret.isOK()) {
+        counterHitCompress(input.length(), ret.getValue());
+    }
+    return ret;
+}
+
+StatusWith<std::size_t> ZstdStreamMessageCompressor::decompressSessionData(SessionContext* context,
+                                                                           ConstDataRange input,
+                                                                           DataRange output) {
+    auto ret = decompressStreamMessage(
+        checked_cast<ZstdStreamSessionContext*>(context)->dctx(), input, output);
+    if (ret.isOK()) {
+        counterHitDecompress(input.length(), ret.getValue());
+    }
+    return ret;
+}
+
 
 MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
                           ("EndStartupOptionHandling"),
@@ -82,6 +471,7 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
 (InitializerContext* context) {
     auto& compressorRegistry = MessageCompressorRegistry::get();
     compressorRegistry.registerImplementation(std::make_unique<ZstdMessageCompressor>());
+    compressorRegistry.registerImplementation(std::make_unique<ZstdStreamMessageCompressor>());
     return Status::OK();
 }
 }  // namespace mongo
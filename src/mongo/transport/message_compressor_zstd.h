@@ -30,6 +30,10 @@
 #include "mongo/transport/message_compressor_base.h"
 
 namespace mongo {
+/**
+ * Compresses every message into an independent zstd frame. Each session reuses its own
+ * compression and decompression contexts rather than allocating new ones for every message.
+ */
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
     ZstdMessageCompressor();
@@ -39,6 +43,48 @@ public:
     StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
 
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    std::unique_ptr<SessionContext> makeSessionContext() override;
+
+    StatusWith<std::size_t> compressSessionData(SessionContext* context,
+                                                ConstDataRange input,
+                                                DataRange output) override;
+
+    StatusWith<std::size_t> decompressSessionData(SessionContext* context,
+                                                  ConstDataRange input,
+                                                  DataRange output) override;
+};
+
+/**
+ * Compresses all the messages a session sends in one direction as a single zstd stream, flushed
+ * at the end of every message, so that the compression window spans messages. Both directions
+ * start from a built-in dictionary of common command and reply shapes.
+ *
+ * The messages of a session must be decompressed in the order in which they were compressed. The
+ * dictionary is part of the wire format of this compressor and must never change.
+ */
+class ZstdStreamMessageCompressor final : public MessageCompressorBase {
+public:
+    ZstdStreamMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    /**
+     * Without a session context, a message is compressed as the first message of a new stream.
+     */
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    std::unique_ptr<SessionContext> makeSessionContext() override;
+
+    StatusWith<std::size_t> compressSessionData(SessionContext* context,
+                                                ConstDataRange input,
+                                                DataRange output) override;
+
+    StatusWith<std::size_t> decompressSessionData(SessionContext* context,
+                                                  ConstDataRange input,
+                                                  DataRange output) override;
 };
 
 
@@ -40,6 +40,7 @@
 #include "mongo/transport/service_executor_fixed.h"
 #include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_work_stealing.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/death_test.h"
@@ -346,5 +347,174 @@ TEST_F(ServiceExecutorFixedFixture, ScheduleFailsAfterShutdown) {
     schedulerThread->join();
 }
 
+class ServiceExecutorWorkStealingFixture : public unittest::Test {
+public:
+    static constexpr auto kNumWorkers = 2;
+
+    void setUp() override {
+        ServiceExecutorWorkStealing::Options options;
+        options.numWorkers = kNumWorkers;
+        options.poolName = "Test";
+        _executor = std::make_shared<ServiceExecutorWorkStealing>(std::move(options));
+    }
+
+    void tearDown() override {
+        ASSERT_OK(_executor->shutdown(kShutdownTime));
+    }
+
+    auto getServiceExecutor() const {
+        return _executor;
+    }
+
+    auto startAndGetServiceExecutor() {
+        ASSERT_OK(_executor->start());
+        return getServiceExecutor();
+    }
+
+    BSONObj getStats() const {
+        BSONObjBuilder bob;
+        _executor->appendStats(&bob);
+        return bob.obj();
+    }
+
+private:
+    std::shared_ptr<ServiceExecutorWorkStealing> _executor;
+};
+
+TEST_F(ServiceExecutorWorkStealingFixture, ScheduleFailsBeforeStartup) {
+    auto executor = getServiceExecutor();
+    ASSERT_NOT_OK(executor->schedule([] {}, ServiceExecutor::kEmptyFlags));
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, BasicTaskRuns) {
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    ASSERT_OK(executor->schedule([barrier]() mutable { barrier->countDownAndWait(); },
+                                 ServiceExecutor::kEmptyFlags));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, RecursiveTask) {
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(2);
+    AtomicWord<int> recursionDepth{0};
+
+    ServiceExecutor::Task recursiveTask;
+    recursiveTask = [executor, barrier, &recursiveTask, &recursionDepth] {
+        recursionDepth.fetchAndAdd(1);
+        ON_BLOCK_EXIT([&] { recursionDepth.fetchAndSubtract(1); });
+        if (recursionDepth.load() < workStealingServiceExecutorRecursionLimit.load()) {
+            ASSERT_OK(executor->schedule(recursiveTask, ServiceExecutor::kMayRecurse));
+        } else {
+            // This test never returns unless the service executor can satisfy the recursion depth.
+            barrier->countDownAndWait();
+        }
+    };
+
+    ASSERT_OK(executor->schedule(recursiveTask, ServiceExecutor::kMayRecurse));
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, TasksScheduledFromWorkerStayOnWorker) {
+    auto executor = startAndGetServiceExecutor();
+    auto done = std::make_shared<SharedPromise<void>>();
+    auto mutex = MONGO_MAKE_LATCH();
+    std::vector<stdx::thread::id> threadIds;
+    constexpr size_t kChainLength = 100;
+
+    // Each task schedules its successor like a session's state machine does, without recursing.
+    ServiceExecutor::Task chainedTask;
+    chainedTask = [&] {
+        stdx::lock_guard<Latch> lk(mutex);
+        threadIds.push_back(stdx::this_thread::get_id());
+        if (threadIds.size() < kChainLength) {
+            ASSERT_OK(executor->schedule(chainedTask, ServiceExecutor::kEmptyFlags));
+        } else {
+            done->emplaceValue();
+        }
+    };
+
+    ASSERT_OK(executor->schedule(chainedTask, ServiceExecutor::kEmptyFlags));
+    done->getFuture().get();
+
+    // A worker that is still awake right after startup may steal a task before going to sleep,
+    // after which the chain stays on the thief. Nothing should keep moving it between workers.
+    stdx::lock_guard<Latch> lk(mutex);
+    int migrations = 0;
+    for (size_t i = 1; i < threadIds.size(); ++i) {
+        migrations += threadIds[i] != threadIds[i - 1];
+    }
+    ASSERT_LTE(migrations, 2);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, IdleWorkerStealsQueuedTask) {
+    auto executor = startAndGetServiceExecutor();
+    auto stolenTaskRan = std::make_shared<SharedPromise<void>>();
+
+    // Tasks scheduled from outside the executor are assigned round-robin, so the first and third
+    // tasks land on the same worker. The first one blocks until the third has run, which can only
+    // happen if the other worker steals it.
+    ASSERT_OK(executor->schedule([stolenTaskRan] { stolenTaskRan->getFuture().get(); },
+                                 ServiceExecutor::kEmptyFlags));
+    ASSERT_OK(executor->schedule([] {}, ServiceExecutor::kEmptyFlags));
+    ASSERT_OK(executor->schedule([stolenTaskRan] { stolenTaskRan->emplaceValue(); },
+                                 ServiceExecutor::kEmptyFlags));
+    stolenTaskRan->getFuture().get();
+
+    auto stats = getStats();
+    ASSERT_EQ(stats.getStringField("executor"), "workStealing"_sd);
+    ASSERT_GTE(stats.getField("tasksStolen").numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, Stats) {
+    auto executor = startAndGetServiceExecutor();
+    auto barrier = std::make_shared<unittest::Barrier>(kNumWorkers + 1);
+    auto blocked = std::make_shared<unittest::Barrier>(kNumWorkers + 1);
+
+    // Occupy every worker, then queue one more task behind them.
+    for (auto i = 0; i < kNumWorkers; i++) {
+        ASSERT_OK(executor->schedule(
+            [barrier, blocked] {
+                blocked->countDownAndWait();
+                barrier->countDownAndWait();
+            },
+            ServiceExecutor::kEmptyFlags));
+    }
+    blocked->countDownAndWait();
+    ASSERT_OK(executor->schedule([] {}, ServiceExecutor::kEmptyFlags));
+
+    auto stats = getStats();
+    ASSERT_EQ(stats.getIntField("threadsRunning"), kNumWorkers);
+    ASSERT_EQ(stats.getField("tasksQueued").numberLong(), 1);
+    auto workers = stats.getField("workers").Array();
+    ASSERT_EQ(workers.size(), static_cast<size_t>(kNumWorkers));
+    long long queued = 0;
+    for (auto& worker : workers) {
+        queued += worker.Obj().getField("queued").numberLong();
+        ASSERT(worker.Obj().hasField("executed"));
+        ASSERT(worker.Obj().hasField("stolen"));
+    }
+    ASSERT_EQ(queued, 1);
+
+    barrier->countDownAndWait();
+}
+
+TEST_F(ServiceExecutorWorkStealingFixture, ScheduleFailsAfterShutdown) {
+    auto executor = startAndGetServiceExecutor();
+    std::unique_ptr<stdx::thread> schedulerThread;
+
+    {
+        FailPointEnableBlock failpoint("hangBeforeSchedulingServiceExecutorWorkStealingTask");
+        schedulerThread = std::make_unique<stdx::thread>([executor] {
+            ASSERT_NOT_OK(
+                executor->schedule([] { MONGO_UNREACHABLE; }, ServiceExecutor::kEmptyFlags));
+        });
+        failpoint->waitForTimesEntered(1);
+        ASSERT_OK(executor->shutdown(kShutdownTime));
+    }
+
+    schedulerThread->join();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,318 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/transport/service_executor_work_stealing.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "mongo/base/error_codes.h"
+#include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+MONGO_FAIL_POINT_DEFINE(hangBeforeSchedulingServiceExecutorWorkStealingTask);
+
+namespace transport {
+namespace {
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "workStealing"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
+constexpr auto kWorkers = "workers"_sd;
+constexpr auto kQueued = "queued"_sd;
+constexpr auto kExecuted = "executed"_sd;
+constexpr auto kStolen = "stolen"_sd;
+}  // namespace
+
+thread_local ServiceExecutorWorkStealing::ThreadContext ServiceExecutorWorkStealing::_threadContext;
+
+struct ServiceExecutorWorkStealing::Worker {
+    Mutex mutex = MONGO_MAKE_LATCH("ServiceExecutorWorkStealing::Worker::mutex");
+    stdx::condition_variable cv;
+
+    // Guarded by 'mutex'. The owner takes tasks from the front, thieves from the back.
+    std::deque<Task> queue;
+    bool notified = false;
+
+    // Mirrors queue.size() so that thieves and stats can skip empty queues without locking.
+    AtomicWord<size_t> queueDepth{0};
+    AtomicWord<bool> sleeping{false};
+
+    AtomicWord<long long> executed{0};
+    AtomicWord<long long> stolen{0};
+
+    stdx::thread thread;
+};
+
+ServiceExecutorWorkStealing::ServiceExecutorWorkStealing(Options options)
+    : _options(std::move(options)) {
+    size_t numWorkers = _options.numWorkers;
+    if (numWorkers == 0) {
+        numWorkers = std::max(1u, stdx::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+}
+
+ServiceExecutorWorkStealing::~ServiceExecutorWorkStealing() {
+    invariant(!_canScheduleWork.load());
+    if (_state == State::kNotStarted)
+        return;
+
+    // Ensures we always call "shutdown" after staring the service executor
+    invariant(_state == State::kStopped);
+    for (auto& worker : _workers) {
+        worker->thread.join();
+    }
+    invariant(_numRunningExecutorThreads.load() == 0);
+}
+
+Status ServiceExecutorWorkStealing::start() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto oldState = std::exchange(_state, State::kRunning);
+    invariant(oldState == State::kNotStarted);
+
+    _canScheduleWork.store(true);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i]->thread = stdx::thread([this, i] { _runWorker(i); });
+    }
+
+    LOGV2_DEBUG(4859041,
+                3,
+                "Started work-stealing service executor",
+                "name"_attr = _options.poolName,
+                "workers"_attr = _workers.size());
+    return Status::OK();
+}
+
+Status ServiceExecutorWorkStealing::shutdown(Milliseconds timeout) {
+    LOGV2_DEBUG(4859042,
+                3,
+                "Shutting down work-stealing service executor",
+                "name"_attr = _options.poolName);
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _canScheduleWork.store(false);
+
+        auto oldState = std::exchange(_state, State::kStopped);
+        if (oldState == State::kRunning) {
+            // Outstanding tasks are dropped once the workers exit.
+            for (auto& worker : _workers) {
+                stdx::lock_guard<Latch> workerLk(worker->mutex);
+                worker->notified = true;
+                worker->cv.notify_one();
+            }
+        }
+    }
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    bool success = _shutdownCondition.wait_for(lk, timeout.toSystemDuration(), [this] {
+        return _numRunningExecutorThreads.load() == 0;
+    });
+    return success ? Status::OK()
+                   : Status(ErrorCodes::ExceededTimeLimit,
+                            "Failed to shutdown all executor threads within the time limit");
+}
+
+Status ServiceExecutorWorkStealing::schedule(Task task, ScheduleFlags flags) {
+    if (!_canScheduleWork.load()) {
+        return Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+    }
+
+    const bool onWorkerThread = _threadContext.executor == this;
+    if ((flags & ScheduleFlags::kMayRecurse) && onWorkerThread &&
+        _threadContext.recursionDepth < workStealingServiceExecutorRecursionLimit.loadRelaxed()) {
+        // Recursively executing the task on the executor thread.
+        _runTask(_workers[_threadContext.workerIndex].get(), task);
+        return Status::OK();
+    }
+
+    hangBeforeSchedulingServiceExecutorWorkStealingTask.pauseWhileSet();
+
+    // Keep tasks scheduled by a worker on that worker so that a session stays where its state is
+    // warm in cache. Everything else is spread across the workers.
+    const size_t index = onWorkerThread ? _threadContext.workerIndex
+                                        : _nextWorker.fetchAndAdd(1) % _workers.size();
+    auto& worker = *_workers[index];
+
+    size_t queueDepth;
+    {
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        if (!_canScheduleWork.load()) {
+            return Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+        }
+
+        worker.queue.push_back(std::move(task));
+        queueDepth = worker.queueDepth.addAndFetch(1);
+        if (worker.sleeping.load()) {
+            worker.notified = true;
+            worker.cv.notify_one();
+            return Status::OK();
+        }
+    }
+
+    // The owner is busy. A worker scheduling its own continuation will get to it as soon as the
+    // current task returns, so only ask for help if the task would otherwise wait behind others.
+    if ((!onWorkerThread || queueDepth > 1) && _numSleepingWorkers.load() > 0) {
+        _wakeSleepingWorker(index);
+    }
+
+    return Status::OK();
+}
+
+void ServiceExecutorWorkStealing::appendStats(BSONObjBuilder* bob) const {
+    long long totalQueued = 0;
+    long long totalStolen = 0;
+    BSONArrayBuilder workersBuilder;
+    for (auto& worker : _workers) {
+        const auto queued = static_cast<long long>(worker->queueDepth.load());
+        const auto stolen = worker->stolen.load();
+        totalQueued += queued;
+        totalStolen += stolen;
+
+        BSONObjBuilder workerBuilder(workersBuilder.subobjStart());
+        workerBuilder << kQueued << queued << kExecuted << worker->executed.load() << kStolen
+                      << stolen;
+    }
+
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning
+         << static_cast<int>(_numRunningExecutorThreads.load()) << kTasksQueued << totalQueued
+         << kTasksStolen << totalStolen << kWorkers << workersBuilder.arr();
+}
+
+void ServiceExecutorWorkStealing::_runWorker(size_t index) {
+    setThreadName(str::stream() << _options.poolName << "-" << index);
+    _threadContext = {this, index, 0};
+
+    _numRunningExecutorThreads.fetchAndAdd(1);
+    ON_BLOCK_EXIT([&] {
+        _threadContext = {};
+        stdx::lock_guard<Latch> lk(_mutex);
+        _numRunningExecutorThreads.fetchAndSubtract(1);
+        _shutdownCondition.notify_all();
+    });
+
+    auto& self = *_workers[index];
+    while (_canScheduleWork.load()) {
+        Task task;
+        if (_popOrSteal(index, &task)) {
+            _runTask(&self, task);
+            continue;
+        }
+
+        // Announce that we are going to sleep before looking for work one last time, so that a
+        // concurrent schedule() either sees us sleeping and wakes us or its task is found here.
+        self.sleeping.store(true);
+        _numSleepingWorkers.fetchAndAdd(1);
+        const bool found = _popOrSteal(index, &task);
+        if (!found) {
+            stdx::unique_lock<Latch> lk(self.mutex);
+            self.cv.wait(lk, [&] {
+                return self.notified || !self.queue.empty() || !_canScheduleWork.load();
+            });
+            self.notified = false;
+        }
+        _numSleepingWorkers.fetchAndSubtract(1);
+        self.sleeping.store(false);
+
+        if (found) {
+            _runTask(&self, task);
+        }
+    }
+}
+
+void ServiceExecutorWorkStealing::_runTask(Worker* worker, const Task& task) {
+    _threadContext.recursionDepth++;
+    task();
+    _threadContext.recursionDepth--;
+    worker->executed.fetchAndAdd(1);
+}
+
+bool ServiceExecutorWorkStealing::_popOrSteal(size_t index, Task* task) {
+    auto& self = *_workers[index];
+    if (self.queueDepth.load() > 0) {
+        stdx::lock_guard<Latch> lk(self.mutex);
+        if (!self.queue.empty()) {
+            *task = std::move(self.queue.front());
+            self.queue.pop_front();
+            self.queueDepth.subtractAndFetch(1);
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        auto& victim = *_workers[(index + i) % _workers.size()];
+        if (victim.queueDepth.load() == 0) {
+            continue;
+        }
+
+        stdx::lock_guard<Latch> lk(victim.mutex);
+        if (!victim.queue.empty()) {
+            *task = std::move(victim.queue.back());
+            victim.queue.pop_back();
+            victim.queueDepth.subtractAndFetch(1);
+            self.stolen.fetchAndAdd(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ServiceExecutorWorkStealing::_wakeSleepingWorker(size_t exclude) {
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        auto& worker = *_workers[(exclude + i) % _workers.size()];
+        if (!worker.sleeping.load()) {
+            continue;
+        }
+
+        stdx::lock_guard<Latch> lk(worker.mutex);
+        if (!worker.notified) {
+            worker.notified = true;
+            worker.cv.notify_one();
+            return;
+        }
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/util/hierarchical_acquisition.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A service executor with one run queue per worker thread and, by default, one worker per core.
+ *
+ * Tasks scheduled from a worker thread are queued on that worker, so a session's state machine
+ * keeps running on the thread (and cache) it last ran on. Tasks scheduled from elsewhere, such as
+ * new sessions, are spread across workers round-robin. A worker that runs out of work steals the
+ * most recently queued task of another worker, and idle workers are woken to steal when a task
+ * lands on a busy worker that already has a backlog. There is no queue shared by all workers.
+ */
+class ServiceExecutorWorkStealing
+    : public ServiceExecutor,
+      public std::enable_shared_from_this<ServiceExecutorWorkStealing> {
+public:
+    struct Options {
+        size_t numWorkers = 0;  // Zero uses one worker per available core.
+        std::string poolName = "WorkStealingServiceExecutor";
+    };
+
+    explicit ServiceExecutorWorkStealing(Options options);
+    virtual ~ServiceExecutorWorkStealing();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status schedule(Task task, ScheduleFlags flags) override;
+
+    Mode transportMode() const override {
+        return Mode::kSynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+private:
+    struct Worker;
+
+    // Identifies the executor worker, if any, running on the current thread.
+    struct ThreadContext {
+        ServiceExecutorWorkStealing* executor = nullptr;
+        size_t workerIndex = 0;
+        int recursionDepth = 0;
+    };
+
+    void _runWorker(size_t index);
+
+    void _runTask(Worker* worker, const Task& task);
+
+    /**
+     * Takes the oldest task from the given worker's queue or, failing that, steals the newest task
+     * of another worker. Returns false if every queue was empty.
+     */
+    bool _popOrSteal(size_t index, Task* task);
+
+    /**
+     * Wakes one sleeping worker other than 'exclude' so that it can steal queued work.
+     */
+    void _wakeSleepingWorker(size_t exclude);
+
+    AtomicWord<size_t> _numRunningExecutorThreads{0};
+    AtomicWord<size_t> _numSleepingWorkers{0};
+    AtomicWord<size_t> _nextWorker{0};
+    AtomicWord<bool> _canScheduleWork{false};
+
+    mutable Mutex _mutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "ServiceExecutorWorkStealing::_mutex");
+    stdx::condition_variable _shutdownCondition;
+
+    /**
+     * State transition diagram: kNotStarted ---> kRunning ---> kStopped
+     * The service executor cannot be in "kRunning" when its destructor is invoked.
+     */
+    enum State { kNotStarted, kRunning, kStopped } _state = kNotStarted;
+
+    const Options _options;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    static thread_local ThreadContext _threadContext;
+};
+
+}  // namespace transport
+}  // namespace mongo
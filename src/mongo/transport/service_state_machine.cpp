@@ -45,6 +45,7 @@
 #include "mongo/rpc/op_msg.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_state_machine_gen.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/assert_util.h"
@@ -341,14 +342,30 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
     _state.store(State::SinkWait);
     guard.release();
 
+    // Any exhaust responses held back go out ahead of this one, in a single vectored write.
+    std::vector<Message> toSinkBatch;
+    if (!_heldResponses.empty()) {
+        toSinkBatch = std::exchange(_heldResponses, {});
+        _heldResponseBytes = 0;
+        if (!toSink.empty()) {
+            toSinkBatch.push_back(std::move(toSink));
+        }
+    }
+
     auto sinkMsgImpl = [&] {
         if (_transportMode == transport::Mode::kSynchronous) {
             // We don't consider ourselves idle while sending the reply since we are still doing
             // work on behalf of the client. Contrast that with sourceMessage() where we are waiting
             // for the client to send us more work to do.
+            if (!toSinkBatch.empty()) {
+                return Future<void>::makeReady(_session()->sinkMessages(std::move(toSinkBatch)));
+            }
             return Future<void>::makeReady(_session()->sinkMessage(std::move(toSink)));
         } else {
             invariant(_transportMode == transport::Mode::kAsynchronous);
+            if (!toSinkBatch.empty()) {
+                return _session()->asyncSinkMessages(std::move(toSinkBatch));
+            }
             return _session()->asyncSinkMessage(std::move(toSink));
         }
     };
@@ -356,6 +373,34 @@ void ServiceStateMachine::_sinkMessage(ThreadGuard guard, Message toSink) {
     sinkMsgImpl().getAsync([this](Status status) { _sinkCallback(std::move(status)); });
 }
 
+bool ServiceStateMachine::_shouldHoldExhaustResponse(const DbResponse& dbresponse,
+                                                     const Message& toSink) {
+    // Only hold back a response when the next one in the exhaust stream is known to be produced
+    // without waiting for new data, so holding it back never stalls the stream.
+    if (!_inExhaust || !dbresponse.nextExhaustResponseReady) {
+        return false;
+    }
+
+    const size_t maxMessages = transport::gExhaustResponseCoalescingMaxMessages.load();
+    const size_t maxBytes = transport::gExhaustResponseCoalescingMaxBytes.load();
+    if (_heldResponses.size() + 1 >= maxMessages ||
+        _heldResponseBytes + toSink.size() > maxBytes) {
+        return false;
+    }
+
+    const auto now = _serviceContext->getPreciseClockSource()->now();
+    if (_heldResponses.empty()) {
+        // Clock times are in milliseconds, so round the delay up rather than down to zero.
+        const auto maxDelayMillis = duration_cast<Milliseconds>(
+            Microseconds(transport::gExhaustResponseCoalescingMaxDelayMicros.load() + 999));
+        _heldResponsesDeadline = now + maxDelayMillis;
+    } else if (now >= _heldResponsesDeadline) {
+        return false;
+    }
+
+    return true;
+}
+
 void ServiceStateMachine::_sourceCallback(Status status) {
     // The first thing to do is create a ThreadGuard which will take ownership of the SSM in this
     // thread.
@@ -463,6 +508,12 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
     auto opCtx = Client::getCurrent()->makeOperationContext();
     if (_inExhaust) {
         opCtx->markKillOnClientDisconnect();
+
+        // The held back responses are only sent along with the next one, so have the next one
+        // produced in time for them to go out by their deadline.
+        if (!_heldResponses.empty()) {
+            opCtx->setExhaustResponsesDeadline(_heldResponsesDeadline);
+        }
     }
 
     // The handleRequest is implemented in a subclass for mongod/mongos and actually all the
@@ -514,8 +565,21 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         TrafficRecorder::get(_serviceContext)
             .observe(_sessionHandle, _serviceContext->getPreciseClockSource()->now(), toSink);
 
+        if (_shouldHoldExhaustResponse(dbresponse, toSink)) {
+            _heldResponseBytes += toSink.size();
+            _heldResponses.push_back(std::move(toSink));
+            return _scheduleNextWithGuard(std::move(guard),
+                                          ServiceExecutor::kDeferredTask |
+                                              ServiceExecutor::kMayYieldBeforeSchedule);
+        }
+
         _sinkMessage(std::move(guard), std::move(toSink));
 
+    } else if (!_heldResponses.empty()) {
+        // The exhaust stream ended without a response of its own, so send the held back ones.
+        _inMessage.reset();
+        _inExhaust = false;
+        _sinkMessage(std::move(guard), Message());
     } else {
         _state.store(State::Source);
         _inMessage.reset();
@@ -689,6 +753,7 @@ void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
     _state.store(State::Ended);
 
     _inMessage.reset();
+    _heldResponses.clear();
 
     // By ignoring the return value of Client::releaseCurrent() we destroy the session.
     // _dbClient is now nullptr and _dbClientPtr is invalid and should never be accessed.
@@ -32,6 +32,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/config.h"
@@ -45,9 +46,12 @@
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_mode.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+struct DbResponse;
+
 /*
  * The ServiceStateMachine holds the state of a single client connection and represents the
  * lifecycle of each user request as a state machine. It is the glue between the stateless
@@ -214,6 +218,12 @@ private:
     void _sourceMessage(ThreadGuard guard);
     void _sinkMessage(ThreadGuard guard, Message toSink);
 
+    /*
+     * Returns true if the exhaust response 'toSink' may be held back to be sent together with the
+     * responses that follow it, rather than being sunk right away.
+     */
+    bool _shouldHoldExhaustResponse(const DbResponse& dbresponse, const Message& toSink);
+
     /*
      * Releases all the resources associated with the session and call the cleanupHook.
      */
@@ -242,6 +252,12 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // Exhaust responses held back so that they can be sunk with a single vectored write, their
+    // total size and the time by which they should be sent.
+    std::vector<Message> _heldResponses;
+    size_t _heldResponseBytes = 0;
+    Date_t _heldResponsesDeadline;
+
     // Allows delegating destruction of opCtx to another function to potentially remove its cost
     // from the critical path. This is currently only used in `_processMessage()`.
     ServiceContext::UniqueOperationContext _killedOpCtx;
@@ -45,6 +45,7 @@
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/service_executor.h"
 #include "mongo/transport/service_state_machine.h"
+#include "mongo/transport/service_state_machine_gen.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
@@ -74,6 +75,7 @@ public:
     DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
         LOGV2(22994, "In handleRequest");
         _ranHandler = true;
+        _lastExhaustResponsesDeadline = opCtx->getExhaustResponsesDeadline();
         ASSERT_TRUE(haveClient());
 
         // Build out a dummy OK response, if no custom response message was set. Otherwise, use the
@@ -94,6 +96,7 @@ public:
             auto cursorObj = reply.body.getObjectField("cursor");
             dbResponse.shouldRunAgainForExhaust = reply.body["ok"].trueValue() &&
                 !cursorObj.isEmpty() && (cursorObj.getField("id").numberLong() != 0);
+            dbResponse.nextExhaustResponseReady = _nextExhaustResponseReady;
         }
         dbResponse.response = res;
 
@@ -124,6 +127,14 @@ public:
         _responseMessage = std::move(m);
     }
 
+    void setNextExhaustResponseReady(bool ready) {
+        _nextExhaustResponseReady = ready;
+    }
+
+    Date_t getLastExhaustResponsesDeadline() const {
+        return _lastExhaustResponsesDeadline;
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -133,6 +144,8 @@ public:
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    bool _nextExhaustResponseReady = false;
+    Date_t _lastExhaustResponsesDeadline;
 
     // A custom response message to return from 'handleRequest'.
     Message _responseMessage;
@@ -191,6 +204,12 @@ public:
 
             return out;
         }
+
+        Status sinkMessages(std::vector<Message> messages) override {
+            auto tl = checked_cast<MockTL*>(getTransportLayer());
+            tl->_lastSinkBatchSize = messages.size();
+            return MockSession::sinkMessages(std::move(messages));
+        }
     };
 
     MockTL() {
@@ -211,6 +230,10 @@ public:
         return std::move(_lastSunk);
     }
 
+    size_t getLastSinkBatchSize() const {
+        return _lastSinkBatchSize;
+    }
+
     bool ranSink() const {
         return _ranSink;
     }
@@ -233,6 +256,7 @@ private:
     bool _ranSource = false;
     FailureMode _nextShouldFail = Nothing;
     Message _lastSunk;
+    size_t _lastSinkBatchSize = 0;
     ServiceStateMachine* _ssm;
     std::function<void()> _waitHook;
 
@@ -308,6 +332,9 @@ protected:
 
         sc->setTickSource(std::make_unique<TickSourceMock<>>());
         sc->setFastClockSource(std::make_unique<ClockSourceMock>());
+        auto preciseClockSource = std::make_unique<ClockSourceMock>();
+        _preciseClockSource = preciseClockSource.get();
+        sc->setPreciseClockSource(std::move(preciseClockSource));
 
         auto sep = std::make_unique<MockSEP>();
         _sep = sep.get();
@@ -356,6 +383,7 @@ protected:
     MockTL* _tl;
     MockSEP* _sep;
     MockServiceExecutor* _sexec;
+    ClockSourceMock* _preciseClockSource;
     SessionHandle _session;
     std::shared_ptr<ServiceStateMachine> _ssm;
     bool _ranHandler;
@@ -487,6 +515,75 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaust) {
     ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
 }
 
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustCoalescesReadyResponses) {
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
+    const std::string nss = "test.coll";
+    _tl->setSourceMessage(getMoreRequestWithExhaust(nss, cursorId, initRequestId));
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray()));
+    _sep->setResponseMessage(buildOpMsg(getMoreResBody));
+    _sep->setNextExhaustResponseReady(true);
+
+    // Source the exhaust request.
+    _ssm->runNext();
+    ASSERT_TRUE(_tl->ranSource());
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    // While the next response in the stream is known to be ready, responses are held back, and
+    // the getMores producing the later responses are told when the held back ones are due.
+    const int kHeldResponses = 3;
+    for (int i = 0; i < kHeldResponses; ++i) {
+        _ssm->runNext();
+        ASSERT_FALSE(haveClient());
+        ASSERT_FALSE(_tl->ranSink());
+        ASSERT_EQ(_ssm->state(), State::Process);
+        ASSERT_EQ(_sep->getLastExhaustResponsesDeadline(),
+                  i == 0 ? Date_t::max()
+                         : _preciseClockSource->now() + duration_cast<Milliseconds>(Microseconds(
+                               transport::gExhaustResponseCoalescingMaxDelayMicros.load())));
+    }
+
+    // The first response which may be followed by a wait for data is sunk along with the held
+    // back responses in a single batch.
+    _sep->setNextExhaustResponseReady(false);
+    _ssm->runNext();
+    ASSERT_TRUE(_tl->ranSink());
+    ASSERT_EQ(_ssm->state(), State::Process);
+    ASSERT_EQ(_tl->getLastSinkBatchSize(), static_cast<size_t>(kHeldResponses + 1));
+    ASSERT(OpMsg::isFlagSet(_tl->getLastSunk(), OpMsg::kMoreToCome));
+}
+
+TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustSendsHeldResponsesOnceDue) {
+    const int32_t initRequestId = 1;
+    const long long cursorId = 42;
+    const std::string nss = "test.coll";
+    _tl->setSourceMessage(getMoreRequestWithExhaust(nss, cursorId, initRequestId));
+    BSONObj getMoreResBody =
+        BSON("ok" << 1 << "cursor"
+                  << BSON("id" << cursorId << "ns" << nss << "nextBatch" << BSONArray()));
+    _sep->setResponseMessage(buildOpMsg(getMoreResBody));
+    _sep->setNextExhaustResponseReady(true);
+
+    _ssm->runNext();
+    ASSERT_TRUE(_tl->ranSource());
+
+    // The first response is held back.
+    _ssm->runNext();
+    ASSERT_FALSE(_tl->ranSink());
+
+    // Once the held back response is due, the next response is sunk along with it even though
+    // the one after that is ready too.
+    _preciseClockSource->advance(duration_cast<Milliseconds>(
+        Microseconds(transport::gExhaustResponseCoalescingMaxDelayMicros.load())));
+    _ssm->runNext();
+    ASSERT_TRUE(_tl->ranSink());
+    ASSERT_EQ(_ssm->state(), State::Process);
+    ASSERT_EQ(_tl->getLastSinkBatchSize(), 2U);
+    ASSERT_LTE(_sep->getLastExhaustResponsesDeadline(), _preciseClockSource->now());
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
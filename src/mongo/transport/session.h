@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/config.h"
 #include "mongo/db/baton.h"
@@ -120,6 +121,16 @@ public:
     virtual Status sinkMessage(Message message) = 0;
     virtual Future<void> asyncSinkMessage(Message message, const BatonHandle& handle = nullptr) = 0;
 
+    /**
+     * Sink (send) several Messages to the remote host for this Session, in order.
+     *
+     * Implementations may gather the messages into a single vectored write. The default sinks them
+     * one at a time. The async version will keep the buffers alive until the operation completes.
+     */
+    virtual Status sinkMessages(std::vector<Message> messages);
+    virtual Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                           const BatonHandle& handle = nullptr);
+
     /**
      * Cancel any outstanding async operations. There is no way to cancel synchronous calls.
      * Futures will finish with an ErrorCodes::CallbackCancelled error if they haven't already
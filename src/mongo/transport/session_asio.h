@@ -186,6 +186,46 @@ public:
             });
     }
 
+    Status sinkMessages(std::vector<Message> messages) override {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            // TLS frames every write into records of its own, so gathering buys nothing here.
+            return Session::sinkMessages(std::move(messages));
+        }
+#endif
+        ensureSync();
+
+        return write(gatherBuffers(messages))
+            .then([this, &messages] {
+                if (_isIngressSession) {
+                    for (const auto& message : messages) {
+                        networkCounter.hitPhysicalOut(message.size());
+                    }
+                }
+            })
+            .getNoThrow();
+    }
+
+    Future<void> asyncSinkMessages(std::vector<Message> messages,
+                                   const BatonHandle& baton = nullptr) override {
+#ifdef MONGO_CONFIG_SSL
+        if (_sslSocket) {
+            return Session::asyncSinkMessages(std::move(messages), baton);
+        }
+#endif
+        ensureAsync();
+
+        auto buffers = gatherBuffers(messages);
+        return write(buffers, baton)
+            .then([this, messages = std::move(messages) /*keep the buffers alive*/]() {
+                if (_isIngressSession) {
+                    for (const auto& message : messages) {
+                        networkCounter.hitPhysicalOut(message.size());
+                    }
+                }
+            });
+    }
+
     void cancelAsyncOperations(const BatonHandle& baton = nullptr) override {
         LOGV2_DEBUG(4615608,
                     3,
@@ -551,6 +591,42 @@ private:
         }
     }
 
+    /**
+     * Returns the buffers which remain to be written once the first 'size' bytes have been.
+     */
+    template <typename Buffer>
+    static Buffer consumeBuffers(Buffer buffer, std::size_t size) {
+        buffer += size;
+        return buffer;
+    }
+
+    static std::vector<asio::const_buffer> consumeBuffers(
+        const std::vector<asio::const_buffer>& buffers, std::size_t size) {
+        std::vector<asio::const_buffer> remaining;
+        remaining.reserve(buffers.size());
+        for (auto buffer : buffers) {
+            if (size >= buffer.size()) {
+                size -= buffer.size();
+                continue;
+            }
+            remaining.push_back(buffer += size);
+            size = 0;
+        }
+        return remaining;
+    }
+
+    /**
+     * Returns one buffer per message, suitable for a single scatter-gather write.
+     */
+    static std::vector<asio::const_buffer> gatherBuffers(const std::vector<Message>& messages) {
+        std::vector<asio::const_buffer> buffers;
+        buffers.reserve(messages.size());
+        for (const auto& message : messages) {
+            buffers.emplace_back(message.buf(), message.size());
+        }
+        return buffers;
+    }
+
     /**
      * moreToSend checks the ssl socket after an opportunisticWrite.  If there are still bytes to
      * send, we manually send them off the underlying socket.  Then we hook that up with a future
@@ -596,16 +672,17 @@ private:
 
         if (MONGO_unlikely(transportLayerASIOshortOpportunisticReadWrite.shouldFail()) &&
             _blockingMode == Async) {
-            asio::const_buffer localBuffer = buffers;
+            asio::const_buffer localBuffer;
+            const auto totalSize = asio::buffer_size(buffers);
 
-            if (buffers.size()) {
-                localBuffer = asio::const_buffer(buffers.data(), 1);
+            if (totalSize) {
+                localBuffer = asio::const_buffer(asio::buffer_sequence_begin(buffers)->data(), 1);
             }
 
             do {
                 size = asio::write(stream, localBuffer, ec);
             } while (ec == asio::error::interrupted);  // retry syscall EINTR
-            if (!ec && buffers.size() > 1) {
+            if (!ec && totalSize > 1) {
                 ec = asio::error::would_block;
             }
         } else {
@@ -620,10 +697,7 @@ private:
             // asio::write is a loop internally, so some of buffers may have been read into already.
             // So we need to adjust the buffers passed into async_write to be offset by size, if
             // size is > 0.
-            ConstBufferSequence asyncBuffers(buffers);
-            if (size > 0) {
-                asyncBuffers += size;
-            }
+            auto asyncBuffers = consumeBuffers(buffers, size);
 
             if (auto more = moreToSend(stream, asyncBuffers, baton)) {
                 return std::move(*more);
@@ -38,12 +38,16 @@
 #include <memory>
 
 #include "mongo/base/status.h"
+#include "mongo/config.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
 #include "mongo/transport/service_executor_synchronous.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
+#ifdef MONGO_CONFIG_IO_URING
+#include "mongo/transport/transport_layer_uring.h"
+#endif
 #include "mongo/util/net/ssl_types.h"
 #include "mongo/util/time_support.h"
 
@@ -140,6 +144,29 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     ctx->setServiceExecutor(std::make_unique<ServiceExecutorSynchronous>(ctx));
 
     std::vector<std::unique_ptr<TransportLayer>> retVector;
+    if (config->transportLayer == "uring") {
+#ifdef MONGO_CONFIG_IO_URING
+        if (TransportLayerUring::isSupported()) {
+            // The io_uring transport layer only serves ingress connections, so egress connections
+            // still go through ASIO. The manager routes connect() to its first transport layer.
+            opts.mode = transport::TransportLayerASIO::Options::kEgress;
+            opts.ipList.clear();
+            retVector.emplace_back(std::make_unique<transport::TransportLayerASIO>(opts, sep));
+            retVector.emplace_back(std::make_unique<transport::TransportLayerUring>(
+                transport::TransportLayerUring::Options(config), sep));
+            return std::make_unique<TransportLayerManager>(std::move(retVector));
+        }
+
+        LOGV2_WARNING(4859038,
+                      "The io_uring transport layer is not supported by this kernel, falling back "
+                      "to the asio transport layer");
+#else
+        LOGV2_WARNING(4859050,
+                      "This build does not support the io_uring transport layer, falling back to "
+                      "the asio transport layer");
+#endif
+    }
+
     retVector.emplace_back(std::make_unique<transport::TransportLayerASIO>(opts, sep));
     return std::make_unique<TransportLayerManager>(std::move(retVector));
 }
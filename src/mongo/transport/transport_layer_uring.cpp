@@ -0,0 +1,1113 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_uring.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <linux/time_types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <set>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mongo/db/stats/counters.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/message.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/transport/io_uring.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/session.h"
+#include "mongo/transport/transport_options_gen.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/functional.h"
+#include "mongo/util/net/socket_utils.h"
+#include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/net/ssl_options.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// Completions carrying this user_data (linked timeouts, cancellations) are not tracked.
+constexpr uint64_t kUntrackedOperation = 0;
+
+// Size of each registered message body buffer.
+constexpr size_t kRegisteredBufferSize = 16 * 1024;
+
+constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+// How long the listener waits before accepting again after running out of file descriptors or
+// memory. Accepting right away would fail the same way and keep the event loop busy.
+constexpr Milliseconds kAcceptErrorBackoff{100};
+
+// Completion results are rewritten by the event loop so that a cancellation requested through
+// cancelAsyncOperations(), one caused by a linked timeout expiring and one caused by shutdown can
+// be told apart.
+Status statusFromResult(int res) {
+    switch (-res) {
+        case 0:
+            return {ErrorCodes::HostUnreachable, "Connection closed by peer"};
+        case ETIME:
+            return {ErrorCodes::NetworkTimeout, "Socket operation timed out"};
+        case ECANCELED:
+            return {ErrorCodes::CallbackCanceled, "Callback was canceled"};
+        case ESHUTDOWN:
+            return TransportLayer::ShutdownStatus;
+        case ECONNRESET:
+            return {ErrorCodes::HostUnreachable, "Connection reset by peer"};
+        case ENETRESET:
+            return {ErrorCodes::HostUnreachable, "Connection reset by network"};
+        default:
+            return {ErrorCodes::SocketException, errnoWithDescription(-res)};
+    }
+}
+
+SockAddr getSocketAddress(int fd, bool peer) {
+    sockaddr_storage storage;
+    socklen_t len = sizeof(storage);
+    auto addr = reinterpret_cast<sockaddr*>(&storage);
+    int ret = peer ? ::getpeername(fd, addr, &len) : ::getsockname(fd, addr, &len);
+    if (ret != 0) {
+        uasserted(ErrorCodes::SocketException, errnoWithDescription(errno));
+    }
+    return SockAddr(addr, len);
+}
+
+}  // namespace
+
+/**
+ * A thread driving one io_uring instance.
+ *
+ * All socket operations of the sessions assigned to a loop are submitted and completed on the
+ * loop's thread. Other threads hand work to the loop with schedule(); the loop only pays for an
+ * eventfd wakeup when it is actually blocked waiting for completions.
+ */
+class TransportLayerUring::EventLoop {
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+public:
+    using Task = unique_function<void(Status)>;
+    using CompletionHandler = unique_function<void(int res, uint32_t flags)>;
+    using OperationId = uint64_t;
+
+    explicit EventLoop(size_t index) : _index(index) {}
+
+    ~EventLoop() {
+        stop();
+        if (_wakeFd >= 0) {
+            ::close(_wakeFd);
+        }
+    }
+
+    Status init(unsigned queueDepth, unsigned registeredBuffers) {
+        if (int ret = _ring.init(queueDepth); ret < 0) {
+            return {ErrorCodes::InternalError,
+                    str::stream() << "Failed to create io_uring instance: "
+                                  << errnoWithDescription(-ret)};
+        }
+
+        _wakeFd = ::eventfd(0, EFD_CLOEXEC);
+        if (_wakeFd < 0) {
+            return {ErrorCodes::InternalError,
+                    str::stream() << "Failed to create eventfd: " << errnoWithDescription(errno)};
+        }
+
+        if (registeredBuffers > 0) {
+            _buffers = std::make_unique<char[]>(registeredBuffers * kRegisteredBufferSize);
+            std::vector<iovec> iovecs(registeredBuffers);
+            for (unsigned i = 0; i < registeredBuffers; ++i) {
+                iovecs[i].iov_base = _buffers.get() + i * kRegisteredBufferSize;
+                iovecs[i].iov_len = kRegisteredBufferSize;
+            }
+
+            if (int ret = _ring.registerBuffers(iovecs.data(), registeredBuffers); ret < 0) {
+                LOGV2_WARNING(4859024,
+                              "Failed to register io_uring message buffers, message bodies will "
+                              "be read without them",
+                              "error"_attr = errnoWithDescription(-ret));
+                _buffers.reset();
+            } else {
+                for (int i = registeredBuffers - 1; i >= 0; --i) {
+                    _freeBuffers.push_back(i);
+                }
+            }
+        }
+
+        return Status::OK();
+    }
+
+    void start() {
+        _thread = stdx::thread([this] { _run(); });
+    }
+
+    /**
+     * Cancels all outstanding operations, waits for them to complete and joins the loop thread.
+     * Tasks scheduled afterwards are run with a ShutdownInProgress status.
+     */
+    void stop() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stopRequested = true;
+        }
+        _wake();
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+
+        std::vector<Task> tasks;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stopped = true;
+            tasks.swap(_tasks);
+        }
+        for (auto& task : tasks) {
+            task(TransportLayer::ShutdownStatus);
+        }
+    }
+
+    /**
+     * Runs 'task' on the loop thread with an OK status, or inline with a non-OK status if the
+     * loop has stopped.
+     */
+    void schedule(Task task) {
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            if (_stopped) {
+                lk.unlock();
+                task(TransportLayer::ShutdownStatus);
+                return;
+            }
+            _tasks.push_back(std::move(task));
+        }
+
+        if (_sleeping.load()) {
+            _wake();
+        }
+    }
+
+    /**
+     * Queues a submission prepared by 'prep' and returns an id that can be passed to cancel().
+     * If 'timeout' is set, the operation fails with ETIME unless it completes in time. Must be
+     * called on the loop thread.
+     */
+    template <typename Prep>
+    OperationId submit(Prep&& prep,
+                       CompletionHandler onComplete,
+                       boost::optional<Milliseconds> timeout = boost::none) {
+        if (_stopping) {
+            onComplete(-ESHUTDOWN, 0);
+            return kUntrackedOperation;
+        }
+
+        // A linked timeout must be published in the same io_uring_enter(2) call as the operation
+        // it guards, so make room for both up front.
+        _reserveSqes(timeout ? 2 : 1);
+
+        const auto id = _nextOperationId++;
+        auto& op = _inflight[id];
+        op.onComplete = std::move(onComplete);
+
+        auto sqe = _ring.getSqe();
+        prep(sqe);
+        sqe->user_data = id;
+
+        if (timeout) {
+            sqe->flags |= IOSQE_IO_LINK;
+            op.timeout.tv_sec = durationCount<Seconds>(*timeout);
+            op.timeout.tv_nsec = (timeout->count() % 1000) * 1000 * 1000;
+
+            auto timeoutSqe = _ring.getSqe();
+            timeoutSqe->opcode = IORING_OP_LINK_TIMEOUT;
+            timeoutSqe->fd = -1;
+            timeoutSqe->addr = reinterpret_cast<uint64_t>(&op.timeout);
+            timeoutSqe->len = 1;
+            timeoutSqe->user_data = kUntrackedOperation;
+        }
+
+        return id;
+    }
+
+    /**
+     * Requests cancellation of an operation returned by submit(). The operation completes with
+     * ECANCELED unless it already finished. Must be called on the loop thread.
+     */
+    void cancel(OperationId id) {
+        auto it = _inflight.find(id);
+        if (it == _inflight.end() || it->second.cancelRequested) {
+            return;
+        }
+        it->second.cancelRequested = true;
+
+        _reserveSqes(1);
+        auto sqe = _ring.getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = id;
+        sqe->user_data = kUntrackedOperation;
+    }
+
+    /**
+     * Calls 'onComplete' with ETIME once 'delay' has passed, or with ESHUTDOWN if the loop stops
+     * first. Must be called on the loop thread.
+     */
+    void waitFor(Milliseconds delay, CompletionHandler onComplete) {
+        if (_stopping) {
+            onComplete(-ESHUTDOWN, 0);
+            return;
+        }
+
+        _reserveSqes(1);
+
+        const auto id = _nextOperationId++;
+        auto& op = _inflight[id];
+        op.onComplete = std::move(onComplete);
+        op.timeout.tv_sec = durationCount<Seconds>(delay);
+        op.timeout.tv_nsec = (delay.count() % 1000) * 1000 * 1000;
+
+        auto sqe = _ring.getSqe();
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<uint64_t>(&op.timeout);
+        sqe->len = 1;
+        sqe->user_data = id;
+    }
+
+    /**
+     * Returns the index of a free registered buffer, or -1 if none is available. Must be called
+     * on the loop thread.
+     */
+    int acquireBuffer() {
+        if (_freeBuffers.empty()) {
+            return -1;
+        }
+        int index = _freeBuffers.back();
+        _freeBuffers.pop_back();
+        return index;
+    }
+
+    void releaseBuffer(int index) {
+        _freeBuffers.push_back(index);
+    }
+
+    char* buffer(int index) {
+        return _buffers.get() + index * kRegisteredBufferSize;
+    }
+
+private:
+    struct Operation {
+        CompletionHandler onComplete;
+        __kernel_timespec timeout{};
+        bool cancelRequested = false;
+    };
+
+    void _wake() {
+        uint64_t one = 1;
+        if (_wakeFd >= 0) {
+            // A failed write means the counter is already non-zero, so the loop will wake anyway.
+            (void)::write(_wakeFd, &one, sizeof(one));
+        }
+    }
+
+    void _reserveSqes(unsigned count) {
+        if (_ring.sqSpaceLeft() >= count) {
+            return;
+        }
+
+        int ret = _ring.submitAndWait(0);
+        invariant(_ring.sqSpaceLeft() >= count,
+                  str::stream() << "Failed to flush io_uring submissions: "
+                                << errnoWithDescription(-ret));
+    }
+
+    void _armWakeup() {
+        submit(
+            [&](io_uring_sqe* sqe) {
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = _wakeFd;
+                sqe->addr = reinterpret_cast<uint64_t>(&_wakeValue);
+                sqe->len = sizeof(_wakeValue);
+            },
+            [this](int res, uint32_t) {
+                if (res != -ESHUTDOWN) {
+                    _armWakeup();
+                }
+            });
+    }
+
+    void _complete(const io_uring_cqe& cqe) {
+        if (cqe.user_data == kUntrackedOperation) {
+            return;
+        }
+
+        auto it = _inflight.find(cqe.user_data);
+        invariant(it != _inflight.end());
+
+        int res = cqe.res;
+        if (res == -ECANCELED) {
+            if (!it->second.cancelRequested) {
+                // The only other source of cancellation is an expired linked timeout.
+                res = -ETIME;
+            } else if (_stopping) {
+                res = -ESHUTDOWN;
+            }
+        }
+
+        if (cqe.flags & IORING_CQE_F_MORE) {
+            it->second.onComplete(res, cqe.flags);
+            return;
+        }
+
+        auto onComplete = std::move(it->second.onComplete);
+        _inflight.erase(it);
+        onComplete(res, cqe.flags);
+    }
+
+    void _run() {
+        setThreadName(str::stream() << "uring-" << _index);
+        _armWakeup();
+
+        while (true) {
+            std::vector<Task> tasks;
+            bool beginStopping = false;
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                tasks.swap(_tasks);
+                beginStopping = _stopRequested && !_stopping;
+            }
+
+            for (auto& task : tasks) {
+                task(Status::OK());
+            }
+
+            if (beginStopping) {
+                _stopping = true;
+                for (auto&& op : _inflight) {
+                    cancel(op.first);
+                }
+            }
+
+            if (_stopping && _inflight.empty()) {
+                break;
+            }
+
+            // Announce that we are about to block before checking for work one last time, so that
+            // schedule() either sees us sleeping and wakes us or its task is picked up here.
+            _sleeping.store(true);
+            bool hasWork;
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                hasWork = !_tasks.empty() || (_stopRequested && !_stopping);
+            }
+
+            int ret = _ring.submitAndWait(hasWork ? 0 : 1);
+            _sleeping.store(false);
+            if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+                LOGV2_FATAL(4859025,
+                            "io_uring event loop failed",
+                            "error"_attr = errnoWithDescription(-ret));
+            }
+
+            _ring.forEachCompletion([&](const io_uring_cqe& cqe) { _complete(cqe); });
+        }
+
+        // Publish the final cancellations before the ring goes away.
+        _ring.submitAndWait(0);
+    }
+
+    const size_t _index;
+    IoUring _ring;
+    int _wakeFd = -1;
+    uint64_t _wakeValue = 0;
+    stdx::thread _thread;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("TransportLayerUring::EventLoop::_mutex");
+    std::vector<Task> _tasks;
+    bool _stopRequested = false;
+    bool _stopped = false;
+    AtomicWord<bool> _sleeping{false};
+
+    // Only accessed on the loop thread.
+    bool _stopping = false;
+    OperationId _nextOperationId = kUntrackedOperation + 1;
+    stdx::unordered_map<OperationId, Operation> _inflight;
+    std::unique_ptr<char[]> _buffers;
+    std::vector<int> _freeBuffers;
+};
+
+class TransportLayerUring::UringSession final : public Session {
+    UringSession(const UringSession&) = delete;
+    UringSession& operator=(const UringSession&) = delete;
+
+public:
+    // Takes ownership of 'fd'. May throw a DBException if the socket is already disconnected.
+    UringSession(TransportLayerUring* tl, EventLoop* loop, int fd)
+        : _tl(tl), _loop(loop), _fd(fd) {
+        _localAddr = getSocketAddress(_fd, false);
+        _remoteAddr = getSocketAddress(_fd, true);
+
+        auto family = _localAddr.getType();
+        if (family == AF_INET || family == AF_INET6) {
+            int on = 1;
+            ::setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            ::setsockopt(_fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+            setSocketKeepAliveParams(_fd);
+        }
+
+        _local = HostAndPort(_localAddr.toString(true));
+        _remote = HostAndPort(_remoteAddr.toString(true));
+    }
+
+    ~UringSession() {
+        ::close(_fd);
+    }
+
+    TransportLayer* getTransportLayer() const override {
+        return _tl;
+    }
+
+    const HostAndPort& remote() const override {
+        return _remote;
+    }
+
+    const HostAndPort& local() const override {
+        return _local;
+    }
+
+    const SockAddr& remoteAddr() const override {
+        return _remoteAddr;
+    }
+
+    const SockAddr& localAddr() const override {
+        return _localAddr;
+    }
+
+    void end() override {
+        // Shutting the socket down fails any outstanding operations. The descriptor itself is only
+        // closed once no operation can reference it anymore.
+        if (!_ended.swap(true)) {
+            ::shutdown(_fd, SHUT_RDWR);
+        }
+    }
+
+    StatusWith<Message> sourceMessage() override {
+        return _sourceMessage(_configuredTimeout).getNoThrow();
+    }
+
+    Future<Message> asyncSourceMessage(const BatonHandle& baton = nullptr) override {
+        return _sourceMessage(boost::none);
+    }
+
+    Status sinkMessage(Message message) override {
+        return _sinkMessage(std::move(message), _configuredTimeout).getNoThrow();
+    }
+
+    Future<void> asyncSinkMessage(Message message, const BatonHandle& baton = nullptr) override {
+        return _sinkMessage(std::move(message), boost::none);
+    }
+
+    void cancelAsyncOperations(const BatonHandle& baton = nullptr) override {
+        LOGV2_DEBUG(4859026,
+                    3,
+                    "Cancelling outstanding I/O operations on connection to remote",
+                    "remote"_attr = _remote);
+        _loop->schedule([this, self = _self()](Status status) {
+            if (!status.isOK()) {
+                return;
+            }
+            _loop->cancel(_readOp);
+            _loop->cancel(_writeOp);
+        });
+    }
+
+    void setTimeout(boost::optional<Milliseconds> timeout) override {
+        invariant(!timeout || timeout->count() > 0);
+        _configuredTimeout = timeout;
+    }
+
+    bool isConnected() override {
+        if (_ended.load()) {
+            return false;
+        }
+
+        pollfd pfd;
+        pfd.fd = _fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ret = ::poll(&pfd, 1, 0);
+        if (ret < 0) {
+            LOGV2_WARNING(4859027,
+                          "Failed to poll socket for connectivity check",
+                          "error"_attr = errnoWithDescription(errno));
+            return false;
+        }
+        if (ret == 0) {
+            return true;
+        }
+
+        if (pfd.revents & POLLIN) {
+            char testByte;
+            int size = ::recv(_fd, &testByte, sizeof(testByte), MSG_PEEK);
+            if (size == sizeof(testByte)) {
+                return true;
+            } else if (size == -1) {
+                LOGV2_WARNING(4859028,
+                              "Failed to check socket connectivity",
+                              "error"_attr = errnoWithDescription(errno));
+            }
+            // If size == 0 then we got disconnected and we should return false.
+        }
+
+        return false;
+    }
+
+#ifdef MONGO_CONFIG_SSL
+    const SSLConfiguration* getSSLConfiguration() const override {
+        auto sslManager = getSSLManager();
+        if (!sslManager) {
+            return nullptr;
+        }
+
+        return &sslManager->getSSLConfiguration();
+    }
+#endif
+
+private:
+    std::shared_ptr<UringSession> _self() {
+        return std::static_pointer_cast<UringSession>(shared_from_this());
+    }
+
+    Future<Message> _sourceMessage(boost::optional<Milliseconds> timeout) {
+        if (_ended.load()) {
+            return Future<Message>::makeReady(Session::ClosedStatus);
+        }
+
+        auto pf = makePromiseFuture<Message>();
+        _loop->schedule([this, self = _self(), promise = std::move(pf.promise), timeout](
+                            Status status) mutable {
+            if (!status.isOK()) {
+                return promise.setError(status);
+            }
+            _readHeader(std::move(promise), timeout);
+        });
+        return std::move(pf.future);
+    }
+
+    Future<void> _sinkMessage(Message message, boost::optional<Milliseconds> timeout) {
+        if (_ended.load()) {
+            return Future<void>::makeReady(Session::ClosedStatus);
+        }
+
+        auto pf = makePromiseFuture<void>();
+        _loop->schedule([this,
+                         self = _self(),
+                         message = std::move(message),
+                         promise = std::move(pf.promise),
+                         timeout](Status status) mutable {
+            if (!status.isOK()) {
+                return promise.setError(status);
+            }
+
+            auto data = message.buf();
+            auto size = message.size();
+            _send(data,
+                  size,
+                  timeout,
+                  [message = std::move(message), promise = std::move(promise)](
+                      Status status) mutable {
+                      if (!status.isOK()) {
+                          return promise.setError(status);
+                      }
+                      networkCounter.hitPhysicalOut(message.size());
+                      promise.emplaceValue();
+                  });
+        });
+        return std::move(pf.future);
+    }
+
+    void _readHeader(Promise<Message> promise, boost::optional<Milliseconds> timeout) {
+        auto header = SharedBuffer::allocate(kHeaderSize);
+        auto headerData = header.get();
+        _recv(headerData,
+              kHeaderSize,
+              timeout,
+              [this, header = std::move(header), promise = std::move(promise), timeout](
+                  Status status) mutable {
+                  if (!status.isOK()) {
+                      return promise.setError(status);
+                  }
+                  _readBody(std::move(header), std::move(promise), timeout);
+              });
+    }
+
+    void _readBody(SharedBuffer header,
+                   Promise<Message> promise,
+                   boost::optional<Milliseconds> timeout) {
+        const auto msgLen = size_t(MSGHEADER::View(header.get()).getMessageLength());
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            LOGV2(4859029,
+                  "recv(): message msgLen is invalid",
+                  "msgLen"_attr = msgLen,
+                  "min"_attr = kHeaderSize,
+                  "max"_attr = MaxMessageSizeBytes);
+            return promise.setError({ErrorCodes::ProtocolError,
+                                     str::stream() << "recv(): message msgLen " << msgLen
+                                                   << " is invalid. Min " << kHeaderSize
+                                                   << " Max: " << MaxMessageSizeBytes});
+        }
+
+        if (msgLen == kHeaderSize) {
+            networkCounter.hitPhysicalIn(msgLen);
+            return promise.emplaceValue(Message(std::move(header)));
+        }
+
+        auto buffer = SharedBuffer::allocate(msgLen);
+        memcpy(buffer.get(), header.get(), kHeaderSize);
+
+        MsgData::View msgView(buffer.get());
+        auto body = msgView.data();
+        size_t bodyLen = msgView.dataLen();
+        auto onBody = [buffer = std::move(buffer), promise = std::move(promise), msgLen](
+                          Status status) mutable {
+            if (!status.isOK()) {
+                return promise.setError(status);
+            }
+            networkCounter.hitPhysicalIn(msgLen);
+            promise.emplaceValue(Message(std::move(buffer)));
+        };
+
+        int bufferIndex = bodyLen <= kRegisteredBufferSize ? _loop->acquireBuffer() : -1;
+        if (bufferIndex >= 0) {
+            _readFixed(bufferIndex, body, bodyLen, 0, timeout, std::move(onBody));
+        } else {
+            _recv(body, bodyLen, timeout, std::move(onBody));
+        }
+    }
+
+    // Receives exactly 'len' bytes into 'data'.
+    void _recv(char* data,
+               size_t len,
+               boost::optional<Milliseconds> timeout,
+               unique_function<void(Status)> onDone) {
+        _readOp = _loop->submit(
+            [&](io_uring_sqe* sqe) {
+                sqe->opcode = IORING_OP_RECV;
+                sqe->fd = _fd;
+                sqe->addr = reinterpret_cast<uint64_t>(data);
+                sqe->len = len;
+                sqe->msg_flags = MSG_WAITALL;
+            },
+            [this, self = _self(), data, len, timeout, onDone = std::move(onDone)](
+                int res, uint32_t) mutable {
+                _readOp = kNoOperation;
+                if (res <= 0) {
+                    return onDone(statusFromResult(res));
+                }
+                if (size_t(res) < len) {
+                    return _recv(data + res, len - res, timeout, std::move(onDone));
+                }
+                onDone(Status::OK());
+            },
+            timeout);
+    }
+
+    // Reads exactly 'len' bytes into the registered buffer 'bufferIndex', starting at 'offset',
+    // then copies them to 'data' and releases the buffer.
+    void _readFixed(int bufferIndex,
+                    char* data,
+                    size_t len,
+                    size_t offset,
+                    boost::optional<Milliseconds> timeout,
+                    unique_function<void(Status)> onDone) {
+        _readOp = _loop->submit(
+            [&](io_uring_sqe* sqe) {
+                sqe->opcode = IORING_OP_READ_FIXED;
+                sqe->fd = _fd;
+                sqe->addr = reinterpret_cast<uint64_t>(_loop->buffer(bufferIndex) + offset);
+                sqe->len = len - offset;
+                sqe->buf_index = bufferIndex;
+            },
+            [this,
+             self = _self(),
+             bufferIndex,
+             data,
+             len,
+             offset,
+             timeout,
+             onDone = std::move(onDone)](int res, uint32_t) mutable {
+                _readOp = kNoOperation;
+                if (res > 0 && offset + res < len) {
+                    return _readFixed(
+                        bufferIndex, data, len, offset + res, timeout, std::move(onDone));
+                }
+
+                if (res > 0) {
+                    memcpy(data, _loop->buffer(bufferIndex), len);
+                }
+                _loop->releaseBuffer(bufferIndex);
+                onDone(res > 0 ? Status::OK() : statusFromResult(res));
+            },
+            timeout);
+    }
+
+    // Sends exactly 'len' bytes from 'data'.
+    void _send(const char* data,
+               size_t len,
+               boost::optional<Milliseconds> timeout,
+               unique_function<void(Status)> onDone) {
+        _writeOp = _loop->submit(
+            [&](io_uring_sqe* sqe) {
+                sqe->opcode = IORING_OP_SEND;
+                sqe->fd = _fd;
+                sqe->addr = reinterpret_cast<uint64_t>(data);
+                sqe->len = len;
+                sqe->msg_flags = MSG_NOSIGNAL;
+            },
+            [this, self = _self(), data, len, timeout, onDone = std::move(onDone)](
+                int res, uint32_t) mutable {
+                _writeOp = kNoOperation;
+                if (res < 0) {
+                    return onDone(statusFromResult(res));
+                }
+                if (size_t(res) < len) {
+                    return _send(data + res, len - res, timeout, std::move(onDone));
+                }
+                onDone(Status::OK());
+            },
+            timeout);
+    }
+
+    static constexpr EventLoop::OperationId kNoOperation = kUntrackedOperation;
+
+    TransportLayerUring* const _tl;
+    EventLoop* const _loop;
+    const int _fd;
+
+    HostAndPort _remote;
+    HostAndPort _local;
+    SockAddr _remoteAddr;
+    SockAddr _localAddr;
+
+    boost::optional<Milliseconds> _configuredTimeout;
+    AtomicWord<bool> _ended{false};
+
+    // Only accessed on the loop thread.
+    EventLoop::OperationId _readOp = kNoOperation;
+    EventLoop::OperationId _writeOp = kNoOperation;
+};
+
+TransportLayerUring::Options::Options(const ServerGlobalParams* params)
+    : port(params->port),
+      ipList(params->bind_ips),
+      useUnixSockets(!params->noUnixSocket),
+      enableIPv6(params->enableIPv6) {}
+
+TransportLayerUring::TransportLayerUring(const Options& opts, ServiceEntryPoint* sep)
+    : _sep(sep), _listenerOptions(opts) {}
+
+TransportLayerUring::~TransportLayerUring() {
+    shutdown();
+}
+
+bool TransportLayerUring::isSupported() {
+    return IoUring::isSupported();
+}
+
+StatusWith<SessionHandle> TransportLayerUring::connect(HostAndPort peer,
+                                                       ConnectSSLMode sslMode,
+                                                       Milliseconds timeout) {
+    return {ErrorCodes::NotImplemented,
+            "The io_uring transport layer does not support egress connections"};
+}
+
+Future<SessionHandle> TransportLayerUring::asyncConnect(HostAndPort peer,
+                                                        ConnectSSLMode sslMode,
+                                                        const ReactorHandle& reactor,
+                                                        Milliseconds timeout) {
+    return Future<SessionHandle>::makeReady(
+        Status(ErrorCodes::NotImplemented,
+               "The io_uring transport layer does not support egress connections"));
+}
+
+ReactorHandle TransportLayerUring::getReactor(WhichReactor which) {
+    return nullptr;
+}
+
+Status TransportLayerUring::setup() {
+#ifdef MONGO_CONFIG_SSL
+    if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+        return {ErrorCodes::InvalidOptions, "The io_uring transport layer does not support TLS"};
+    }
+#endif
+
+    std::vector<std::string> listenAddrs = _listenerOptions.ipList;
+    if (listenAddrs.empty()) {
+        listenAddrs = {"127.0.0.1"};
+        if (_listenerOptions.enableIPv6) {
+            listenAddrs.emplace_back("::1");
+        }
+    }
+    if (_listenerOptions.useUnixSockets) {
+        listenAddrs.emplace_back(makeUnixSockPath(_listenerOptions.port));
+    }
+
+    _listenerPort = _listenerOptions.port;
+
+    // Self-deduplicating list of unique endpoint addresses.
+    std::set<std::string> seen;
+    std::vector<SockAddr> endpoints;
+    for (auto& ip : listenAddrs) {
+        if (ip.empty()) {
+            LOGV2_WARNING(4859030, "Skipping empty bind address");
+            continue;
+        }
+
+        auto addrs = SockAddr::createAll(
+            ip, _listenerPort, _listenerOptions.enableIPv6 ? AF_UNSPEC : AF_INET);
+        if (addrs.empty()) {
+            LOGV2_WARNING(4859031, "Found no addresses for bind address", "address"_attr = ip);
+            continue;
+        }
+        for (auto& addr : addrs) {
+            if (seen.insert(addr.toString()).second) {
+                endpoints.push_back(std::move(addr));
+            }
+        }
+    }
+
+    auto socketError = [](StringData what, const SockAddr& addr) {
+        return Status(ErrorCodes::SocketException,
+                      str::stream() << "Failed to " << what << " " << addr.toString() << ": "
+                                    << errnoWithDescription(errno));
+    };
+
+    for (auto& addr : endpoints) {
+        const auto family = addr.getType();
+        if (family == AF_UNIX) {
+            if (::unlink(addr.getAddr().c_str()) == -1 && errno != ENOENT) {
+                return socketError("unlink socket file", addr);
+            }
+        }
+        if (family == AF_INET6 && !_listenerOptions.enableIPv6) {
+            return {ErrorCodes::BadValue, "Specified ipv6 bind address, but ipv6 is disabled"};
+        }
+
+        int fd = ::socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return socketError("open listening socket for", addr);
+        }
+        _listeners.emplace_back(addr, fd);
+
+        int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (family == AF_INET6) {
+            ::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &on, sizeof(on));
+        }
+
+        if (::bind(fd, addr.raw(), addr.addressSize) != 0) {
+            return socketError("bind to", addr);
+        }
+
+        if (family == AF_UNIX) {
+            if (::chmod(addr.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
+                return socketError("chmod socket file", addr);
+            }
+        }
+
+        if (_listenerOptions.port == 0 && (family == AF_INET || family == AF_INET6)) {
+            if (_listenerPort != _listenerOptions.port) {
+                return Status(ErrorCodes::BadValue,
+                              "Port 0 (ephemeral port) is not allowed when"
+                              " listening on multiple IP interfaces");
+            }
+            _listenerPort = getSocketAddress(fd, false).getPort();
+        }
+    }
+
+    if (_listeners.empty()) {
+        return Status(ErrorCodes::SocketException, "No available addresses/ports to bind to");
+    }
+
+    size_t numLoops = gUringEventLoopThreads;
+    if (numLoops == 0) {
+        numLoops = std::max(1u, stdx::thread::hardware_concurrency() / 4);
+    }
+
+    for (size_t i = 0; i < numLoops; ++i) {
+        auto loop = std::make_unique<EventLoop>(i);
+        auto status = loop->init(gUringQueueDepth, gUringRegisteredBuffers);
+        if (!status.isOK()) {
+            return status;
+        }
+        _loops.push_back(std::move(loop));
+    }
+
+    return Status::OK();
+}
+
+Status TransportLayerUring::start() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_isShutdown) {
+        return ShutdownStatus;
+    }
+
+    for (auto& listener : _listeners) {
+        if (::listen(listener.second, serverGlobalParams.listenBacklog) != 0) {
+            return Status(ErrorCodes::SocketException,
+                          str::stream()
+                              << "Error listening for new connections on "
+                              << listener.first.toString() << ": " << errnoWithDescription(errno));
+        }
+    }
+
+    for (auto& loop : _loops) {
+        loop->start();
+    }
+
+    for (auto& listener : _listeners) {
+        _loops.front()->schedule([this, fd = listener.second](Status status) {
+            if (status.isOK()) {
+                _acceptConnections(fd, true);
+            }
+        });
+        LOGV2(4859032, "Listening on", "address"_attr = listener.first.getAddr());
+    }
+
+    LOGV2(4859033,
+          "Waiting for connections on io_uring transport layer",
+          "port"_attr = _listenerPort,
+          "eventLoops"_attr = _loops.size());
+    return Status::OK();
+}
+
+void TransportLayerUring::shutdown() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_isShutdown) {
+            return;
+        }
+        _isShutdown = true;
+    }
+
+    // Stopping the loops cancels the outstanding accepts and session operations.
+    for (auto& loop : _loops) {
+        loop->stop();
+    }
+
+    for (auto& listener : _listeners) {
+        ::close(listener.second);
+        auto& addr = listener.first;
+        if (addr.getType() == AF_UNIX && !addr.isAnonymousUNIXSocket()) {
+            ::unlink(addr.getAddr().c_str());
+        }
+    }
+    _listeners.clear();
+}
+
+void TransportLayerUring::_acceptConnections(int listenFd, bool multishot) {
+    _loops.front()->submit(
+        [&](io_uring_sqe* sqe) {
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = listenFd;
+            sqe->accept_flags = SOCK_CLOEXEC;
+            if (multishot) {
+                sqe->ioprio |= IORING_ACCEPT_MULTISHOT;
+            }
+        },
+        [this, listenFd, multishot](int res, uint32_t flags) {
+            _onAccept(listenFd, res, flags, multishot);
+        });
+}
+
+void TransportLayerUring::_onAccept(int listenFd, int res, uint32_t flags, bool multishot) {
+    if (res == -ESHUTDOWN) {
+        return;
+    }
+
+    if (res == -EINVAL && multishot) {
+        LOGV2_DEBUG(4859034, 1, "Multishot accept is not supported, accepting one at a time");
+        return _acceptConnections(listenFd, false);
+    }
+
+    if (res < 0) {
+        LOGV2(4859035,
+              "Error accepting new connection",
+              "error"_attr = errnoWithDescription(-res));
+
+        const bool outOfResources =
+            res == -EMFILE || res == -ENFILE || res == -ENOBUFS || res == -ENOMEM;
+        if (outOfResources && !(flags & IORING_CQE_F_MORE)) {
+            _loops.front()->waitFor(kAcceptErrorBackoff,
+                                    [this, listenFd, multishot](int waitRes, uint32_t) {
+                                        if (waitRes != -ESHUTDOWN) {
+                                            _acceptConnections(listenFd, multishot);
+                                        }
+                                    });
+            return;
+        }
+    } else {
+        auto loop = _loops[_nextLoop.fetchAndAdd(1) % _loops.size()].get();
+        std::shared_ptr<UringSession> session;
+        try {
+            session = std::make_shared<UringSession>(this, loop, res);
+        } catch (const DBException& e) {
+            ::close(res);
+            LOGV2_WARNING(4859036, "Error accepting new connection", "error"_attr = e);
+        }
+
+        if (session) {
+            try {
+                _sep->startSession(std::move(session));
+            } catch (const DBException& e) {
+                LOGV2_WARNING(4859037, "Error starting new session", "error"_attr = e);
+            }
+        }
+    }
+
+    // A multishot accept keeps producing completions until the kernel reports otherwise.
+    if (!(flags & IORING_CQE_F_MORE)) {
+        _acceptConnections(listenFd, multishot);
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
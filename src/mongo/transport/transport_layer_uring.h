@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/net/sockaddr.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+namespace transport {
+
+/**
+ * A TransportLayer that accepts and serves ingress connections using Linux io_uring.
+ *
+ * Connections are spread across a fixed number of event loop threads, each of which owns an
+ * io_uring instance. Every loop iteration publishes all queued socket operations with a single
+ * io_uring_enter(2) call and reaps their completions in bulk, so a busy loop pays one system call
+ * for many connections. Listening sockets use multishot accept where the kernel supports it, and
+ * message bodies that fit in a slot are read into buffers registered with the ring.
+ *
+ * This transport layer only handles ingress traffic without TLS; egress connections are left to
+ * TransportLayerASIO by TransportLayerManager.
+ */
+class TransportLayerUring final : public TransportLayer {
+    TransportLayerUring(const TransportLayerUring&) = delete;
+    TransportLayerUring& operator=(const TransportLayerUring&) = delete;
+
+public:
+    struct Options {
+        explicit Options(const ServerGlobalParams* params);
+        Options() = default;
+
+        int port = ServerGlobalParams::DefaultDBPort;  // port to bind to
+        std::vector<std::string> ipList;               // addresses to bind to
+        bool useUnixSockets = true;                    // whether to allow UNIX sockets in ipList
+        bool enableIPv6 = false;                       // whether to allow IPv6 sockets in ipList
+    };
+
+    TransportLayerUring(const Options& opts, ServiceEntryPoint* sep);
+
+    ~TransportLayerUring() override;
+
+    /**
+     * Returns true if the running kernel provides the io_uring features this transport layer
+     * needs.
+     */
+    static bool isSupported();
+
+    StatusWith<SessionHandle> connect(HostAndPort peer,
+                                      ConnectSSLMode sslMode,
+                                      Milliseconds timeout) final;
+
+    Future<SessionHandle> asyncConnect(HostAndPort peer,
+                                       ConnectSSLMode sslMode,
+                                       const ReactorHandle& reactor,
+                                       Milliseconds timeout) final;
+
+    Status setup() final;
+
+    Status start() final;
+
+    void shutdown() final;
+
+    ReactorHandle getReactor(WhichReactor which) final;
+
+    int listenerPort() const {
+        return _listenerPort;
+    }
+
+private:
+    class EventLoop;
+    class UringSession;
+
+    void _acceptConnections(int listenFd, bool multishot);
+
+    void _onAccept(int listenFd, int res, uint32_t flags, bool multishot);
+
+    Mutex _mutex = MONGO_MAKE_LATCH("TransportLayerUring::_mutex");
+
+    ServiceEntryPoint* const _sep;
+    const Options _listenerOptions;
+
+    std::vector<std::pair<SockAddr, int>> _listeners;
+    std::vector<std::unique_ptr<EventLoop>> _loops;
+    AtomicWord<unsigned> _nextLoop{0};
+
+    int _listenerPort = 0;
+    bool _isShutdown = false;
+};
+
+}  // namespace transport
+}  // namespace mongo
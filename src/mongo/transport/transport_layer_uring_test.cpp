@@ -0,0 +1,251 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kTest
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_uring.h"
+
+#include "mongo/db/server_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+namespace {
+
+class ServiceEntryPointUring : public ServiceEntryPoint {
+public:
+    void startSession(transport::SessionHandle session) override {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _sessions.push_back(std::move(session));
+        _cv.notify_one();
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {
+        std::vector<transport::SessionHandle> oldSessions;
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            oldSessions.swap(_sessions);
+        }
+        for (auto& session : oldSessions) {
+            session->end();
+        }
+    }
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::unique_lock<Latch> lk(_mutex);
+        return _sessions.size();
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx, const Message& request) override {
+        MONGO_UNREACHABLE;
+    }
+
+    transport::SessionHandle waitForSession() {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cv.wait(lk, [&] { return !_sessions.empty(); });
+        return _sessions.back();
+    }
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ServiceEntryPointUring::_mutex");
+    stdx::condition_variable _cv;
+    std::vector<transport::SessionHandle> _sessions;
+};
+
+bool uringUnsupported() {
+    if (transport::TransportLayerUring::isSupported()) {
+        return false;
+    }
+    LOGV2(4859039, "Skipping test, io_uring is not supported by this kernel");
+    return true;
+}
+
+std::unique_ptr<transport::TransportLayerUring> makeTransportLayer(ServiceEntryPoint* sep) {
+    ServerGlobalParams params;
+    params.noUnixSocket = true;
+    transport::TransportLayerUring::Options opts(&params);
+    opts.port = 0;
+
+    auto tl = std::make_unique<transport::TransportLayerUring>(opts, sep);
+    ASSERT_OK(tl->setup());
+    ASSERT_OK(tl->start());
+    ASSERT_GT(tl->listenerPort(), 0);
+    return tl;
+}
+
+void connectTo(Socket* socket, int port) {
+    SockAddr sa{"localhost", port, AF_INET};
+    ASSERT(socket->connect(sa));
+}
+
+TEST(TransportLayerUring, PortZeroConnect) {
+    if (uringUnsupported()) {
+        return;
+    }
+
+    ServiceEntryPointUring sep;
+    auto tl = makeTransportLayer(&sep);
+    LOGV2(4859040, "TransportLayerUring.listenerPort()", "port"_attr = tl->listenerPort());
+
+    Socket client;
+    connectTo(&client, tl->listenerPort());
+    auto session = sep.waitForSession();
+    ASSERT(session->isConnected());
+
+    sep.endAllSessions({});
+    ASSERT_FALSE(session->isConnected());
+    tl->shutdown();
+}
+
+TEST(TransportLayerUring, SourceAndSinkMessages) {
+    if (uringUnsupported()) {
+        return;
+    }
+
+    ServiceEntryPointUring sep;
+    auto tl = makeTransportLayer(&sep);
+
+    Socket client;
+    connectTo(&client, tl->listenerPort());
+    auto session = sep.waitForSession();
+
+    // The small body is read through a registered buffer, the large one directly into the
+    // message.
+    for (size_t padSize : {16, 64 * 1024}) {
+        auto request = OpMsgRequest::fromDBAndBody(
+                           "admin", BSON("ping" << 1 << "pad" << std::string(padSize, 'x')))
+                           .serialize();
+        client.send(request.buf(), request.size(), "request");
+
+        auto swMessage = session->sourceMessage();
+        ASSERT_OK(swMessage.getStatus());
+        auto& message = swMessage.getValue();
+        ASSERT_EQ(message.size(), request.size());
+        ASSERT_EQ(memcmp(message.buf(), request.buf(), request.size()), 0);
+
+        ASSERT_OK(session->sinkMessage(message));
+        std::vector<char> reply(request.size());
+        client.recv(reply.data(), reply.size());
+        ASSERT_EQ(memcmp(reply.data(), request.buf(), request.size()), 0);
+    }
+
+    tl->shutdown();
+}
+
+TEST(TransportLayerUring, SourceMessageTimesOut) {
+    if (uringUnsupported()) {
+        return;
+    }
+
+    ServiceEntryPointUring sep;
+    auto tl = makeTransportLayer(&sep);
+
+    Socket client;
+    connectTo(&client, tl->listenerPort());
+    auto session = sep.waitForSession();
+
+    session->setTimeout(Milliseconds(100));
+    ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::NetworkTimeout);
+
+    tl->shutdown();
+}
+
+TEST(TransportLayerUring, CancelAsyncSourceMessage) {
+    if (uringUnsupported()) {
+        return;
+    }
+
+    ServiceEntryPointUring sep;
+    auto tl = makeTransportLayer(&sep);
+
+    Socket client;
+    connectTo(&client, tl->listenerPort());
+    auto session = sep.waitForSession();
+
+    auto future = session->asyncSourceMessage();
+    session->cancelAsyncOperations();
+    ASSERT_EQ(future.getNoThrow().getStatus(), ErrorCodes::CallbackCanceled);
+
+    tl->shutdown();
+}
+
+TEST(TransportLayerUring, ShutdownFailsOutstandingOperations) {
+    if (uringUnsupported()) {
+        return;
+    }
+
+    ServiceEntryPointUring sep;
+    auto tl = makeTransportLayer(&sep);
+
+    Socket client;
+    connectTo(&client, tl->listenerPort());
+    auto session = sep.waitForSession();
+
+    auto future = session->asyncSourceMessage();
+    tl->shutdown();
+    ASSERT_EQ(future.getNoThrow().getStatus(), ErrorCodes::ShutdownInProgress);
+    ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::ShutdownInProgress);
+}
+
+TEST(TransportLayerUring, PeerClosingFailsSourceMessage) {
+    if (uringUnsupported()) {
+        return;
+    }
+
+    ServiceEntryPointUring sep;
+    auto tl = makeTransportLayer(&sep);
+
+    auto client = std::make_unique<Socket>();
+    connectTo(client.get(), tl->listenerPort());
+    auto session = sep.waitForSession();
+
+    client.reset();
+    ASSERT_EQ(session->sourceMessage().getStatus(), ErrorCodes::HostUnreachable);
+
+    tl->shutdown();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
+
+#include <algorithm>
+
+namespace mongo {
+namespace {
+
+// Latency within this factor of the base means extra tickets are still paying off.
+constexpr double kIncreaseThreshold = 1.25;
+
+// Latency beyond this factor of the base means operations mostly queue inside the engine.
+constexpr double kDecreaseThreshold = 2.0;
+
+// Additive steps are this fraction of the current ticket count, and never less than one ticket.
+constexpr int kStepDivisor = 16;
+
+// The multiplicative cut applied on cache pressure.
+constexpr double kCachePressureFactor = 0.75;
+
+// The base latency drifts up by this factor each interval, so that it follows a workload whose
+// operations became more expensive instead of holding on to a minimum it can never reach again.
+constexpr double kBaseLatencyDrift = 1.01;
+
+}  // namespace
+
+int AdaptiveTicketController::update(const Observation& observation,
+                                     int minTickets,
+                                     int maxTickets) {
+    const auto seconds = durationCount<Microseconds>(observation.interval) / 1'000'000.0;
+    const bool measured = observation.released > 0 && seconds > 0;
+    if (measured) {
+        _throughput = observation.released / seconds;
+        _latency = observation.averageInUse / _throughput * 1'000'000.0;
+        _baseLatency =
+            _baseLatency > 0 ? std::min(_baseLatency * kBaseLatencyDrift, _latency) : _latency;
+    }
+
+    auto target = observation.totalTickets;
+    const auto step = std::max(1, target / kStepDivisor);
+    if (observation.cachePressure) {
+        target = static_cast<int>(target * kCachePressureFactor);
+    } else if (measured && observation.queued) {
+        if (_latency <= _baseLatency * kIncreaseThreshold) {
+            target += step;
+        } else if (_latency >= _baseLatency * kDecreaseThreshold) {
+            target -= step;
+        }
+    }
+    target = std::clamp(target, minTickets, maxTickets);
+
+    if (target > observation.totalTickets) {
+        _lastDecision = Decision::kIncrease;
+        ++_increases;
+    } else if (target < observation.totalTickets) {
+        _lastDecision = Decision::kDecrease;
+        ++_decreases;
+        if (observation.cachePressure) {
+            ++_cachePressureDecreases;
+        }
+    } else {
+        _lastDecision = Decision::kHold;
+    }
+    _totalTickets = target;
+
+    return target;
+}
+
+void AdaptiveTicketController::appendStats(BSONObjBuilder* builder) const {
+    builder->append("totalTickets", _totalTickets);
+    switch (_lastDecision) {
+        case Decision::kHold:
+            builder->append("lastDecision", "hold"_sd);
+            break;
+        case Decision::kIncrease:
+            builder->append("lastDecision", "increase"_sd);
+            break;
+        case Decision::kDecrease:
+            builder->append("lastDecision", "decrease"_sd);
+            break;
+    }
+    builder->append("throughputPerSec", static_cast<long long>(_throughput));
+    builder->append("latencyMicros", static_cast<long long>(_latency));
+    builder->append("baseLatencyMicros", static_cast<long long>(_baseLatency));
+    builder->append("increases", _increases);
+    builder->append("decreases", _decreases);
+    builder->append("cachePressureDecreases", _cachePressureDecreases);
+}
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+/**
+ * Decides how many tickets a TicketHolder should hand out from what the operations holding them
+ * achieve, in the manner of TCP Vegas. The time an operation holds its ticket is derived from the
+ * throughput and the average number of tickets in use (Little's law), and compared with the lowest
+ * such latency seen recently. While operations queue for tickets and latency stays near that base,
+ * more concurrency turns into more throughput and the ticket count grows additively. Once latency
+ * climbs well above the base, extra tickets only queue work up inside the storage engine and the
+ * count shrinks by the same step. Cache pressure in the storage engine overrides both and cuts the
+ * count multiplicatively, the way AIMD reacts to loss.
+ *
+ * Not thread safe, it is meant to be driven by a single background thread.
+ */
+class AdaptiveTicketController {
+public:
+    /**
+     * What was seen of a TicketHolder over one adjustment interval.
+     */
+    struct Observation {
+        // The time the observation covers.
+        Milliseconds interval;
+
+        // The number of tickets handed out during the interval.
+        int totalTickets = 0;
+
+        // The number of tickets released, i.e. operations finished with their ticket.
+        long long released = 0;
+
+        // The average number of tickets in use.
+        double averageInUse = 0;
+
+        // Whether any operation had to wait for a ticket.
+        bool queued = false;
+
+        // Whether the storage engine cache is full enough that application threads are drawn
+        // into eviction.
+        bool cachePressure = false;
+    };
+
+    /**
+     * Returns the number of tickets to hand out next, between 'minTickets' and 'maxTickets'.
+     */
+    int update(const Observation& observation, int minTickets, int maxTickets);
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    enum class Decision { kHold, kIncrease, kDecrease };
+
+    Decision _lastDecision = Decision::kHold;
+    int _totalTickets = 0;
+
+    // Operations finished per second and the latency of holding a ticket, in microseconds, over
+    // the last interval that saw any operation finish.
+    double _throughput = 0;
+    double _latency = 0;
+    double _baseLatency = 0;
+
+    long long _increases = 0;
+    long long _decreases = 0;
+    long long _cachePressureDecreases = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/adaptive_ticket_controller.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns an observation over 100ms of 'totalTickets' tickets all in use, during which 'released'
+ * of them were released.
+ */
+AdaptiveTicketController::Observation makeObservation(int totalTickets,
+                                                      long long released,
+                                                      bool queued = true,
+                                                      bool cachePressure = false) {
+    AdaptiveTicketController::Observation observation;
+    observation.interval = Milliseconds(100);
+    observation.totalTickets = totalTickets;
+    observation.released = released;
+    observation.averageInUse = totalTickets;
+    observation.queued = queued;
+    observation.cachePressure = cachePressure;
+    return observation;
+}
+
+BSONObj getStats(const AdaptiveTicketController& controller) {
+    BSONObjBuilder builder;
+    controller.appendStats(&builder);
+    return builder.obj();
+}
+
+TEST(AdaptiveTicketControllerTest, IncreasesWhileLatencyStaysNearTheBase) {
+    AdaptiveTicketController controller;
+
+    // 64 tickets releasing 64 operations a millisecond is 1ms per operation.
+    ASSERT_EQ(68, controller.update(makeObservation(64, 6400), 5, 256));
+    ASSERT_EQ(72, controller.update(makeObservation(68, 6800), 5, 256));
+
+    auto stats = getStats(controller);
+    ASSERT_EQ(72, stats["totalTickets"].numberInt());
+    ASSERT_EQ("increase", stats["lastDecision"].str());
+    ASSERT_EQ(1000, stats["latencyMicros"].numberLong());
+    ASSERT_EQ(2, stats["increases"].numberLong());
+}
+
+TEST(AdaptiveTicketControllerTest, DecreasesWhenLatencyClimbsWellAboveTheBase) {
+    AdaptiveTicketController controller;
+    ASSERT_EQ(136, controller.update(makeObservation(128, 12800), 5, 256));
+
+    // More tickets made throughput drop, operations now take almost three times as long.
+    ASSERT_EQ(128, controller.update(makeObservation(136, 5000), 5, 256));
+
+    auto stats = getStats(controller);
+    ASSERT_EQ("decrease", stats["lastDecision"].str());
+    ASSERT_EQ(2720, stats["latencyMicros"].numberLong());
+    ASSERT_EQ(0, stats["cachePressureDecreases"].numberLong());
+}
+
+TEST(AdaptiveTicketControllerTest, HoldsBetweenTheThresholds) {
+    AdaptiveTicketController controller;
+    ASSERT_EQ(136, controller.update(makeObservation(128, 12800), 5, 256));
+    ASSERT_EQ(136, controller.update(makeObservation(136, 9000), 5, 256));
+    ASSERT_EQ("hold", getStats(controller)["lastDecision"].str());
+}
+
+TEST(AdaptiveTicketControllerTest, HoldsWhenNothingIsQueued) {
+    AdaptiveTicketController controller;
+    ASSERT_EQ(64, controller.update(makeObservation(64, 6400, false /* queued */), 5, 256));
+    ASSERT_EQ(64, controller.update(makeObservation(64, 0), 5, 256));
+}
+
+TEST(AdaptiveTicketControllerTest, CachePressureCutsMultiplicatively) {
+    AdaptiveTicketController controller;
+    ASSERT_EQ(96, controller.update(makeObservation(128, 12800, true, true), 5, 256));
+    ASSERT_EQ(72, controller.update(makeObservation(96, 9600, false, true), 5, 256));
+
+    auto stats = getStats(controller);
+    ASSERT_EQ(2, stats["decreases"].numberLong());
+    ASSERT_EQ(2, stats["cachePressureDecreases"].numberLong());
+}
+
+TEST(AdaptiveTicketControllerTest, StaysWithinBounds) {
+    AdaptiveTicketController controller;
+    ASSERT_EQ(130, controller.update(makeObservation(128, 12800), 5, 130));
+    ASSERT_EQ(16, controller.update(makeObservation(20, 2000, true, true), 16, 130));
+    ASSERT_EQ(8, controller.update(makeObservation(5, 500, false), 8, 16));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,11 +35,74 @@
 
 #include <iostream>
 
+#include "mongo/db/operation_context.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 
+void TicketHolder::setPrioritizeWaiters(bool prioritize) {
+    _prioritizeWaiters.store(prioritize);
+}
+
+TicketHolder::Priority TicketHolder::_addWaiter(Priority priority) {
+    if (priority == Priority::kLow && _prioritizeWaiters.load()) {
+        _lowWaiters.fetchAndAdd(1);
+        return Priority::kLow;
+    }
+    _normalWaiters.fetchAndAdd(1);
+    return Priority::kNormal;
+}
+
+void TicketHolder::_removeWaiter(Priority priority) {
+    if (priority == Priority::kLow) {
+        _lowWaiters.fetchAndSubtract(1);
+        return;
+    }
+
+    // A deferred low priority waiter registers itself before checking for normal priority ones
+    // under the mutex, so it is either seen here or sees the count at zero.
+    if (_normalWaiters.subtractAndFetch(1) == 0 && _lowWaiters.load() > 0) {
+        stdx::lock_guard<Latch> lk(_lowPriorityMutex);
+        _normalWaitersDrained.notify_all();
+    }
+}
+
+bool TicketHolder::_deferLowPriority(OperationContext* opCtx, Date_t until) {
+    if (_normalWaiters.load() == 0) {
+        return true;
+    }
+
+    _lowPriorityDeferrals.fetchAndAdd(1);
+
+    // Wait for the normal priority waiters rather than for the tickets, so that every ticket
+    // released meanwhile goes to one of them.
+    const Date_t deferUntil = std::min(until, Date_t::now() + kMaxLowPriorityDeferral);
+    auto noNormalWaiters = [this] { return _normalWaiters.load() == 0; };
+    stdx::unique_lock<Latch> lk(_lowPriorityMutex);
+    if (opCtx) {
+        opCtx->waitForConditionOrInterruptUntil(
+            _normalWaitersDrained, lk, deferUntil, noNormalWaiters);
+    } else {
+        _normalWaitersDrained.wait_until(lk, deferUntil.toSystemTimePoint(), noNormalWaiters);
+    }
+
+    return until == Date_t::max() || Date_t::now() < until;
+}
+
+int TicketHolder::waiting() const {
+    return _normalWaiters.load() + _lowWaiters.load();
+}
+
+long long TicketHolder::numReleased() const {
+    return _released.load();
+}
+
+long long TicketHolder::numLowPriorityDeferrals() const {
+    return _lowPriorityDeferrals.load();
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -89,16 +152,30 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::waitForTicket(OperationContext* opCtx, Priority priority) {
+    waitForTicketUntil(opCtx, Date_t::max(), priority);
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
-    // Attempt to get a ticket without waiting in order to avoid expensive time calculations.
-    if (sem_trywait(&_sem) == 0) {
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until, Priority priority) {
+    const bool lowPriority = priority == Priority::kLow && _prioritizeWaiters.load();
+
+    // Attempt to get a ticket without waiting in order to avoid expensive time calculations. Low
+    // priority waiters may only do so when there is no normal priority waiter queued.
+    if ((!lowPriority || _normalWaiters.load() == 0) && sem_trywait(&_sem) == 0) {
         return true;
     }
 
+    priority = _addWaiter(priority);
+    ON_BLOCK_EXIT([&] { _removeWaiter(priority); });
+
+    if (priority == Priority::kLow && !_deferLowPriority(opCtx, until)) {
+        return false;
+    }
+
+    return _waitUntil(opCtx, until);
+}
+
+bool TicketHolder::_waitUntil(OperationContext* opCtx, Date_t until) {
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -130,6 +207,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
 }
 
 void TicketHolder::release() {
+    _released.fetchAndAdd(1);
     check(sem_post(&_sem));
 }
 
@@ -146,12 +224,16 @@ Status TicketHolder::resize(int newSize) {
                                     << "; given " << newSize);
 
     while (_outof.load() < newSize) {
-        release();
+        check(sem_post(&_sem));
         _outof.fetchAndAdd(1);
     }
 
+    // The tickets taken out of circulation are waited for without counting as a waiter, which
+    // would hold back low priority waiters for as long as the shrink takes.
     while (_outof.load() > newSize) {
-        waitForTicket();
+        if (sem_trywait(&_sem) != 0) {
+            _waitUntil(nullptr, Date_t::max());
+        }
         _outof.subtractAndFetch(1);
     }
 
@@ -184,7 +266,14 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
+void TicketHolder::waitForTicket(OperationContext* opCtx, Priority priority) {
+    priority = _addWaiter(priority);
+    ON_BLOCK_EXIT([&] { _removeWaiter(priority); });
+
+    if (priority == Priority::kLow) {
+        _deferLowPriority(opCtx, Date_t::max());
+    }
+
     stdx::unique_lock<Latch> lk(_mutex);
 
     if (opCtx) {
@@ -194,7 +283,14 @@ void TicketHolder::waitForTicket(OperationContext* opCtx) {
     }
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until, Priority priority) {
+    priority = _addWaiter(priority);
+    ON_BLOCK_EXIT([&] { _removeWaiter(priority); });
+
+    if (priority == Priority::kLow && !_deferLowPriority(opCtx, until)) {
+        return false;
+    }
+
     stdx::unique_lock<Latch> lk(_mutex);
 
     if (opCtx) {
@@ -207,6 +303,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
 }
 
 void TicketHolder::release() {
+    _released.fetchAndAdd(1);
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _num++;
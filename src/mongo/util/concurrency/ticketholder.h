@@ -32,7 +32,7 @@
 #include <semaphore.h>
 #endif
 
-#include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -41,11 +41,23 @@
 
 namespace mongo {
 
+class OperationContext;
+
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
+    /**
+     * The order in which waiters are handed tickets, once enabled with setPrioritizeWaiters(). Low
+     * priority waiters then step aside for up to 'kMaxLowPriorityDeferral' while there are normal
+     * priority waiters queued, after which they compete for tickets as usual so that they are
+     * never starved. Otherwise all waiters are treated as normal priority.
+     */
+    enum class Priority { kNormal, kLow };
+
+    static constexpr Milliseconds kMaxLowPriorityDeferral{100};
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
@@ -56,7 +68,7 @@ public:
      * 'opCtx' is killed, throwing an AssertionException.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    void waitForTicket(OperationContext* opCtx);
+    void waitForTicket(OperationContext* opCtx, Priority priority = Priority::kNormal);
     void waitForTicket() {
         waitForTicket(nullptr);
     }
@@ -68,7 +80,9 @@ public:
      * proceed.
      * If 'opCtx' is not provided or equal to nullptr, the wait is not interruptible.
      */
-    bool waitForTicketUntil(OperationContext* opCtx, Date_t until);
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            Priority priority = Priority::kNormal);
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
@@ -82,8 +96,56 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of operations currently waiting for a ticket.
+     */
+    int waiting() const;
+
+    /**
+     * Returns the number of tickets released since this TicketHolder was created, which is the
+     * number of operations that have finished with their ticket.
+     */
+    long long numReleased() const;
+
+    /**
+     * Returns the number of times a low priority waiter stepped aside for normal priority ones.
+     */
+    long long numLowPriorityDeferrals() const;
+
+    /**
+     * Sets whether the priority waiters pass in is honored, which it is not by default.
+     */
+    void setPrioritizeWaiters(bool prioritize);
+
 private:
+    /**
+     * Returns the priority a waiter asking for 'priority' actually waits with, and counts it as a
+     * waiter of that priority.
+     */
+    Priority _addWaiter(Priority priority);
+    void _removeWaiter(Priority priority);
+
+    /**
+     * Holds a low priority waiter back while normal priority waiters are queued, for at most
+     * 'kMaxLowPriorityDeferral' and never past 'until'. Returns false if 'until' was reached.
+     */
+    bool _deferLowPriority(OperationContext* opCtx, Date_t until);
+
+    AtomicWord<bool> _prioritizeWaiters{false};
+    AtomicWord<int> _normalWaiters{0};
+    AtomicWord<int> _lowWaiters{0};
+    AtomicWord<long long> _released{0};
+    AtomicWord<long long> _lowPriorityDeferrals{0};
+
+    // Deferred low priority waiters wait on '_normalWaitersDrained', which is notified once the
+    // last normal priority waiter is handed a ticket or gives up.
+    Mutex _lowPriorityMutex =
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "TicketHolder::_lowPriorityMutex");
+    stdx::condition_variable _normalWaitersDrained;
+
 #if defined(__linux__)
+    bool _waitUntil(OperationContext* opCtx, Date_t until);
+
     mutable sem_t _sem;
 
     // You can read _outof without a lock, but have to hold _resizeMutex to change.
@@ -32,6 +32,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -72,4 +73,103 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, LowPriorityWaitersDeferToNormalPriorityOnes) {
+    TicketHolder holder(1);
+    holder.setPrioritizeWaiters(true);
+    holder.waitForTicket();
+
+    AtomicWord<int> order{0};
+    AtomicWord<int> lowPriorityOrder{0};
+    AtomicWord<int> normalPriorityOrder{0};
+
+    stdx::thread normal([&] {
+        holder.waitForTicket(nullptr, TicketHolder::Priority::kNormal);
+        normalPriorityOrder.store(order.addAndFetch(1));
+        holder.release();
+    });
+    while (holder.waiting() < 1) {
+        sleepmillis(1);
+    }
+
+    stdx::thread low([&] {
+        holder.waitForTicket(nullptr, TicketHolder::Priority::kLow);
+        lowPriorityOrder.store(order.addAndFetch(1));
+        holder.release();
+    });
+    while (holder.waiting() < 2) {
+        sleepmillis(1);
+    }
+
+    holder.release();
+    normal.join();
+    low.join();
+
+    ASSERT_EQ(1, normalPriorityOrder.load());
+    ASSERT_EQ(2, lowPriorityOrder.load());
+    ASSERT_EQ(1, holder.numLowPriorityDeferrals());
+    ASSERT_EQ(3, holder.numReleased());
+    ASSERT_EQ(0, holder.waiting());
+    ASSERT_EQ(0, holder.used());
+}
+
+TEST(TicketholderTest, LowPriorityWaitersAreNotDeferredUnlessPrioritized) {
+    TicketHolder holder(1);
+    holder.waitForTicket();
+
+    stdx::thread normal([&] {
+        holder.waitForTicket(nullptr, TicketHolder::Priority::kNormal);
+        holder.release();
+    });
+    while (holder.waiting() < 1) {
+        sleepmillis(1);
+    }
+
+    stdx::thread low([&] {
+        holder.waitForTicket(nullptr, TicketHolder::Priority::kLow);
+        holder.release();
+    });
+    while (holder.waiting() < 2) {
+        sleepmillis(1);
+    }
+
+    holder.release();
+    normal.join();
+    low.join();
+
+    ASSERT_EQ(0, holder.numLowPriorityDeferrals());
+    ASSERT_EQ(3, holder.numReleased());
+    ASSERT_EQ(0, holder.waiting());
+}
+
+#if defined(__linux__)
+TEST(TicketholderTest, ShrinkingDoesNotDeferLowPriorityWaiters) {
+    TicketHolder holder(6);
+    holder.setPrioritizeWaiters(true);
+    for (int i = 0; i < 6; ++i) {
+        holder.waitForTicket();
+    }
+
+    // The shrink has to wait for a ticket to be released, but doesn't count as a waiter
+    Status resizeStatus = Status::OK();
+    stdx::thread shrink([&] { resizeStatus = holder.resize(5); });
+    sleepmillis(10);
+    ASSERT_EQ(0, holder.waiting());
+
+    stdx::thread low([&] { holder.waitForTicket(nullptr, TicketHolder::Priority::kLow); });
+    while (holder.waiting() < 1) {
+        sleepmillis(1);
+    }
+
+    holder.release();
+    holder.release();
+    shrink.join();
+    low.join();
+
+    ASSERT_OK(resizeStatus);
+    ASSERT_EQ(0, holder.numLowPriorityDeferrals());
+    ASSERT_EQ(5, holder.outof());
+    ASSERT_EQ(5, holder.used());
+}
+#endif
 }  // namespace